@@ -137,6 +137,8 @@ private slots:
 
     void GotAnswerForVersionRequest(QNetworkReply *pReply);
     void CreateScreenShot();
+    void DumpQueueStatistics();
+    void DumpMutexStatistics();
 
     void RegisterAtStunSipServer();
     void UpdateSysTrayContextMenu();
@@ -200,6 +202,8 @@ private:
     MediaSourceMuxer 		    *mOwnVideoMuxer;
     MediaSourceMuxer 		    *mOwnAudioMuxer;
     QTimer 					    *mScreenShotTimer;
+    QTimer                      *mQueueStatisticTimer;
+    QTimer                      *mMutexStatisticTimer;
     QSystemTrayIcon			    *mSysTrayIcon;
     QMenu					    *mSysTrayMenu, *mDockMenu /* OSX dock menu */;
     MediaSourceDesktop 		    *mMediaSourceDesktop;
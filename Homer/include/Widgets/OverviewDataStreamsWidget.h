@@ -32,6 +32,7 @@
 #include <QMutex>
 
 #include <PacketStatistic.h>
+#include <QueueStatistic.h>
 
 #include <ui_OverviewDataStreamsWidget.h>
 
@@ -74,6 +75,7 @@ private:
     void SaveHistory(enum Homer::Monitor::DataType pDataType, int pIndex);
     void FillCellText(QTableWidget *pTable, int pRow, int pCol, QString pText);
     void FillRow(QTableWidget *pTable, int pRow, Homer::Monitor::PacketStatistic *pStats);
+    void FillQueueRow(QTableWidget *pTable, int pRow, Homer::Monitor::QueueStatistic *pStats);
 
     QPoint              mWinPos;
     QAction             *mAssignedAction;
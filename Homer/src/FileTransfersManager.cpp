@@ -1276,6 +1276,8 @@ void* FileTransfersManager::Run(void* pArgs)
     int tDataSize;
 
     SVC_PROCESS_STATISTIC.AssignThreadName("FileTransfer-Listener");
+    // bulk data transfers mustn't delay the media processing
+    SetSchedulingClass(THREAD_SCHEDULING_BACKGROUND);
 
     if (mReceiverSocket == NULL)
         return NULL;
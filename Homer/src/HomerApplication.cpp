@@ -143,11 +143,16 @@ void HomerApplication::initializeLogging()
     	tFile.remove();
     }
 
-    // log to default log file
+    // log to default log file, it follows the log level of the console
     if (CONF.GetFeatureAutoLogging())
-        LOGGER.RegisterLogSink(new LogSinkFile(PATH_DEFAULT_LOGFILE.toStdString()));
+    {
+        LogSinkFile *tAutoLogSink = new LogSinkFile(PATH_DEFAULT_LOGFILE.toStdString());
+        tAutoLogSink->SetLogLevel(LOG_SINK_LEVEL_OF_LOGGER);
+        LOGGER.RegisterLogSink(tAutoLogSink);
+    }
 
-	// network based log sinks
+	// network based log sinks, binary batches by default
+    enum LogSinkNetFormat tNetFormat = mArguments.contains("-DebugOutputNetworkText") ? LOG_SINK_NET_TEXT : LOG_SINK_NET_BINARY;
     QStringList tPorts = mArguments.filter("-DebugOutputNetwork=");
     if (tPorts.size())
     {
@@ -165,14 +170,19 @@ void HomerApplication::initializeLogging()
         		if (tPortParsingWasOkay)
         		{
         			LOG(LOG_VERBOSE, "New network based log sink at %s:%d", tNetwork.toStdString().c_str(), tPort);
-					LOGGER.RegisterLogSink(new LogSinkNet(tNetwork.toStdString(), tPort));
+					LOGGER.RegisterLogSink(new LogSinkNet(tNetwork.toStdString(), tPort, tNetFormat));
         		}else
         			LOG(LOG_ERROR, "Couldn't parse %s as network port", tPortStr.toStdString().c_str());
         	}
         }
     }
 
-    MainWindow::removeArguments(mArguments, "-Debug");
+    // decouple the media threads from the I/O of the log sinks
+    if (mArguments.contains("-DebugOutputAsync"))
+        LOGGER.ActivateAsyncMode();
+
+    MainWindow::removeArguments(mArguments, "-DebugLevel");
+    MainWindow::removeArguments(mArguments, "-DebugOutput");
 }
 
 void HomerApplication::RegisterPluginPath(QString pPath)
@@ -56,6 +56,10 @@
 #include <WaveOutPulseAudio.h>
 #include <Header_NetworkSimulator.h>
 #include <ProcessStatisticService.h>
+#include <HBExecutor.h>
+#include <HBSocketReactor.h>
+#include <QueueStatisticService.h>
+#include <MutexStatisticService.h>
 #include <Snippets.h>
 
 #if not defined(HOMER_QT5)
@@ -117,6 +121,8 @@ MainWindow::MainWindow(QStringList pArguments, QString pAbsBinPath) :
     mOverviewFileTransfersWidget = NULL;
     mOnlineStatusWidget = NULL;
     mMosaicModeActive = false;
+    mQueueStatisticTimer = NULL;
+    mMutexStatisticTimer = NULL;
 
     QCoreApplication::setApplicationName("Homer");
     QCoreApplication::setApplicationVersion(HOMER_VERSION);
@@ -466,6 +472,26 @@ void MainWindow::initializeFeatureDisablers(QStringList &pArguments)
                 LOG(LOG_WARN, "Disabling QoS support..");
                 Socket::DisableQoSSupport();
             }
+            if(tFeatureName == "JitterBuffer")
+            {
+                LOG(LOG_WARN, "Disabling JITTER BUFFER for received RTP packets..");
+                MediaSourceMem::DisableJitterBuffer();
+            }
+            if(tFeatureName == "NACK")
+            {
+                LOG(LOG_WARN, "Disabling NACK based RETRANSMISSIONS of RTP packets..");
+                RTP::DisableNackSupport();
+            }
+            if(tFeatureName == "KeyFrameRequests")
+            {
+                LOG(LOG_WARN, "Disabling KEY FRAME REQUESTS (RTCP PLI/FIR) for RTP streams..");
+                RTP::DisableKeyFrameRequestSupport();
+            }
+            if(tFeatureName == "NativePacketizer")
+            {
+                LOG(LOG_WARN, "Disabling NATIVE RTP PACKETIZER for H.264/HEVC streams..");
+                RTP::DisableNativePacketizerSupport();
+            }
             if(tFeatureName == "AudioOutput")
             {
                 LOG(LOG_WARN, "Disabling AUDIO OUTPUT support..");
@@ -491,6 +517,34 @@ void MainWindow::initializeFeatureDisablers(QStringList &pArguments)
         CONF.DisableConferencing();
 
     removeArguments(pArguments, "-Disable");
+
+    if (pArguments.contains("-Enable=SharedWorkers"))
+    {
+        LOG(LOG_WARN, "Enabling SHARED WORKERS for pipeline stages..");
+        Executor::ActivatePipelineTasks();
+    }
+    removeArguments(pArguments, "-Enable=SharedWorkers");
+
+    if (pArguments.contains("-Enable=SegmentationOffload"))
+    {
+        LOG(LOG_WARN, "Enabling SEGMENTATION OFFLOAD for network streams..");
+        Socket::ActivateSegmentationOffload();
+    }
+    removeArguments(pArguments, "-Enable=SegmentationOffload");
+
+    if (pArguments.contains("-Enable=SocketReactor"))
+    {
+        LOG(LOG_WARN, "Enabling SOCKET REACTOR for network listeners..");
+        SocketReactor::ActivateReactor();
+    }
+    removeArguments(pArguments, "-Enable=SocketReactor");
+
+    if (pArguments.contains("-Enable=FEC"))
+    {
+        LOG(LOG_WARN, "Enabling FORWARD ERROR CORRECTION for RTP streams..");
+        RTP::ActivateFec();
+    }
+    removeArguments(pArguments, "-Enable=FEC");
 }
 
 void MainWindow::ShowFfmpegCaps(QStringList &pArguments)
@@ -552,6 +606,40 @@ void MainWindow::initializeDebugging(QStringList &pArguments)
             }
         }
     }
+    // periodic dump of queue statistics, e.g. for headless runs
+    QStringList tQueueStatisticArgs = pArguments.filter("-DebugQueueStatistic=");
+    if (tQueueStatisticArgs.size())
+    {
+        QString tPeriod = tQueueStatisticArgs.first();
+        int tPeriodSecs = tPeriod.remove("-DebugQueueStatistic=").toInt();
+        if (tPeriodSecs > 0)
+        {
+            LOG(LOG_INFO, "Dumping queue statistics every %d seconds", tPeriodSecs);
+            mQueueStatisticTimer = new QTimer(this);
+            connect(mQueueStatisticTimer, SIGNAL(timeout()), this, SLOT(DumpQueueStatistics()));
+            mQueueStatisticTimer->start(tPeriodSecs * 1000);
+        }else
+            LOG(LOG_WARN, "Invalid period for queue statistic dump given");
+    }
+    removeArguments(pArguments, "-DebugQueueStatistic");
+    // mutex profiling and periodic dump of the results
+    QStringList tMutexStatisticArgs = pArguments.filter("-DebugMutexStatistic=");
+    if (tMutexStatisticArgs.size())
+    {
+        QString tPeriod = tMutexStatisticArgs.first();
+        int tPeriodSecs = tPeriod.remove("-DebugMutexStatistic=").toInt();
+        if (tPeriodSecs > 0)
+        {
+            LOG(LOG_INFO, "Profiling mutexes and dumping the statistics every %d seconds", tPeriodSecs);
+            SVC_MUTEX_STATISTIC.ActivateProfiling();
+            mMutexStatisticTimer = new QTimer(this);
+            connect(mMutexStatisticTimer, SIGNAL(timeout()), this, SLOT(DumpMutexStatistics()));
+            mMutexStatisticTimer->start(tPeriodSecs * 1000);
+        }else
+            LOG(LOG_WARN, "Invalid period for mutex statistic dump given");
+    }
+    removeArguments(pArguments, "-DebugMutexStatistic");
+
     LOG(LOG_VERBOSE, "################ SYSTEM INFO ################");
     LOG(LOG_VERBOSE, "Found system info:\n%s", HelpDialog::GetSystemInfo().toStdString().c_str());
     LOG(LOG_VERBOSE, "#############################################");
@@ -926,6 +1014,16 @@ void MainWindow::CreateScreenShot()
     mScreenShotTimer->start(1000 / SCREEN_CAPTURE_FPS);
 }
 
+void MainWindow::DumpQueueStatistics()
+{
+    SVC_QUEUE_STATISTIC.DumpQueueStatistics();
+}
+
+void MainWindow::DumpMutexStatistics()
+{
+    SVC_MUTEX_STATISTIC.DumpMutexStatistics();
+}
+
 void MainWindow::loadSettings()
 {
     int tX = 352;
@@ -1048,6 +1146,10 @@ void MainWindow::closeEvent(QCloseEvent* pEvent)
     // stop the screenshot creating timer function
     LOG(LOG_VERBOSE, "..stopping GUI capturing");
     mScreenShotTimer->stop();
+    if (mQueueStatisticTimer != NULL)
+        mQueueStatisticTimer->stop();
+    if (mMutexStatisticTimer != NULL)
+        mMutexStatisticTimer->stop();
 
     // prevent the system from further incoming events
     LOG(LOG_VERBOSE, "..stopping conference manager");
@@ -26,6 +26,7 @@
 
 #include <Widgets/OverviewDataStreamsWidget.h>
 #include <PacketStatisticService.h>
+#include <QueueStatisticService.h>
 #include <Configuration.h>
 #include <Snippets.h>
 #include <QDockWidget>
@@ -108,12 +109,18 @@ void OverviewDataStreamsWidget::initializeGUI()
     mTwVideo->horizontalHeader()->resizeSection(10, mTwVideo->horizontalHeader()->sectionSize(9) * 2);
     mTwVideo->horizontalHeader()->resizeSection(11, mTwVideo->horizontalHeader()->sectionSize(10) * 2);
 
+    mTwQueues->horizontalHeader()->resizeSection(0, mTwQueues->horizontalHeader()->sectionSize(0) * 4);
+    for (int i = 1; i < 11; i++)
+        mTwQueues->horizontalHeader()->resizeSection(i, mTwQueues->horizontalHeader()->sectionSize(i) * 2);
+
 	#if HOMER_QT5
 		mTwAudio->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 	    mTwVideo->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+	    mTwQueues->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 	#else
 		mTwAudio->horizontalHeader()->setResizeMode(QHeaderView::Interactive);
 	    mTwVideo->horizontalHeader()->setResizeMode(QHeaderView::Interactive);
+	    mTwQueues->horizontalHeader()->setResizeMode(QHeaderView::Interactive);
 	#endif
 
     UpdateView();
@@ -511,10 +518,38 @@ void OverviewDataStreamsWidget::FillRow(QTableWidget *pTable, int pRow, PacketSt
 
 }
 
+void OverviewDataStreamsWidget::FillQueueRow(QTableWidget *pTable, int pRow, QueueStatistic *pStats)
+{
+    if (pStats == NULL)
+        return;
+
+    QueueStatisticDescriptor tStatValues = pStats->GetQueueStatistic();
+
+    if (pRow > pTable->rowCount() - 1)
+        pTable->insertRow(pTable->rowCount());
+
+    if (pTable->item(pRow, 0) != NULL)
+        pTable->item(pRow, 0)->setText(QString(pStats->GetQueueName().c_str()));
+    else
+        pTable->setItem(pRow, 0, new QTableWidgetItem(QString(pStats->GetQueueName().c_str())));
+    pTable->item(pRow, 0)->setBackground(QBrush(QColor(Qt::lightGray)));
+
+    FillCellText(pTable, pRow, 1, QString("%1 / %2").arg(tStatValues.Usage).arg(tStatValues.Size));
+    FillCellText(pTable, pRow, 2, QString("%1").arg(tStatValues.UsageHighWatermark));
+    FillCellText(pTable, pRow, 3, Int2ByteExpression(tStatValues.MemoryHighWatermark) + " / " + Int2ByteExpression(tStatValues.MemoryBudget) + " bytes");
+    FillCellText(pTable, pRow, 4, Int2ByteExpression(tStatValues.WriteCount));
+    FillCellText(pTable, pRow, 5, Int2ByteExpression(tStatValues.DropCount));
+    FillCellText(pTable, pRow, 6, Int2ByteExpression(tStatValues.AvgResidenceTime) + " us");
+    FillCellText(pTable, pRow, 7, Int2ByteExpression(QueueStatistic::GetResidenceTimePercentile(tStatValues, 95)) + " us");
+    FillCellText(pTable, pRow, 8, Int2ByteExpression(tStatValues.MaxResidenceTime) + " us");
+    FillCellText(pTable, pRow, 9, Int2ByteExpression(tStatValues.WriterBlockedTime / 1000) + " ms");
+    FillCellText(pTable, pRow, 10, Int2ByteExpression(tStatValues.ReaderBlockedTime / 1000) + " ms");
+}
+
 void OverviewDataStreamsWidget::UpdateView()
 {
 	PacketStatistics::iterator tIt;
-    int tRowAudio = 0, tRowVideo = 0;
+    int tRowAudio = 0, tRowVideo = 0, tRowQueues = 0;
     int tASelectedRow = -1, tVSelectedRow = -1;
 
     // save old widget state
@@ -551,6 +586,13 @@ void OverviewDataStreamsWidget::UpdateView()
     }
     SVC_PACKET_STATISTIC.ReleasePacketStatisticsAccess();
 
+    QueueStatistics::iterator tQueueIt;
+    QueueStatistics tQueueStatList = SVC_QUEUE_STATISTIC.GetQueueStatisticsAccess();
+    for (tQueueIt = tQueueStatList.begin(); tQueueIt != tQueueStatList.end(); tQueueIt++)
+        FillQueueRow(mTwQueues, tRowQueues++, *tQueueIt);
+    SVC_QUEUE_STATISTIC.ReleaseQueueStatisticsAccess();
+    mTwQueues->setRowCount(tRowQueues);
+
     for (int i = mTwAudio->rowCount(); i > tRowAudio; i--)
         mTwAudio->removeRow(i);
     for (int i = mTwVideo->rowCount(); i > tRowVideo; i--)
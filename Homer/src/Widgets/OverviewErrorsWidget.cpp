@@ -55,6 +55,7 @@ OverviewErrorsWidget::OverviewErrorsWidget(QAction *pAssignedAction, QMainWindow
     mAssignedAction = pAssignedAction;
     mTimerId = -1;
     mLogSinkId = "Qt-based error view";
+    mLogLevel = LOG_SINK_LEVEL_OF_LOGGER;
 
     initializeGUI();
 
@@ -92,8 +92,8 @@ void OverviewThreadsWidget::initializeGUI()
     setupUi(this);
 
     // hide id column
-    mTwThreads->setColumnHidden(13, true);
-    mTwThreads->sortItems(13);
+    mTwThreads->setColumnHidden(15, true);
+    mTwThreads->sortItems(15);
 	#if HOMER_QT5
 		mTwThreads->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 	#else
@@ -103,6 +103,8 @@ void OverviewThreadsWidget::initializeGUI()
     mTwThreads->horizontalHeader()->resizeSection(7, mTwThreads->horizontalHeader()->sectionSize(7) * 2);
     mTwThreads->horizontalHeader()->resizeSection(8, mTwThreads->horizontalHeader()->sectionSize(8) * 2);
     mTwThreads->horizontalHeader()->resizeSection(9, mTwThreads->horizontalHeader()->sectionSize(9) * 2);
+    mTwThreads->horizontalHeader()->resizeSection(13, mTwThreads->horizontalHeader()->sectionSize(13) * 2);
+    mTwThreads->horizontalHeader()->resizeSection(14, mTwThreads->horizontalHeader()->sectionSize(14) * 2);
 
     UpdateView();
 }
@@ -195,7 +197,13 @@ void OverviewThreadsWidget::FillRow(int pRow, ProcessStatistic *pStats)
     FillCellText(pRow, 10, QString("%1 %").arg(tStatValues.LoadUser * tScaleFactor, 0, 'f', 2));
     FillCellText(pRow, 11, QString("%1 %").arg(tStatValues.LoadSystem * tScaleFactor, 0, 'f', 2));
     FillCellText(pRow, 12, QString("%1 %").arg(tStatValues.LoadTotal * tScaleFactor, 0, 'f', 2));
-    FillCellText(pRow, 13, QString("%1").arg(pRow));
+    // show the requested class if the OS has denied it
+    if (tStatValues.SchedulingClassEffective != tStatValues.SchedulingClass)
+        FillCellText(pRow, 13, QString(Thread::SchedulingClass2String(tStatValues.SchedulingClassEffective).c_str()) + " (" + QString(Thread::SchedulingClass2String(tStatValues.SchedulingClass).c_str()) + ")");
+    else
+        FillCellText(pRow, 13, QString(Thread::SchedulingClass2String(tStatValues.SchedulingClass).c_str()));
+    FillCellText(pRow, 14, QString("%1 / %2 us").arg(tStatValues.SchedulingLatencyAvg).arg(tStatValues.SchedulingLatencyMax));
+    FillCellText(pRow, 15, QString("%1").arg(pRow));
 }
 
 void OverviewThreadsWidget::UpdateView()
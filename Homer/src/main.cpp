@@ -34,6 +34,9 @@
 #include <stdio.h>
 #include <signal.h>
 #include <stdlib.h>
+#if defined(LINUX) || defined(APPLE)
+#include <unistd.h>
+#endif
 
 #if HOMER_QT5
     #warning "QT5 support enabled"
@@ -139,6 +142,9 @@ void LogExceptionSignal(int pSignal)
     LOGEX(MainWindow, LOG_ERROR, "Signal \"%s\(%d): %s\" detected.", tSignalName.c_str(), pSignal, tSignalDescription.c_str());
 }
 
+// already opened file descriptor for the queued debug outputs of a crash, see Logger::WriteQueuedMessagesAfterCrash()
+static int sCrashOutputFd = -1;
+
 void HandleExceptionSignal(int pSignal)
 {
     switch(pSignal)
@@ -160,7 +166,9 @@ void HandleExceptionSignal(int pSignal)
                 LOGEX(MainWindow, LOG_ERROR, "Restart Homer Conferencing via \"Homer -DebugOutputFile=debug.log\" to generate verbose debug data.");
                 LOGEX(MainWindow, LOG_ERROR, "Afterwards attach the file debug.log to your bug report and send both by mail to homer@homer-conferencing.com.");
                 LOGEX(MainWindow, LOG_ERROR, " ");
-                exit(0);
+                // HINT: the crashed thread might hold a logger or log sink mutex, hence we neither flush the log sinks nor run any destructors here
+                LOGGER.WriteQueuedMessagesAfterCrash(sCrashOutputFd);
+                _exit(0);
             }
             break;
         default:
@@ -192,6 +200,8 @@ static void HandleSignalLinux(int pSignal, siginfo_t *pSignalInfo, void *pArg)
 
 static void SetHandlers()
 {
+    sCrashOutputFd = fileno(stderr);
+
     // set handler stack
     stack_t tStack;
     tStack.ss_sp = malloc(SIGSTKSZ);
@@ -239,6 +249,8 @@ void HandleSignalWindows(int pSignal)
 
 static void SetHandlers()
 {
+    sCrashOutputFd = fileno(stderr);
+
 	// activate signal handler
     signal(SIGILL, HandleSignalWindows);
     signal(SIGFPE, HandleSignalWindows);
@@ -557,14 +569,26 @@ int WINAPI WinMain(HINSTANCE pInstance,	HINSTANCE pPrevInstance, LPSTR pCmdLine,
 		printf("   -DebugLevel=<level>                 defines the level of debug outputs, possible values are: \"Error, Info, Verbose, World\"\n");
 		printf("   -DebugOutputFile=<file>             write verbose debug data to the given file\n");
 		printf("   -DebugOutputNetwork=<host>:<port>   send verbose debug data to the given target host and port, UDP is used for message transport\n");
+		printf("   -DebugOutputNetworkText             send network debug data as text records instead of binary batches for HomerLogDecoder\n");
+		printf("   -DebugOutputAsync                   write debug data from a background thread, messages are dropped if the queue is full\n");
+		printf("   -DebugQueueStatistic=<seconds>      periodically write statistics of all media queues to the debug output\n");
+		printf("   -DebugMutexStatistic=<seconds>      profile all mutexes and periodically write their statistics to the debug output\n");
 		printf("\n");
 		printf("Options for feature selection:\n");
 		printf("   -Disable=AudioCapture               disable audio capture from devices\n");
 		printf("   -Disable=AudioOutput                disable audio playback support\n");
 		printf("   -Disable=Conferencing               disable conference functions (disables ports for SIP/STUN management and file transfers)\n");
 		printf("   -Disable=IPv6                       disable IPv6 support\n");
+		printf("   -Disable=JitterBuffer               disable reordering of received RTP packets and waiting for missing ones\n");
+		printf("   -Disable=KeyFrameRequests           disable key frame requests for lost or joined video streams (RTCP PLI/FIR)\n");
+		printf("   -Disable=NACK                       disable retransmission requests for lost RTP packets (RTCP NACK)\n");
+		printf("   -Disable=NativePacketizer           disable the copy free RTP packetizer for H.264/HEVC and use the one of ffmpeg instead\n");
 		printf("   -Disable=QoS                        disable QoS support\n");
+		printf("   -Enable=FEC                         add XOR parity packets to sent RTP streams, their overhead follows the loss reported by the receiver\n");
 		printf("   -Enable=NetSim                      enable network simulator\n");
+		printf("   -Enable=SegmentationOffload         let the network stack split and coalesce bursts of equally sized RTP packets (Linux UDP GSO/GRO)\n");
+		printf("   -Enable=SharedWorkers               run pipeline stages as tasks on a shared pool of worker threads instead of own threads\n");
+		printf("   -Enable=SocketReactor               receive network streams by a few shared I/O threads instead of one thread per stream (Linux only)\n");
 		printf("   -ListVideoCodecs                    list all supported video codecs of the used libavcodec\n");
 		printf("   -ListAudioCodecs                    list all supported audio codecs of the used libavcodec\n");
 		printf("   -ListInputFormats                   list all supported input formats of the used libavformat\n");
@@ -604,5 +628,8 @@ int WINAPI WinMain(HINSTANCE pInstance,	HINSTANCE pPrevInstance, LPSTR pCmdLine,
     LOGEX(HomerApplication, LOG_VERBOSE, "Executing Qt main window");
     tApp->exec();
 
+    // write all queued debug outputs
+    LOGGER.Deinit();
+
     return 0;
 }
@@ -56,8 +56,8 @@ public:
     virtual ~Condition( );
 
     bool Wait(Mutex *pMutex = NULL, int pMSecs = 0); //in ms
-    bool SignalOne();
-    bool Signal();
+    bool SignalOne(); // wakes one waiting thread
+    bool Signal(); // wakes all waiting threads
 
 private:
     bool Reset();
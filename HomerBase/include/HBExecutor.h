@@ -0,0 +1,202 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: work-stealing executor which runs tasks on a shared pool of worker threads
+ * Since:   2026-10-17
+ */
+
+#ifndef _BASE_EXECUTOR_
+#define _BASE_EXECUTOR_
+
+#include <HBMutex.h>
+#include <HBCondition.h>
+#include <HBThread.h>
+
+#include <deque>
+#include <list>
+#include <string>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of task scheduling
+//#define HB_DEBUG_EXECUTOR
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define SVC_EXECUTOR Executor::GetInstance()
+
+// maximum time in ms an idle worker parks before it looks for work again
+#define EXECUTOR_WORKER_PARK_TIME                   250
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Executor;
+class ExecutorWorker;
+
+/* a unit of work for the executor: a task is queued at most once at the same time and is never executed concurrently,
+   scheduling a running task executes it once more afterwards, hence a task can serve as serialized stage of a processing pipeline */
+class Task
+{
+public:
+    Task(std::string pName = "", bool pAutoDelete = false /* delete the task after its execution */);
+
+    virtual ~Task();
+
+    virtual void Execute() = 0;
+
+    /* continuation: scheduled after each execution of this task */
+    void SetContinuation(Task *pTask);
+    Task* GetContinuation();
+
+    void AssignTaskName(std::string pName);
+    std::string GetTaskName();
+    bool IsTaskScheduled(); // queued or running
+    /* removes a queued execution and waits for the end of a running one, it is called by the destructor at latest
+       HINT: derived classes should call this before they destroy resources which are used by Execute() */
+    void UnscheduleTask();
+
+    /* queueing delay between scheduling and execution, in us */
+    void GetQueueingDelayStatistic(int64_t &pExecutions, int64_t &pAvgDelay, int64_t &pMaxDelay);
+
+private:
+    friend class Executor;
+    friend class ExecutorWorker;
+
+    bool MarkQueued(); // returns false if the task is already queued or will be executed once more
+    bool MarkFinished(); // returns false if the task has to be executed once more
+    void AnnounceExecution();
+
+    std::string         mTaskName;
+    bool                mAutoDelete;
+    Task                *mContinuation;
+    volatile int        mTaskState;
+    int64_t             mScheduleTime; // monotonic clock
+    int64_t             mExecutions;
+    int64_t             mQueueingDelaySum;
+    int64_t             mQueueingDelayMax;
+};
+
+typedef std::list<Task*> TaskList;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* one worker thread: own tasks are taken LIFO from the back of its queue, foreign ones are stolen FIFO from the front */
+class ExecutorWorker:
+    public Thread
+{
+public:
+    ExecutorWorker(Executor *pExecutor, int pIndex);
+
+    virtual ~ExecutorWorker();
+
+    void PushTask(Task *pTask);
+    Task* PopTask();
+    Task* StealTask();
+
+    bool RemoveTask(Task *pTask);
+
+    void Unpark();
+    void Stop();
+    bool IsParked();
+    int GetWorkerThreadId();
+
+private:
+    virtual void* Run(void* pArgs = NULL);
+    void Park();
+
+    Executor            *mExecutor;
+    int                 mIndex;
+    int                 mWorkerThreadId;
+    bool                mWorkerNeeded;
+    std::deque<Task*>   mTasks;
+    Mutex               mTasksMutex;
+    volatile int        mParked;
+    Mutex               mParkMutex;
+    Condition           mParkCondition;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Executor
+{
+public:
+    Executor();
+
+    virtual ~Executor();
+
+    static Executor& GetInstance();
+
+    /* the executor is started on demand with one worker per machine core */
+    bool Start(int pWorkerCount = 0 /* 0 means one worker per machine core */);
+    void Stop();
+    bool IsRunning();
+    int GetWorkerCount();
+
+    /* returns false if the task was already queued, tasks scheduled by a worker are queued at this worker */
+    bool Schedule(Task *pTask);
+    /* removes a queued task and waits until a running execution has finished */
+    void Unschedule(Task *pTask);
+
+    /* pipeline stages which are able to run as tasks use the executor only if this is activated */
+    static void ActivatePipelineTasks(bool pActive = true);
+    static bool PipelineTasksActivated();
+
+    /* task registry for statistics */
+    TaskList GetTasksAccess();
+    void ReleaseTasksAccess();
+    void RegisterTask(Task *pTask);
+    void UnregisterTask(Task *pTask);
+
+private:
+    friend class ExecutorWorker;
+
+    bool StartLocked(int pWorkerCount);
+    int GetCurrentWorker(); // returns -1 if the calling thread isn't a worker
+    void EnqueueTask(Task *pTask, int pWorkerIndex);
+    Task* FindTask(int pWorkerIndex);
+    void ExecuteTask(Task *pTask);
+    int GetPendingTasks();
+
+    ExecutorWorker      **mWorkers;
+    int                 mWorkerCount;
+    volatile int        mPendingTasks;
+    volatile int        mNextWorker;
+    bool                mRunning;
+    bool                mStopping;
+    Mutex               mStartMutex; // protects the worker set against concurrent scheduling during Start()/Stop()
+    /* waiting for the end of task executions */
+    volatile int        mTaskFinishedWaiters;
+    Mutex               mTaskFinishedMutex;
+    Condition           mTaskFinishedCondition;
+    TaskList            mTasks;
+    Mutex               mTasksMutex;
+    static bool         sPipelineTasksActive;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
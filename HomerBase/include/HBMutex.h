@@ -41,6 +41,8 @@
 #endif
 
 #include <string>
+#include <vector>
+#include <stdint.h>
 
 namespace Homer { namespace Base {
 
@@ -49,6 +51,27 @@ namespace Homer { namespace Base {
 // the following de/activates debugging of mutexes
 //#define HB_DEBUG_MUTEX
 
+// amount of buckets for the wait time histogram: bucket 0 counts wait times below 1 us, bucket i counts wait times in [2^(i-1), 2^i) us, the last bucket counts all longer ones
+#define MUTEX_PROFILE_HISTOGRAM_SIZE                            16
+
+// upper limit for the busy waiting rounds of an adaptive mutex before the calling thread is parked in the kernel
+#define MUTEX_ADAPTIVE_SPIN_ROUNDS                              100
+
+///////////////////////////////////////////////////////////////////////////////
+
+// profile of all mutexes which share the same name, unnamed mutexes are aggregated as "unnamed"
+struct MutexProfile{
+    std::string Name;
+    int64_t     Acquisitions;
+    int64_t     Contentions; // acquisitions which found the mutex locked
+    int64_t     WaitTime; // in us
+    int64_t     WaitTimeMax; // in us
+    int64_t     WaitTimeHistogram[MUTEX_PROFILE_HISTOGRAM_SIZE];
+    int64_t     HoldTimeMax; // in us
+};
+
+typedef std::vector<MutexProfile> MutexProfiles;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class Mutex
@@ -65,14 +88,38 @@ public:
     /* for debbuging */
     void AssignName(std::string pName);
 
+    /* locking strategy: spin for a short time before the calling thread is parked, only useful for very short critical sections */
+    void SetAdaptiveSpinning(bool pActive = true);
+
+    /* profiling: disabled by default, costs one time stamp per contended acquisition and two time stamps per critical section if active */
+    static void ActivateProfiling();
+    static void DeactivateProfiling();
+    static bool IsProfilingActive();
+    static MutexProfiles GetProfiles();
+    static void ResetProfiles();
+
 private:
 friend class Condition;
 
     bool tryLock(int pMSecs = 0);
+    bool TryLockOnce();
+    bool SpinLock();
+
+    /* profiling */
+    bool IsProfiled();
+    MutexProfile* GetProfile();
+    void ProfileAcquisition(bool pContended, int64_t pWaitTime /* in us */);
+    void ProfileHoldStart();
+    void ProfileHoldEnd();
+    static void UpdateMaximum(volatile int64_t *pValue, int64_t pSample);
 
     OS_DEP_MUTEX    mMutex;
     int             mOwnerThreadId;
     std::string     mName;
+    bool            mAdaptiveSpinning;
+    volatile int    mSpinEstimate;
+    MutexProfile    *mProfile;
+    int64_t         mLockTime; // monotonic clock, 0 if the hold time isn't measured
 };
 
 ///////////////////////////////////////////////////////////////////////////////
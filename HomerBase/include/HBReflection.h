@@ -28,6 +28,7 @@
 #define _BASE_REFLECTION_
 
 #include <typeinfo>
+#include <string>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -69,6 +70,21 @@ inline std::string ParseRawObjectName(std::string pRawName)
 #define GetObjectNameRawStr(x)  (toString(typeid(x).name()))
 #define GetObjectNameStr(x) (ParseRawObjectName(GetObjectNameRawStr(x)))
 
+// parses the raw type name only once per type, the result is valid until program end
+template <typename T>
+inline const std::string& GetObjectNameCached()
+{
+    static const std::string sName = ParseRawObjectName(std::string(typeid(T).name()));
+    return sName;
+}
+
+// the same for the type of the given object, e.g. "this"
+template <typename T>
+inline const std::string& GetObjectNameCached(T const&)
+{
+    return GetObjectNameCached<T>();
+}
+
 namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
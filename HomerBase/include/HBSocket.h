@@ -101,6 +101,16 @@ union SocketAddressDescriptor
     struct sockaddr_storage sa_stor;
 };
 
+// one datagram of a batched transmission, see SendBatch() and ReceiveBatch()
+struct SocketDatagram
+{
+    void                    *Data;
+    ssize_t                 Size; // for reception: the buffer size, afterwards the size of the received datagram
+    SocketAddressDescriptor Source; // for reception: the source of the datagram
+    unsigned int            SourceSize;
+    unsigned int            SegmentSize; // for reception: 0 or the size of the coalesced datagrams if receive offload is enabled, only the last one may be shorter
+};
+
 #define IP_OPTIONS_SIZE                         (sizeof(QoSIpOption))
 #define IP4_HEADER_SIZE							20 // default size, additional bytes for IP options are possible
 #define IP6_HEADER_SIZE							40 // fixed size
@@ -152,6 +162,19 @@ public:
     /* transmission */
     void StopReceiving();
     bool Send(std::string pTargetHost, unsigned int pTargetPort, void *pBuffer, ssize_t pBufferSize);
+    /* fixed destination: the address is resolved once, for UDP the socket is optionally connected in addition */
+    bool SetDestination(std::string pTargetHost, unsigned int pTargetPort, bool pConnectUdp = false);
+    void ResetDestination();
+    bool HasDestination();
+    bool Send(void *pBuffer, ssize_t pBufferSize); // sends towards the fixed destination
+    /* batched datagram transmission: one system call for several datagrams on Linux (sendmmsg/recvmmsg), a loop elsewhere */
+    bool SendBatch(SocketDatagram *pDatagrams, int pDatagramCount); // sends towards the fixed destination
+    int ReceiveBatch(SocketDatagram *pDatagrams, int pMaxDatagrams, bool pWait = true); // waits for the first datagram only (not on Windows if pWait is false), returns the number of received datagrams or -1
+    /* segmentation offload: the network stack splits/coalesces bursts of equally sized datagrams (Linux UDP GSO/GRO), a loop elsewhere */
+    static bool IsSegmentationOffloadActivated();
+    static void ActivateSegmentationOffload();
+    bool SendSegmented(SocketDatagram *pSegments, int pSegmentCount); // sends towards the fixed destination, only the last segment may be shorter
+    bool EnableReceiveOffload(bool pActive = true); // afterwards only ReceiveBatch() should be used, see SocketDatagram::SegmentSize
     bool Receive(std::string &pSourceHost, unsigned int &pSourcePort, void *pBuffer, ssize_t &pBufferSize);
     int GetSendBufferSize();
     bool SetSendBufferSize(int pSize);
@@ -204,6 +227,18 @@ private:
     std::string         mPeerHost;
     unsigned int        mPeerPort;
     Mutex               mPeerDataMutex; // mutual exclusion of concurrent access to data about peer at remote side
+
+    /* fixed destination */
+    bool                mHasDestination;
+    bool                mDestinationConnected;
+    std::string         mDestinationHost;
+    unsigned int        mDestinationPort;
+    SocketAddressDescriptor mDestinationAddress;
+    unsigned int        mDestinationAddressSize;
+
+    /* segmentation offload */
+    int                 mSendOffloadSupported;
+    bool                mReceiveOffload;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,142 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: reactor which serves many sockets by a small number of I/O threads
+ * Since:   2026-10-17
+ */
+
+#ifndef _BASE_SOCKET_REACTOR_
+#define _BASE_SOCKET_REACTOR_
+
+#include <HBMutex.h>
+#include <HBSocket.h>
+#include <HBThread.h>
+
+#include <map>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of event dispatching
+//#define HB_DEBUG_SOCKET_REACTOR
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define SVC_SOCKET_REACTOR SocketReactor::GetInstance()
+
+// maximum number of I/O threads if the reactor is started on demand
+#define SOCKET_REACTOR_MAX_THREADS                  4
+
+// maximum number of events which are fetched by one system call
+#define SOCKET_REACTOR_MAX_EVENTS                   64
+
+// maximum time in ms an I/O thread waits for events before it checks for termination
+#define SOCKET_REACTOR_WAIT_TIME                    250
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SocketReactorHandler
+{
+public:
+    virtual ~SocketReactorHandler() { }
+
+    /* called by an I/O thread of the reactor if input is waiting at the socket, never concurrently for the same socket;
+       the handler mustn't block: it reads without waiting, e.g., via Socket::ReceiveBatch(.., false), until nothing is left;
+       returns false if the socket shouldn't be served anymore */
+    virtual bool HandleSocketInput(Socket *pSocket) = 0;
+};
+
+struct SocketReactorRegistration
+{
+    Socket                  *DataSocket;
+    SocketReactorHandler    *Handler;
+};
+
+typedef std::map<int /* socket handle */, SocketReactorRegistration> SocketReactorRegistrations;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* one I/O thread: waits for input at its own set of sockets and dispatches it to the registered handlers */
+class SocketReactorThread:
+    public Thread
+{
+public:
+    SocketReactorThread(int pIndex);
+
+    virtual ~SocketReactorThread();
+
+    bool Init();
+    bool AddSocket(Socket *pSocket, SocketReactorHandler *pHandler);
+    bool RemoveSocket(Socket *pSocket); // returns false if the socket isn't served by this thread
+    int GetSocketCount();
+    void Stop();
+
+private:
+    virtual void* Run(void* pArgs = NULL);
+
+    int                 mIndex;
+    int                 mEventHandle;
+    bool                mThreadNeeded;
+    SocketReactorRegistrations mRegistrations;
+    Mutex               mRegistrationsMutex; // held while events are dispatched
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SocketReactor
+{
+public:
+    SocketReactor();
+
+    virtual ~SocketReactor();
+
+    static SocketReactor& GetInstance();
+
+    /* the reactor is started on demand, only Linux (epoll) is supported */
+    bool Start(int pThreadCount = 0 /* 0 means one thread per machine core, limited to SOCKET_REACTOR_MAX_THREADS */);
+    void Stop();
+    bool IsRunning();
+    int GetThreadCount();
+
+    /* the socket is served by the I/O thread with the fewest sockets */
+    bool Register(Socket *pSocket, SocketReactorHandler *pHandler);
+    /* afterwards the handler isn't called anymore, mustn't be called within a handler */
+    void Unregister(Socket *pSocket);
+
+    /* network listeners use the reactor instead of own threads only if this is activated */
+    static void ActivateReactor(bool pActive = true);
+    static bool ReactorActivated();
+
+private:
+    SocketReactorThread **mThreads;
+    int                 mThreadCount;
+    bool                mRunning;
+    Mutex               mStartMutex;
+    static bool         sReactorActive;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
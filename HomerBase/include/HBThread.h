@@ -39,14 +39,36 @@ typedef void*(*THREAD_MAIN)(void*);
 #define OS_DEP_THREAD HANDLE
 #endif
 
+#include <HBCondition.h>
+#include <HBMutex.h>
+
+#include <stdint.h>
+#include <string>
 #include <vector>
 
 #define THREAD_DEFAULT_STACK_SIZE			(2 * 1024 * 1024)
 
+// priority for SCHED_FIFO/SCHED_RR, it is limited to the maximum of the OS
+#define THREAD_REALTIME_PRIORITY            10
+
+// nice levels of the scheduling classes in Linux
+#define THREAD_NICE_LEVEL_HIGH              -10
+#define THREAD_NICE_LEVEL_BACKGROUND        10
+
 namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+enum ThreadSchedulingClass
+{
+    THREAD_SCHEDULING_BACKGROUND = 0,   // e.g., bulk transfers
+    THREAD_SCHEDULING_NORMAL,           // default for every thread
+    THREAD_SCHEDULING_HIGH,             // e.g., encoders
+    THREAD_SCHEDULING_REALTIME          // e.g., audio capture and playback, falls back to THREAD_SCHEDULING_HIGH if the OS denies real-time scheduling
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class Thread
 {
 public:
@@ -64,14 +86,34 @@ public:
     bool StopThread(int pTimeoutInMSecs = 0, void** pResults = NULL); // return pointer to result of thread
     bool IsRunning();
     static void Suspend(unsigned int pUSecs);
+
+    /* event based synchronization, timeouts in ms, 0 means infinite waiting time, every function returns TRUE if the event occurred */
+    bool WaitForStart(int pTimeoutInMSecs = 0);
+    bool WaitForReady(int pTimeoutInMSecs = 0); // FALSE if the thread terminated without calling AnnounceReady()
+    bool WaitForTermination(int pTimeoutInMSecs = 0);
+    bool SuspendUntilWakeUp(int pTimeoutInMSecs = 0); // called from inside the thread, returns FALSE on timeout
+    void WakeUp();
+
     static int GetTId();
     static int GetPId();
     static int GetPPId();
     static std::vector<int> GetTIds();
+    /* scheduling of the calling thread */
+    static bool SetSchedulingClass(enum ThreadSchedulingClass pClass); // returns FALSE if the OS denied the class and a fallback is used
+    static bool SetCpuAffinity(uint64_t pCpuMask); // bit n selects cpu core n
+    static bool GetSchedulingStatistic(int pTid, enum ThreadSchedulingClass &pClass, enum ThreadSchedulingClass &pEffectiveClass, int64_t &pLatencyAvg, int64_t &pLatencyMax); // latency in us, returns FALSE if the thread hasn't declared a class
+    static void ResetSchedulingStatistic(int pTid);
+    static std::string SchedulingClass2String(enum ThreadSchedulingClass pClass);
     static bool GetThreadStatistic(int pTid, unsigned long &pMemVirtual, unsigned long &pMemPhysical, unsigned long &pMemAllocs, int &pPid, int &pPPid, float &pLoadUser, float &pLoadSystem, float &pLoadTotal, int &pPriority, int &pNice, int &pThreadCount, unsigned long long &pLastUserTicsThread, unsigned long long &pLastKernelTicsThread, unsigned long long &pLastSystemTime);
 
+protected:
+    void AnnounceReady(); // called from inside the thread after its initialization is finished
+
 private:
     void CloseThread();
+    void ResetStateSignaling();
+    bool WaitForStateChange(int64_t pStartTime, int pTimeoutInMSecs); // state mutex has to be locked by caller, pStartTime is given by the monotonic clock
+    static void AnnounceSchedulingLatency(int64_t pLatency);
 
     static void* StartThreadStaticWrapperUniversal(void* pThread);
     static void* StartThreadStaticWrapperRun(void* pThread);
@@ -81,6 +123,13 @@ private:
     OS_DEP_THREAD   mThreadHandle;
     bool            mRunning;
     int             mThreadId;
+    /* state signaling */
+    Mutex           mStateMutex;
+    Condition       mStateCondition;
+    bool            mStarted;
+    bool            mReady;
+    bool            mWakeUpPending;
+    int64_t         mWakeUpTime; // monotonic clock
 };
 
 ///////////////////////////////////////////////////////////////////////////////
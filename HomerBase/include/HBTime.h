@@ -41,6 +41,13 @@ namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// period after which the mapping from monotonic clock to wall clock is recalibrated
+#define TIME_WALL_CLOCK_CALIBRATION_PERIOD                  1000000 // in s
+// offset between NTP epoch (1900) and UNIX epoch (1970)
+#define TIME_NTP_OFFSET_US                                  (2208988800ULL * 1000000ULL)
+
+///////////////////////////////////////////////////////////////////////////////
+
 class Time
 {
 public:
@@ -53,11 +60,20 @@ public:
     int64_t UpdateTimeStamp(); // in s
     int64_t TimeDiffInUSecs(Time *pTime);
     static int64_t GetTimeStamp(); // in s
+    /* monotonic clock, not influenced by wall clock adjustments and cheap enough for per packet time stamps */
+    static int64_t GetMonotonicNanoTime(); // in ns
+    static int64_t GetMonotonicTimeStamp(); // in s
+    /* mapping from the monotonic clock to the wall clock, recalibrated periodically */
+    static int64_t ConvertMonotonicToWallClock(int64_t pMonotonicTimeStamp /* in s */); // in s since 1970
+    static uint64_t GetNtpTimeStamp(); // in s since 1900
     static bool GetNow(int *pDay = NULL, int *pMonth = NULL, int *pYear = NULL, int *pHour = NULL, int *pMin = NULL, int *pSec = NULL);
+    static bool GetLocalTime(int64_t pTimeStamp /* in s */, int *pDay = NULL, int *pMonth = NULL, int *pYear = NULL, int *pHour = NULL, int *pMin = NULL, int *pSec = NULL);
 
     Time& operator=(const Time &pTime);
 
 private:
+    static void CalibrateWallClock(int64_t pMonotonicTimeStamp);
+
     int64_t     mTimeStamp; // in s
 };
 
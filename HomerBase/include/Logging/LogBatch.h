@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: compact binary format for batches of log messages
+ * Since:   2026-10-17
+ */
+
+#ifndef _LOGGER_LOG_BATCH_
+#define _LOGGER_LOG_BATCH_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Format of a batch (all integers are unsigned LEB128 varints if not stated otherwise):
+ *
+ *      header:     'H' 'L' <version: 1 byte> <flags: 1 byte> <session id: 4 bytes, big endian> <sequence number> <base time stamp in us>
+ *      records:    LOG_BATCH_RECORD_SOURCE  <source id> <length> <source string>
+ *                  LOG_BATCH_RECORD_MESSAGE <level> <source id> <line> <time stamp delta in us, zigzag coded> <length> <message string>
+ *
+ * Source strings are interned per batch, so every batch can be decoded on its own even if previous batches were lost.
+ * The session id changes with every sender instance, the sequence number counts the batches of a session.
+ */
+#define LOG_BATCH_MAGIC                         "HL"
+#define LOG_BATCH_VERSION                       1
+#define LOG_BATCH_MAX_HEADER_SIZE               28
+
+enum LogBatchRecordType
+{
+    LOG_BATCH_RECORD_SOURCE = 1,
+    LOG_BATCH_RECORD_MESSAGE
+};
+
+struct LogBatchMessage
+{
+    int         Level;
+    int64_t     TimeStamp; // in us
+    std::string Source;
+    int         Line;
+    std::string Message;
+};
+
+typedef std::vector<LogBatchMessage> LogBatchMessages;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class LogBatchEncoder
+{
+public:
+    LogBatchEncoder(uint32_t pSessionId, int pMaxBatchSize);
+
+    virtual ~LogBatchEncoder();
+
+    /* returns FALSE if the message doesn't fit into the current batch, an oversized message is truncated if the batch is empty */
+    bool AddMessage(int pLevel, int64_t pTimeStamp, const std::string &pSource, int pLine, const std::string &pMessage);
+    bool IsEmpty();
+    /* finishes the current batch and starts the next one */
+    std::string GetBatch();
+
+private:
+    uint32_t    mSessionId;
+    uint64_t    mSequenceNumber;
+    int         mMaxBatchSize;
+    std::string mRecords;
+    int64_t     mBaseTimeStamp;
+    int64_t     mLastTimeStamp;
+    std::map<std::string, int> mSourceIds;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class LogBatchDecoder
+{
+public:
+    /* returns FALSE if the batch is malformed, all messages before the malformed part are returned anyway */
+    static bool Decode(const char *pData, int pSize, uint32_t &pSessionId, uint64_t &pSequenceNumber, LogBatchMessages &pMessages);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
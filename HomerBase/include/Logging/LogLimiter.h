@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: rate limitation and sampling of log messages per call site
+ * Since:   2026-10-17
+ */
+
+#ifndef _LOGGER_LOG_LIMITER_
+#define _LOGGER_LOG_LIMITER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// token bucket which allows a burst of pMaxPerSecond messages and refills at the same rate
+class LogRateLimiter
+{
+public:
+    LogRateLimiter(int pMaxPerSecond);
+
+    virtual ~LogRateLimiter();
+
+    /* returns TRUE if the message may be logged, pSuppressed gets the amount of suppressed messages since the last allowed one, lock-free */
+    bool Allow(int64_t &pSuppressed);
+
+private:
+    int                 mMaxPerSecond;
+    volatile int64_t    mTokens; // in millionths of a token
+    volatile int64_t    mLastRefillTime; // in us, monotonic clock
+    volatile int64_t    mSuppressed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// allows every pInterval-th message, starting with the first one
+class LogSampler
+{
+public:
+    LogSampler(int pInterval);
+
+    virtual ~LogSampler();
+
+    /* returns TRUE if the message may be logged, pSuppressed gets the amount of suppressed messages since the last allowed one, lock-free */
+    bool Allow(int64_t &pSuppressed);
+
+private:
+    int                 mInterval;
+    volatile int64_t    mCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
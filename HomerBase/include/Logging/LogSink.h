@@ -33,6 +33,11 @@ namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// log level of a sink which gets the same messages as the console, see Logger::SetLogLevel()
+#define LOG_SINK_LEVEL_OF_LOGGER            -1
+
+///////////////////////////////////////////////////////////////////////////////
+
 class LogSink
 {
 public:
@@ -44,10 +49,20 @@ public:
 
     virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage) = 0;
 
+    /* batched output: if buffering is active, a sink may delay its output until Flush() is called */
+    void SetBuffering(bool pActive);
+    virtual void Flush();
+
     std::string GetId() { return mLogSinkId; }
+    /* messages above this level aren't delivered, the level has to be set before the sink is registered */
+    void SetLogLevel(int pLevel) { mLogLevel = pLevel; }
+    int GetLogLevel() { return mLogLevel; }
 
 protected:
     std::string         mLogSinkId;
+    bool                mBuffering;
+    int                 mLogLevel; // all messages by default
+
 };
 
 ///////////////////////////////////////////////////////////////////////////////
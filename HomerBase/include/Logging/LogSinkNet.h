@@ -29,29 +29,47 @@
 
 #include <string>
 #include <LogSink.h>
+#include <LogBatch.h>
 #include <HBSocket.h>
 
 namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// maximum size of one UDP datagram if several messages are batched, fits into the usual path MTU
+#define LOG_SINK_NET_MAX_DATAGRAM_SIZE                  1400
+
+enum LogSinkNetFormat
+{
+    LOG_SINK_NET_BINARY = 0,    // batches of binary records, see LogBatch.h
+    LOG_SINK_NET_TEXT           // "LEVEL=..\nTIME=..\n.." text records
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class LogSinkNet:
     public LogSink
 {
 public:
 
-    LogSinkNet(std::string pTargetHost, unsigned short pTargetPort);
+    LogSinkNet(std::string pTargetHost, unsigned short pTargetPort, enum LogSinkNetFormat pFormat = LOG_SINK_NET_BINARY);
 
     /// The destructor
     virtual ~LogSinkNet();
 
     virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
+    virtual void Flush();
 
 private:
+    void SendData(std::string pData);
+
     std::string         mTargetHost;
     unsigned short      mTargetPort;
     Socket 				*mDataSocket;
     bool                mBrokenPipe;
+    std::string         mPendingData;
+    enum LogSinkNetFormat mFormat;
+    LogBatchEncoder     *mBatchEncoder;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
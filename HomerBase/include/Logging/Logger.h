@@ -29,10 +29,13 @@
 
 #include <LogSinkConsole.h>
 #include <LogSink.h>
+#include <LogLimiter.h>
 #include <string>
 #include <list>
 #include <sys/types.h>
 #include <sstream>
+#include <stdarg.h>
+#include <stdint.h>
 #include <HBReflection.h>
 #include <HBMutex.h>
 
@@ -91,6 +94,27 @@ typedef std::list<LogSink*>        LogSinksList;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// amount of records within the queue of the asynchronous mode, has to be a power of 2
+#define         LOGGER_ASYNC_RECORDS            2048
+// maximum sizes of source and message of a queued record, longer strings are truncated
+#define         LOGGER_ASYNC_SOURCE_SIZE        128
+#define         LOGGER_ASYNC_MESSAGE_SIZE       1024
+// maximum time in ms until a queued record reaches the log sinks
+#define         LOGGER_ASYNC_FLUSH_PERIOD       100
+
+struct LogRecord{
+    volatile int64_t Sequence; // state of the queue entry, see Logger::QueueMessage()
+    int         Level;
+    int         Line;
+    int64_t     TimeStamp; // in us
+    char        Source[LOGGER_ASYNC_SOURCE_SIZE];
+    char        Message[LOGGER_ASYNC_MESSAGE_SIZE];
+};
+
+class Thread;
+
+///////////////////////////////////////////////////////////////////////////////
+
 #define         LOG_OFF                         0
 #define         LOG_ERROR                       1
 #define         LOG_WARN                        2
@@ -99,12 +123,40 @@ typedef std::list<LogSink*>        LogSinksList;
 #define         LOG_WORLD                       5
 
 #define         LOGGER                          Logger::GetInstance()
+// hint: the macros check the log level before any argument is evaluated, hence a suppressed message costs only one comparison;
+//       they are statements and can't be used within expressions
 // standard logging macro
-#define         LOG(Level, ...)                 LOGGER.AddMessage(Level, GetObjectNameStr(this).c_str(), __LINE__, __VA_ARGS__)
+#define         LOG(Level, ...)                 do{ if (LOGGER.IsLevelActive(Level)) LOGGER.AddMessage(Level, GetObjectNameCached(this).c_str(), __LINE__, __VA_ARGS__); }while(0)
 // remote logging with given source file and line number
-#define         LOG_REMOTE(Level, Source, Line, ...)   LOGGER.AddMessage(Level, Source.c_str(), Line, __VA_ARGS__)
-// static logging
-#define         LOGEX(FromWhere, Level, ...)    LOGGER.AddMessage(Level, ("static:" + GetObjectNameStr(FromWhere) + ":" + GetShortFileName(__FILE__)).c_str(), __LINE__, __VA_ARGS__)
+#define         LOG_REMOTE(Level, Source, Line, ...)   do{ if (LOGGER.IsLevelActive(Level)) LOGGER.AddMessage(Level, Source.c_str(), Line, __VA_ARGS__); }while(0)
+// static logging: FromWhere has to be a type, e.g., the class name, its name is determined only once per type
+#define         LOGEX(FromWhere, Level, ...)    do{ if (LOGGER.IsLevelActive(Level)) LOGGER.AddMessage(Level, ("static:" + GetObjectNameCached<FromWhere>() + ":" + GetShortFileName(__FILE__)).c_str(), __LINE__, __VA_ARGS__); }while(0)
+
+// rate limited logging per call site: a burst of MaxPerSecond messages, afterwards at most MaxPerSecond messages per second
+#define         LOG_RATE_LIMITED(Level, MaxPerSecond, ...)                  LOG_LIMITED(LogRateLimiter, MaxPerSecond, Level, LOG(Level, __VA_ARGS__), LOG(Level, LOG_SUPPRESSED_FORMAT, tLogSuppressed))
+#define         LOGEX_RATE_LIMITED(FromWhere, Level, MaxPerSecond, ...)     LOG_LIMITED(LogRateLimiter, MaxPerSecond, Level, LOGEX(FromWhere, Level, __VA_ARGS__), LOGEX(FromWhere, Level, LOG_SUPPRESSED_FORMAT, tLogSuppressed))
+// sampled logging per call site: only every Interval-th message is logged
+#define         LOG_SAMPLED(Level, Interval, ...)                           LOG_LIMITED(LogSampler, Interval, Level, LOG(Level, __VA_ARGS__), LOG(Level, LOG_SUPPRESSED_FORMAT, tLogSuppressed))
+#define         LOGEX_SAMPLED(FromWhere, Level, Interval, ...)              LOG_LIMITED(LogSampler, Interval, Level, LOGEX(FromWhere, Level, __VA_ARGS__), LOGEX(FromWhere, Level, LOG_SUPPRESSED_FORMAT, tLogSuppressed))
+// default limit for warnings and errors on per packet paths
+#define         LOG_PER_PACKET_RATE_LIMIT       2
+
+// helpers for the limited logging: the limiter is a static object of the call site, the summary of suppressed messages follows the next logged one
+#define         LOG_SUPPRESSED_FORMAT           "        SUPPRESSED %"PRId64" SIMILAR MESSAGE(S) BEFORE"
+#define         LOG_LIMITED(Limiter, LimiterParameter, Level, Output, Summary) \
+                                                do{ \
+                                                    if (LOGGER.IsLevelActive(Level)) \
+                                                    { \
+                                                        static Limiter sLogLimiter(LimiterParameter); \
+                                                        int64_t tLogSuppressed = 0; \
+                                                        if (sLogLimiter.Allow(tLogSuppressed)) \
+                                                        { \
+                                                            Output; \
+                                                            if (tLogSuppressed > 0) \
+                                                                Summary; \
+                                                        } \
+                                                    } \
+                                                }while(0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -125,23 +177,55 @@ public:
     void AddMessage(int pLevel, const char *pSource, int pLine, const char* pFormat, ...);
     void SetLogLevel(int pLevel);
     int GetLogLevel();
+    /* fast check if a message of the given level would reach the console or a registered log sink */
+    inline bool IsLevelActive(int pLevel)
+    {
+        return (pLevel <= mActiveLogLevel);
+    }
 
     void RegisterLogSink(LogSink *pLogSink);
     void UnregisterLogSink(LogSink *pLogSink);
 
+    /* asynchronous mode: the calling thread only queues the formatted message, a background thread writes it to the log sinks in batches */
+    bool ActivateAsyncMode();
+    void DeactivateAsyncMode(); // writes all queued messages before it returns
+    bool IsAsyncModeActive();
+    int64_t GetDroppedMessages(); // messages which were dropped because the queue was full
+    /* crash handling: writes the queued messages, which haven't reached the log sinks yet, with write() to an already opened file descriptor;
+       it neither locks nor allocates, hence it can be used within a signal handler */
+    void WriteQueuedMessagesAfterCrash(int pFd);
+
 private:
+    friend class LoggerThread;
+
+    void QueueMessage(int pLevel, const char *pSource, int pLine, const char *pFormat, va_list pVArgs);
+    void ProcessQueuedMessages();
+    void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
     void RelayMessageToLogSinks(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
+    void SetLogSinksBuffering(bool pActive);
+    void UpdateActiveLogLevel(); // log sinks mutex has to be held by the caller
+    static std::string GetTimeString(int64_t pTimeStamp);
 
     Mutex       mLoggerMutex, mLogSinksMutex;
     LogSinksList mLogSinks;
     int         mRegisteredSinks;
     int         mLogLevel;
+    volatile int mActiveLogLevel; // highest level of console and all log sinks
     int         mLastMessageLogLevel;
     std::string mLastMessage;
     std::string	mLastSource;
     int         mLastLine;
     int         mRepetitionCount;
     LogSinkConsole *mLogSinkConsole;
+    /* asynchronous mode */
+    volatile bool   mAsyncMode;
+    Mutex           mAsyncModeMutex, mAsyncReadMutex;
+    Thread          *mAsyncThread;
+    LogRecord       *mAsyncRecords;
+    volatile int64_t mAsyncWritePos;
+    volatile int64_t mAsyncReadPos;
+    volatile int64_t mAsyncDroppedMessages;
+    int64_t         mAsyncReportedDroppedMessages;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
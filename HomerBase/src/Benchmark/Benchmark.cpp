@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: micro benchmarks for HomerBase
+ * Since:   2026-10-17
+ */
+
+#include <Benchmark.h>
+#include <Logger.h>
+#include <HBTime.h>
+
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Homer::Base;
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PrintBenchmarkResult(string pName, int64_t pIterations, int64_t pDuration)
+{
+    printf("   %-60s %10.1f ns\n", pName.c_str(), (pIterations > 0) ? (double)pDuration / pIterations : 0.0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct BenchmarkDescriptor
+{
+    const char  *Name;
+    void        (*Function)(int pIterations);
+};
+
+static BenchmarkDescriptor sBenchmarks[] = {
+    { "Logging", BenchmarkLogging },
+    { "Time", BenchmarkTime },
+    { "Socket", BenchmarkSocket },
+    { NULL, NULL }
+};
+
+static void ShowUsage()
+{
+    printf("Usage:\n");
+    printf("   HomerBaseBenchmark [-Iterations=<count>] [<benchmark> ...]   run the given benchmarks, all of them by default\n");
+    printf("Benchmarks:\n");
+    for (int i = 0; sBenchmarks[i].Name != NULL; i++)
+        printf("   %s\n", sBenchmarks[i].Name);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int pArgc, char* pArgv[])
+{
+    int tIterations = BENCHMARK_DEFAULT_ITERATIONS;
+    bool tSelected[sizeof(sBenchmarks) / sizeof(sBenchmarks[0])] = { false };
+    bool tSelectedAny = false;
+
+    for (int i = 1; i < pArgc; i++)
+    {
+        string tArg = pArgv[i];
+        bool tFound = false;
+        if (tArg.find("-Iterations=") == 0)
+        {
+            tIterations = atoi(tArg.substr(12).c_str());
+            if (tIterations > 0)
+                continue;
+        }
+        for (int j = 0; sBenchmarks[j].Name != NULL; j++)
+        {
+            if (tArg == sBenchmarks[j].Name)
+            {
+                tSelected[j] = true;
+                tSelectedAny = true;
+                tFound = true;
+            }
+        }
+        if (!tFound)
+        {
+            ShowUsage();
+            return 1;
+        }
+    }
+
+    for (int i = 0; sBenchmarks[i].Name != NULL; i++)
+    {
+        if ((tSelectedAny) && (!tSelected[i]))
+            continue;
+        printf("%s (%d iterations):\n", sBenchmarks[i].Name, tIterations);
+        sBenchmarks[i].Function(tIterations);
+    }
+
+    return 0;
+}
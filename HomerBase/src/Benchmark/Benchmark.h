@@ -0,0 +1,54 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: common functions of the micro benchmarks for HomerBase
+ * Since:   2026-10-17
+ */
+
+#ifndef _BASE_BENCHMARK_
+#define _BASE_BENCHMARK_
+
+#include <string>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// default amount of iterations of a measurement
+#define BENCHMARK_DEFAULT_ITERATIONS            1000000
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* prints the average duration of one iteration, pDuration in ns */
+void PrintBenchmarkResult(std::string pName, int64_t pIterations, int64_t pDuration);
+
+/* the benchmarks */
+void BenchmarkLogging(int pIterations);
+void BenchmarkTime(int pIterations);
+void BenchmarkSocket(int pIterations);
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: micro benchmark for the logging macros
+ * Since:   2026-10-17
+ */
+
+#include <Benchmark.h>
+#include <Logger.h>
+#include <LogSink.h>
+#include <HBTime.h>
+
+#include <string>
+
+using namespace std;
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// a log sink like the error view of the GUI: it follows the log level of the console
+class BenchmarkLogSink:
+    public LogSink
+{
+public:
+    BenchmarkLogSink(int pLogLevel)
+    {
+        mLogSinkId = "benchmark";
+        mLogLevel = pLogLevel;
+        mMessages = 0;
+    }
+
+    virtual ~BenchmarkLogSink()
+    {
+    }
+
+    virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage)
+    {
+        mMessages++;
+    }
+
+    int64_t             mMessages;
+};
+
+class LoggingBenchmark
+{
+public:
+    LoggingBenchmark()
+    {
+        mCounter = 0;
+    }
+
+    /* typical per packet debug output with an argument which is expensive to evaluate */
+    void LogPerPacket(int pIterations)
+    {
+        for (int i = 0; i < pIterations; i++)
+            LOG(LOG_VERBOSE, "Processing packet %d of stream %s", i, GetStreamName().c_str());
+    }
+
+    /* the same without level check in front of the argument evaluation, like the macro before */
+    void LogPerPacketUnchecked(int pIterations)
+    {
+        for (int i = 0; i < pIterations; i++)
+            LOGGER.AddMessage(LOG_VERBOSE, GetObjectNameStr(this).c_str(), __LINE__, "Processing packet %d of stream %s", i, GetStreamName().c_str());
+    }
+
+    void LogRateLimited(int pIterations)
+    {
+        for (int i = 0; i < pIterations; i++)
+            LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "Packet %d of stream %s is late", i, GetStreamName().c_str());
+    }
+
+private:
+    string GetStreamName()
+    {
+        mCounter++;
+        return "VIDEO-STREAM-" + toString(mCounter % 16);
+    }
+
+    int                 mCounter;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void Measure(string pName, LoggingBenchmark &pBenchmark, void (LoggingBenchmark::*pFunction)(int), int pIterations)
+{
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    (pBenchmark.*pFunction)(pIterations);
+    PrintBenchmarkResult(pName, pIterations, Time::GetMonotonicNanoTime() - tStart);
+}
+
+void BenchmarkLogging(int pIterations)
+{
+    LoggingBenchmark tBenchmark;
+    BenchmarkLogSink tSink(LOG_SINK_LEVEL_OF_LOGGER);
+    int tUncheckedIterations = pIterations / 10 + 1;
+
+    LOGGER.Init(LOG_ERROR);
+    LOGGER.RegisterLogSink(&tSink);
+
+    Measure("disabled message, level checked by macro", tBenchmark, &LoggingBenchmark::LogPerPacket, pIterations);
+    Measure("disabled message, level checked by logger (previous macro)", tBenchmark, &LoggingBenchmark::LogPerPacketUnchecked, tUncheckedIterations);
+    Measure("rate limited warning, log level error", tBenchmark, &LoggingBenchmark::LogRateLimited, pIterations);
+
+    LOGGER.UnregisterLogSink(&tSink);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: micro benchmark for single and batched datagram transmissions over loopback
+ * Since:   2026-10-17
+ */
+
+#include <Benchmark.h>
+#include <HBSocket.h>
+#include <HBTime.h>
+#include <Logger.h>
+
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+using namespace std;
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// size of one datagram, like a RTP packet of a video stream
+#define BENCHMARK_SOCKET_DATAGRAM_SIZE              1200
+// datagrams per batch, like a burst of fragments from the sink FIFO
+#define BENCHMARK_SOCKET_BATCH_SIZE                 32
+// datagrams which are sent before the receiver drains its socket buffer, they have to fit into the socket buffer
+#define BENCHMARK_SOCKET_RECEIVE_ROUND              (8 * BENCHMARK_SOCKET_BATCH_SIZE)
+#define BENCHMARK_SOCKET_RECEIVE_BUFFER_SIZE        (4 * 1024 * 1024)
+// port range of the receiver
+#define BENCHMARK_SOCKET_PORT                       5400
+#define BENCHMARK_SOCKET_PORT_MAX                   5499
+
+///////////////////////////////////////////////////////////////////////////////
+
+static char sDatagrams[BENCHMARK_SOCKET_BATCH_SIZE][BENCHMARK_SOCKET_DATAGRAM_SIZE];
+
+static void PrintPacketRate(string pName, int64_t pPackets, int64_t pDuration)
+{
+    printf("   %-60s %10.0f packets/s\n", pName.c_str(), (pDuration > 0) ? (double)pPackets * 1000 * 1000 * 1000 / pDuration : 0.0);
+}
+
+static void InitDatagrams(SocketDatagram *pDatagrams)
+{
+    for (int i = 0; i < BENCHMARK_SOCKET_BATCH_SIZE; i++)
+    {
+        memset(&pDatagrams[i], 0, sizeof(SocketDatagram));
+        pDatagrams[i].Data = sDatagrams[i];
+        pDatagrams[i].Size = BENCHMARK_SOCKET_DATAGRAM_SIZE;
+    }
+}
+
+static void MeasureSending(Socket *pSender, int pPackets)
+{
+    SocketDatagram tDatagrams[BENCHMARK_SOCKET_BATCH_SIZE];
+    int tBatches = pPackets / BENCHMARK_SOCKET_BATCH_SIZE;
+
+    InitDatagrams(tDatagrams);
+
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pPackets; i++)
+        pSender->Send(sDatagrams[0], BENCHMARK_SOCKET_DATAGRAM_SIZE);
+    PrintPacketRate("send: one datagram per call", pPackets, Time::GetMonotonicNanoTime() - tStart);
+
+    tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < tBatches; i++)
+        pSender->SendBatch(tDatagrams, BENCHMARK_SOCKET_BATCH_SIZE);
+    PrintPacketRate("send: batches of " + toString(BENCHMARK_SOCKET_BATCH_SIZE) + " datagrams", tBatches * BENCHMARK_SOCKET_BATCH_SIZE, Time::GetMonotonicNanoTime() - tStart);
+}
+
+static void MeasureReceiving(Socket *pSender, Socket *pReceiver, int pPackets, bool pBatched)
+{
+    SocketDatagram tDatagrams[BENCHMARK_SOCKET_BATCH_SIZE];
+    char tBuffer[BENCHMARK_SOCKET_DATAGRAM_SIZE];
+    string tSourceHost;
+    unsigned int tSourcePort;
+    int64_t tDuration = 0;
+    int64_t tReceived = 0;
+    int tRounds = pPackets / BENCHMARK_SOCKET_RECEIVE_ROUND;
+
+    for (int i = 0; i < tRounds; i++)
+    {
+        InitDatagrams(tDatagrams);
+        for (int j = 0; j < BENCHMARK_SOCKET_RECEIVE_ROUND / BENCHMARK_SOCKET_BATCH_SIZE; j++)
+            pSender->SendBatch(tDatagrams, BENCHMARK_SOCKET_BATCH_SIZE);
+
+        // drain the socket buffer
+        int tRoundReceived = 0;
+        int64_t tStart = Time::GetMonotonicNanoTime();
+        while (tRoundReceived < BENCHMARK_SOCKET_RECEIVE_ROUND)
+        {
+            if (pBatched)
+            {
+                InitDatagrams(tDatagrams);
+                int tCount = pReceiver->ReceiveBatch(tDatagrams, BENCHMARK_SOCKET_BATCH_SIZE, false);
+                if (tCount <= 0)
+                    break;
+                tRoundReceived += tCount;
+            }else
+            {
+                ssize_t tBufferSize = BENCHMARK_SOCKET_DATAGRAM_SIZE;
+                if (!pReceiver->Receive(tSourceHost, tSourcePort, tBuffer, tBufferSize))
+                    break;
+                tRoundReceived++;
+            }
+        }
+        tDuration += Time::GetMonotonicNanoTime() - tStart;
+        tReceived += tRoundReceived;
+
+        // lost datagrams would block the receiver
+        if (tRoundReceived < BENCHMARK_SOCKET_RECEIVE_ROUND)
+        {
+            printf("   only %d of %d datagrams were received, aborting\n", tRoundReceived, BENCHMARK_SOCKET_RECEIVE_ROUND);
+            break;
+        }
+    }
+    PrintPacketRate(pBatched ? "receive: batches of up to " + toString(BENCHMARK_SOCKET_BATCH_SIZE) + " datagrams" : "receive: one datagram per call", tReceived, tDuration);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkSocket(int pIterations)
+{
+    Socket *tReceiver = Socket::CreateServerSocket(SOCKET_IPv4, SOCKET_UDP, BENCHMARK_SOCKET_PORT, false, 1, BENCHMARK_SOCKET_PORT_MAX);
+    Socket *tSender = Socket::CreateClientSocket(SOCKET_IPv4, SOCKET_UDP);
+    // a million datagrams per second are far more than a conference needs
+    int tPackets = pIterations / 4;
+
+    if ((tReceiver == NULL) || (tSender == NULL) || (!tSender->SetDestination("127.0.0.1", tReceiver->GetLocalPort())))
+    {
+        printf("   failed to create the sockets\n");
+        delete tReceiver;
+        delete tSender;
+        return;
+    }
+    tReceiver->SetReceiveBufferSize(BENCHMARK_SOCKET_RECEIVE_BUFFER_SIZE);
+
+    MeasureSending(tSender, tPackets);
+
+    // drop the datagrams of the sending benchmark
+    SocketDatagram tDatagrams[BENCHMARK_SOCKET_BATCH_SIZE];
+    do{
+        InitDatagrams(tDatagrams);
+    }while (tReceiver->ReceiveBatch(tDatagrams, BENCHMARK_SOCKET_BATCH_SIZE, false) > 0);
+
+    MeasureReceiving(tSender, tReceiver, tPackets, false);
+    MeasureReceiving(tSender, tReceiver, tPackets, true);
+
+    delete tSender;
+    delete tReceiver;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: micro benchmark for the time stamp sources
+ * Since:   2026-10-17
+ */
+
+#include <Benchmark.h>
+#include <HBTime.h>
+#include <Logger.h>
+
+#include <string>
+#include <stdio.h>
+
+using namespace std;
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the results are summed up, otherwise the compiler could drop the calls
+static volatile int64_t sTimeSink = 0;
+
+static void MeasureWallClock(int pIterations)
+{
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+        sTimeSink += Time::GetTimeStamp();
+    PrintBenchmarkResult("wall clock: GetTimeStamp()", pIterations, Time::GetMonotonicNanoTime() - tStart);
+}
+
+static void MeasureMonotonicClock(int pIterations)
+{
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+        sTimeSink += Time::GetMonotonicNanoTime();
+    PrintBenchmarkResult("monotonic clock: GetMonotonicNanoTime()", pIterations, Time::GetMonotonicNanoTime() - tStart);
+
+    tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+        sTimeSink += Time::GetMonotonicTimeStamp();
+    PrintBenchmarkResult("monotonic clock: GetMonotonicTimeStamp()", pIterations, Time::GetMonotonicNanoTime() - tStart);
+}
+
+static void MeasureNtpClock(int pIterations)
+{
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+        sTimeSink += (int64_t)Time::GetNtpTimeStamp();
+    PrintBenchmarkResult("NTP time: GetNtpTimeStamp()", pIterations, Time::GetMonotonicNanoTime() - tStart);
+}
+
+/* the time stamps of one announced packet before the monotonic clock: a Time object and a further wall clock time stamp */
+static void MeasurePacketStatisticPattern(int pIterations)
+{
+    int64_t tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+    {
+        Time tTime;
+        tTime.UpdateTimeStamp();
+        sTimeSink += tTime.TimeDiffInUSecs(&tTime);
+        sTimeSink += Time::GetTimeStamp();
+    }
+    PrintBenchmarkResult("previous time stamps per announced packet", pIterations, Time::GetMonotonicNanoTime() - tStart);
+
+    tStart = Time::GetMonotonicNanoTime();
+    for (int i = 0; i < pIterations; i++)
+        sTimeSink += Time::GetMonotonicTimeStamp();
+    PrintBenchmarkResult("current time stamp per announced packet", pIterations, Time::GetMonotonicNanoTime() - tStart);
+}
+
+/* the NTP time is derived from the monotonic clock, it has to follow the wall clock */
+static void MeasureNtpMappingError()
+{
+    int64_t tMaxError = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        int64_t tError = (int64_t)(Time::GetNtpTimeStamp() - TIME_NTP_OFFSET_US) - Time::GetTimeStamp();
+        if (tError < 0)
+            tError = -tError;
+        if (tError > tMaxError)
+            tMaxError = tError;
+    }
+    printf("   %-60s %10" PRId64 " us\n", "max. difference between NTP time and wall clock", tMaxError);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkTime(int pIterations)
+{
+    MeasureWallClock(pIterations);
+    MeasureMonotonicClock(pIterations);
+    MeasureNtpClock(pIterations);
+    MeasurePacketStatisticPattern(pIterations);
+    MeasureNtpMappingError();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -28,11 +28,7 @@
 #include <HBCondition.h>
 #include <HBThread.h>
 
-#ifdef APPLE
-// to get current time stamp
-#include <mach/clock.h>
-#include <mach/mach.h>
-#endif
+#include <time.h>
 
 namespace Homer { namespace Base {
 
@@ -43,7 +39,15 @@ using namespace std;
 Condition::Condition()
 {
 	bool tResult = false;
-    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+    #if defined(LINUX) || defined(BSD)
+        // timed waits are based on the monotonic clock, hence they don't depend on changes of the system time
+        pthread_condattr_t tAttributes;
+        pthread_condattr_init(&tAttributes);
+        pthread_condattr_setclock(&tAttributes, CLOCK_MONOTONIC);
+		tResult = (pthread_cond_init(&mCondition, &tAttributes) == 0);
+        pthread_condattr_destroy(&tAttributes);
+	#endif
+    #if defined(APPLE)
 		tResult = (pthread_cond_init(&mCondition, NULL) == 0);
 	#endif
 	#if defined(WINDOWS)
@@ -69,6 +73,35 @@ Condition::~Condition()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+static int TimedWait(pthread_cond_t *pCondition, pthread_mutex_t *pMutex, int pMSecs)
+{
+    struct timespec tTimeout;
+
+    #if defined(APPLE)
+        // relative timeout: independent from changes of the system time
+        tTimeout.tv_sec = pMSecs / 1000;
+        tTimeout.tv_nsec = (pMSecs % 1000) * 1000 * 1000;
+        return pthread_cond_timedwait_relative_np(pCondition, pMutex, &tTimeout);
+    #else
+        // absolute timeout based on the monotonic clock, the condition was initialized for this clock
+        if (clock_gettime(CLOCK_MONOTONIC, &tTimeout) == -1)
+            LOGEX(Condition, LOG_ERROR, "Failed to get time from clock");
+        tTimeout.tv_sec += pMSecs / 1000;
+        tTimeout.tv_nsec += (pMSecs % 1000) * 1000 * 1000;
+        if (tTimeout.tv_nsec >= 1000 * 1000 * 1000)
+        {
+            tTimeout.tv_sec++;
+            tTimeout.tv_nsec -= 1000 * 1000 * 1000;
+        }
+        #ifdef HBC_DEBUG_TIMED
+            LOGEX(Condition, LOG_VERBOSE, "Waiting until monotonic time %ld.%09ld", (long)tTimeout.tv_sec, (long)tTimeout.tv_nsec);
+        #endif
+        return pthread_cond_timedwait(pCondition, pMutex, &tTimeout);
+    #endif
+}
+#endif
+
 bool Condition::Wait(Mutex *pMutex, int pMSecs)
 {
     if (!Reset())
@@ -78,57 +111,25 @@ bool Condition::Wait(Mutex *pMutex, int pMSecs)
     }
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
-        struct timespec tTimeout;
-        struct timespec tTimeout1;
-
-        #if defined(LINUX) || defined(BSD)
-            if (clock_gettime(CLOCK_REALTIME, &tTimeout) == -1)
-                LOG(LOG_ERROR, "Failed to get time from clock");
-        #endif
-        #if defined(APPLE)
-            // apple specific implementation for clock_gettime()
-            clock_serv_t tCalenderClock;
-            mach_timespec_t tMachTimeSpec;
-            host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &tCalenderClock);
-            clock_get_time(tCalenderClock, &tMachTimeSpec);
-            mach_port_deallocate(mach_task_self(), tCalenderClock);
-            tTimeout.tv_sec = tMachTimeSpec.tv_sec;
-            tTimeout.tv_nsec = tMachTimeSpec.tv_nsec;
-        #endif
-        int tTime = pMSecs;
-
-        // add complete seconds if pMSecs is bigger than 1 sec
-        if (tTime >= 1000)
-        {
-            tTimeout.tv_sec += tTime / 1000;
-            tTime %= 1000;
-        }
-        tTimeout.tv_nsec += tTime * 1000 * 1000;
-        if (tTimeout.tv_nsec > (int64_t) 1000 * 1000 * 1000)
-        {
-            int64_t tAddSecs = tTimeout.tv_nsec / 1000 / 1000 / 1000;
-            int64_t tNanoDiff = tAddSecs * 1000 * 1000 * 1000;
-            int64_t tNanoSecs = tTimeout.tv_nsec - tNanoDiff;
-            tTimeout.tv_nsec = tNanoSecs;
-            tTimeout.tv_sec += tAddSecs;
-            #ifdef HBC_DEBUG_TIMED
-                LOG(LOG_WARN, "Condition ns part of timeout exceeds by %"PRId64" seconds", tAddSecs);
-            #endif
-        }
-
         if (pMutex)
+        {
+            bool tResult;
+            // the mutex is released while waiting, this time doesn't count as hold time
+            pMutex->ProfileHoldEnd();
             if (pMSecs > 0)
-                return !pthread_cond_timedwait(&mCondition, &pMutex->mMutex, &tTimeout);
+                tResult = !TimedWait(&mCondition, &pMutex->mMutex, pMSecs);
             else
-                return !pthread_cond_wait(&mCondition, &pMutex->mMutex);
-        else
+                tResult = !pthread_cond_wait(&mCondition, &pMutex->mMutex);
+            pMutex->ProfileHoldStart();
+            return tResult;
+        }else
         {
         	bool tResult = false;
             pthread_mutex_t tMutex = PTHREAD_MUTEX_INITIALIZER;
             pthread_mutex_lock(&tMutex);
             if (pMSecs > 0)
             {
-                int tRes = pthread_cond_timedwait(&mCondition, &tMutex, &tTimeout);
+                int tRes = TimedWait(&mCondition, &tMutex, pMSecs);
 				switch(tRes)
 				{
 					case EDEADLK:
@@ -137,7 +138,6 @@ bool Condition::Wait(Mutex *pMutex, int pMSecs)
 					case EBUSY: // Condition can't be obtained because it is busy
 						break;
 					case EINVAL:
-			            LOG(LOG_WARN, "Timeout time: %"PRId64" / %"PRId64"", tTimeout.tv_sec, tTimeout.tv_nsec);
 						LOG(LOG_ERROR, "Specified time of %d was invalid", pMSecs);
 						break;
 					case EFAULT:
@@ -219,7 +219,8 @@ bool Condition::Signal()
 bool Condition::Reset()
 {
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
-        return (pthread_cond_init(&mCondition, NULL) == 0);
+        // a pthread condition doesn't store signals, re-initializing it while other threads are waiting would be undefined
+        return true;
 	#endif
 	#if defined(WINDOWS)
 		return (ResetEvent(mCondition) != 0);
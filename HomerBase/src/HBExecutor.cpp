@@ -0,0 +1,672 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a work-stealing executor
+ * Since:   2026-10-17
+ */
+
+#include <HBExecutor.h>
+#include <HBSystem.h>
+#include <HBTime.h>
+#include <Logger.h>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+Executor sExecutor;
+
+bool Executor::sPipelineTasksActive = false;
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum TaskState
+{
+    TASK_IDLE = 0,
+    TASK_QUEUED,
+    TASK_RUNNING,
+    TASK_RUNNING_RESCHEDULED // has to be executed once more after the current execution
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+Task::Task(string pName, bool pAutoDelete)
+{
+    mTaskName = pName;
+    mAutoDelete = pAutoDelete;
+    mContinuation = NULL;
+    mTaskState = TASK_IDLE;
+    mScheduleTime = 0;
+    mExecutions = 0;
+    mQueueingDelaySum = 0;
+    mQueueingDelayMax = 0;
+
+    // one-shot tasks are too short-living for the statistics
+    if (!mAutoDelete)
+        SVC_EXECUTOR.RegisterTask(this);
+}
+
+Task::~Task()
+{
+    if (IsTaskScheduled())
+    {
+        LOG(LOG_WARN, "Task %s is destroyed while it is still scheduled, unscheduling it", mTaskName.c_str());
+        UnscheduleTask();
+    }
+
+    if (!mAutoDelete)
+        SVC_EXECUTOR.UnregisterTask(this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Task::SetContinuation(Task *pTask)
+{
+    mContinuation = pTask;
+}
+
+Task* Task::GetContinuation()
+{
+    return mContinuation;
+}
+
+void Task::AssignTaskName(string pName)
+{
+    mTaskName = pName;
+}
+
+string Task::GetTaskName()
+{
+    return mTaskName;
+}
+
+bool Task::IsTaskScheduled()
+{
+    return (mTaskState != TASK_IDLE);
+}
+
+void Task::UnscheduleTask()
+{
+    SVC_EXECUTOR.Unschedule(this);
+}
+
+void Task::GetQueueingDelayStatistic(int64_t &pExecutions, int64_t &pAvgDelay, int64_t &pMaxDelay)
+{
+    pExecutions = mExecutions;
+    pAvgDelay = (pExecutions > 0) ? mQueueingDelaySum / pExecutions : 0;
+    pMaxDelay = mQueueingDelayMax;
+}
+
+bool Task::MarkQueued()
+{
+    while (true)
+    {
+        int tState = mTaskState;
+        switch (tState)
+        {
+            case TASK_IDLE:
+                if (__sync_bool_compare_and_swap(&mTaskState, TASK_IDLE, TASK_QUEUED))
+                    return true;
+                break;
+            case TASK_RUNNING:
+                if (__sync_bool_compare_and_swap(&mTaskState, TASK_RUNNING, TASK_RUNNING_RESCHEDULED))
+                    return false;
+                break;
+            default:
+                return false;
+        }
+    }
+}
+
+bool Task::MarkFinished()
+{
+    if (__sync_bool_compare_and_swap(&mTaskState, TASK_RUNNING, TASK_IDLE))
+        return true;
+
+    // the task was scheduled again during its execution
+    mTaskState = TASK_QUEUED;
+    return false;
+}
+
+void Task::AnnounceExecution()
+{
+    // HINT: a task is never executed concurrently, hence no atomic operations are needed here
+    int64_t tDelay = Time::GetMonotonicTimeStamp() - mScheduleTime;
+    if (tDelay < 0)
+        tDelay = 0;
+    mExecutions++;
+    mQueueingDelaySum += tDelay;
+    if (tDelay > mQueueingDelayMax)
+        mQueueingDelayMax = tDelay;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ExecutorWorker::ExecutorWorker(Executor *pExecutor, int pIndex)
+{
+    mExecutor = pExecutor;
+    mIndex = pIndex;
+    mWorkerThreadId = 0;
+    mWorkerNeeded = true;
+    mParked = 0;
+    mTasksMutex.AssignName("ExecutorWorkerTasks");
+}
+
+ExecutorWorker::~ExecutorWorker()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ExecutorWorker::PushTask(Task *pTask)
+{
+    mTasksMutex.lock();
+    mTasks.push_back(pTask);
+    mTasksMutex.unlock();
+}
+
+Task* ExecutorWorker::PopTask()
+{
+    Task *tResult = NULL;
+
+    mTasksMutex.lock();
+    if (!mTasks.empty())
+    {
+        // newest task first: its data is most likely still cached
+        tResult = mTasks.back();
+        mTasks.pop_back();
+    }
+    mTasksMutex.unlock();
+
+    return tResult;
+}
+
+Task* ExecutorWorker::StealTask()
+{
+    Task *tResult = NULL;
+
+    mTasksMutex.lock();
+    if (!mTasks.empty())
+    {
+        // oldest task first: it waits the longest time
+        tResult = mTasks.front();
+        mTasks.pop_front();
+    }
+    mTasksMutex.unlock();
+
+    return tResult;
+}
+
+bool ExecutorWorker::RemoveTask(Task *pTask)
+{
+    bool tResult = false;
+    std::deque<Task*>::iterator tIt;
+
+    mTasksMutex.lock();
+    for (tIt = mTasks.begin(); tIt != mTasks.end(); tIt++)
+    {
+        if (*tIt == pTask)
+        {
+            mTasks.erase(tIt);
+            tResult = true;
+            break;
+        }
+    }
+    mTasksMutex.unlock();
+
+    return tResult;
+}
+
+void ExecutorWorker::Unpark()
+{
+    if (mParked)
+    {
+        mParkMutex.lock();
+        mParkCondition.Signal();
+        mParkMutex.unlock();
+    }
+}
+
+void ExecutorWorker::Stop()
+{
+    mWorkerNeeded = false;
+    __sync_synchronize();
+    Unpark();
+    StopThread();
+}
+
+bool ExecutorWorker::IsParked()
+{
+    return (mParked != 0);
+}
+
+int ExecutorWorker::GetWorkerThreadId()
+{
+    return mWorkerThreadId;
+}
+
+void ExecutorWorker::Park()
+{
+    mParkMutex.lock();
+    mParked = 1;
+    // the parking flag has to be visible to schedulers before we check for pending tasks a last time
+    __sync_synchronize();
+    if ((mWorkerNeeded) && (mExecutor->GetPendingTasks() == 0))
+        mParkCondition.Wait(&mParkMutex, EXECUTOR_WORKER_PARK_TIME);
+    mParked = 0;
+    mParkMutex.unlock();
+}
+
+void* ExecutorWorker::Run(void* pArgs)
+{
+    Task *tTask;
+
+    mWorkerThreadId = GetTId();
+    LOG(LOG_VERBOSE, "Executor worker %d started", mIndex);
+    AnnounceReady();
+
+    while (mWorkerNeeded)
+    {
+        tTask = mExecutor->FindTask(mIndex);
+        if (tTask != NULL)
+            mExecutor->ExecuteTask(tTask);
+        else
+            Park();
+    }
+
+    LOG(LOG_VERBOSE, "Executor worker %d finished", mIndex);
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Executor::Executor()
+{
+    mWorkers = NULL;
+    mWorkerCount = 0;
+    mPendingTasks = 0;
+    mNextWorker = 0;
+    mRunning = false;
+    mStopping = false;
+    mTaskFinishedWaiters = 0;
+}
+
+Executor::~Executor()
+{
+    Stop();
+}
+
+Executor& Executor::GetInstance()
+{
+    return sExecutor;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Executor::Start(int pWorkerCount)
+{
+    bool tResult;
+
+    mStartMutex.lock();
+    tResult = StartLocked(pWorkerCount);
+    mStartMutex.unlock();
+
+    return tResult;
+}
+
+bool Executor::StartLocked(int pWorkerCount)
+{
+    if (mRunning)
+        return true;
+
+    // the workers of the previous run are still terminating
+    if (mStopping)
+        return false;
+
+    if (pWorkerCount < 1)
+        pWorkerCount = System::GetMachineCores();
+    if (pWorkerCount < 1)
+        pWorkerCount = 1;
+
+    LOG(LOG_VERBOSE, "Starting executor with %d workers", pWorkerCount);
+
+    mWorkers = (ExecutorWorker**)malloc(pWorkerCount * sizeof(ExecutorWorker*));
+    for (int i = 0; i < pWorkerCount; i++)
+        mWorkers[i] = new ExecutorWorker(this, i);
+    mWorkerCount = pWorkerCount;
+
+    // the worker set has to be complete before any worker starts stealing
+    __sync_synchronize();
+    for (int i = 0; i < mWorkerCount; i++)
+        mWorkers[i]->StartThread();
+
+    // HINT: StopThread() doesn't wait for a thread which hasn't started yet, and workers have to be identifiable by their thread ID
+    for (int i = 0; i < mWorkerCount; i++)
+    {
+        if (!mWorkers[i]->WaitForReady())
+            LOG(LOG_ERROR, "Executor worker %d terminated during its init. process", i);
+    }
+
+    mRunning = true;
+
+    return true;
+}
+
+void Executor::Stop()
+{
+    Task *tTask;
+
+    mStartMutex.lock();
+    if (!mRunning)
+    {
+        mStartMutex.unlock();
+        return;
+    }
+
+    LOG(LOG_VERBOSE, "Stopping executor with %d workers", mWorkerCount);
+
+    // from now on, Schedule() rejects new tasks, the worker set stays valid until all workers have terminated
+    mRunning = false;
+    mStopping = true;
+    mStartMutex.unlock();
+
+    // HINT: the lock isn't held here because running tasks may schedule continuations
+    for (int i = 0; i < mWorkerCount; i++)
+        mWorkers[i]->Stop();
+
+    mStartMutex.lock();
+
+    // drop all tasks which weren't executed
+    for (int i = 0; i < mWorkerCount; i++)
+    {
+        while ((tTask = mWorkers[i]->PopTask()) != NULL)
+        {
+            LOG(LOG_WARN, "Dropping unexecuted task %s", tTask->GetTaskName().c_str());
+            tTask->mTaskState = TASK_IDLE;
+            if (tTask->mAutoDelete)
+                delete tTask;
+        }
+        delete mWorkers[i];
+    }
+    free(mWorkers);
+    mWorkers = NULL;
+    mWorkerCount = 0;
+    mPendingTasks = 0;
+    mStopping = false;
+
+    mStartMutex.unlock();
+}
+
+bool Executor::IsRunning()
+{
+    return mRunning;
+}
+
+int Executor::GetWorkerCount()
+{
+    return mWorkerCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Executor::Schedule(Task *pTask)
+{
+    int tWorker;
+
+    if (pTask == NULL)
+        return false;
+
+    // HINT: the worker set mustn't change while we use it
+    mStartMutex.lock();
+
+    if ((!mRunning) && (!StartLocked(0)))
+    {
+        mStartMutex.unlock();
+        return false;
+    }
+
+    if (!pTask->MarkQueued())
+    {
+        mStartMutex.unlock();
+        #ifdef HB_DEBUG_EXECUTOR
+            LOG(LOG_VERBOSE, "Task %s is already scheduled", pTask->GetTaskName().c_str());
+        #endif
+        return false;
+    }
+
+    // tasks which are scheduled by a worker stay at this worker
+    tWorker = GetCurrentWorker();
+    if (tWorker < 0)
+        tWorker = (int)(((unsigned int)__sync_fetch_and_add(&mNextWorker, 1)) % mWorkerCount);
+
+    #ifdef HB_DEBUG_EXECUTOR
+        LOG(LOG_VERBOSE, "Scheduling task %s at worker %d", pTask->GetTaskName().c_str(), tWorker);
+    #endif
+
+    EnqueueTask(pTask, tWorker);
+
+    // wake up the selected worker or any parked one which is able to steal the task
+    if (mWorkers[tWorker]->IsParked())
+        mWorkers[tWorker]->Unpark();
+    else
+    {
+        for (int i = 1; i < mWorkerCount; i++)
+        {
+            int tCandidate = (tWorker + i) % mWorkerCount;
+            if (mWorkers[tCandidate]->IsParked())
+            {
+                mWorkers[tCandidate]->Unpark();
+                break;
+            }
+        }
+    }
+
+    mStartMutex.unlock();
+
+    return true;
+}
+
+void Executor::Unschedule(Task *pTask)
+{
+    int tWaitingRound = 0;
+    bool tCalledByWorker;
+
+    if (pTask == NULL)
+        return;
+
+    // remove a queued execution
+    mStartMutex.lock();
+    tCalledByWorker = (GetCurrentWorker() >= 0);
+    for (int i = 0; i < mWorkerCount; i++)
+    {
+        if (mWorkers[i]->RemoveTask(pTask))
+        {
+            __sync_sub_and_fetch(&mPendingTasks, 1);
+            pTask->mTaskState = TASK_IDLE;
+            break;
+        }
+    }
+    mStartMutex.unlock();
+
+    // a running task mustn't be executed once more
+    __sync_bool_compare_and_swap(&pTask->mTaskState, TASK_RUNNING_RESCHEDULED, TASK_RUNNING);
+
+    if (!pTask->IsTaskScheduled())
+        return;
+
+    if (tCalledByWorker)
+    {
+        LOG(LOG_ERROR, "Task %s is unscheduled by a worker of the executor, won't wait for the end of its execution", pTask->GetTaskName().c_str());
+        return;
+    }
+
+    // wait for the end of the execution, a task which was taken by a worker but isn't running yet is executed once
+    mTaskFinishedMutex.lock();
+    __sync_add_and_fetch(&mTaskFinishedWaiters, 1);
+    while (pTask->IsTaskScheduled())
+    {
+        if (tWaitingRound > 0)
+            LOG(LOG_WARN, "Waiting round %d for the end of task %s, system has high load", tWaitingRound, pTask->GetTaskName().c_str());
+        tWaitingRound++;
+
+        mTaskFinishedCondition.Wait(&mTaskFinishedMutex, EXECUTOR_WORKER_PARK_TIME);
+    }
+    __sync_sub_and_fetch(&mTaskFinishedWaiters, 1);
+    mTaskFinishedMutex.unlock();
+}
+
+int Executor::GetCurrentWorker()
+{
+    int tThreadId = Thread::GetTId();
+
+    for (int i = 0; i < mWorkerCount; i++)
+    {
+        if (mWorkers[i]->GetWorkerThreadId() == tThreadId)
+            return i;
+    }
+
+    return -1;
+}
+
+void Executor::EnqueueTask(Task *pTask, int pWorkerIndex)
+{
+    pTask->mScheduleTime = Time::GetMonotonicTimeStamp();
+    mWorkers[pWorkerIndex]->PushTask(pTask);
+    // the pending counter has to be visible before the caller checks for parked workers
+    __sync_add_and_fetch(&mPendingTasks, 1);
+}
+
+Task* Executor::FindTask(int pWorkerIndex)
+{
+    Task *tResult;
+
+    if (GetPendingTasks() == 0)
+        return NULL;
+
+    // own tasks first
+    tResult = mWorkers[pWorkerIndex]->PopTask();
+
+    // steal from the other workers
+    for (int i = 1; (tResult == NULL) && (i < mWorkerCount); i++)
+        tResult = mWorkers[(pWorkerIndex + i) % mWorkerCount]->StealTask();
+
+    if (tResult != NULL)
+        __sync_sub_and_fetch(&mPendingTasks, 1);
+
+    return tResult;
+}
+
+void Executor::ExecuteTask(Task *pTask)
+{
+    Task *tContinuation;
+    // HINT: the task may be destroyed by a waiting thread as soon as it is marked as finished
+    bool tAutoDelete = pTask->mAutoDelete;
+
+    pTask->mTaskState = TASK_RUNNING;
+    __sync_synchronize();
+    pTask->AnnounceExecution();
+
+    #ifdef HB_DEBUG_EXECUTOR
+        LOG(LOG_VERBOSE, "Executing task %s", pTask->GetTaskName().c_str());
+    #endif
+
+    pTask->Execute();
+
+    tContinuation = pTask->GetContinuation();
+    if (tContinuation != NULL)
+        Schedule(tContinuation);
+
+    if (pTask->MarkFinished())
+    {
+        // the atomic state change of MarkFinished() is visible before we check for waiters
+        // HINT: the waiters may wait for different tasks, hence all of them are woken up and check their own task
+        if (mTaskFinishedWaiters > 0)
+        {
+            mTaskFinishedMutex.lock();
+            mTaskFinishedCondition.Signal();
+            mTaskFinishedMutex.unlock();
+        }
+
+        if (tAutoDelete)
+            delete pTask;
+    }else
+    {// execute the task once more at this worker, it is still marked as queued
+        int tWorker = GetCurrentWorker();
+        EnqueueTask(pTask, (tWorker >= 0) ? tWorker : 0);
+    }
+}
+
+int Executor::GetPendingTasks()
+{
+    return mPendingTasks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Executor::ActivatePipelineTasks(bool pActive)
+{
+    sPipelineTasksActive = pActive;
+}
+
+bool Executor::PipelineTasksActivated()
+{
+    return sPipelineTasksActive;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TaskList Executor::GetTasksAccess()
+{
+    TaskList tResult;
+
+    // lock
+    mTasksMutex.lock();
+
+    tResult = mTasks;
+
+    return tResult;
+}
+
+void Executor::ReleaseTasksAccess()
+{
+    // unlock
+    mTasksMutex.unlock();
+}
+
+void Executor::RegisterTask(Task *pTask)
+{
+    mTasksMutex.lock();
+    mTasks.push_back(pTask);
+    mTasksMutex.unlock();
+}
+
+void Executor::UnregisterTask(Task *pTask)
+{
+    mTasksMutex.lock();
+    mTasks.remove(pTask);
+    mTasksMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -28,6 +28,9 @@
 #include <HBMutex.h>
 #include <HBThread.h>
 #include <HBSystem.h>
+#include <HBTime.h>
+
+#include <map>
 
 #ifdef APPLE
 // to get current time stamp
@@ -41,10 +44,23 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// registry of mutex profiles: profiles are never freed because mutexes may still refer to them after a reset
+typedef map<string, MutexProfile*> MutexProfileRegistry;
+
+static volatile bool sMutexProfilingActive = false;
+static MutexProfileRegistry sMutexProfiles;
+static Mutex sMutexProfilesMutex("MutexProfiles");
+
+///////////////////////////////////////////////////////////////////////////////
+
 Mutex::Mutex(string pName)
 {
     mName = pName;
     mOwnerThreadId = -1;
+    mAdaptiveSpinning = false;
+    mSpinEstimate = 0;
+    mProfile = NULL;
+    mLockTime = 0;
     bool tResult = false;
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
 		tResult = (pthread_mutex_init(&mMutex, NULL) == 0);
@@ -94,6 +110,52 @@ bool Mutex::lock(int pTimeout)
 
     mOwnerThreadId = tThreadId;
 
+    bool tProfiled = IsProfiled();
+    if ((tProfiled) || (mAdaptiveSpinning))
+    {
+        // fast path: uncontended acquisition
+        if (TryLockOnce())
+        {
+            if (tProfiled)
+            {
+                ProfileAcquisition(false, 0);
+                ProfileHoldStart();
+            }
+            return true;
+        }
+
+        bool tResult = false;
+        int64_t tStartTime = tProfiled ? Time::GetMonotonicTimeStamp() : 0;
+
+        if ((mAdaptiveSpinning) && (pTimeout == 0))
+            tResult = SpinLock();
+
+        // park the thread until the mutex is released
+        if (!tResult)
+        {
+            if (pTimeout > 0)
+            {
+                tResult = tryLock(pTimeout);
+            }else
+            {
+                #if defined(LINUX) || defined(APPLE) || defined(BSD)
+                    tResult = !pthread_mutex_lock(&mMutex);
+                #endif
+                #if defined(WINDOWS)
+                    tResult = (WaitForSingleObject(mMutex, INFINITE) != WAIT_FAILED);
+                #endif
+            }
+        }
+
+        if ((tResult) && (tProfiled))
+        {
+            ProfileAcquisition(true, Time::GetMonotonicTimeStamp() - tStartTime);
+            ProfileHoldStart();
+        }
+
+        return tResult;
+    }
+
     if (pTimeout > 0)
     {
         return tryLock(pTimeout);
@@ -113,6 +175,8 @@ bool Mutex::lock(int pTimeout)
 
 bool Mutex::unlock()
 {
+    ProfileHoldEnd();
+
     mOwnerThreadId = -1;
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
@@ -237,9 +301,211 @@ bool Mutex::tryLock(int pMSecs)
 	return tResult;
 }
 
+bool Mutex::TryLockOnce()
+{
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        return (pthread_mutex_trylock(&mMutex) == 0);
+    #endif
+    #if defined(WINDOWS)
+        return (WaitForSingleObject(mMutex, 0) == WAIT_OBJECT_0);
+    #endif
+}
+
+static inline void CpuRelax()
+{
+    #if defined(__i386__) || defined(__x86_64__)
+        __asm__ __volatile__("pause" ::: "memory");
+    #else
+        __sync_synchronize();
+    #endif
+}
+
+bool Mutex::SpinLock()
+{
+    // spinning is useless if the owner can't run in parallel
+    if (System::GetMachineCores() < 2)
+        return false;
+
+    // spin up to twice the rounds which were needed in the past, plus a small margin for variations
+    int tMaxRounds = 2 * mSpinEstimate + 10;
+    if (tMaxRounds > MUTEX_ADAPTIVE_SPIN_ROUNDS)
+        tMaxRounds = MUTEX_ADAPTIVE_SPIN_ROUNDS;
+
+    for (int i = 1; i <= tMaxRounds; i++)
+    {
+        CpuRelax();
+        if (TryLockOnce())
+        {
+            // adapt the estimate with a weight of 1/8 for the new sample
+            mSpinEstimate += (i - mSpinEstimate) / 8;
+            return true;
+        }
+    }
+
+    // spinning failed, the estimate is lowered so that long critical sections park the thread soon
+    mSpinEstimate += (tMaxRounds - mSpinEstimate) / 8 - 1;
+    if (mSpinEstimate < 0)
+        mSpinEstimate = 0;
+
+    return false;
+}
+
 void Mutex::AssignName(string pName)
 {
     mName = pName;
+    mProfile = NULL;
+}
+
+void Mutex::SetAdaptiveSpinning(bool pActive)
+{
+    mAdaptiveSpinning = pActive;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mutex::ActivateProfiling()
+{
+    sMutexProfilingActive = true;
+}
+
+void Mutex::DeactivateProfiling()
+{
+    sMutexProfilingActive = false;
+}
+
+bool Mutex::IsProfilingActive()
+{
+    return sMutexProfilingActive;
+}
+
+MutexProfiles Mutex::GetProfiles()
+{
+    MutexProfiles tResult;
+    MutexProfileRegistry::iterator tIt;
+
+    sMutexProfilesMutex.lock();
+
+    for (tIt = sMutexProfiles.begin(); tIt != sMutexProfiles.end(); tIt++)
+    {
+        if (tIt->second->Acquisitions > 0)
+            tResult.push_back(*tIt->second);
+    }
+
+    sMutexProfilesMutex.unlock();
+
+    return tResult;
+}
+
+void Mutex::ResetProfiles()
+{
+    MutexProfileRegistry::iterator tIt;
+
+    sMutexProfilesMutex.lock();
+
+    for (tIt = sMutexProfiles.begin(); tIt != sMutexProfiles.end(); tIt++)
+    {
+        MutexProfile *tProfile = tIt->second;
+        tProfile->Acquisitions = 0;
+        tProfile->Contentions = 0;
+        tProfile->WaitTime = 0;
+        tProfile->WaitTimeMax = 0;
+        for (int i = 0; i < MUTEX_PROFILE_HISTOGRAM_SIZE; i++)
+            tProfile->WaitTimeHistogram[i] = 0;
+        tProfile->HoldTimeMax = 0;
+    }
+
+    sMutexProfilesMutex.unlock();
+}
+
+bool Mutex::IsProfiled()
+{
+    // the registry mutex is excluded because it is locked while profiles are resolved
+    return ((sMutexProfilingActive) && (this != &sMutexProfilesMutex));
+}
+
+MutexProfile* Mutex::GetProfile()
+{
+    if (mProfile != NULL)
+        return mProfile;
+
+    string tName = (mName != "") ? mName : "unnamed";
+
+    sMutexProfilesMutex.lock();
+
+    MutexProfileRegistry::iterator tIt = sMutexProfiles.find(tName);
+    if (tIt == sMutexProfiles.end())
+    {
+        MutexProfile *tProfile = new MutexProfile();
+        tProfile->Name = tName;
+        tProfile->Acquisitions = 0;
+        tProfile->Contentions = 0;
+        tProfile->WaitTime = 0;
+        tProfile->WaitTimeMax = 0;
+        for (int i = 0; i < MUTEX_PROFILE_HISTOGRAM_SIZE; i++)
+            tProfile->WaitTimeHistogram[i] = 0;
+        tProfile->HoldTimeMax = 0;
+        sMutexProfiles[tName] = tProfile;
+        mProfile = tProfile;
+    }else
+        mProfile = tIt->second;
+
+    sMutexProfilesMutex.unlock();
+
+    return mProfile;
+}
+
+void Mutex::UpdateMaximum(volatile int64_t *pValue, int64_t pSample)
+{
+    int64_t tValue = *pValue;
+
+    while (pSample > tValue)
+    {
+        int64_t tOldValue = __sync_val_compare_and_swap(pValue, tValue, pSample);
+        if (tOldValue == tValue)
+            break;
+        tValue = tOldValue;
+    }
+}
+
+void Mutex::ProfileAcquisition(bool pContended, int64_t pWaitTime)
+{
+    MutexProfile *tProfile = GetProfile();
+    int tBucket = 0;
+
+    if (pWaitTime < 0)
+        pWaitTime = 0;
+
+    // logarithmic histogram bucket
+    while ((tBucket < MUTEX_PROFILE_HISTOGRAM_SIZE - 1) && ((pWaitTime >> tBucket) > 0))
+        tBucket++;
+
+    __sync_add_and_fetch(&tProfile->Acquisitions, 1);
+    __sync_add_and_fetch(&tProfile->WaitTimeHistogram[tBucket], 1);
+    if (pContended)
+    {
+        __sync_add_and_fetch(&tProfile->Contentions, 1);
+        __sync_add_and_fetch(&tProfile->WaitTime, pWaitTime);
+        UpdateMaximum(&tProfile->WaitTimeMax, pWaitTime);
+    }
+}
+
+void Mutex::ProfileHoldStart()
+{
+    if (IsProfiled())
+        mLockTime = Time::GetMonotonicTimeStamp();
+}
+
+void Mutex::ProfileHoldEnd()
+{
+    // the caller still owns the mutex, so mLockTime can't be changed concurrently
+    if (mLockTime == 0)
+        return;
+
+    int64_t tHoldTime = Time::GetMonotonicTimeStamp() - mLockTime;
+    mLockTime = 0;
+
+    if (IsProfiled())
+        UpdateMaximum(&GetProfile()->HoldTimeMax, tHoldTime);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,22 @@
 #ifndef WINDOWS
 #include <unistd.h>
 #endif
+#if defined(LINUX)
+#include <netinet/udp.h>
+#endif
+
+// UDP segmentation offload, available since Linux 4.18 (GSO) and 5.0 (GRO)
+#if defined(LINUX)
+#ifndef SOL_UDP
+#define SOL_UDP                                 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT                             103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO                                 104
+#endif
+#endif
 
 namespace Homer { namespace Base {
 
@@ -73,6 +89,15 @@ int sIPv6Supported = -1;
 int sUDPliteSupported = -1;
 int sDCCPSupported = -1;
 int sSCTPSupported = -1;
+int sMmsgSupported = -1;
+bool sSegmentationOffloadActivated = false;
+
+// maximum number of datagrams per sendmmsg()/recvmmsg() call
+#define SOCKET_BATCH_CHUNK                      64
+
+// limits of one segmented transmission: the kernel accepts up to 64 segments (older kernels) and an IP payload of up to 64 KB
+#define SOCKET_SEGMENTED_MAX_SEGMENTS           64
+#define SOCKET_SEGMENTED_MAX_SIZE               65000
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -90,6 +115,13 @@ void Socket::SetDefaults(enum TransportType pTransportType)
     mTcpClientSockeHandle = -1;
     mPeerHost = "";
     mPeerPort = 0;
+    mHasDestination = false;
+    mDestinationConnected = false;
+    mDestinationHost = "";
+    mDestinationPort = 0;
+    mDestinationAddressSize = 0;
+    mSendOffloadSupported = -1;
+    mReceiveOffload = false;
     mUdpLiteChecksumCoverage = UDP_LITE_HEADER_SIZE;
 
     #if defined(WINDOWS) || defined(APPLE) || defined(BSD)
@@ -392,7 +424,7 @@ bool Socket::SetQoS(const QoSSettings &pQoSSettings)
     }else
         LOG(LOG_WARN, "QoS support deactivated, settings will be ignored");
 
-	return true;
+    return true;
 }
 
 bool Socket::GetQoS(QoSSettings &pQoSSettings)
@@ -564,7 +596,9 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
     unsigned short int  tLocalPort = 0;
     bool                tTargetIsIPv6 = IS_IPV6_ADDRESS(pTargetHost);
     int                 tUdpLiteChecksumCoverage = mUdpLiteChecksumCoverage;
-    int64_t             tTime, tTime2;
+    #ifdef HBS_DEBUG_TIMING
+        int64_t         tTime, tTime2;
+    #endif
 
     if (mWasClosed)
     	return false;
@@ -588,11 +622,16 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
 		case SOCKET_UDP_LITE:
             // continue as it was UDP sending
 		case SOCKET_UDP:
+		    // a connected socket has to be disconnected before it can send towards another target
+		    if ((mDestinationConnected) && ((mDestinationHost != pTargetHost) || (mDestinationPort != pTargetPort)))
+		        ResetDestination();
 		    mPeerDataMutex.lock();
 		    mPeerHost = pTargetHost;
 		    mPeerPort = pTargetPort;
 		    mPeerDataMutex.unlock();
-	        tTime = Time::GetTimeStamp();
+            #ifdef HBS_DEBUG_TIMING
+                tTime = Time::GetMonotonicTimeStamp();
+            #endif
             #if defined(LINUX)
 				tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL, &tAddressDescriptor.sa, tAddressDescriptorSize);
 			#endif
@@ -603,7 +642,7 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
 				tSent = sendto(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0, &tAddressDescriptor.sa, (int)tAddressDescriptorSize);
 			#endif
             #ifdef HBS_DEBUG_TIMING
-                tTime2 = Time::GetTimeStamp();
+                tTime2 = Time::GetMonotonicTimeStamp();
                 LOG(LOG_VERBOSE, "Sending %d bytes to network via UDP took %"PRId64" us", (int)pBufferSize, tTime2 - tTime);
             #endif
 			break;
@@ -680,6 +719,537 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
     return tResult;
 }
 
+bool Socket::SetDestination(string pTargetHost, unsigned int pTargetPort, bool pConnectUdp)
+{
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return false;
+    }
+
+    if (mHasDestination)
+        ResetDestination();
+
+    if (!FillAddrDescriptor(pTargetHost, pTargetPort, &mDestinationAddress, mDestinationAddressSize))
+    {
+        LOG(LOG_ERROR ,"Could not process the destination address %s:%u of socket %d", pTargetHost.c_str(), pTargetPort, mSocketHandle);
+        return false;
+    }
+
+    //HINT: a connected UDP socket receives only datagrams from the destination, hence connecting is limited to sockets which aren't shared with a receiver
+    if ((pConnectUdp) && ((mSocketTransportType == SOCKET_UDP) || (mSocketTransportType == SOCKET_UDP_LITE)))
+    {
+        if (connect(mSocketHandle, &mDestinationAddress.sa, mDestinationAddressSize) < 0)
+        {
+            LOG(LOG_WARN, "Failed to connect UDP socket %d to %s:%u because \"%s\"(%d), falling back to unconnected sending", mSocketHandle, pTargetHost.c_str(), pTargetPort, strerror(errno), errno);
+        }else
+            mDestinationConnected = true;
+    }
+
+    mDestinationHost = pTargetHost;
+    mDestinationPort = pTargetPort;
+    mHasDestination = true;
+    // the new route decides about segmentation offload
+    mSendOffloadSupported = -1;
+
+    mPeerDataMutex.lock();
+    mPeerHost = pTargetHost;
+    mPeerPort = pTargetPort;
+    mPeerDataMutex.unlock();
+
+    LOG(LOG_VERBOSE, "Set destination of socket %d to %s:%u%s", mSocketHandle, pTargetHost.c_str(), pTargetPort, mDestinationConnected ? " (connected)" : "");
+
+    return true;
+}
+
+void Socket::ResetDestination()
+{
+    if (mDestinationConnected)
+    {
+        // dissolve the association of the UDP socket
+        SocketAddressDescriptor tAddressDescriptor;
+        memset(&tAddressDescriptor, 0, sizeof(tAddressDescriptor));
+        #if defined(LINUX) || defined(APPLE) || defined(BSD)
+            tAddressDescriptor.sa.sa_family = AF_UNSPEC;
+            connect(mSocketHandle, &tAddressDescriptor.sa, sizeof(tAddressDescriptor.sa));
+        #endif
+        #if defined(WINDOWS)
+            // a zero address dissolves the association
+            tAddressDescriptor.sa.sa_family = mDestinationAddress.sa.sa_family;
+            connect(mSocketHandle, &tAddressDescriptor.sa, (int)mDestinationAddressSize);
+        #endif
+
+        // drop a pending error of the old association, e.g., an ICMP "port unreachable"
+        int tError = 0;
+        #if defined(LINUX) || defined(APPLE) || defined(BSD)
+            socklen_t tErrorSize = sizeof(tError);
+        #endif
+        #if defined(WINDOWS)
+            int tErrorSize = sizeof(tError);
+        #endif
+        getsockopt(mSocketHandle, SOL_SOCKET, SO_ERROR, (char*)&tError, &tErrorSize);
+
+        mDestinationConnected = false;
+    }
+    mHasDestination = false;
+}
+
+bool Socket::HasDestination()
+{
+    return mHasDestination;
+}
+
+bool Socket::Send(void *pBuffer, ssize_t pBufferSize)
+{
+    int                 tSent = 0;
+    bool                tResult = false;
+
+    if (mWasClosed)
+        return false;
+
+    if (!mHasDestination)
+    {
+        LOG(LOG_ERROR, "Destination of socket %d is undefined", mSocketHandle);
+        return false;
+    }
+
+    // TCP has its own connection handling
+    if ((mSocketTransportType != SOCKET_UDP) && (mSocketTransportType != SOCKET_UDP_LITE))
+        return Send(mDestinationHost, mDestinationPort, pBuffer, pBufferSize);
+
+    if (mDestinationConnected)
+    {
+        // a connected socket reports an ICMP "port unreachable" for an earlier datagram with the next send call,
+        // unconnected sockets ignore this, hence we retry once to keep the same behavior
+        for (int tAttempt = 0; tAttempt < 2; tAttempt++)
+        {
+            #if defined(LINUX)
+                tSent = send(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL);
+            #endif
+            #if defined(APPLE) || defined(BSD)
+                tSent = send(mSocketHandle, pBuffer, (size_t)pBufferSize, 0);
+            #endif
+            #if defined(WINDOWS)
+                tSent = send(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0);
+            #endif
+            if ((tSent >= 0) || (errno != ECONNREFUSED))
+                break;
+        }
+    }else
+    {
+        #if defined(LINUX)
+            tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL, &mDestinationAddress.sa, mDestinationAddressSize);
+        #endif
+        #if defined(APPLE) || defined(BSD)
+            tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, 0, &mDestinationAddress.sa, mDestinationAddressSize);
+        #endif
+        #if defined(WINDOWS)
+            tSent = sendto(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0, &mDestinationAddress.sa, (int)mDestinationAddressSize);
+        #endif
+    }
+
+    if (tSent < 0)
+    {
+        LOG(LOG_ERROR, "Error when sending data via socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+    }else
+    {
+        if (tSent < (int)pBufferSize)
+        {
+            LOG(LOG_ERROR, "Insufficient data on socket %d was sent", mSocketHandle);
+        }else
+        {
+            #ifdef HBS_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Sent %d bytes via socket %d to %s<%u>", tSent, mSocketHandle, mDestinationHost.c_str(), mDestinationPort);
+            #endif
+            tResult = true;
+        }
+    }
+
+    return tResult;
+}
+
+bool Socket::SendBatch(SocketDatagram *pDatagrams, int pDatagramCount)
+{
+    int                 tSentDatagrams = 0;
+
+    if (mWasClosed)
+        return false;
+
+    if (!mHasDestination)
+    {
+        LOG(LOG_ERROR, "Destination of socket %d is undefined", mSocketHandle);
+        return false;
+    }
+
+    #if defined(LINUX)
+        if ((sMmsgSupported != 0) && ((mSocketTransportType == SOCKET_UDP) || (mSocketTransportType == SOCKET_UDP_LITE)))
+        {
+            struct mmsghdr  tMessages[SOCKET_BATCH_CHUNK];
+            struct iovec    tVectors[SOCKET_BATCH_CHUNK];
+            bool            tRetried = false;
+
+            while (tSentDatagrams < pDatagramCount)
+            {
+                int tChunk = pDatagramCount - tSentDatagrams;
+                if (tChunk > SOCKET_BATCH_CHUNK)
+                    tChunk = SOCKET_BATCH_CHUNK;
+
+                memset(tMessages, 0, sizeof(struct mmsghdr) * tChunk);
+                for (int i = 0; i < tChunk; i++)
+                {
+                    tVectors[i].iov_base = pDatagrams[tSentDatagrams + i].Data;
+                    tVectors[i].iov_len = (size_t)pDatagrams[tSentDatagrams + i].Size;
+                    tMessages[i].msg_hdr.msg_iov = &tVectors[i];
+                    tMessages[i].msg_hdr.msg_iovlen = 1;
+                    if (!mDestinationConnected)
+                    {
+                        tMessages[i].msg_hdr.msg_name = &mDestinationAddress.sa;
+                        tMessages[i].msg_hdr.msg_namelen = mDestinationAddressSize;
+                    }
+                }
+
+                int tSent = sendmmsg(mSocketHandle, tMessages, (unsigned int)tChunk, MSG_NOSIGNAL);
+                if (tSent < 0)
+                {
+                    if (errno == ENOSYS)
+                    {// kernel without sendmmsg(), fall back to single transmissions
+                        LOG(LOG_WARN, "sendmmsg() isn't supported by the kernel, falling back to single datagram transmissions");
+                        sMmsgSupported = 0;
+                        break;
+                    }
+                    if ((mDestinationConnected) && (errno == ECONNREFUSED) && (!tRetried))
+                    {// see Send(), a second refusal is reported as error
+                        tRetried = true;
+                        continue;
+                    }
+                    LOG(LOG_ERROR, "Error when sending %d datagrams via socket %d because of \"%s\"(%d)", tChunk, mSocketHandle, strerror(errno), errno);
+                    return false;
+                }
+                sMmsgSupported = 1;
+                tSentDatagrams += tSent;
+            }
+            #ifdef HBS_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Sent %d datagrams via socket %d to %s<%u>", tSentDatagrams, mSocketHandle, mDestinationHost.c_str(), mDestinationPort);
+            #endif
+        }
+    #endif
+
+    // fall back to single transmissions
+    for (int i = tSentDatagrams; i < pDatagramCount; i++)
+    {
+        if (!Send(pDatagrams[i].Data, pDatagrams[i].Size))
+            return false;
+    }
+
+    return true;
+}
+
+int Socket::ReceiveBatch(SocketDatagram *pDatagrams, int pMaxDatagrams, bool pWait)
+{
+    int                 tResult = 0;
+
+    if (mWasClosed)
+        return -1;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return -1;
+    }
+
+    if ((mSocketTransportType != SOCKET_UDP) && (mSocketTransportType != SOCKET_UDP_LITE))
+    {
+        LOG(LOG_ERROR, "Batched reception is only supported for datagram sockets");
+        return -1;
+    }
+
+    if (pMaxDatagrams > SOCKET_BATCH_CHUNK)
+        pMaxDatagrams = SOCKET_BATCH_CHUNK;
+
+    #if defined(LINUX)
+        struct mmsghdr  tMessages[SOCKET_BATCH_CHUNK];
+        struct iovec    tVectors[SOCKET_BATCH_CHUNK];
+        // the segment size of coalesced datagrams is reported as ancillary data
+        char            tControls[SOCKET_BATCH_CHUNK][CMSG_SPACE(sizeof(int))];
+
+        memset(tMessages, 0, sizeof(struct mmsghdr) * pMaxDatagrams);
+        for (int i = 0; i < pMaxDatagrams; i++)
+        {
+            tVectors[i].iov_base = pDatagrams[i].Data;
+            tVectors[i].iov_len = (size_t)pDatagrams[i].Size;
+            tMessages[i].msg_hdr.msg_iov = &tVectors[i];
+            tMessages[i].msg_hdr.msg_iovlen = 1;
+            tMessages[i].msg_hdr.msg_name = &pDatagrams[i].Source.sa_stor;
+            tMessages[i].msg_hdr.msg_namelen = sizeof(pDatagrams[i].Source.sa_stor);
+            if (mReceiveOffload)
+            {
+                tMessages[i].msg_hdr.msg_control = tControls[i];
+                tMessages[i].msg_hdr.msg_controllen = sizeof(tControls[i]);
+            }
+            pDatagrams[i].SegmentSize = 0;
+        }
+
+        if (sMmsgSupported != 0)
+        {
+            // wait for the first datagram, afterwards take what is already queued
+            tResult = recvmmsg(mSocketHandle, tMessages, (unsigned int)pMaxDatagrams, pWait ? MSG_WAITFORONE : MSG_DONTWAIT, NULL);
+            if (tResult >= 0)
+            {
+                sMmsgSupported = 1;
+            }else
+            {
+                if ((!pWait) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+                    return 0;
+                if (errno != ENOSYS)
+                {
+                    if (!mWasClosed)
+                        LOG(LOG_ERROR, "Error when receiving datagrams via socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+                    return -1;
+                }
+                LOG(LOG_WARN, "recvmmsg() isn't supported by the kernel, falling back to single datagram receptions");
+                sMmsgSupported = 0;
+                tResult = 0;
+            }
+        }
+
+        // fall back to single receptions: the first one waits, the following ones take only what is already queued
+        if (tResult == 0)
+        {
+            for (int i = 0; i < pMaxDatagrams; i++)
+            {
+                ssize_t tReceivedBytes = recvmsg(mSocketHandle, &tMessages[i].msg_hdr, ((i > 0) || (!pWait)) ? MSG_DONTWAIT : 0);
+                if (tReceivedBytes < 0)
+                {
+                    if ((i == 0) && ((pWait) || ((errno != EAGAIN) && (errno != EWOULDBLOCK))))
+                    {
+                        if (!mWasClosed)
+                            LOG(LOG_ERROR, "Error when receiving datagrams via socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+                        return -1;
+                    }
+                    break;
+                }
+                tMessages[i].msg_len = (unsigned int)tReceivedBytes;
+                tResult++;
+            }
+        }
+
+        for (int i = 0; i < tResult; i++)
+        {
+            pDatagrams[i].Size = (ssize_t)tMessages[i].msg_len;
+            pDatagrams[i].SourceSize = (unsigned int)tMessages[i].msg_hdr.msg_namelen;
+            if ((mReceiveOffload) && (tMessages[i].msg_hdr.msg_controllen > 0))
+            {
+                for (struct cmsghdr *tControlMessage = CMSG_FIRSTHDR(&tMessages[i].msg_hdr); tControlMessage != NULL; tControlMessage = CMSG_NXTHDR(&tMessages[i].msg_hdr, tControlMessage))
+                {
+                    if ((tControlMessage->cmsg_level == SOL_UDP) && (tControlMessage->cmsg_type == UDP_GRO))
+                    {
+                        int tSegmentSize = *(int*)CMSG_DATA(tControlMessage);
+                        if ((tSegmentSize > 0) && (tSegmentSize < pDatagrams[i].Size))
+                            pDatagrams[i].SegmentSize = (unsigned int)tSegmentSize;
+                    }
+                }
+            }
+        }
+    #endif
+
+    #if defined(APPLE) || defined(BSD) || defined(WINDOWS)
+        // single receptions: the first one waits, the following ones take only what is already queued
+        for (int i = 0; i < pMaxDatagrams; i++)
+        {
+            ssize_t tReceivedBytes = 0;
+            #if defined(APPLE) || defined(BSD)
+                socklen_t tAddressDescriptorSize = sizeof(pDatagrams[i].Source.sa_stor);
+                tReceivedBytes = recvfrom(mSocketHandle, pDatagrams[i].Data, (size_t)pDatagrams[i].Size, ((i > 0) || (!pWait)) ? MSG_DONTWAIT : 0, &pDatagrams[i].Source.sa, &tAddressDescriptorSize);
+            #endif
+            #if defined(WINDOWS)
+                int tAddressDescriptorSize = sizeof(pDatagrams[i].Source.sa_stor);
+                tReceivedBytes = recvfrom(mSocketHandle, (char*)pDatagrams[i].Data, (int)pDatagrams[i].Size, 0, &pDatagrams[i].Source.sa, &tAddressDescriptorSize);
+            #endif
+            if (tReceivedBytes < 0)
+            {
+                if ((i == 0) && ((pWait) || ((errno != EAGAIN) && (errno != EWOULDBLOCK))))
+                {
+                    if (!mWasClosed)
+                        LOG(LOG_ERROR, "Error when receiving datagrams via socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+                    return -1;
+                }
+                break;
+            }
+            pDatagrams[i].Size = tReceivedBytes;
+            pDatagrams[i].SourceSize = (unsigned int)tAddressDescriptorSize;
+            pDatagrams[i].SegmentSize = 0;
+            tResult++;
+            #if defined(WINDOWS)
+                // Windows has no per call non-blocking mode, hence we receive only one datagram per call
+                break;
+            #endif
+        }
+    #endif
+
+    // the last source is the peer of the socket, see Receive()
+    if (tResult > 0)
+    {
+        mPeerDataMutex.lock();
+        mPeerHost = GetAddrFromDescriptor(&pDatagrams[tResult - 1].Source, &mPeerPort);
+        mPeerDataMutex.unlock();
+    }
+
+    #ifdef HBS_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Received %d datagrams via socket %d", tResult, mSocketHandle);
+    #endif
+
+    return tResult;
+}
+
+bool Socket::IsSegmentationOffloadActivated()
+{
+    return sSegmentationOffloadActivated;
+}
+
+void Socket::ActivateSegmentationOffload()
+{
+    #if defined(LINUX)
+        printf("Segmentation offload activated\n");
+        sSegmentationOffloadActivated = true;
+    #else
+        printf("Segmentation offload isn't supported on this platform\n");
+    #endif
+}
+
+bool Socket::SendSegmented(SocketDatagram *pSegments, int pSegmentCount)
+{
+    int                 tSentSegments = 0;
+
+    if (mWasClosed)
+        return false;
+
+    if (!mHasDestination)
+    {
+        LOG(LOG_ERROR, "Destination of socket %d is undefined", mSocketHandle);
+        return false;
+    }
+
+    #if defined(LINUX)
+        //HINT: UDP-Lite has its own checksum calculation and isn't supported by GSO
+        if ((sSegmentationOffloadActivated) && (mSendOffloadSupported != 0) && (mSocketTransportType == SOCKET_UDP))
+        {
+            struct iovec        tVectors[SOCKET_SEGMENTED_MAX_SEGMENTS];
+            char                tControl[CMSG_SPACE(sizeof(uint16_t))];
+            struct msghdr       tMessage;
+            struct cmsghdr      *tControlMessage;
+            bool                tRetried = false;
+
+            while (tSentSegments < pSegmentCount)
+            {
+                // the first segment defines the segment size, the kernel splits the buffer at segment boundaries, only the last segment may be shorter
+                ssize_t tSegmentSize = pSegments[tSentSegments].Size;
+                ssize_t tSize = 0;
+                int tChunk = 0;
+                while ((tSentSegments + tChunk < pSegmentCount) && (tChunk < SOCKET_SEGMENTED_MAX_SEGMENTS) && (tSize == tChunk * tSegmentSize) && (tSize + pSegments[tSentSegments + tChunk].Size <= SOCKET_SEGMENTED_MAX_SIZE))
+                {
+                    SocketDatagram *tSegment = &pSegments[tSentSegments + tChunk];
+                    if ((tSegment->Size < 1) || (tSegment->Size > tSegmentSize))
+                        break;
+                    tVectors[tChunk].iov_base = tSegment->Data;
+                    tVectors[tChunk].iov_len = (size_t)tSegment->Size;
+                    tSize += tSegment->Size;
+                    tChunk++;
+                }
+
+                // a single segment doesn't benefit from the offload
+                if (tChunk < 2)
+                {
+                    if (!Send(pSegments[tSentSegments].Data, pSegments[tSentSegments].Size))
+                        return false;
+                    tSentSegments++;
+                    continue;
+                }
+
+                memset(&tMessage, 0, sizeof(tMessage));
+                memset(tControl, 0, sizeof(tControl));
+                tMessage.msg_iov = tVectors;
+                tMessage.msg_iovlen = tChunk;
+                if (!mDestinationConnected)
+                {
+                    tMessage.msg_name = &mDestinationAddress.sa;
+                    tMessage.msg_namelen = mDestinationAddressSize;
+                }
+                tMessage.msg_control = tControl;
+                tMessage.msg_controllen = sizeof(tControl);
+                tControlMessage = CMSG_FIRSTHDR(&tMessage);
+                tControlMessage->cmsg_level = SOL_UDP;
+                tControlMessage->cmsg_type = UDP_SEGMENT;
+                tControlMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                *(uint16_t*)CMSG_DATA(tControlMessage) = (uint16_t)tSegmentSize;
+
+                ssize_t tSent = sendmsg(mSocketHandle, &tMessage, MSG_NOSIGNAL);
+                if (tSent < 0)
+                {
+                    if ((mDestinationConnected) && (errno == ECONNREFUSED) && (!tRetried))
+                    {// see Send(), a second refusal is reported as error
+                        tRetried = true;
+                        continue;
+                    }
+                    if ((errno == EIO) || (errno == EINVAL) || (errno == ENOPROTOOPT) || (errno == EOPNOTSUPP))
+                    {
+                        if (mSendOffloadSupported != 1)
+                        {// kernel or outgoing interface without UDP GSO, fall back to batched transmissions
+                            LOG(LOG_WARN, "Segmentation offload isn't available for socket %d towards %s:%u because of \"%s\"(%d), falling back to batched transmissions", mSocketHandle, mDestinationHost.c_str(), mDestinationPort, strerror(errno), errno);
+                            mSendOffloadSupported = 0;
+                        }else
+                        {// e.g., the segment size exceeds the path MTU
+                            LOG_RATE_LIMITED(LOG_WARN, 1, "Segmentation offload of %d segments with %d bytes failed for socket %d because of \"%s\"(%d), falling back to batched transmission", tChunk, (int)tSegmentSize, mSocketHandle, strerror(errno), errno);
+                        }
+                        break;
+                    }
+                    LOG(LOG_ERROR, "Error when sending %d segments via socket %d because of \"%s\"(%d)", tChunk, mSocketHandle, strerror(errno), errno);
+                    return false;
+                }
+                mSendOffloadSupported = 1;
+                tSentSegments += tChunk;
+
+                #ifdef HBS_DEBUG_PACKETS
+                    LOG(LOG_VERBOSE, "Sent %d segments of %d bytes via socket %d to %s<%u>", tChunk, (int)tSegmentSize, mSocketHandle, mDestinationHost.c_str(), mDestinationPort);
+                #endif
+            }
+        }
+    #endif
+
+    // fall back to batched transmissions
+    if (tSentSegments < pSegmentCount)
+        return SendBatch(&pSegments[tSentSegments], pSegmentCount - tSentSegments);
+
+    return true;
+}
+
+bool Socket::EnableReceiveOffload(bool pActive)
+{
+    bool tResult = false;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return false;
+    }
+
+    #if defined(LINUX)
+        if (mSocketTransportType == SOCKET_UDP)
+        {
+            int tGroOptionValue = pActive;
+            if (setsockopt(mSocketHandle, SOL_UDP, UDP_GRO, (char*)&tGroOptionValue, sizeof(tGroOptionValue)) < 0)
+                LOG(LOG_WARN, "Failed to set socket option UDP_GRO on socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+            else
+            {
+                LOG(LOG_VERBOSE, "%s receive offload for socket %d", pActive ? "Enabled" : "Disabled", mSocketHandle);
+                mReceiveOffload = pActive;
+                tResult = true;
+            }
+        }
+    #endif
+
+    return tResult;
+}
+
 bool Socket::Receive(string &pSourceHost, unsigned int &pSourcePort, void *pBuffer, ssize_t &pBufferSize)
 {
     ssize_t                 tReceivedBytes = 0;
@@ -1312,6 +1882,7 @@ bool Socket::CreateSocket(enum NetworkType pIpVersion)
 					tResult = true;
 				break;
 			}
+			// fall through - UDP-Lite isn't supported, use UDP instead
         case SOCKET_UDP:
             if ((mSocketHandle = (int)socket(tSelectedIPDomain, SOCK_DGRAM, IPPROTO_UDP)) < 0)
                 LOG(LOG_ERROR, "Could not create UDP socket");
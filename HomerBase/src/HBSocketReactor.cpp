@@ -0,0 +1,375 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a reactor which serves many sockets by a small number of I/O threads
+ * Since:   2026-10-17
+ */
+
+#include <HBSocketReactor.h>
+#include <HBSystem.h>
+#include <Logger.h>
+
+#include <string.h>
+#include <errno.h>
+#if defined(LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+SocketReactor sSocketReactor;
+
+bool SocketReactor::sReactorActive = false;
+
+///////////////////////////////////////////////////////////////////////////////
+
+SocketReactorThread::SocketReactorThread(int pIndex)
+{
+    mIndex = pIndex;
+    mEventHandle = -1;
+    mThreadNeeded = true;
+    mRegistrationsMutex.AssignName("SocketReactorRegistrations");
+}
+
+SocketReactorThread::~SocketReactorThread()
+{
+    #if defined(LINUX)
+        if (mEventHandle != -1)
+            close(mEventHandle);
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactorThread::Init()
+{
+    #if defined(LINUX)
+        mEventHandle = epoll_create1(EPOLL_CLOEXEC);
+        if (mEventHandle == -1)
+        {
+            LOG(LOG_ERROR, "Failed to create event handle for I/O thread %d because of \"%s\"(%d)", mIndex, strerror(errno), errno);
+            return false;
+        }
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+bool SocketReactorThread::AddSocket(Socket *pSocket, SocketReactorHandler *pHandler)
+{
+    bool tResult = false;
+
+    #if defined(LINUX)
+        int tHandle = pSocket->GetHandle();
+        struct epoll_event tEvent;
+
+        memset(&tEvent, 0, sizeof(tEvent));
+        tEvent.events = EPOLLIN;
+        tEvent.data.fd = tHandle;
+
+        mRegistrationsMutex.lock();
+        if (epoll_ctl(mEventHandle, EPOLL_CTL_ADD, tHandle, &tEvent) < 0)
+        {
+            LOG(LOG_ERROR, "Failed to add socket %d to I/O thread %d because of \"%s\"(%d)", tHandle, mIndex, strerror(errno), errno);
+        }else
+        {
+            mRegistrations[tHandle].DataSocket = pSocket;
+            mRegistrations[tHandle].Handler = pHandler;
+            LOG(LOG_VERBOSE, "Socket %d is served by I/O thread %d, %d sockets are served by this thread", tHandle, mIndex, (int)mRegistrations.size());
+            tResult = true;
+        }
+        mRegistrationsMutex.unlock();
+    #endif
+
+    return tResult;
+}
+
+bool SocketReactorThread::RemoveSocket(Socket *pSocket)
+{
+    bool tResult = false;
+
+    #if defined(LINUX)
+        int tHandle = pSocket->GetHandle();
+        SocketReactorRegistrations::iterator tIt;
+
+        // waits for the end of a running dispatch
+        mRegistrationsMutex.lock();
+        tIt = mRegistrations.find(tHandle);
+        if ((tIt != mRegistrations.end()) && (tIt->second.DataSocket == pSocket))
+        {
+            //HINT: a closed socket was already removed from the event set by the kernel
+            epoll_ctl(mEventHandle, EPOLL_CTL_DEL, tHandle, NULL);
+            mRegistrations.erase(tIt);
+            LOG(LOG_VERBOSE, "Socket %d isn't served by I/O thread %d anymore", tHandle, mIndex);
+            tResult = true;
+        }
+        mRegistrationsMutex.unlock();
+    #endif
+
+    return tResult;
+}
+
+int SocketReactorThread::GetSocketCount()
+{
+    int tResult;
+
+    mRegistrationsMutex.lock();
+    tResult = (int)mRegistrations.size();
+    mRegistrationsMutex.unlock();
+
+    return tResult;
+}
+
+void SocketReactorThread::Stop()
+{
+    mThreadNeeded = false;
+    StopThread();
+}
+
+void* SocketReactorThread::Run(void* pArgs)
+{
+    LOG(LOG_VERBOSE, "Socket reactor I/O thread %d started", mIndex);
+
+    #if defined(LINUX)
+        struct epoll_event tEvents[SOCKET_REACTOR_MAX_EVENTS];
+
+        while (mThreadNeeded)
+        {
+            int tEventCount = epoll_wait(mEventHandle, tEvents, SOCKET_REACTOR_MAX_EVENTS, SOCKET_REACTOR_WAIT_TIME);
+            if (tEventCount < 0)
+            {
+                if (errno != EINTR)
+                {
+                    LOG(LOG_ERROR, "Failed to wait for events in I/O thread %d because of \"%s\"(%d)", mIndex, strerror(errno), errno);
+                    break;
+                }
+                continue;
+            }
+
+            #ifdef HB_DEBUG_SOCKET_REACTOR
+                if (tEventCount > 1)
+                    LOG(LOG_VERBOSE, "I/O thread %d got %d events", mIndex, tEventCount);
+            #endif
+
+            // the registrations are locked during the dispatch, hence no handler is called after its socket was removed
+            mRegistrationsMutex.lock();
+            for (int i = 0; i < tEventCount; i++)
+            {
+                SocketReactorRegistrations::iterator tIt = mRegistrations.find(tEvents[i].data.fd);
+                if (tIt == mRegistrations.end())
+                    continue;
+
+                // errors are delivered to the handler by its next read attempt
+                if (!tIt->second.Handler->HandleSocketInput(tIt->second.DataSocket))
+                {
+                    LOG(LOG_WARN, "Handler of socket %d requested its removal from I/O thread %d", tIt->first, mIndex);
+                    epoll_ctl(mEventHandle, EPOLL_CTL_DEL, tIt->first, NULL);
+                    mRegistrations.erase(tIt);
+                }
+            }
+            mRegistrationsMutex.unlock();
+        }
+    #endif
+
+    LOG(LOG_VERBOSE, "Socket reactor I/O thread %d finished", mIndex);
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SocketReactor::SocketReactor()
+{
+    mThreads = NULL;
+    mThreadCount = 0;
+    mRunning = false;
+}
+
+SocketReactor::~SocketReactor()
+{
+    Stop();
+}
+
+SocketReactor& SocketReactor::GetInstance()
+{
+    return sSocketReactor;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::Start(int pThreadCount)
+{
+    #if defined(LINUX)
+        mStartMutex.lock();
+        if (mRunning)
+        {
+            mStartMutex.unlock();
+            return true;
+        }
+
+        if (pThreadCount < 1)
+        {
+            pThreadCount = System::GetMachineCores();
+            if (pThreadCount > SOCKET_REACTOR_MAX_THREADS)
+                pThreadCount = SOCKET_REACTOR_MAX_THREADS;
+        }
+        if (pThreadCount < 1)
+            pThreadCount = 1;
+
+        LOG(LOG_VERBOSE, "Starting socket reactor with %d I/O threads", pThreadCount);
+
+        mThreads = (SocketReactorThread**)malloc(pThreadCount * sizeof(SocketReactorThread*));
+        for (int i = 0; i < pThreadCount; i++)
+        {
+            mThreads[i] = new SocketReactorThread(i);
+            if (!mThreads[i]->Init())
+            {
+                for (int j = 0; j <= i; j++)
+                    delete mThreads[j];
+                free(mThreads);
+                mThreads = NULL;
+                mStartMutex.unlock();
+                return false;
+            }
+        }
+        mThreadCount = pThreadCount;
+
+        for (int i = 0; i < mThreadCount; i++)
+            mThreads[i]->StartThread();
+
+        mRunning = true;
+        mStartMutex.unlock();
+
+        return true;
+    #else
+        LOG(LOG_WARN, "Socket reactor isn't supported on this platform");
+        return false;
+    #endif
+}
+
+void SocketReactor::Stop()
+{
+    mStartMutex.lock();
+    if (!mRunning)
+    {
+        mStartMutex.unlock();
+        return;
+    }
+
+    LOG(LOG_VERBOSE, "Stopping socket reactor with %d I/O threads", mThreadCount);
+
+    mRunning = false;
+    for (int i = 0; i < mThreadCount; i++)
+    {
+        mThreads[i]->Stop();
+        int tRemainingSockets = mThreads[i]->GetSocketCount();
+        if (tRemainingSockets > 0)
+            LOG(LOG_WARN, "Dropping %d sockets of I/O thread %d", tRemainingSockets, i);
+        delete mThreads[i];
+    }
+    free(mThreads);
+    mThreads = NULL;
+    mThreadCount = 0;
+
+    mStartMutex.unlock();
+}
+
+bool SocketReactor::IsRunning()
+{
+    return mRunning;
+}
+
+int SocketReactor::GetThreadCount()
+{
+    return mThreadCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::Register(Socket *pSocket, SocketReactorHandler *pHandler)
+{
+    bool tResult = false;
+
+    if ((pSocket == NULL) || (pHandler == NULL) || (pSocket->GetHandle() == -1))
+    {
+        LOG(LOG_ERROR, "Invalid socket registration");
+        return false;
+    }
+
+    if ((!mRunning) && (!Start()))
+        return false;
+
+    mStartMutex.lock();
+    if (mRunning)
+    {
+        // balance the sockets among the I/O threads
+        int tThread = 0;
+        int tThreadSockets = mThreads[0]->GetSocketCount();
+        for (int i = 1; i < mThreadCount; i++)
+        {
+            int tSockets = mThreads[i]->GetSocketCount();
+            if (tSockets < tThreadSockets)
+            {
+                tThread = i;
+                tThreadSockets = tSockets;
+            }
+        }
+        tResult = mThreads[tThread]->AddSocket(pSocket, pHandler);
+    }
+    mStartMutex.unlock();
+
+    return tResult;
+}
+
+void SocketReactor::Unregister(Socket *pSocket)
+{
+    if (pSocket == NULL)
+        return;
+
+    mStartMutex.lock();
+    for (int i = 0; i < mThreadCount; i++)
+    {
+        if (mThreads[i]->RemoveSocket(pSocket))
+            break;
+    }
+    mStartMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SocketReactor::ActivateReactor(bool pActive)
+{
+    sReactorActive = pActive;
+}
+
+bool SocketReactor::ReactorActivated()
+{
+    return sReactorActive;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
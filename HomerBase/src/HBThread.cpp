@@ -27,6 +27,7 @@
 #include <HBThread.h>
 #include <HBMutex.h>
 #include <HBSystem.h>
+#include <HBTime.h>
 #include <Logger.h>
 
 #include <Header_Windows.h>
@@ -45,6 +46,8 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
+#include <sched.h>
+#include <sys/resource.h>
 #endif
 
 #ifdef APPLE
@@ -62,6 +65,10 @@ using namespace std;
 Thread::Thread()
 {
 	mRunning = false;
+    mStarted = false;
+    mReady = false;
+    mWakeUpPending = false;
+    mWakeUpTime = 0;
     mThreadHandle = 0;
     mThreadId = -1;
     LOG(LOG_VERBOSE, "Created thread object");
@@ -161,6 +168,33 @@ unsigned long Thread::GetMemoryAllocationSize(int pThreadID)
 }
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+
+struct ThreadSchedulingEntry
+{
+    enum ThreadSchedulingClass  Class;
+    enum ThreadSchedulingClass  EffectiveClass;
+    int64_t                     LatencySum;
+    int64_t                     LatencyCount;
+    int64_t                     LatencyMax;
+};
+
+// scheduling classes of all threads which have declared one, indexed by thread id
+std::map<int, ThreadSchedulingEntry*> sThreadScheduling;
+Mutex sThreadSchedulingMutex("ThreadSchedulingMutex");
+
+#if defined(_MSC_VER)
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL __thread
+#endif
+
+// entry of the calling thread: Suspend() updates the latency statistic without the global mutex and the lookup in the map
+//HINT: only the owning thread writes the latency values, other threads read them under sThreadSchedulingMutex
+static THREAD_LOCAL ThreadSchedulingEntry *sOwnThreadScheduling = NULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
 void Thread::DeactivateMemoryDebugger()
 {
 
@@ -181,6 +215,7 @@ void Thread::Suspend(unsigned int pUSecs)
 {
 	if (pUSecs < 1)
 		return;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
 		if (usleep(pUSecs) != 0)
 			LOGEX(Thread, LOG_ERROR, "Error from usleep: \"%s\"", strerror(errno));
@@ -188,6 +223,235 @@ void Thread::Suspend(unsigned int pUSecs)
 	#if defined(WINDOWS)
 		Sleep(pUSecs / 1000);
 	#endif
+    // the time we slept longer than requested is the delay until the scheduler has given the cpu back to us
+    AnnounceSchedulingLatency(Time::GetMonotonicTimeStamp() - tStartTime - pUSecs);
+}
+
+bool Thread::SetSchedulingClass(enum ThreadSchedulingClass pClass)
+{
+    enum ThreadSchedulingClass tEffectiveClass = pClass;
+    int tTid = GetTId();
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        struct sched_param tSchedulingParameters;
+        if (pClass == THREAD_SCHEDULING_REALTIME)
+        {
+            int tPolicy = SCHED_FIFO;
+            tSchedulingParameters.sched_priority = THREAD_REALTIME_PRIORITY;
+            if (tSchedulingParameters.sched_priority > sched_get_priority_max(tPolicy))
+                tSchedulingParameters.sched_priority = sched_get_priority_max(tPolicy);
+            if (int tRes = pthread_setschedparam(pthread_self(), tPolicy, &tSchedulingParameters))
+            {
+                LOGEX(Thread, LOG_VERBOSE, "SCHED_FIFO denied for thread %d because \"%s\", trying SCHED_RR", tTid, strerror(tRes));
+                tPolicy = SCHED_RR;
+                if ((tRes = pthread_setschedparam(pthread_self(), tPolicy, &tSchedulingParameters)))
+                {
+                    LOGEX(Thread, LOG_WARN, "Real-time scheduling denied for thread %d because \"%s\", falling back to high priority", tTid, strerror(tRes));
+                    tEffectiveClass = THREAD_SCHEDULING_HIGH;
+                }
+            }
+        }
+    #endif
+    #if defined(LINUX)
+        if (tEffectiveClass != THREAD_SCHEDULING_REALTIME)
+        {
+            // leave real-time scheduling if it was active before
+            tSchedulingParameters.sched_priority = 0;
+            pthread_setschedparam(pthread_self(), SCHED_OTHER, &tSchedulingParameters);
+
+            // HINT: nice levels are per thread in Linux
+            int tNiceLevel = 0;
+            if (tEffectiveClass == THREAD_SCHEDULING_HIGH)
+                tNiceLevel = THREAD_NICE_LEVEL_HIGH;
+            if (tEffectiveClass == THREAD_SCHEDULING_BACKGROUND)
+                tNiceLevel = THREAD_NICE_LEVEL_BACKGROUND;
+            if (setpriority(PRIO_PROCESS, tTid, tNiceLevel) != 0)
+            {
+                LOGEX(Thread, LOG_WARN, "Nice level %d denied for thread %d because \"%s\", keeping normal priority", tNiceLevel, tTid, strerror(errno));
+                tEffectiveClass = THREAD_SCHEDULING_NORMAL;
+            }
+        }
+    #endif
+    #if defined(APPLE) || defined(BSD)
+        if (tEffectiveClass != THREAD_SCHEDULING_REALTIME)
+        {
+            // no per-thread nice levels, use the priority range of SCHED_OTHER instead
+            int tMinPriority = sched_get_priority_min(SCHED_OTHER);
+            int tMaxPriority = sched_get_priority_max(SCHED_OTHER);
+            tSchedulingParameters.sched_priority = (tMinPriority + tMaxPriority) / 2;
+            if (tEffectiveClass == THREAD_SCHEDULING_HIGH)
+                tSchedulingParameters.sched_priority = tMaxPriority;
+            if (tEffectiveClass == THREAD_SCHEDULING_BACKGROUND)
+                tSchedulingParameters.sched_priority = tMinPriority;
+            if (int tRes = pthread_setschedparam(pthread_self(), SCHED_OTHER, &tSchedulingParameters))
+            {
+                LOGEX(Thread, LOG_WARN, "Priority %d denied for thread %d because \"%s\", keeping normal priority", tSchedulingParameters.sched_priority, tTid, strerror(tRes));
+                tEffectiveClass = THREAD_SCHEDULING_NORMAL;
+            }
+        }
+    #endif
+    #if defined(WINDOWS)
+        int tPriority = THREAD_PRIORITY_NORMAL;
+        switch(pClass)
+        {
+            case THREAD_SCHEDULING_REALTIME:
+                tPriority = THREAD_PRIORITY_TIME_CRITICAL;
+                break;
+            case THREAD_SCHEDULING_HIGH:
+                tPriority = THREAD_PRIORITY_HIGHEST;
+                break;
+            case THREAD_SCHEDULING_BACKGROUND:
+                tPriority = THREAD_PRIORITY_BELOW_NORMAL;
+                break;
+            default:
+                break;
+        }
+        if (!SetThreadPriority(GetCurrentThread(), tPriority))
+        {
+            LOGEX(Thread, LOG_WARN, "Priority %d denied for thread %d because of code \"%d\", keeping normal priority", tPriority, tTid, GetLastError());
+            tEffectiveClass = THREAD_SCHEDULING_NORMAL;
+        }
+    #endif
+
+    LOGEX(Thread, LOG_VERBOSE, "Thread %d uses scheduling class %s (requested: %s)", tTid, SchedulingClass2String(tEffectiveClass).c_str(), SchedulingClass2String(pClass).c_str());
+
+    sThreadSchedulingMutex.lock();
+    ThreadSchedulingEntry *tEntry = sThreadScheduling[tTid];
+    // an entry which doesn't belong to the calling thread is left over from a terminated thread with the same id
+    if ((tEntry != NULL) && (tEntry != sOwnThreadScheduling))
+        delete tEntry;
+    if (sOwnThreadScheduling == NULL)
+        sOwnThreadScheduling = new ThreadSchedulingEntry();
+    tEntry = sOwnThreadScheduling;
+    tEntry->Class = pClass;
+    tEntry->EffectiveClass = tEffectiveClass;
+    tEntry->LatencySum = 0;
+    tEntry->LatencyCount = 0;
+    tEntry->LatencyMax = 0;
+    sThreadScheduling[tTid] = tEntry;
+    sThreadSchedulingMutex.unlock();
+
+    return (tEffectiveClass == pClass);
+}
+
+bool Thread::SetCpuAffinity(uint64_t pCpuMask)
+{
+    bool tResult = false;
+
+    if (pCpuMask == 0)
+    {
+        LOGEX(Thread, LOG_ERROR, "Empty cpu affinity mask given");
+        return false;
+    }
+
+    #if defined(LINUX)
+        cpu_set_t tCpuSet;
+        CPU_ZERO(&tCpuSet);
+        for (int i = 0; i < 64; i++)
+        {
+            if (pCpuMask & ((uint64_t)1 << i))
+                CPU_SET(i, &tCpuSet);
+        }
+        if (int tRes = pthread_setaffinity_np(pthread_self(), sizeof(tCpuSet), &tCpuSet))
+            LOGEX(Thread, LOG_ERROR, "Setting cpu affinity mask 0x%"PRIx64" for thread %d failed because \"%s\"", pCpuMask, GetTId(), strerror(tRes));
+        else
+            tResult = true;
+    #endif
+    #if defined(APPLE) || defined(BSD)
+        // OSX supports only affinity tags as hints for the scheduler and no cpu masks
+        LOGEX(Thread, LOG_WARN, "Cpu affinity mask 0x%" PRIx64 " for thread %d ignored, cpu affinity masks aren't supported for this OS", pCpuMask, GetTId());
+    #endif
+    #if defined(WINDOWS)
+        if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)pCpuMask) == 0)
+            LOGEX(Thread, LOG_ERROR, "Setting cpu affinity mask 0x%"PRIx64" for thread %d failed because of code \"%d\"", pCpuMask, GetTId(), GetLastError());
+        else
+            tResult = true;
+    #endif
+
+    if (tResult)
+        LOGEX(Thread, LOG_VERBOSE, "Thread %d uses cpu affinity mask 0x%"PRIx64"", GetTId(), pCpuMask);
+
+    return tResult;
+}
+
+bool Thread::GetSchedulingStatistic(int pTid, enum ThreadSchedulingClass &pClass, enum ThreadSchedulingClass &pEffectiveClass, int64_t &pLatencyAvg, int64_t &pLatencyMax)
+{
+    bool tResult = false;
+    std::map<int, ThreadSchedulingEntry*>::iterator tIt;
+
+    pClass = THREAD_SCHEDULING_NORMAL;
+    pEffectiveClass = THREAD_SCHEDULING_NORMAL;
+    pLatencyAvg = 0;
+    pLatencyMax = 0;
+
+    sThreadSchedulingMutex.lock();
+    tIt = sThreadScheduling.find(pTid);
+    if (tIt != sThreadScheduling.end())
+    {
+        ThreadSchedulingEntry *tEntry = tIt->second;
+        int64_t tLatencySum = __sync_fetch_and_add(&tEntry->LatencySum, 0);
+        int64_t tLatencyCount = __sync_fetch_and_add(&tEntry->LatencyCount, 0);
+        pClass = tEntry->Class;
+        pEffectiveClass = tEntry->EffectiveClass;
+        if (tLatencyCount > 0)
+            pLatencyAvg = tLatencySum / tLatencyCount;
+        pLatencyMax = __sync_fetch_and_add(&tEntry->LatencyMax, 0);
+        tResult = true;
+    }
+    sThreadSchedulingMutex.unlock();
+
+    return tResult;
+}
+
+//HINT: pTid has to be the calling thread or a terminated one, otherwise the entry would be deleted while its thread uses it
+void Thread::ResetSchedulingStatistic(int pTid)
+{
+    std::map<int, ThreadSchedulingEntry*>::iterator tIt;
+
+    sThreadSchedulingMutex.lock();
+    tIt = sThreadScheduling.find(pTid);
+    if (tIt != sThreadScheduling.end())
+    {
+        if (tIt->second == sOwnThreadScheduling)
+            sOwnThreadScheduling = NULL;
+        delete tIt->second;
+        sThreadScheduling.erase(tIt);
+    }
+    sThreadSchedulingMutex.unlock();
+}
+
+void Thread::AnnounceSchedulingLatency(int64_t pLatency)
+{
+    ThreadSchedulingEntry *tEntry = sOwnThreadScheduling;
+
+    // only threads which have declared a scheduling class are observed
+    if (tEntry == NULL)
+        return;
+
+    if (pLatency < 0)
+        pLatency = 0;
+
+    __sync_add_and_fetch(&tEntry->LatencySum, pLatency);
+    __sync_add_and_fetch(&tEntry->LatencyCount, 1);
+    if (pLatency > tEntry->LatencyMax)
+        __sync_lock_test_and_set(&tEntry->LatencyMax, pLatency);
+}
+
+string Thread::SchedulingClass2String(enum ThreadSchedulingClass pClass)
+{
+    switch(pClass)
+    {
+        case THREAD_SCHEDULING_BACKGROUND:
+            return "background";
+        case THREAD_SCHEDULING_NORMAL:
+            return "normal";
+        case THREAD_SCHEDULING_HIGH:
+            return "high";
+        case THREAD_SCHEDULING_REALTIME:
+            return "real-time";
+        default:
+            return "unknown";
+    }
 }
 
 int Thread::GetTId()
@@ -760,10 +1024,18 @@ void* Thread::StartThreadStaticWrapperUniversal(void* pThread)
 
     Thread *tThreadObject = (Thread*)pThread;
     tThreadObject->mThreadId = GetTId();
+    tThreadObject->mStateMutex.lock();
     tThreadObject->mRunning = true;
+    tThreadObject->mStarted = true;
+    tThreadObject->mStateCondition.Signal();
+    tThreadObject->mStateMutex.unlock();
     void* tResult = tThreadObject->mThreadMain(tThreadObject->mThreadArguments);
-    tThreadObject->mRunning = false;
+    ResetSchedulingStatistic(tThreadObject->mThreadId);
     tThreadObject->CloseThread();
+    tThreadObject->mStateMutex.lock();
+    tThreadObject->mRunning = false;
+    tThreadObject->mStateCondition.Signal();
+    tThreadObject->mStateMutex.unlock();
     LOGEX(Thread, LOG_VERBOSE, "Thread %d finished", GetTId());
     return tResult;
 }
@@ -774,10 +1046,18 @@ void* Thread::StartThreadStaticWrapperRun(void* pThread)
 
     Thread *tThreadObject = (Thread*)pThread;
     tThreadObject->mThreadId = GetTId();
+    tThreadObject->mStateMutex.lock();
     tThreadObject->mRunning = true;
+    tThreadObject->mStarted = true;
+    tThreadObject->mStateCondition.Signal();
+    tThreadObject->mStateMutex.unlock();
     void* tResult = tThreadObject->Run(tThreadObject->mThreadArguments);
-    tThreadObject->mRunning = false;
+    ResetSchedulingStatistic(tThreadObject->mThreadId);
     tThreadObject->CloseThread();
+    tThreadObject->mStateMutex.lock();
+    tThreadObject->mRunning = false;
+    tThreadObject->mStateCondition.Signal();
+    tThreadObject->mStateMutex.unlock();
     LOGEX(Thread, LOG_VERBOSE, "Thread %d finished (Run method)", GetTId());
     return tResult;
 }
@@ -800,6 +1080,7 @@ bool Thread::StartThread(void* pArgs)
 
     mThreadMain = 0;
     mThreadArguments = pArgs;
+    ResetStateSignaling();
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
         size_t tThreadStackSize;
@@ -859,6 +1140,7 @@ bool Thread::StartThread(THREAD_MAIN pMain, void* pArgs)
 
 	mThreadMain = pMain;
 	mThreadArguments = pArgs;
+    ResetStateSignaling();
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
 		size_t tThreadStackSize;
@@ -994,4 +1276,122 @@ bool Thread::IsRunning()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void Thread::ResetStateSignaling()
+{
+    mStateMutex.lock();
+    mStarted = false;
+    mReady = false;
+    mWakeUpPending = false;
+    mStateMutex.unlock();
+}
+
+bool Thread::WaitForStateChange(int64_t pStartTime, int pTimeoutInMSecs)
+{
+    if (pTimeoutInMSecs <= 0)
+        return mStateCondition.Wait(&mStateMutex);
+
+    // spurious wake ups and foreign state changes are possible, hence we wait only for the remaining time
+    int64_t tRemainingTime = (int64_t)pTimeoutInMSecs - (Time::GetMonotonicTimeStamp() - pStartTime) / 1000;
+    if (tRemainingTime <= 0)
+        return false;
+    mStateCondition.Wait(&mStateMutex, (int)tRemainingTime);
+
+    return true;
+}
+
+bool Thread::WaitForStart(int pTimeoutInMSecs)
+{
+    bool tResult;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    mStateMutex.lock();
+    while (!mStarted)
+    {
+        if (!WaitForStateChange(tStartTime, pTimeoutInMSecs))
+            break;
+    }
+    tResult = mStarted;
+    mStateMutex.unlock();
+
+    return tResult;
+}
+
+bool Thread::WaitForReady(int pTimeoutInMSecs)
+{
+    bool tResult;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    mStateMutex.lock();
+    while ((!mReady) && (!((mStarted) && (!mRunning))))
+    {
+        if (!WaitForStateChange(tStartTime, pTimeoutInMSecs))
+            break;
+    }
+    tResult = mReady;
+    mStateMutex.unlock();
+
+    return tResult;
+}
+
+bool Thread::WaitForTermination(int pTimeoutInMSecs)
+{
+    bool tResult;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    mStateMutex.lock();
+    while (mRunning)
+    {
+        if (!WaitForStateChange(tStartTime, pTimeoutInMSecs))
+            break;
+    }
+    tResult = !mRunning;
+    mStateMutex.unlock();
+
+    return tResult;
+}
+
+bool Thread::SuspendUntilWakeUp(int pTimeoutInMSecs)
+{
+    bool tResult;
+    int64_t tWakeUpTime;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    mStateMutex.lock();
+    while (!mWakeUpPending)
+    {
+        if (!WaitForStateChange(tStartTime, pTimeoutInMSecs))
+            break;
+    }
+    tResult = mWakeUpPending;
+    tWakeUpTime = mWakeUpTime;
+    mWakeUpPending = false;
+    mStateMutex.unlock();
+
+    // the time since WakeUp() is the delay until the scheduler has given the cpu to us
+    if (tResult)
+        AnnounceSchedulingLatency(Time::GetMonotonicTimeStamp() - tWakeUpTime);
+
+    return tResult;
+}
+
+void Thread::WakeUp()
+{
+    mStateMutex.lock();
+    if (!mWakeUpPending)
+        mWakeUpTime = Time::GetMonotonicTimeStamp();
+    mWakeUpPending = true;
+    mStateCondition.Signal();
+    mStateMutex.unlock();
+}
+
+void Thread::AnnounceReady()
+{
+    mStateMutex.lock();
+    mReady = true;
+    mStateCondition.Signal();
+    mStateMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }} //namespace
@@ -34,6 +34,11 @@
 #include <sys/time.h>
 #endif
 
+#ifdef APPLE
+// to get monotonic time stamps
+#include <mach/mach_time.h>
+#endif
+
 #include <Header_Windows.h>
 
 namespace Homer { namespace Base {
@@ -42,6 +47,12 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// mapping from monotonic clock to wall clock: wall clock = monotonic clock + offset
+static int64_t sWallClockOffset = 0; // in s
+static int64_t sWallClockCalibrationTime = 0; // in s, monotonic
+
+///////////////////////////////////////////////////////////////////////////////
+
 Time::Time()
 {
     mTimeStamp = 0;
@@ -95,6 +106,68 @@ int64_t Time::GetTimeStamp()
 	return tResult;
 }
 
+int64_t Time::GetMonotonicNanoTime()
+{
+    int64_t tResult = 0;
+    #if defined(LINUX) || defined(BSD)
+        struct timespec tTimeSpec;
+        clock_gettime(CLOCK_MONOTONIC, &tTimeSpec);
+        tResult = (int64_t)1000 * 1000 * 1000 * tTimeSpec.tv_sec + tTimeSpec.tv_nsec;
+    #endif
+
+    #if defined(APPLE)
+        static mach_timebase_info_data_t sTimeBase = {0, 0};
+        if (sTimeBase.denom == 0)
+            mach_timebase_info(&sTimeBase);
+        tResult = (int64_t)(mach_absolute_time() * sTimeBase.numer / sTimeBase.denom);
+    #endif
+
+    #ifdef WINDOWS
+        static LARGE_INTEGER sFrequency = {0};
+        LARGE_INTEGER tCounter;
+        if (sFrequency.QuadPart == 0)
+            QueryPerformanceFrequency(&sFrequency);
+        QueryPerformanceCounter(&tCounter);
+        // split the conversion to avoid an overflow of the 64 bit value
+        tResult = (int64_t)(tCounter.QuadPart / sFrequency.QuadPart) * 1000 * 1000 * 1000 + (int64_t)(tCounter.QuadPart % sFrequency.QuadPart) * 1000 * 1000 * 1000 / sFrequency.QuadPart;
+    #endif
+
+    return tResult;
+}
+
+int64_t Time::GetMonotonicTimeStamp()
+{
+    return GetMonotonicNanoTime() / 1000;
+}
+
+void Time::CalibrateWallClock(int64_t pMonotonicTimeStamp)
+{
+    // sample the wall clock between two monotonic time stamps and assume it was taken in the middle
+    int64_t tMonotonicBefore = GetMonotonicTimeStamp();
+    int64_t tWallClock = GetTimeStamp();
+    int64_t tMonotonicAfter = GetMonotonicTimeStamp();
+
+    // publish the offset before the calibration time, concurrent calibrations deliver nearly the same result
+    __sync_lock_test_and_set(&sWallClockOffset, tWallClock - (tMonotonicBefore + tMonotonicAfter) / 2);
+    __sync_synchronize();
+    __sync_lock_test_and_set(&sWallClockCalibrationTime, pMonotonicTimeStamp);
+}
+
+int64_t Time::ConvertMonotonicToWallClock(int64_t pMonotonicTimeStamp)
+{
+    int64_t tLastCalibrationTime = __sync_add_and_fetch(&sWallClockCalibrationTime, 0);
+
+    if ((tLastCalibrationTime == 0) || (pMonotonicTimeStamp - tLastCalibrationTime > TIME_WALL_CLOCK_CALIBRATION_PERIOD))
+        CalibrateWallClock(pMonotonicTimeStamp);
+
+    return pMonotonicTimeStamp + __sync_add_and_fetch(&sWallClockOffset, 0);
+}
+
+uint64_t Time::GetNtpTimeStamp()
+{
+    return (uint64_t)ConvertMonotonicToWallClock(GetMonotonicTimeStamp()) + TIME_NTP_OFFSET_US;
+}
+
 int64_t Time::UpdateTimeStamp()
 {
 	mTimeStamp = GetTimeStamp();
@@ -107,9 +180,14 @@ int64_t Time::TimeDiffInUSecs(Time *pTime)
 }
 
 bool Time::GetNow(int *pDay, int *pMonth, int *pYear, int *pHour, int *pMin, int *pSec)
+{
+    return GetLocalTime(GetTimeStamp(), pDay, pMonth, pYear, pHour, pMin, pSec);
+}
+
+bool Time::GetLocalTime(int64_t pTimeStamp, int *pDay, int *pMonth, int *pYear, int *pHour, int *pMin, int *pSec)
 {
     bool tResult = false;
-    time_t tTimeStamp = GetTimeStamp() / 1000000;
+    time_t tTimeStamp = pTimeStamp / 1000000;
     struct tm tLocalTimeData;
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
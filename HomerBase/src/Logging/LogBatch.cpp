@@ -0,0 +1,237 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of the binary format for batches of log messages
+ * Since:   2026-10-17
+ */
+
+#include <LogBatch.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void AppendVarint(string &pData, uint64_t pValue)
+{
+    while (pValue >= 0x80)
+    {
+        pData += (char)((pValue & 0x7F) | 0x80);
+        pValue >>= 7;
+    }
+    pData += (char)pValue;
+}
+
+static void AppendString(string &pData, const string &pString)
+{
+    AppendVarint(pData, pString.size());
+    pData += pString;
+}
+
+static bool ReadVarint(const unsigned char *pData, int pSize, int &pPos, uint64_t &pValue)
+{
+    int tShift = 0;
+
+    pValue = 0;
+    while ((pPos < pSize) && (tShift < 64))
+    {
+        unsigned char tByte = pData[pPos++];
+        pValue |= (uint64_t)(tByte & 0x7F) << tShift;
+        if ((tByte & 0x80) == 0)
+            return true;
+        tShift += 7;
+    }
+
+    return false;
+}
+
+static bool ReadString(const unsigned char *pData, int pSize, int &pPos, string &pString)
+{
+    uint64_t tLength;
+
+    if ((!ReadVarint(pData, pSize, pPos, tLength)) || (tLength > (uint64_t)(pSize - pPos)))
+        return false;
+
+    pString.assign((const char*)pData + pPos, (size_t)tLength);
+    pPos += (int)tLength;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+LogBatchEncoder::LogBatchEncoder(uint32_t pSessionId, int pMaxBatchSize)
+{
+    mSessionId = pSessionId;
+    mSequenceNumber = 0;
+    mMaxBatchSize = pMaxBatchSize;
+    mBaseTimeStamp = 0;
+    mLastTimeStamp = 0;
+}
+
+LogBatchEncoder::~LogBatchEncoder()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool LogBatchEncoder::AddMessage(int pLevel, int64_t pTimeStamp, const string &pSource, int pLine, const string &pMessage)
+{
+    string tRecord;
+    int tSourceId;
+    bool tNewSource = false;
+
+    if (mRecords.size() == 0)
+    {
+        mBaseTimeStamp = pTimeStamp;
+        mLastTimeStamp = pTimeStamp;
+    }
+
+    map<string, int>::iterator tIt = mSourceIds.find(pSource);
+    if (tIt == mSourceIds.end())
+    {
+        tSourceId = (int)mSourceIds.size();
+        tNewSource = true;
+        tRecord += (char)LOG_BATCH_RECORD_SOURCE;
+        AppendVarint(tRecord, tSourceId);
+        AppendString(tRecord, pSource);
+    }else
+        tSourceId = tIt->second;
+
+    int64_t tDelta = pTimeStamp - mLastTimeStamp;
+    tRecord += (char)LOG_BATCH_RECORD_MESSAGE;
+    AppendVarint(tRecord, pLevel);
+    AppendVarint(tRecord, tSourceId);
+    AppendVarint(tRecord, (pLine > 0) ? pLine : 0);
+    AppendVarint(tRecord, ((uint64_t)tDelta << 1) ^ (uint64_t)(tDelta >> 63));
+
+    int tFreeSpace = mMaxBatchSize - LOG_BATCH_MAX_HEADER_SIZE - (int)mRecords.size() - (int)tRecord.size() - 5 /* max. size of the length field */;
+    string tMessage = pMessage;
+    if ((int)tMessage.size() > tFreeSpace)
+    {
+        if (mRecords.size() > 0)
+            return false;
+
+        // an oversized message would never fit, hence it is truncated
+        if (tFreeSpace < 0)
+            tFreeSpace = 0;
+        tMessage = tMessage.substr(0, tFreeSpace);
+    }
+    AppendString(tRecord, tMessage);
+
+    if (tNewSource)
+        mSourceIds[pSource] = tSourceId;
+    mRecords += tRecord;
+    mLastTimeStamp = pTimeStamp;
+
+    return true;
+}
+
+bool LogBatchEncoder::IsEmpty()
+{
+    return (mRecords.size() == 0);
+}
+
+string LogBatchEncoder::GetBatch()
+{
+    string tResult = LOG_BATCH_MAGIC;
+
+    tResult += (char)LOG_BATCH_VERSION;
+    tResult += (char)0; // flags
+    tResult += (char)((mSessionId >> 24) & 0xFF);
+    tResult += (char)((mSessionId >> 16) & 0xFF);
+    tResult += (char)((mSessionId >> 8) & 0xFF);
+    tResult += (char)(mSessionId & 0xFF);
+    AppendVarint(tResult, mSequenceNumber);
+    AppendVarint(tResult, (uint64_t)mBaseTimeStamp);
+    tResult += mRecords;
+
+    mSequenceNumber++;
+    mRecords = "";
+    mSourceIds.clear();
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool LogBatchDecoder::Decode(const char *pData, int pSize, uint32_t &pSessionId, uint64_t &pSequenceNumber, LogBatchMessages &pMessages)
+{
+    const unsigned char *tData = (const unsigned char*)pData;
+    int tPos = 8;
+    uint64_t tValue;
+    map<uint64_t, string> tSources;
+
+    if ((pSize < 8) || (tData[0] != LOG_BATCH_MAGIC[0]) || (tData[1] != LOG_BATCH_MAGIC[1]) || (tData[2] != LOG_BATCH_VERSION))
+        return false;
+
+    pSessionId = ((uint32_t)tData[4] << 24) | ((uint32_t)tData[5] << 16) | ((uint32_t)tData[6] << 8) | (uint32_t)tData[7];
+    if (!ReadVarint(tData, pSize, tPos, pSequenceNumber))
+        return false;
+    if (!ReadVarint(tData, pSize, tPos, tValue))
+        return false;
+    int64_t tTimeStamp = (int64_t)tValue;
+
+    while (tPos < pSize)
+    {
+        switch(tData[tPos++])
+        {
+            case LOG_BATCH_RECORD_SOURCE:
+                {
+                    uint64_t tSourceId;
+                    string tSource;
+                    if ((!ReadVarint(tData, pSize, tPos, tSourceId)) || (!ReadString(tData, pSize, tPos, tSource)))
+                        return false;
+                    tSources[tSourceId] = tSource;
+                }
+                break;
+            case LOG_BATCH_RECORD_MESSAGE:
+                {
+                    LogBatchMessage tMessage;
+                    uint64_t tLevel, tSourceId, tLine, tDelta;
+                    if ((!ReadVarint(tData, pSize, tPos, tLevel)) || (!ReadVarint(tData, pSize, tPos, tSourceId)) || (!ReadVarint(tData, pSize, tPos, tLine)) || (!ReadVarint(tData, pSize, tPos, tDelta)) || (!ReadString(tData, pSize, tPos, tMessage.Message)))
+                        return false;
+                    tTimeStamp += (int64_t)(tDelta >> 1) ^ -(int64_t)(tDelta & 1);
+                    tMessage.Level = (int)tLevel;
+                    tMessage.TimeStamp = tTimeStamp;
+                    tMessage.Line = (int)tLine;
+                    map<uint64_t, string>::iterator tIt = tSources.find(tSourceId);
+                    if (tIt == tSources.end())
+                        return false;
+                    tMessage.Source = tIt->second;
+                    pMessages.push_back(tMessage);
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -0,0 +1,237 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: decoder for binary log batches of LogSinkNet
+ * Since:   2026-10-17
+ */
+
+#include <Logger.h>
+#include <LogBatch.h>
+#include <HBSocket.h>
+#include <HBTime.h>
+
+#include <map>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// maximum size of a received batch
+#define LOG_DECODER_MAX_BATCH_SIZE              64 * 1024
+
+///////////////////////////////////////////////////////////////////////////////
+
+// next expected sequence number per sender session
+static map<uint32_t, uint64_t> sSessions;
+
+static const char* Level2String(int pLevel)
+{
+    switch(pLevel)
+    {
+        case LOG_ERROR:
+            return "ERROR:  ";
+        case LOG_WARN:
+            return "WARN:   ";
+        case LOG_INFO:
+            return "INFO:   ";
+        case LOG_VERBOSE:
+            return "VERBOSE:";
+        case LOG_WORLD:
+            return "WORLD:  ";
+        default:
+            return "UNKNOWN:";
+    }
+}
+
+static void DecodeBatch(const char *pData, int pSize, string pSender)
+{
+    uint32_t tSessionId = 0;
+    uint64_t tSequenceNumber = 0;
+    LogBatchMessages tMessages;
+    LogBatchMessages::iterator tIt;
+
+    bool tValid = LogBatchDecoder::Decode(pData, pSize, tSessionId, tSequenceNumber, tMessages);
+
+    if (tMessages.size() > 0)
+    {
+        map<uint32_t, uint64_t>::iterator tSession = sSessions.find(tSessionId);
+        if (tSession == sSessions.end())
+        {
+            printf("### New session %08x from %s, starting with batch %"PRIu64"\n", tSessionId, pSender.c_str(), tSequenceNumber);
+        }else if (tSequenceNumber > tSession->second)
+        {
+            printf("### Lost %"PRIu64" batch(es) of session %08x\n", tSequenceNumber - tSession->second, tSessionId);
+        }else if (tSequenceNumber < tSession->second)
+        {
+            printf("### Reordered batch %"PRIu64" of session %08x\n", tSequenceNumber, tSessionId);
+        }
+        if ((tSession == sSessions.end()) || (tSequenceNumber >= tSession->second))
+            sSessions[tSessionId] = tSequenceNumber + 1;
+    }
+
+    for (tIt = tMessages.begin(); tIt != tMessages.end(); tIt++)
+    {
+        int tHour = 0, tMin = 0, tSec = 0;
+        Time::GetLocalTime(tIt->TimeStamp, NULL, NULL, NULL, &tHour, &tMin, &tSec);
+        printf("(%02d:%02d:%02d.%06d) %s %s(%d): %s\n", tHour, tMin, tSec, (int)(tIt->TimeStamp % 1000000), Level2String(tIt->Level), tIt->Source.c_str(), tIt->Line, tIt->Message.c_str());
+    }
+
+    if (!tValid)
+        printf("### Malformed batch of %d bytes from %s\n", pSize, pSender.c_str());
+
+    fflush(stdout);
+}
+
+static bool WriteCapture(FILE *pFile, const char *pData, int pSize)
+{
+    unsigned char tLength[2];
+
+    // batches are prefixed by their length in network byte order
+    tLength[0] = (unsigned char)((pSize >> 8) & 0xFF);
+    tLength[1] = (unsigned char)(pSize & 0xFF);
+
+    return ((fwrite(tLength, 1, 2, pFile) == 2) && (fwrite(pData, 1, pSize, pFile) == (size_t)pSize) && (fflush(pFile) == 0));
+}
+
+static int DecodeCapture(string pFileName)
+{
+    FILE *tFile = fopen(pFileName.c_str(), "rb");
+    char tBuffer[LOG_DECODER_MAX_BATCH_SIZE];
+    unsigned char tLength[2];
+
+    if (tFile == NULL)
+    {
+        printf("Unable to open capture file %s\n", pFileName.c_str());
+        return 1;
+    }
+
+    while (fread(tLength, 1, 2, tFile) == 2)
+    {
+        int tSize = ((int)tLength[0] << 8) | (int)tLength[1];
+        if (fread(tBuffer, 1, tSize, tFile) != (size_t)tSize)
+        {
+            printf("### Capture file %s is truncated\n", pFileName.c_str());
+            break;
+        }
+        DecodeBatch(tBuffer, tSize, pFileName);
+    }
+
+    fclose(tFile);
+
+    return 0;
+}
+
+static int DecodeNetwork(unsigned int pPort, enum NetworkType pIpVersion, string pCaptureFileName)
+{
+    Socket *tSocket = Socket::CreateServerSocket(pIpVersion, SOCKET_UDP, pPort);
+    FILE *tCaptureFile = NULL;
+    char tBuffer[LOG_DECODER_MAX_BATCH_SIZE];
+
+    if (tSocket == NULL)
+    {
+        printf("Unable to listen on UDP port %u\n", pPort);
+        return 1;
+    }
+
+    if (pCaptureFileName != "")
+    {
+        tCaptureFile = fopen(pCaptureFileName.c_str(), "ab");
+        if (tCaptureFile == NULL)
+            printf("Unable to open capture file %s, will only decode\n", pCaptureFileName.c_str());
+    }
+
+    printf("Waiting for log batches on UDP port %u\n", pPort);
+    for (;;)
+    {
+        string tSourceHost;
+        unsigned int tSourcePort;
+        ssize_t tSize = sizeof(tBuffer);
+
+        if (!tSocket->Receive(tSourceHost, tSourcePort, tBuffer, tSize))
+            break;
+        if (tSize <= 0)
+            continue;
+
+        if ((tCaptureFile != NULL) && (!WriteCapture(tCaptureFile, tBuffer, (int)tSize)))
+        {
+            printf("Unable to write to capture file %s, will only decode\n", pCaptureFileName.c_str());
+            fclose(tCaptureFile);
+            tCaptureFile = NULL;
+        }
+
+        DecodeBatch(tBuffer, (int)tSize, tSourceHost + ":" + toString(tSourcePort));
+    }
+
+    if (tCaptureFile != NULL)
+        fclose(tCaptureFile);
+    delete tSocket;
+
+    return 0;
+}
+
+static void ShowUsage()
+{
+    printf("Usage:\n");
+    printf("   HomerLogDecoder -Port=<port> [-Capture=<file>] [-IPv4]   decode log batches received on the given UDP port and store them optionally\n");
+    printf("   HomerLogDecoder -Input=<file>                          decode log batches from the given capture file\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int pArgc, char* pArgv[])
+{
+    string tInputFileName, tCaptureFileName;
+    unsigned int tPort = 0;
+    enum NetworkType tIpVersion = SOCKET_IPv6;
+
+    for (int i = 1; i < pArgc; i++)
+    {
+        string tArg = pArgv[i];
+        if (tArg.find("-Port=") == 0)
+            tPort = (unsigned int)atoi(tArg.substr(6).c_str());
+        else if (tArg.find("-Capture=") == 0)
+            tCaptureFileName = tArg.substr(9);
+        else if (tArg.find("-Input=") == 0)
+            tInputFileName = tArg.substr(7);
+        else if (tArg == "-IPv4")
+            tIpVersion = SOCKET_IPv4;
+        else
+        {
+            ShowUsage();
+            return 1;
+        }
+    }
+
+    if (tInputFileName != "")
+        return DecodeCapture(tInputFileName);
+
+    if (tPort != 0)
+        return DecodeNetwork(tPort, tIpVersion, tCaptureFileName);
+
+    ShowUsage();
+    return 1;
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of rate limitation and sampling of log messages
+ * Since:   2026-10-17
+ */
+
+#include <LogLimiter.h>
+#include <HBTime.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// one token in millionths, hence the bucket is refilled by pMaxPerSecond units per us
+#define LOG_LIMITER_TOKEN                       1000000
+
+///////////////////////////////////////////////////////////////////////////////
+
+LogRateLimiter::LogRateLimiter(int pMaxPerSecond)
+{
+    mMaxPerSecond = (pMaxPerSecond > 0) ? pMaxPerSecond : 1;
+    mTokens = (int64_t)mMaxPerSecond * LOG_LIMITER_TOKEN;
+    mLastRefillTime = Time::GetMonotonicTimeStamp();
+    mSuppressed = 0;
+}
+
+LogRateLimiter::~LogRateLimiter()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool LogRateLimiter::Allow(int64_t &pSuppressed)
+{
+    int64_t tMaxTokens = (int64_t)mMaxPerSecond * LOG_LIMITER_TOKEN;
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+    int64_t tLastRefillTime = mLastRefillTime;
+
+    // refill the bucket, only the thread which updates the refill time adds the tokens
+    if ((tNow > tLastRefillTime) && (__sync_bool_compare_and_swap(&mLastRefillTime, tLastRefillTime, tNow)))
+    {
+        int64_t tRefill = (tNow - tLastRefillTime) * mMaxPerSecond;
+        if (tRefill > tMaxTokens)
+            tRefill = tMaxTokens;
+        int64_t tTokens = __sync_add_and_fetch(&mTokens, tRefill);
+        if (tTokens > tMaxTokens)
+            __sync_bool_compare_and_swap(&mTokens, tTokens, tMaxTokens);
+    }
+
+    // take one token
+    int64_t tTokens = mTokens;
+    for (;;)
+    {
+        if (tTokens < LOG_LIMITER_TOKEN)
+        {
+            __sync_add_and_fetch(&mSuppressed, 1);
+            return false;
+        }
+        int64_t tOldTokens = __sync_val_compare_and_swap(&mTokens, tTokens, tTokens - LOG_LIMITER_TOKEN);
+        if (tOldTokens == tTokens)
+            break;
+        tTokens = tOldTokens;
+    }
+
+    pSuppressed = __sync_lock_test_and_set(&mSuppressed, 0);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+LogSampler::LogSampler(int pInterval)
+{
+    mInterval = (pInterval > 0) ? pInterval : 1;
+    mCount = 0;
+}
+
+LogSampler::~LogSampler()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool LogSampler::Allow(int64_t &pSuppressed)
+{
+    int64_t tCount = __sync_fetch_and_add(&mCount, 1);
+
+    if (tCount % mInterval != 0)
+        return false;
+
+    pSuppressed = (tCount > 0) ? mInterval - 1 : 0;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
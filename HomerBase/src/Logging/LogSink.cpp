@@ -25,6 +25,7 @@
  */
 
 #include <LogSink.h>
+#include <Logger.h>
 
 namespace Homer { namespace Base {
 
@@ -33,6 +34,8 @@ namespace Homer { namespace Base {
 LogSink::LogSink()
 {
     mLogSinkId = "undefined";
+    mBuffering = false;
+    mLogLevel = LOG_WORLD;
 }
 
 LogSink::~LogSink()
@@ -41,4 +44,17 @@ LogSink::~LogSink()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void LogSink::SetBuffering(bool pActive)
+{
+    mBuffering = pActive;
+    if (!mBuffering)
+        Flush();
+}
+
+void LogSink::Flush()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }} //namespace
@@ -82,10 +82,17 @@ void LogSinkFile::ProcessMessage(int pLevel, string pTime, string pSource, int p
                     fprintf(mFile, "(%s) WORLD: %s(%d): %s\n", pTime.c_str(), pSource.c_str(), pLine, pMessage.c_str());
                     break;
         }
-        fflush(mFile);
+        if (!mBuffering)
+            fflush(mFile);
     }
 }
 
+void LogSinkFile::Flush()
+{
+    if (mFile != NULL)
+        fflush(mFile);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }} //namespace
@@ -26,6 +26,8 @@
 
 #include <LogSinkNet.h>
 #include <Logger.h>
+#include <HBRandom.h>
+#include <HBTime.h>
 
 #include <string>
 #include <stdio.h>
@@ -38,19 +40,31 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-LogSinkNet::LogSinkNet(string pTargetHost, unsigned short pTargetPort)
+LogSinkNet::LogSinkNet(string pTargetHost, unsigned short pTargetPort, enum LogSinkNetFormat pFormat)
 {
     mBrokenPipe = false;
+    mDataSocket = NULL;
+    mFormat = pFormat;
+    mBatchEncoder = NULL;
+    if (mFormat == LOG_SINK_NET_BINARY)
+        mBatchEncoder = new LogBatchEncoder((uint32_t)Random::GenerateNumber(), LOG_SINK_NET_MAX_DATAGRAM_SIZE);
     mTargetHost = pTargetHost;
     mTargetPort = pTargetPort;
     mLogSinkId = "NET: " + mTargetHost + "<" + toString(mTargetPort) + ">";
     if ((mTargetHost != "") && (mTargetPort != 0))
+    {
         mDataSocket = Socket::CreateClientSocket(IS_IPV6_ADDRESS(mTargetHost) ? SOCKET_IPv6 : SOCKET_IPv4, SOCKET_UDP);
-    printf("Logging debug output via IPv%d to net %s:%u\n", IS_IPV6_ADDRESS(mTargetHost) ? SOCKET_IPv6 : SOCKET_IPv4, mTargetHost.c_str(), mTargetPort);
+        // the socket is used exclusively for this sink, hence it can be connected to the target
+        if ((mDataSocket != NULL) && (!mDataSocket->SetDestination(mTargetHost, mTargetPort, true)))
+            mBrokenPipe = true;
+    }
+    printf("Logging %s debug output via IPv%d to net %s:%u\n", (mFormat == LOG_SINK_NET_BINARY) ? "binary" : "text", IS_IPV6_ADDRESS(mTargetHost) ? SOCKET_IPv6 : SOCKET_IPv4, mTargetHost.c_str(), mTargetPort);
 }
 
 LogSinkNet::~LogSinkNet()
 {
+    Flush();
+    delete mBatchEncoder;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -71,6 +85,20 @@ void LogSinkNet::ProcessMessage(int pLevel, string pTime, string pSource, int pL
         return;
     }
 
+    if (mFormat == LOG_SINK_NET_BINARY)
+    {
+        // the time stamp replaces the formatted time string of the logger
+        int64_t tTimeStamp = Time::GetTimeStamp();
+        if (!mBatchEncoder->AddMessage(pLevel, tTimeStamp, pSource, pLine, pMessage))
+        {
+            Flush();
+            mBatchEncoder->AddMessage(pLevel, tTimeStamp, pSource, pLine, pMessage);
+        }
+        if (!mBuffering)
+            Flush();
+        return;
+    }
+
     string tData;
     tData += "LEVEL=" + toString(pLevel) + "\n";
     tData += "TIME=" + pTime + "\n";
@@ -78,7 +106,42 @@ void LogSinkNet::ProcessMessage(int pLevel, string pTime, string pSource, int pL
     tData += "LINE=" + toString(pLine) + "\n";
     tData += "MESSAGE=" + pMessage + "\n";
 
-    if (!mDataSocket->Send(mTargetHost, mTargetPort, (void*)tData.c_str(), (ssize_t)tData.size()))
+    if (mBuffering)
+    {
+        // the records are self-delimiting, hence several of them can be combined within one datagram
+        if ((mPendingData.size() > 0) && (mPendingData.size() + tData.size() > LOG_SINK_NET_MAX_DATAGRAM_SIZE))
+            Flush();
+        mPendingData += tData;
+        if (mPendingData.size() >= LOG_SINK_NET_MAX_DATAGRAM_SIZE)
+            Flush();
+    }else
+        SendData(tData);
+}
+
+void LogSinkNet::Flush()
+{
+    string tData;
+
+    if (mFormat == LOG_SINK_NET_BINARY)
+    {
+        if ((mBatchEncoder == NULL) || (mBatchEncoder->IsEmpty()))
+            return;
+        tData = mBatchEncoder->GetBatch();
+    }else
+    {
+        if (mPendingData.size() == 0)
+            return;
+        tData = mPendingData;
+        mPendingData = "";
+    }
+
+    if ((mDataSocket != NULL) && (!mBrokenPipe))
+        SendData(tData);
+}
+
+void LogSinkNet::SendData(string pData)
+{
+    if (!mDataSocket->Send((void*)pData.c_str(), (ssize_t)pData.size()))
     {
         LOG(LOG_ERROR, "Error when sending data through UDP socket to %s:%u, will skip further transmissions", mTargetHost.c_str(), mTargetPort);
         mBrokenPipe = true;
@@ -32,11 +32,16 @@
 #include <Logger.h>
 #include <HBReflection.h>
 #include <HBTime.h>
+#include <HBThread.h>
 
 #include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
 
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+#include <unistd.h>
+#endif
+
 #include <Header_Windows.h>
 
 namespace Homer { namespace Base {
@@ -58,14 +63,58 @@ bool sLoggerReady = false;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// background thread of the asynchronous mode
+class LoggerThread:
+    public Thread
+{
+public:
+    LoggerThread(Logger *pLogger)
+    {
+        mLogger = pLogger;
+    }
+
+    virtual ~LoggerThread()
+    {
+    }
+
+    virtual void* Run(void* pArgs = NULL)
+    {
+        // logging must not compete with the media threads
+        SetSchedulingClass(THREAD_SCHEDULING_BACKGROUND);
+        AnnounceReady();
+
+        while(mLogger->mAsyncMode)
+        {
+            // woken up early if the queue is half full
+            SuspendUntilWakeUp(LOGGER_ASYNC_FLUSH_PERIOD);
+            mLogger->ProcessQueuedMessages();
+        }
+
+        return NULL;
+    }
+
+private:
+    Logger      *mLogger;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 Logger::Logger()
 {
     mRegisteredSinks = 0;
     mLogLevel = LOG_ERROR;
+    mActiveLogLevel = LOG_ERROR;
     mLastMessageLogLevel = LOG_ERROR;
     mLastSource = "";
     mLastLine = 0;
     mRepetitionCount = 0;
+    mAsyncMode = false;
+    mAsyncThread = NULL;
+    mAsyncRecords = NULL;
+    mAsyncWritePos = 0;
+    mAsyncReadPos = 0;
+    mAsyncDroppedMessages = 0;
+    mAsyncReportedDroppedMessages = 0;
 	sLoggerReady = true;
 	mLoggerMutex.AssignName("LoggerMutex");
 	mLogSinksMutex.AssignName("LogSinksMutex");
@@ -117,8 +166,11 @@ void Logger::RegisterLogSink(LogSink* pLogSink)
 
     if (!tFound)
     {
+        if (mAsyncMode)
+            pLogSink->SetBuffering(true);
         mLogSinks.push_back(pLogSink);
         mRegisteredSinks++;
+        UpdateActiveLogLevel();
     }
 
     // unlock
@@ -156,8 +208,10 @@ void Logger::UnregisterLogSink(LogSink* pLogSink)
             printf("Sink found, deleting it..\n");
             // remove registration of log sink object
             tFound = true;
+            pLogSink->SetBuffering(false);
             mLogSinks.erase(tIt);
             mRegisteredSinks--;
+            UpdateActiveLogLevel();
             break;
         }
     }
@@ -196,7 +250,11 @@ void Logger::RelayMessageToLogSinks(int pLevel, string pTime, string pSource, in
     {
         for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
         {
-            (*tIt)->ProcessMessage(pLevel, pTime, pSource, pLine, pMessage);
+            int tSinkLogLevel = (*tIt)->GetLogLevel();
+            if (tSinkLogLevel == LOG_SINK_LEVEL_OF_LOGGER)
+                tSinkLogLevel = mLogLevel;
+            if (pLevel <= tSinkLogLevel)
+                (*tIt)->ProcessMessage(pLevel, pTime, pSource, pLine, pMessage);
         }
     }
 
@@ -217,7 +275,7 @@ void Logger::AddMessage(int pLevel, const char *pSource, int pLine, const char*
     	return;
     }
 
-    if ((pLevel > mLogLevel /* we won't produce an output in the console */) && (mRegisteredSinks == 0 /* only the console would get the message */))
+    if (!IsLevelActive(pLevel) /* neither the console nor a log sink would get the message */)
     {// nothing to do
 
         // return immediately
@@ -225,18 +283,36 @@ void Logger::AddMessage(int pLevel, const char *pSource, int pLine, const char*
     }
 
     va_list tVArgs;
+
+    if (mAsyncMode)
+    {
+        va_start(tVArgs, pFormat);
+        QueueMessage(pLevel, pSource, pLine, pFormat, tVArgs);
+        va_end(tVArgs);
+        return;
+    }
+
     char tMessageBuffer[4 * 1024];
 
     va_start(tVArgs, pFormat);
     vsprintf(tMessageBuffer, pFormat, tVArgs);
     va_end(tVArgs);
 
-    string tFinalSource, tFinalTime, tFinalMessage;
+    ProcessMessage(pLevel, GetTimeString(Time::GetTimeStamp()), toString(pSource), pLine, toString(tMessageBuffer));
+}
+
+string Logger::GetTimeString(int64_t pTimeStamp)
+{
     int tHour, tMin, tSec;
-    Time::GetNow(0, 0, 0, &tHour, &tMin, &tSec);
-    tFinalTime = (tHour < 10 ? "0" : "") + toString(tHour) + ":" + (tMin < 10 ? "0" : "") + toString(tMin) + "." + (tSec < 10 ? "0" : "") + toString(tSec);
-    tFinalSource = toString(pSource);
-    tFinalMessage = toString(tMessageBuffer);
+
+    Time::GetLocalTime(pTimeStamp, 0, 0, 0, &tHour, &tMin, &tSec);
+
+    return (tHour < 10 ? "0" : "") + toString(tHour) + ":" + (tMin < 10 ? "0" : "") + toString(tMin) + "." + (tSec < 10 ? "0" : "") + toString(tSec);
+}
+
+void Logger::ProcessMessage(int pLevel, string pTime, string pSource, int pLine, string pMessage)
+{
+    string tFinalSource = pSource, tFinalTime = pTime, tFinalMessage = pMessage;
 
     // lock
     if (mLoggerMutex.lock(250))
@@ -264,11 +340,249 @@ void Logger::AddMessage(int pLevel, const char *pSource, int pLine, const char*
     {
         if ((pLevel <= mLogLevel) && (pLevel > LOG_OFF))
         {
-        	printf("LOGGER: system load is high, skipped locking at %s for %s(%d) and message \"%s\", will ignore this.\n", tFinalTime.c_str(), pSource, pLine, tFinalMessage.c_str());
+        	printf("LOGGER: system load is high, skipped locking at %s for %s(%d) and message \"%s\", will ignore this.\n", tFinalTime.c_str(), tFinalSource.c_str(), pLine, tFinalMessage.c_str());
         }
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+bool Logger::ActivateAsyncMode()
+{
+    bool tResult = true;
+
+    mAsyncModeMutex.lock();
+
+    if (!mAsyncMode)
+    {
+        // the queue and the thread are never freed because producers might still refer to them after a deactivation
+        if (mAsyncRecords == NULL)
+        {
+            mAsyncRecords = new LogRecord[LOGGER_ASYNC_RECORDS];
+            for (int i = 0; i < LOGGER_ASYNC_RECORDS; i++)
+                mAsyncRecords[i].Sequence = mAsyncWritePos + i;
+        }
+        if (mAsyncThread == NULL)
+            mAsyncThread = new LoggerThread(this);
+
+        // wait for the end of a previous run
+        if (mAsyncThread->IsRunning())
+            mAsyncThread->StopThread();
+
+        SetLogSinksBuffering(true);
+        mAsyncMode = true;
+        if ((mAsyncThread->StartThread()) && (mAsyncThread->WaitForReady()))
+        {
+            printf("Logging asynchronously with a queue of %d messages\n", LOGGER_ASYNC_RECORDS);
+        }else
+        {
+            printf("LOGGER: failed to start the logger thread, will log synchronously\n");
+            mAsyncMode = false;
+            SetLogSinksBuffering(false);
+            tResult = false;
+        }
+    }
+
+    mAsyncModeMutex.unlock();
+
+    return tResult;
+}
+
+void Logger::DeactivateAsyncMode()
+{
+    mAsyncModeMutex.lock();
+
+    if (mAsyncMode)
+    {
+        // the logger thread terminates on its own, it isn't joined here
+        mAsyncMode = false;
+        mAsyncThread->WakeUp();
+
+        ProcessQueuedMessages();
+        SetLogSinksBuffering(false);
+    }
+
+    mAsyncModeMutex.unlock();
+}
+
+bool Logger::IsAsyncModeActive()
+{
+    return mAsyncMode;
+}
+
+int64_t Logger::GetDroppedMessages()
+{
+    return mAsyncDroppedMessages;
+}
+
+/*
+ * The queue is a bounded multi-producer ring buffer: every entry carries a sequence number which tells
+ * whether the entry is free for the write position "pos" (Sequence == pos), is filled for the reader
+ * (Sequence == pos + 1) or still waits for the reader of the previous round (Sequence < pos).
+ */
+void Logger::QueueMessage(int pLevel, const char *pSource, int pLine, const char *pFormat, va_list pVArgs)
+{
+    LogRecord *tRecord;
+    int64_t tPos = mAsyncWritePos;
+
+    for (;;)
+    {
+        tRecord = &mAsyncRecords[tPos & (LOGGER_ASYNC_RECORDS - 1)];
+        int64_t tDiff = tRecord->Sequence - tPos;
+        if (tDiff == 0)
+        {// entry is free, try to claim it
+            int64_t tOldPos = __sync_val_compare_and_swap(&mAsyncWritePos, tPos, tPos + 1);
+            if (tOldPos == tPos)
+                break;
+            tPos = tOldPos;
+        }else if (tDiff < 0)
+        {// queue is full, drop the new message
+            __sync_add_and_fetch(&mAsyncDroppedMessages, 1);
+            return;
+        }else
+        {// another producer was faster
+            tPos = mAsyncWritePos;
+        }
+    }
+
+    tRecord->Level = pLevel;
+    tRecord->Line = pLine;
+    tRecord->TimeStamp = Time::GetTimeStamp();
+    strncpy(tRecord->Source, pSource, LOGGER_ASYNC_SOURCE_SIZE - 1);
+    tRecord->Source[LOGGER_ASYNC_SOURCE_SIZE - 1] = 0;
+    vsnprintf(tRecord->Message, LOGGER_ASYNC_MESSAGE_SIZE, pFormat, pVArgs);
+    tRecord->Message[LOGGER_ASYNC_MESSAGE_SIZE - 1] = 0;
+
+    // publish the entry
+    __sync_synchronize();
+    tRecord->Sequence = tPos + 1;
+
+    // wake up the logger thread before the queue overflows
+    if (tPos - mAsyncReadPos == LOGGER_ASYNC_RECORDS / 2)
+        mAsyncThread->WakeUp();
+}
+
+void Logger::ProcessQueuedMessages()
+{
+    LogSinksList::iterator tIt;
+    int tCount = 0;
+
+    if (mAsyncRecords == NULL)
+        return;
+
+    // only one reader at a time
+    if (!mAsyncReadMutex.lock(250))
+        return;
+
+    for (;;)
+    {
+        LogRecord *tRecord = &mAsyncRecords[mAsyncReadPos & (LOGGER_ASYNC_RECORDS - 1)];
+        if (tRecord->Sequence != mAsyncReadPos + 1)
+            break;
+        __sync_synchronize();
+
+        ProcessMessage(tRecord->Level, GetTimeString(tRecord->TimeStamp), tRecord->Source, tRecord->Line, tRecord->Message);
+
+        // release the entry for the next round
+        __sync_synchronize();
+        tRecord->Sequence = mAsyncReadPos + LOGGER_ASYNC_RECORDS;
+        mAsyncReadPos++;
+        tCount++;
+    }
+
+    int64_t tDroppedMessages = mAsyncDroppedMessages;
+    if (tDroppedMessages != mAsyncReportedDroppedMessages)
+    {
+        ProcessMessage(LOG_WARN, GetTimeString(Time::GetTimeStamp()), "Logger", __LINE__, "Dropped " + toString(tDroppedMessages - mAsyncReportedDroppedMessages) + " message(s) because the queue was full");
+        mAsyncReportedDroppedMessages = tDroppedMessages;
+    }
+
+    mAsyncReadMutex.unlock();
+
+    // write the whole batch
+    if (tCount > 0)
+    {
+        mLogSinksMutex.lock();
+        for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
+            (*tIt)->Flush();
+        mLogSinksMutex.unlock();
+    }
+}
+
+// async-signal-safe helpers for WriteQueuedMessagesAfterCrash()
+static void WriteRaw(int pFd, const char *pData)
+{
+    size_t tSize = strlen(pData);
+
+    while (tSize > 0)
+    {
+        #if defined(LINUX) || defined(APPLE) || defined(BSD)
+            ssize_t tWritten = write(pFd, pData, tSize);
+        #endif
+        #if defined(WINDOWS)
+            int tWritten = _write(pFd, pData, (unsigned int)tSize);
+        #endif
+        if (tWritten <= 0)
+            return;
+        pData += tWritten;
+        tSize -= (size_t)tWritten;
+    }
+}
+
+static void WriteRawNumber(int pFd, int pNumber)
+{
+    char tBuffer[16];
+    int tPos = sizeof(tBuffer) - 1;
+    unsigned int tNumber = (pNumber < 0) ? -(unsigned int)pNumber : (unsigned int)pNumber;
+
+    tBuffer[tPos] = 0;
+    do{
+        tBuffer[--tPos] = (char)('0' + tNumber % 10);
+        tNumber /= 10;
+    }while (tNumber > 0);
+    if (pNumber < 0)
+        tBuffer[--tPos] = '-';
+
+    WriteRaw(pFd, &tBuffer[tPos]);
+}
+
+void Logger::WriteQueuedMessagesAfterCrash(int pFd)
+{
+    static const char *sLevelNames[] = { "", "ERROR:   ", "WARN:    ", "INFO:    ", "VERBOSE: ", "WORLD:   " };
+
+    if ((mAsyncRecords == NULL) || (pFd < 0))
+        return;
+
+    // HINT: the crashed thread might hold the read mutex, hence the records are read without it and the read position isn't changed
+    int64_t tReadPos = mAsyncReadPos;
+    for (int64_t tPos = tReadPos; tPos < tReadPos + LOGGER_ASYNC_RECORDS; tPos++)
+    {
+        LogRecord *tRecord = &mAsyncRecords[tPos & (LOGGER_ASYNC_RECORDS - 1)];
+        if (tRecord->Sequence != tPos + 1)
+            break;
+        __sync_synchronize();
+
+        if ((tRecord->Level >= LOG_ERROR) && (tRecord->Level <= LOG_WORLD))
+            WriteRaw(pFd, sLevelNames[tRecord->Level]);
+        WriteRaw(pFd, tRecord->Source);
+        WriteRaw(pFd, "(");
+        WriteRawNumber(pFd, tRecord->Line);
+        WriteRaw(pFd, "): ");
+        WriteRaw(pFd, tRecord->Message);
+        WriteRaw(pFd, "\n");
+    }
+}
+
+void Logger::SetLogSinksBuffering(bool pActive)
+{
+    LogSinksList::iterator tIt;
+
+    mLogSinksMutex.lock();
+    for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
+        (*tIt)->SetBuffering(pActive);
+    mLogSinksMutex.unlock();
+}
+
 void Logger::Init(int pLevel)
 {
     SetLogLevel(pLevel);
@@ -276,6 +590,7 @@ void Logger::Init(int pLevel)
 
 void Logger::Deinit()
 {
+    DeactivateAsyncMode();
 }
 
 void Logger::SetLogLevel(int pLevel)
@@ -312,6 +627,25 @@ void Logger::SetLogLevel(int pLevel)
                 mLogLevel = LOG_OFF;
                 break;
     }
+
+    mLogSinksMutex.lock();
+    UpdateActiveLogLevel();
+    mLogSinksMutex.unlock();
+}
+
+void Logger::UpdateActiveLogLevel()
+{
+    LogSinksList::iterator tIt;
+    int tResult = mLogLevel;
+
+    for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
+    {
+        int tSinkLogLevel = (*tIt)->GetLogLevel();
+        if ((tSinkLogLevel != LOG_SINK_LEVEL_OF_LOGGER) && (tSinkLogLevel > tResult))
+            tResult = tSinkLogLevel;
+    }
+
+    mActiveLogLevel = tResult;
 }
 
 int Logger::GetLogLevel()
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Mutex statistic service
+ * Since:   2026-10-17
+ */
+
+#ifndef _MONITOR_MUTEX_STATISTIC_SERVICE_
+#define _MONITOR_MUTEX_STATISTIC_SERVICE_
+
+#include <HBMutex.h>
+
+#include <string>
+
+namespace Homer { namespace Monitor {
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define SVC_MUTEX_STATISTIC MutexStatisticService::GetInstance()
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MutexStatisticService
+{
+public:
+    /// The default constructor
+    MutexStatisticService();
+
+    /// The destructor.
+    virtual ~MutexStatisticService();
+
+    static MutexStatisticService& GetInstance();
+
+    /* profiling of all mutexes, disabled by default */
+    void ActivateProfiling();
+    void DeactivateProfiling();
+    bool IsProfilingActive();
+
+    /* get statistics: one entry per mutex name, sorted by descending total wait time */
+    Homer::Base::MutexProfiles GetMutexStatistics();
+    static int64_t GetWaitTimePercentile(Homer::Base::MutexProfile &pProfile, int pPercentile); // returns an upper bound in us
+    void ResetMutexStatistics();
+
+    /* headless output: one line per mutex */
+    std::string GetMutexStatisticsReport();
+    void DumpMutexStatistics(); // writes the report to the logger
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -64,6 +64,7 @@ struct PacketStatisticDescriptor{
     int  PacketCount;
     int64_t ByteCount;
     uint64_t LostPacketCount;
+    uint64_t RecoveredPacketCount; // restored by FEC
     int  AvgPacketSize;
     int  AvgDataRate;
     int  MomentAvgDataRate;
@@ -97,6 +98,7 @@ public:
     int GetMinPacketSize();
     int GetMaxPacketSize();
     uint64_t GetLostPacketCount();
+    uint64_t GetRecoveredPacketCount();
 
     /* get statistic values */
     PacketStatisticDescriptor GetPacketStatistic();
@@ -119,6 +121,7 @@ public:
     virtual void ResetPacketStatistic();
 
     void SetLostPacketCount(uint64_t pPacketCount);
+    void SetRecoveredPacketCount(uint64_t pPacketCount);
 
 protected:
     /* update internal states */
@@ -144,7 +147,8 @@ private:
     int64_t       mStartTimeStamp;
     int64_t       mEndTimeStamp;
     uint64_t      mLostPacketCount;
-    Time          mLastTime;
+    uint64_t      mRecoveredPacketCount;
+    int64_t       mLastTimeStamp; // in us, monotonic
     Statistics mStatistics;
     Mutex         mStatisticsMutex;
     std::string	  mName;
@@ -28,6 +28,7 @@
 #define _MULTIMEDIA_PROCESS_STATISTIC_
 
 #include <HBMutex.h>
+#include <HBThread.h>
 #include <ProcessStatisticService.h>
 
 #include <string>
@@ -51,6 +52,10 @@ struct ThreadStatisticDescriptor{
     unsigned long MemVirtual;
     unsigned long MemPhysical;
     unsigned long MemAllocs;
+    enum ThreadSchedulingClass SchedulingClass; // declared by the thread
+    enum ThreadSchedulingClass SchedulingClassEffective; // granted by the OS
+    int64_t SchedulingLatencyAvg; // in us
+    int64_t SchedulingLatencyMax; // in us
 };
 
 typedef std::vector<ThreadStatisticDescriptor> ThreadStatistics;
@@ -0,0 +1,112 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Queue statistic
+ * Since:   2026-10-17
+ */
+
+#ifndef _MONITOR_QUEUE_STATISTIC_
+#define _MONITOR_QUEUE_STATISTIC_
+
+#include <string>
+#include <stdint.h>
+
+namespace Homer { namespace Monitor {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// amount of buckets for the residence time histogram: bucket i counts residence times in [2^i, 2^(i+1)) us, the last bucket counts all longer ones
+#define QUEUE_STATISTIC_HISTOGRAM_SIZE                          24
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct QueueStatisticDescriptor{
+    int     Size;
+    int     Usage;
+    int     UsageHighWatermark;
+    int     MemoryBudget; // in bytes
+    int     MemoryHighWatermark; // in bytes
+    int64_t WriteCount;
+    int64_t ReadCount;
+    int64_t DropCount;
+    int64_t WriterBlockedTime; // in us
+    int64_t ReaderBlockedTime; // in us
+    int64_t MinResidenceTime; // in us
+    int64_t AvgResidenceTime; // in us
+    int64_t MaxResidenceTime; // in us
+    int64_t ResidenceTimeHistogram[QUEUE_STATISTIC_HISTOGRAM_SIZE];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class QueueStatistic
+{
+public:
+    QueueStatistic(std::string pName = "");
+    virtual ~QueueStatistic();
+
+    /* get statistic values */
+    virtual QueueStatisticDescriptor GetQueueStatistic();
+    static int64_t GetResidenceTimePercentile(QueueStatisticDescriptor &pStatistic, int pPercentile); // returns an upper bound in us
+
+    /* classification */
+    void AssignQueueName(std::string pName);
+    std::string GetQueueName();
+
+    /* activation: only active statistics are registered at the queue statistic service and collect data */
+    void SetQueueStatisticActivation(bool pActive);
+    bool IsQueueStatisticActive();
+
+    /* reset internal states */
+    virtual void ResetQueueStatistic();
+
+protected:
+    /* update internal states, all functions are lock-free and may be called concurrently */
+    void AnnounceQueueWrite(int pUsage /* in entries, including the new one */);
+    void AnnounceQueueRead(int64_t pResidenceTime /* in us */);
+    void AnnounceQueueDrop(int pCount = 1);
+    void AnnounceWriterBlocked(int64_t pBlockedTime /* in us */);
+    void AnnounceReaderBlocked(int64_t pBlockedTime /* in us */);
+
+private:
+    static void UpdateMaximum(volatile int64_t *pValue, int64_t pSample);
+    static void UpdateMinimum(volatile int64_t *pValue, int64_t pSample);
+
+    std::string         mName;
+    volatile bool       mQueueStatisticActive;
+    volatile int64_t    mUsageHighWatermark;
+    volatile int64_t    mWriteCount;
+    volatile int64_t    mReadCount;
+    volatile int64_t    mDropCount;
+    volatile int64_t    mWriterBlockedTime;
+    volatile int64_t    mReaderBlockedTime;
+    volatile int64_t    mMinResidenceTime;
+    volatile int64_t    mMaxResidenceTime;
+    volatile int64_t    mSumResidenceTime;
+    volatile int64_t    mResidenceTimeHistogram[QUEUE_STATISTIC_HISTOGRAM_SIZE];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -0,0 +1,78 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Queue statistic service
+ * Since:   2026-10-17
+ */
+
+#ifndef _MONITOR_QUEUE_STATISTIC_SERVICE_
+#define _MONITOR_QUEUE_STATISTIC_SERVICE_
+
+#include <HBMutex.h>
+#include <QueueStatistic.h>
+
+#include <string>
+#include <vector>
+
+namespace Homer { namespace Monitor {
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define SVC_QUEUE_STATISTIC QueueStatisticService::GetInstance()
+
+typedef std::vector<QueueStatistic*>  QueueStatistics;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class QueueStatisticService
+{
+public:
+    /// The default constructor
+    QueueStatisticService();
+
+    /// The destructor.
+    virtual ~QueueStatisticService();
+
+    static QueueStatisticService& GetInstance();
+
+    /* get statistics */
+    QueueStatistics GetQueueStatisticsAccess();
+    void ReleaseQueueStatisticsAccess();
+
+    /* headless output: one line per queue */
+    std::string GetQueueStatisticsReport();
+    void DumpQueueStatistics(); // writes the report to the logger
+
+    /* registration interface */
+    QueueStatistic* RegisterQueueStatistic(QueueStatistic *pStat);
+    bool UnregisterQueueStatistic(QueueStatistic *pStat);
+
+private:
+    QueueStatistics     mQueueStatistics;
+    Homer::Base::Mutex  mQueueStatisticsMutex;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -0,0 +1,159 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of mutex statistic service as singleton
+ * Since:   2026-10-17
+*/
+#include <MutexStatisticService.h>
+
+#include <Logger.h>
+
+#include <algorithm>
+#include <stdio.h>
+
+using namespace std;
+using namespace Homer::Base;
+
+namespace Homer { namespace Monitor {
+
+MutexStatisticService sMutexStatisticService;
+
+///////////////////////////////////////////////////////////////////////////////
+
+MutexStatisticService::MutexStatisticService()
+{
+
+}
+
+MutexStatisticService::~MutexStatisticService()
+{
+
+}
+
+MutexStatisticService& MutexStatisticService::GetInstance()
+{
+    return sMutexStatisticService;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MutexStatisticService::ActivateProfiling()
+{
+    LOG(LOG_VERBOSE, "Activating mutex profiling");
+    Mutex::ActivateProfiling();
+}
+
+void MutexStatisticService::DeactivateProfiling()
+{
+    LOG(LOG_VERBOSE, "Deactivating mutex profiling");
+    Mutex::DeactivateProfiling();
+}
+
+bool MutexStatisticService::IsProfilingActive()
+{
+    return Mutex::IsProfilingActive();
+}
+
+static bool CompareWaitTime(const MutexProfile &pA, const MutexProfile &pB)
+{
+    return (pA.WaitTime > pB.WaitTime);
+}
+
+MutexProfiles MutexStatisticService::GetMutexStatistics()
+{
+    MutexProfiles tResult = Mutex::GetProfiles();
+
+    sort(tResult.begin(), tResult.end(), CompareWaitTime);
+
+    return tResult;
+}
+
+int64_t MutexStatisticService::GetWaitTimePercentile(MutexProfile &pProfile, int pPercentile)
+{
+    int64_t tCount = 0;
+    int64_t tSum = 0;
+
+    for (int i = 0; i < MUTEX_PROFILE_HISTOGRAM_SIZE; i++)
+        tCount += pProfile.WaitTimeHistogram[i];
+
+    if (tCount == 0)
+        return 0;
+
+    for (int i = 0; i < MUTEX_PROFILE_HISTOGRAM_SIZE - 1; i++)
+    {
+        tSum += pProfile.WaitTimeHistogram[i];
+        if (tSum * 100 >= tCount * pPercentile)
+        {
+            int64_t tResult = (int64_t)1 << i;
+            return (tResult < pProfile.WaitTimeMax) ? tResult : pProfile.WaitTimeMax;
+        }
+    }
+
+    return pProfile.WaitTimeMax;
+}
+
+void MutexStatisticService::ResetMutexStatistics()
+{
+    Mutex::ResetProfiles();
+}
+
+string MutexStatisticService::GetMutexStatisticsReport()
+{
+    string tResult;
+    char tLine[512];
+    MutexProfiles tProfiles = GetMutexStatistics();
+    MutexProfiles::iterator tIt;
+
+    snprintf(tLine, sizeof(tLine), "%-40s %12s %12s %9s %9s %9s %9s\n", "Mutex", "Acquisitions", "Contentions", "Avg.wait", "99% wait", "Max.wait", "Max.hold");
+    tResult += tLine;
+
+    for (tIt = tProfiles.begin(); tIt != tProfiles.end(); tIt++)
+    {
+        // all times in us, the average refers to contended acquisitions
+        snprintf(tLine, sizeof(tLine), "%-40s %12"PRId64" %12"PRId64" %9"PRId64" %9"PRId64" %9"PRId64" %9"PRId64"\n",
+                tIt->Name.c_str(), tIt->Acquisitions, tIt->Contentions, (tIt->Contentions > 0) ? tIt->WaitTime / tIt->Contentions : 0,
+                GetWaitTimePercentile(*tIt, 99), tIt->WaitTimeMax, tIt->HoldTimeMax);
+        tResult += tLine;
+    }
+
+    return tResult;
+}
+
+void MutexStatisticService::DumpMutexStatistics()
+{
+    string tReport = GetMutexStatisticsReport();
+    size_t tStart = 0, tEnd;
+
+    if (!IsProfilingActive())
+        LOG(LOG_WARN, "Mutex profiling is inactive, statistics might be outdated");
+
+    LOG(LOG_INFO, "Mutex statistics (times in us):");
+    while ((tEnd = tReport.find('\n', tStart)) != string::npos)
+    {
+        LOG(LOG_INFO, "%s", tReport.substr(tStart, tEnd - tStart).c_str());
+        tStart = tEnd + 1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
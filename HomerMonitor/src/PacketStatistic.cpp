@@ -88,7 +88,8 @@ void PacketStatistic::AnnouncePacket(int pSize)
             break;
     }
 
-    mEndTimeStamp = Time::GetTimeStamp();
+    // one monotonic time stamp per packet, the wall clock is only derived for the data rate history
+    mEndTimeStamp = Time::GetMonotonicTimeStamp();
     if (mStartTimeStamp == 0)
         mStartTimeStamp = mEndTimeStamp;
 
@@ -96,14 +97,16 @@ void PacketStatistic::AnnouncePacket(int pSize)
     tStatEntry.PacketSize = pSize;
     tStatEntry.Timestamp = mEndTimeStamp;
 
-    int64_t tTime = Time::GetTimeStamp();
+    #ifdef STATISTIC_DEBUG_TIMING
+        int64_t tTime = Time::GetMonotonicTimeStamp();
+    #endif
     // lock
     mStatisticsMutex.lock();
     
     // init last time if we are called for the first time
-    if (!mLastTime.ValidTimeStamp())
+    if (mLastTimeStamp == 0)
     {
-        mLastTime.UpdateTimeStamp();
+        mLastTimeStamp = mEndTimeStamp;
 
         // unlock
         mStatisticsMutex.unlock();
@@ -111,10 +114,7 @@ void PacketStatistic::AnnouncePacket(int pSize)
         return;
     }
 
-    Time tCurTime;
-    tCurTime.UpdateTimeStamp();
-    long int tDiff = (long)tCurTime.TimeDiffInUSecs(&mLastTime);
-    tStatEntry.TimeDiff = (int)tDiff;
+    tStatEntry.TimeDiff = (int)(mEndTimeStamp - mLastTimeStamp);
 
     mPacketCount++;
     mByteCount += pSize;
@@ -124,7 +124,7 @@ void PacketStatistic::AnnouncePacket(int pSize)
         mMaxPacketSize = pSize;
 
     tStatEntry.ByteCount = mByteCount;
-    mLastTime = tCurTime;
+    mLastTimeStamp = mEndTimeStamp;
 
     mStatistics.push_back(tStatEntry);
     while (mStatistics.size() > STATISTIC_MOMENT_DATARATE_REFERENCE_SIZE)
@@ -136,18 +136,22 @@ void PacketStatistic::AnnouncePacket(int pSize)
     mStatisticsMutex.unlock();
 
     #ifdef STATISTIC_DEBUG_TIMING
-        int64_t tTime2 = Time::GetTimeStamp();
+        int64_t tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock1 took %"PRId64" us", tTime2 - tTime);
     #endif
 
     DataRateHistoryDescriptor tHistEntry;
     tHistEntry.TimeStamp = mEndTimeStamp - mStartTimeStamp;
-    tHistEntry.Time = mEndTimeStamp;
+    tHistEntry.Time = Time::ConvertMonotonicToWallClock(mEndTimeStamp);
     tHistEntry.DataRate = GetMomentAvgDataRate();
 
-    tTime = Time::GetTimeStamp();
+    #ifdef STATISTIC_DEBUG_TIMING
+        tTime = Time::GetMonotonicTimeStamp();
+    #endif
     mDataRateHistoryMutex.lock();
-    int64_t tTime3 = Time::GetTimeStamp();
+    #ifdef STATISTIC_DEBUG_TIMING
+        int64_t tTime3 = Time::GetMonotonicTimeStamp();
+    #endif
 
     if (mDataRateHistory.size() > STATISTIC_MOMENT_DATARATE_HISTORY)
     {
@@ -161,9 +165,9 @@ void PacketStatistic::AnnouncePacket(int pSize)
 
     mDataRateHistoryMutex.unlock();
     #ifdef STATISTIC_DEBUG_TIMING
-        tTime2 = Time::GetTimeStamp();
+        tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock2 took %"PRId64" us", tTime2 - tTime);
-        tTime2 = Time::GetTimeStamp();
+        tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock2-mutex took %"PRId64" us", tTime3 - tTime);
     #endif
 }
@@ -180,13 +184,14 @@ void PacketStatistic::ResetPacketStatistic()
     mMinPacketSize = INT_MAX;
     mMaxPacketSize = 0;
     mLostPacketCount = 0;
+    mRecoveredPacketCount = 0;
 
     mDataRateHistoryMutex.lock();
     mDataRateHistory.clear();
     mDataRateHistoryMutex.unlock();
 
     mFirstDataRateHistoryLoss = true;
-    mLastTime.InvalidateTimeStamp();
+    mLastTimeStamp = 0;
     mStatistics.clear();
 
     // unlock
@@ -198,6 +203,11 @@ void PacketStatistic::SetLostPacketCount(uint64_t pPacketCount)
     mLostPacketCount = pPacketCount;
 }
 
+void PacketStatistic::SetRecoveredPacketCount(uint64_t pPacketCount)
+{
+    mRecoveredPacketCount = pPacketCount;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int PacketStatistic::GetAvgPacketSize()
@@ -251,7 +261,7 @@ int PacketStatistic::GetMomentAvgDataRate()
 
     if (mStatistics.size() > 1)
     {
-        int64_t tCurrentTime = Time::GetTimeStamp();
+        int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
         int64_t tMeasurementStartTime = mStatistics.front().Timestamp;
         int64_t tMeasurementStartByteCount = mStatistics.front().ByteCount;
         int tMeasuredValues = STATISTIC_MOMENT_DATARATE_REFERENCE_SIZE - 1;
@@ -296,6 +306,11 @@ uint64_t PacketStatistic::GetLostPacketCount()
     return mLostPacketCount;
 }
 
+uint64_t PacketStatistic::GetRecoveredPacketCount()
+{
+    return mRecoveredPacketCount;
+}
+
 void PacketStatistic::AssignStreamName(std::string pName)
 {
 	mName = pName;
@@ -400,6 +415,7 @@ PacketStatisticDescriptor PacketStatistic::GetPacketStatistic()
 	tStat.PacketCount = GetPacketCount();
 	tStat.ByteCount = GetByteCount();
 	tStat.LostPacketCount = GetLostPacketCount();
+	tStat.RecoveredPacketCount = GetRecoveredPacketCount();
 	tStat.AvgPacketSize = GetAvgPacketSize();
 	tStat.AvgDataRate = GetAvgDataRate();
     tStat.MomentAvgDataRate = GetMomentAvgDataRate();
@@ -152,6 +152,8 @@ void ProcessStatisticService::UpdateThreadDatabase()
             {
                 // delete the unneeded statistic object
                 SVC_PROCESS_STATISTIC.UnregisterProcessStatistic(tThreadId);
+                // the thread id may be reused by a new thread
+                Thread::ResetSchedulingStatistic(tThreadId);
                 break;
             }
         }
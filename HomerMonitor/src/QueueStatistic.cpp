@@ -0,0 +1,235 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of queue statistic
+ * Since:   2026-10-17
+*/
+#include <QueueStatistic.h>
+#include <QueueStatisticService.h>
+#include <Logger.h>
+
+using namespace std;
+using namespace Homer::Base;
+
+namespace Homer { namespace Monitor {
+
+///////////////////////////////////////////////////////////////////////////////
+
+QueueStatistic::QueueStatistic(string pName)
+{
+    mQueueStatisticActive = false;
+    ResetQueueStatistic();
+    AssignQueueName(pName);
+}
+
+QueueStatistic::~QueueStatistic()
+{
+    SetQueueStatisticActivation(false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void QueueStatistic::AssignQueueName(string pName)
+{
+    mName = pName;
+}
+
+string QueueStatistic::GetQueueName()
+{
+    return mName;
+}
+
+void QueueStatistic::SetQueueStatisticActivation(bool pActive)
+{
+    if (mQueueStatisticActive == pActive)
+        return;
+
+    if (pActive)
+    {
+        if (SVC_QUEUE_STATISTIC.RegisterQueueStatistic(this) != this)
+            LOG(LOG_ERROR, "Error when registering queue statistic");
+        mQueueStatisticActive = true;
+    }else
+    {
+        mQueueStatisticActive = false;
+        // HINT: afterwards no statistic reader accesses this object anymore
+        if (!SVC_QUEUE_STATISTIC.UnregisterQueueStatistic(this))
+            LOG(LOG_ERROR, "Error when unregistering queue statistic");
+    }
+}
+
+bool QueueStatistic::IsQueueStatisticActive()
+{
+    return mQueueStatisticActive;
+}
+
+void QueueStatistic::ResetQueueStatistic()
+{
+    mUsageHighWatermark = 0;
+    mWriteCount = 0;
+    mReadCount = 0;
+    mDropCount = 0;
+    mWriterBlockedTime = 0;
+    mReaderBlockedTime = 0;
+    mMinResidenceTime = -1;
+    mMaxResidenceTime = 0;
+    mSumResidenceTime = 0;
+    for (int i = 0; i < QUEUE_STATISTIC_HISTOGRAM_SIZE; i++)
+        mResidenceTimeHistogram[i] = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QueueStatisticDescriptor QueueStatistic::GetQueueStatistic()
+{
+    QueueStatisticDescriptor tResult;
+
+    // HINT: the values are read without locking, hence they may be slightly inconsistent
+    tResult.Size = 0;
+    tResult.Usage = 0;
+    tResult.UsageHighWatermark = (int)mUsageHighWatermark;
+    tResult.MemoryBudget = 0;
+    tResult.MemoryHighWatermark = 0;
+    tResult.WriteCount = mWriteCount;
+    tResult.ReadCount = mReadCount;
+    tResult.DropCount = mDropCount;
+    tResult.WriterBlockedTime = mWriterBlockedTime;
+    tResult.ReaderBlockedTime = mReaderBlockedTime;
+    tResult.MinResidenceTime = (mMinResidenceTime >= 0) ? mMinResidenceTime : 0;
+    tResult.MaxResidenceTime = mMaxResidenceTime;
+    tResult.AvgResidenceTime = (tResult.ReadCount > 0) ? mSumResidenceTime / tResult.ReadCount : 0;
+    for (int i = 0; i < QUEUE_STATISTIC_HISTOGRAM_SIZE; i++)
+        tResult.ResidenceTimeHistogram[i] = mResidenceTimeHistogram[i];
+
+    return tResult;
+}
+
+int64_t QueueStatistic::GetResidenceTimePercentile(QueueStatisticDescriptor &pStatistic, int pPercentile)
+{
+    int64_t tCount = 0;
+    int64_t tSum = 0;
+
+    for (int i = 0; i < QUEUE_STATISTIC_HISTOGRAM_SIZE; i++)
+        tCount += pStatistic.ResidenceTimeHistogram[i];
+
+    if (tCount == 0)
+        return 0;
+
+    for (int i = 0; i < QUEUE_STATISTIC_HISTOGRAM_SIZE - 1; i++)
+    {
+        tSum += pStatistic.ResidenceTimeHistogram[i];
+        if (tSum * 100 >= tCount * pPercentile)
+        {
+            int64_t tResult = (int64_t)1 << (i + 1);
+            return (tResult < pStatistic.MaxResidenceTime) ? tResult : pStatistic.MaxResidenceTime;
+        }
+    }
+
+    return pStatistic.MaxResidenceTime;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void QueueStatistic::UpdateMaximum(volatile int64_t *pValue, int64_t pSample)
+{
+    int64_t tValue = *pValue;
+
+    while (pSample > tValue)
+    {
+        int64_t tOldValue = __sync_val_compare_and_swap(pValue, tValue, pSample);
+        if (tOldValue == tValue)
+            break;
+        tValue = tOldValue;
+    }
+}
+
+void QueueStatistic::UpdateMinimum(volatile int64_t *pValue, int64_t pSample)
+{
+    int64_t tValue = *pValue;
+
+    // a negative value marks a missing minimum
+    while ((tValue < 0) || (pSample < tValue))
+    {
+        int64_t tOldValue = __sync_val_compare_and_swap(pValue, tValue, pSample);
+        if (tOldValue == tValue)
+            break;
+        tValue = tOldValue;
+    }
+}
+
+void QueueStatistic::AnnounceQueueWrite(int pUsage)
+{
+    if (!mQueueStatisticActive)
+        return;
+
+    __sync_add_and_fetch(&mWriteCount, 1);
+    UpdateMaximum(&mUsageHighWatermark, pUsage);
+}
+
+void QueueStatistic::AnnounceQueueRead(int64_t pResidenceTime)
+{
+    int tBucket = 0;
+
+    if (!mQueueStatisticActive)
+        return;
+
+    if (pResidenceTime < 0)
+        pResidenceTime = 0;
+
+    // logarithmic histogram bucket
+    while ((tBucket < QUEUE_STATISTIC_HISTOGRAM_SIZE - 1) && ((pResidenceTime >> (tBucket + 1)) > 0))
+        tBucket++;
+
+    __sync_add_and_fetch(&mReadCount, 1);
+    __sync_add_and_fetch(&mSumResidenceTime, pResidenceTime);
+    __sync_add_and_fetch(&mResidenceTimeHistogram[tBucket], 1);
+    UpdateMinimum(&mMinResidenceTime, pResidenceTime);
+    UpdateMaximum(&mMaxResidenceTime, pResidenceTime);
+}
+
+void QueueStatistic::AnnounceQueueDrop(int pCount)
+{
+    if ((!mQueueStatisticActive) || (pCount < 1))
+        return;
+
+    __sync_add_and_fetch(&mDropCount, pCount);
+}
+
+void QueueStatistic::AnnounceWriterBlocked(int64_t pBlockedTime)
+{
+    if ((!mQueueStatisticActive) || (pBlockedTime < 1))
+        return;
+
+    __sync_add_and_fetch(&mWriterBlockedTime, pBlockedTime);
+}
+
+void QueueStatistic::AnnounceReaderBlocked(int64_t pBlockedTime)
+{
+    if ((!mQueueStatisticActive) || (pBlockedTime < 1))
+        return;
+
+    __sync_add_and_fetch(&mReaderBlockedTime, pBlockedTime);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -0,0 +1,202 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of queue statistic service as singleton
+ * Since:   2026-10-17
+*/
+#include <QueueStatisticService.h>
+
+#include <HBExecutor.h>
+#include <Logger.h>
+
+#include <stdio.h>
+
+using namespace std;
+using namespace Homer::Base;
+
+namespace Homer { namespace Monitor {
+
+QueueStatisticService sQueueStatisticService;
+
+///////////////////////////////////////////////////////////////////////////////
+
+QueueStatisticService::QueueStatisticService()
+{
+
+}
+
+QueueStatisticService::~QueueStatisticService()
+{
+
+}
+
+QueueStatisticService& QueueStatisticService::GetInstance()
+{
+    return sQueueStatisticService;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QueueStatistics QueueStatisticService::GetQueueStatisticsAccess()
+{
+    QueueStatistics tResult;
+
+    // lock
+    mQueueStatisticsMutex.lock();
+
+    tResult = mQueueStatistics;
+
+    return tResult;
+}
+
+void QueueStatisticService::ReleaseQueueStatisticsAccess()
+{
+    // unlock
+    mQueueStatisticsMutex.unlock();
+}
+
+string QueueStatisticService::GetQueueStatisticsReport()
+{
+    string tResult;
+    char tLine[512];
+    QueueStatistics::iterator tIt;
+
+    snprintf(tLine, sizeof(tLine), "%-40s %11s %6s %21s %10s %8s %9s %9s %9s %12s %12s\n", "Queue", "Usage", "Max.", "Memory (max./budget)", "Writes", "Drops", "Avg.lat.", "95% lat.", "Max.lat.", "Wr.blocked", "Rd.blocked");
+    tResult += tLine;
+
+    // lock
+    mQueueStatisticsMutex.lock();
+
+    for (tIt = mQueueStatistics.begin(); tIt != mQueueStatistics.end(); tIt++)
+    {
+        QueueStatisticDescriptor tStat = (*tIt)->GetQueueStatistic();
+
+        // latencies in us, blocked times in ms
+        snprintf(tLine, sizeof(tLine), "%-40s %5d/%5d %6d %10d/%10d %10"PRId64" %8"PRId64" %9"PRId64" %9"PRId64" %9"PRId64" %12"PRId64" %12"PRId64"\n",
+                (*tIt)->GetQueueName().c_str(), tStat.Usage, tStat.Size, tStat.UsageHighWatermark, tStat.MemoryHighWatermark, tStat.MemoryBudget, tStat.WriteCount, tStat.DropCount,
+                tStat.AvgResidenceTime, QueueStatistic::GetResidenceTimePercentile(tStat, 95), tStat.MaxResidenceTime, tStat.WriterBlockedTime / 1000, tStat.ReaderBlockedTime / 1000);
+        tResult += tLine;
+    }
+
+    // unlock
+    mQueueStatisticsMutex.unlock();
+
+    // queueing delays of the pipeline stages which run as tasks on the shared executor, in us
+    TaskList::iterator tTaskIt;
+    TaskList tTasks = SVC_EXECUTOR.GetTasksAccess();
+    if (tTasks.size() > 0)
+    {
+        snprintf(tLine, sizeof(tLine), "%-40s %12s %12s %12s\n", "Task", "Executions", "Avg.delay", "Max.delay");
+        tResult += tLine;
+        for (tTaskIt = tTasks.begin(); tTaskIt != tTasks.end(); tTaskIt++)
+        {
+            int64_t tExecutions, tAvgDelay, tMaxDelay;
+            (*tTaskIt)->GetQueueingDelayStatistic(tExecutions, tAvgDelay, tMaxDelay);
+            if (tExecutions == 0)
+                continue;
+            snprintf(tLine, sizeof(tLine), "%-40s %12"PRId64" %12"PRId64" %12"PRId64"\n", (*tTaskIt)->GetTaskName().c_str(), tExecutions, tAvgDelay, tMaxDelay);
+            tResult += tLine;
+        }
+    }
+    SVC_EXECUTOR.ReleaseTasksAccess();
+
+    return tResult;
+}
+
+void QueueStatisticService::DumpQueueStatistics()
+{
+    string tReport = GetQueueStatisticsReport();
+    size_t tStart = 0, tEnd;
+
+    LOG(LOG_INFO, "Queue statistics (latencies in us, blocked times in ms):");
+    while ((tEnd = tReport.find('\n', tStart)) != string::npos)
+    {
+        LOG(LOG_INFO, "%s", tReport.substr(tStart, tEnd - tStart).c_str());
+        tStart = tEnd + 1;
+    }
+}
+
+QueueStatistic* QueueStatisticService::RegisterQueueStatistic(QueueStatistic *pStat)
+{
+    QueueStatistics::iterator tIt;
+    bool tFound = false;
+
+    if (pStat == NULL)
+        return NULL;
+
+    LOG(LOG_VERBOSE, "Registering queue statistic: %s", pStat->GetQueueName().c_str());
+
+    // lock
+    mQueueStatisticsMutex.lock();
+
+    for (tIt = mQueueStatistics.begin(); tIt != mQueueStatistics.end(); tIt++)
+    {
+        if (*tIt == pStat)
+        {
+            LOG(LOG_VERBOSE, "Statistic already registered");
+            tFound = true;
+            break;
+        }
+    }
+
+    if (!tFound)
+        mQueueStatistics.push_back(pStat);
+
+    // unlock
+    mQueueStatisticsMutex.unlock();
+
+    return pStat;
+}
+
+bool QueueStatisticService::UnregisterQueueStatistic(QueueStatistic *pStat)
+{
+    QueueStatistics::iterator tIt;
+    bool tFound = false;
+
+    if (pStat == NULL)
+        return false;
+
+    LOG(LOG_VERBOSE, "Unregistering queue statistic: %s", pStat->GetQueueName().c_str());
+
+    // lock
+    mQueueStatisticsMutex.lock();
+
+    for (tIt = mQueueStatistics.begin(); tIt != mQueueStatistics.end(); tIt++)
+    {
+        if (*tIt == pStat)
+        {
+            tFound = true;
+            mQueueStatistics.erase(tIt);
+            LOG(LOG_VERBOSE, "..unregistered");
+            break;
+        }
+    }
+
+    // unlock
+    mQueueStatisticsMutex.unlock();
+
+    return tFound;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: reference counted memory for sharing media data between media sources, sinks and FIFOs
+ * Since:   2026-10-17
+ */
+
+#ifndef _MULTIMEDIA_MEDIA_BUFFER_
+#define _MULTIMEDIA_MEDIA_BUFFER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of buffer references
+//#define MB_DEBUG
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MediaBuffer
+{
+public:
+    /* creates a buffer with one reference, which belongs to the caller */
+    static MediaBuffer* Create(int pSize);
+    static MediaBuffer* Create(const char *pData, int pSize);
+
+    void AddReference();
+    void Release(); // destroys the buffer if the last reference is released
+
+    char* GetData();
+    int GetSize();
+    int GetReferenceCount();
+
+private:
+    MediaBuffer(int pSize);
+    ~MediaBuffer();
+
+    char                *mData;
+    int                 mSize;
+    volatile int        mReferences;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -28,12 +28,16 @@
 #define _MULTIMEDIA_MEDIA_FIFO_
 
 #include <HBCondition.h>
+#include <HBExecutor.h>
 #include <HBMutex.h>
+#include <QueueStatistic.h>
 
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 using namespace Homer::Base;
+using namespace Homer::Monitor;
 
 namespace Homer { namespace Multimedia {
 
@@ -44,34 +48,125 @@ namespace Homer { namespace Multimedia {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// size of one cache line, used to keep the SPSC cursors of producer and consumer apart
+#define MEDIA_FIFO_CACHE_LINE_SIZE                  64
+
+// alignment of entries within the byte arena
+#define MEDIA_FIFO_ARENA_ALIGNMENT                  32
+
+// maximum number of wake up signals which wait for their position in SPSC mode, further signals are dropped
+#define MEDIA_FIFO_MAX_PENDING_WAKE_UPS             16
+
+// default time in ms a writer waits for free space if the FIFO is full and the overflow policy allows blocking
+#define MEDIA_FIFO_DEFAULT_BLOCK_TIMEOUT            500
+
+enum MediaFifoMode
+{
+    MEDIA_FIFO_LOCKED = 0,  // mutex based, allows any number of writer and reader threads
+    MEDIA_FIFO_SPSC         // lock-free, allows exactly one writer thread and one reader thread
+};
+
+/* behavior of a writer if the FIFO is full or its memory budget is exhausted, empty (signaling) chunks never block */
+enum MediaFifoOverflowPolicy
+{
+    MEDIA_FIFO_DROP_OLDEST = 0, // drops the oldest waiting entry, in SPSC mode the reader owns the oldest entry and the newest entry is dropped instead
+    MEDIA_FIFO_DROP_NEWEST,     // drops the entry which is currently written
+    MEDIA_FIFO_BLOCK,           // waits until the reader has freed an entry or the timeout has passed, the newest entry is dropped after a timeout
+    MEDIA_FIFO_DROP_NON_KEY     // drops non-key entries first: the oldest waiting one in locked mode, the newest one in SPSC mode where key entries wait like MEDIA_FIFO_BLOCK
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MediaBuffer;
+class MediaFifoGroup;
+
 struct MediaFifoEntry
 {
-    char    *Data;
-    int     Size;
-    int64_t Number;
-    Mutex   EntryMutex;
+    char        *Data;
+    int         Size;
+    int64_t     Number;
+    bool        KeyFrame; // entry is needed to decode the following entries, e.g., an encoded key frame
+    int64_t     WriteTime; // in us, 0 if the queue statistic was inactive when the entry was written
+    char        *Storage; // memory owned by the FIFO, Data points to it if the entry isn't shared
+    int         ArenaChunk; // index of the occupied arena chunk, -1 if none
+    MediaBuffer *SharedBuffer; // referenced memory of a shared entry, NULL if none
+    bool        Reserved; // locked mode: the entry is still filled by a writer, see WriteFifoExclusive(), readers wait without holding the entry mutex
+    Mutex       EntryMutex;
+};
+
+// one entry of a batch read, see ReadFifoBatch() and ReadFifoExclusiveBatch()
+struct MediaFifoBatchEntry
+{
+    char        *Data;
+    int         Size;
+    int64_t     Number;
+    int         EntryPointer; // FIFO entry which is held until the batch is finished, -1 for wake up signals which aren't backed by an entry
+};
+
+// one allocation within the byte arena, chunks are stored in allocation order
+struct MediaFifoArenaChunk
+{
+    int             Offset;
+    volatile bool   Busy;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class MediaFifo
+class MediaFifo:
+    public QueueStatistic
 {
 public:
     MediaFifo(std::string pName = "");
-    MediaFifo(int pFifoSize, int pFifoEntrySize, std::string pName = "");
+    /* pFifoMemoryBudget > 0 carves the entries from a byte arena of the given size instead of preallocating pFifoSize * pFifoEntrySize bytes */
+    MediaFifo(int pFifoSize, int pFifoEntrySize, std::string pName = "", enum MediaFifoMode pFifoMode = MEDIA_FIFO_LOCKED, int pFifoMemoryBudget = 0);
     virtual ~MediaFifo();
 
-    virtual void WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp);
+    virtual void WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp, bool pKeyFrame = true);
     virtual void ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimestamp); // memory copy, returns entire memory
-    virtual void ClearFifo();
+    virtual void ClearFifo(); // in SPSC mode the clear is only requested, the consumer drops the entries before its next read
 
     virtual int ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBufferTimestamp); // avoids memory copy, returns a pointer to memory
     virtual void ReadFifoExclusiveFinished(int pEntryPointer);
 
+    /* batch reads: wait for at least one entry and return up to pMaxEntries ready entries with one lock acquisition, a batch ends after an empty chunk;
+       the exclusive variant avoids memory copies and keeps all returned entries until ReadFifoExclusiveBatchFinished(),
+       the copy variant stores the entries one after another in pBuffer, entries which don't fit into it are dropped;
+       without pWaitForInput the functions return 0 if no entry is available */
+    virtual int ReadFifoBatch(char *pBuffer, int pBufferSize, MediaFifoBatchEntry *pEntries, int pMaxEntries, bool pWaitForInput = true);
+    virtual int ReadFifoExclusiveBatch(MediaFifoBatchEntry *pEntries, int pMaxEntries, bool pWaitForInput = true);
+    virtual void ReadFifoExclusiveBatchFinished(MediaFifoBatchEntry *pEntries, int pEntryCount);
+
+    /* reserves an entry of up to pBufferSize bytes and returns a pointer to its memory (avoids memory copy), returns -1 if the entry was dropped;
+       in locked mode readers wait for the reserved entry, hence the caller should fill it quickly */
+    virtual int WriteFifoExclusive(char **pBuffer, int pBufferSize);
+    /* avoids memory copy: stores a reference to the shared buffer, the reference is released after the entry was read */
+    virtual void WriteFifoShared(MediaBuffer *pBuffer, int64_t pBufferTimestamp, bool pKeyFrame = true);
+    virtual void WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp, bool pKeyFrame = true);
+
     virtual int GetEntrySize();
     virtual int GetUsage();
     virtual int GetSize();
 
+    /* readiness: timeouts in ms, 0 means infinite waiting time, both functions return FALSE after a timeout;
+       in SPSC mode WaitForInput() may only be called by the consumer and WaitForSpace() only by the producer */
+    bool HasPendingData(); // entries or wake up signals
+    bool WaitForInput(int pTimeout = 0);
+    bool WaitForSpace(int pMaxUsage, int pTimeout = 0); // waits until the usage is at most pMaxUsage entries
+
+    enum MediaFifoMode GetMode();
+    int GetMemoryBudget();
+    int GetMemoryHighWatermark();
+
+    /* pBlockTimeout: maximum time in ms a writer waits for free space, 0 waits without limit */
+    void SetOverflowPolicy(enum MediaFifoOverflowPolicy pPolicy, int pBlockTimeout = MEDIA_FIFO_DEFAULT_BLOCK_TIMEOUT);
+    enum MediaFifoOverflowPolicy GetOverflowPolicy();
+
+    /* consumer which runs as executor task: it is scheduled before a writer waits for free space, otherwise the writer would wait for a consumer which is scheduled by itself afterwards */
+    void SetConsumerTask(Task *pTask);
+
+    /* queue statistic: the FIFO registers its statistic at the queue statistic service, see SetQueueStatisticActivation() */
+    virtual QueueStatisticDescriptor GetQueueStatistic();
+
 protected:
     std::string         mName;
     MediaFifoEntry      *mFifo;
@@ -82,6 +177,120 @@ protected:
     int                 mFifoEntrySize;
     Mutex               mFifoMutex;
     Condition           mFifoDataInputCondition;
+
+private:
+friend class MediaFifoGroup;
+
+    /* pMemorySize: bytes which have to be allocated from the arena, signaling chunks have a pBufferSize of 0 */
+    int LockedAcquireEntry(int pBufferSize, int pMemorySize, bool pKeyFrame, int &pArenaChunk);
+    bool LockedHandleOverflow(int pBufferSize, bool pKeyFrame, int64_t &pBlockStartTime); // returns false if the newest entry has to be dropped, pBlockStartTime is 0 until the writer blocks the first time
+    bool LockedHasReadableEntry(); // the oldest entry isn't reserved by a writer anymore
+    bool LockedHasReservedEntry(int pQueuePositions);
+    int LockedFindNonKeyEntry();
+    void LockedDropEntry(int pQueuePosition);
+    void LockedWakeUpProducers();
+    void ScheduleConsumerTask();
+    void NotifyGroup(); // FIFO mutex mustn't be held by the caller
+    void SwapEntries(int pEntry1, int pEntry2);
+
+    /* queue statistic */
+    int64_t GetStatisticTimestamp(); // returns 0 if the queue statistic is inactive
+    void AnnounceEntryRead(int pEntry);
+    void AssignSharedBuffer(int pEntry, MediaBuffer *pBuffer);
+    void ReleaseEntry(int pEntry); // releases arena memory and shared buffer of an entry
+
+    /* lock-free single producer/single consumer mode */
+    int SpscAcquireEntry(int pMemorySize, bool pKeyFrame);
+    bool SpscTryAcquireSpace(int pEntry, int pMemorySize);
+    bool SpscHandleOverflow(int pMemorySize, bool pKeyFrame, int pReadCounter, int64_t &pBlockStartTime); // returns false if the newest entry has to be dropped, pBlockStartTime is 0 until the producer blocks the first time
+    bool SpscWaitForSpace(int pReadCounter, int64_t &pBlockStartTime);
+    void SpscWakeUpProducer();
+    void SpscPublishEntry();
+    void SpscWaitForInput();
+    void SpscWakeUpConsumer();
+    /* wake up signals: empty chunks of WriteFifo(), they don't use the producer cursor but are read after all entries which were written before them */
+    void SpscSignalWakeUp();
+    int SpscGetPendingWakeUps();
+    int SpscGetEntriesBeforeWakeUp(); // returns -1 if there is no pending signal, 0 if the oldest signal is the next chunk
+    void SpscTakeWakeUp();
+    bool SpscApplyClearRequest();
+    int SpscGetUsage();
+
+    /* byte arena storage */
+    int ArenaAllocate(int pSize);
+    int ArenaGetTailOffset();
+    void ArenaRelease(int pEntry);
+    void ArenaShrink(int pChunk, int pSize);
+    void ArenaAssign(int pEntry, int pChunk);
+
+    enum MediaFifoMode  mFifoMode;
+    /* cursors count in [0, 2 * mFifoSize) to distinguish between "full" and "empty" */
+    char                mSpscPadding0[MEDIA_FIFO_CACHE_LINE_SIZE];
+    volatile int        mSpscWriteCounter; // only modified by the producer
+    char                mSpscPadding1[MEDIA_FIFO_CACHE_LINE_SIZE - sizeof(int)];
+    volatile int        mSpscReadCounter; // only modified by the consumer
+    char                mSpscPadding2[MEDIA_FIFO_CACHE_LINE_SIZE - sizeof(int)];
+    /* rarely modified control data */
+    volatile int        mSpscConsumerWaiting;
+    volatile int        mSpscWakeUpHead; // only modified by the consumer
+    volatile int        mSpscWakeUpTail; // only modified with locked FIFO mutex
+    volatile int        mSpscClearRequested;
+    volatile int        mSpscClearMark;
+    volatile int        mSpscProducerWaiting;
+    char                mSpscPadding3[MEDIA_FIFO_CACHE_LINE_SIZE - 6 * sizeof(int)];
+    /* write cursor at the time of each pending wake up signal, the signal is read after all entries before this mark,
+       head and tail count in [0, 2 * MEDIA_FIFO_MAX_PENDING_WAKE_UPS) like the cursors */
+    volatile int        mSpscWakeUpMarks[MEDIA_FIFO_MAX_PENDING_WAKE_UPS];
+
+    /* overflow handling */
+    enum MediaFifoOverflowPolicy mOverflowPolicy;
+    int                 mOverflowBlockTimeout;
+    Condition           mFifoSpaceCondition;
+    volatile int        mSpaceWaiters; // threads within WaitForSpace() in locked mode
+    Task * volatile     mConsumerTask;
+
+    /* readiness group */
+    MediaFifoGroup      *mGroup;
+
+    /* byte arena: chunks are allocated by the producer and released by the consumer, the producer recycles them in allocation order */
+    char                *mArena;
+    int                 mArenaSize;
+    int                 mArenaWritePos;
+    int                 mArenaHighWatermark;
+    MediaFifoArenaChunk *mArenaChunks;
+    int                 mArenaChunkCount;
+    int                 mArenaChunkHead;
+    int                 mArenaChunkTail;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* wait-for-any: one consumer thread waits for input of several FIFOs, each FIFO may belong to one group only;
+   the FIFOs have to be added before and removed after their producers write to them */
+class MediaFifoGroup
+{
+public:
+    MediaFifoGroup(std::string pName = "");
+
+    virtual ~MediaFifoGroup();
+
+    void AddFifo(MediaFifo *pFifo);
+    void RemoveFifo(MediaFifo *pFifo);
+
+    /* returns a FIFO with pending data in round robin order, NULL after a timeout of pTimeout ms, 0 means infinite waiting time */
+    MediaFifo* WaitForAny(int pTimeout = 0);
+
+private:
+friend class MediaFifo;
+
+    void Notify();
+
+    std::string         mName;
+    std::vector<MediaFifo*> mFifos;
+    int                 mNextFifo;
+    Mutex               mGroupMutex;
+    Condition           mGroupCondition;
+    volatile int        mConsumerWaiting;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,7 @@
 #define _MULTIMEDIA_MEDIA_SINK_
 
 #include <PacketStatistic.h>
+#include <MediaBuffer.h>
 #include <Header_Ffmpeg.h>
 
 #include <string>
@@ -52,7 +53,10 @@ public:
 
     virtual ~MediaSink();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "") = 0;
+    // pSharedPacketData: optional reference counted copy of the packet data, shared by all media sinks of a media source
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "", MediaBuffer *pSharedPacketData = NULL) = 0;
+    // does the media sink store the packet data unchanged and can use a shared copy?
+    virtual bool SupportsSharedPacketData();
     virtual void UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp);
     virtual void SetActivation(bool pState);
 
@@ -62,6 +66,10 @@ public:
     void SetMaxFps(int pMaxFps);
     int GetMaxFps();
 
+    /* key frame requests: set by a receiver's feedback, collected by the encoder of the media source */
+    void RequestKeyFrame();
+    bool HasKeyFrameRequest(); // resets the request
+
 protected:
     bool BelowMaxFps(int pFrameNumber);
 
@@ -75,6 +83,8 @@ protected:
     int                 mMaxFps;
     int                 mMaxFpsFrameNumberLastFragment;
     int64_t             mMaxFpsTimestampLastFragment;
+    /* key frame requests */
+    int                 mKeyFrameRequested;
 };
 
 typedef std::vector<MediaSink*>        MediaSinks;
@@ -32,6 +32,8 @@
 #include <MediaFifo.h>
 #include <MediaSink.h>
 #include <RTP.h>
+#include <RTPPacketHistory.h>
+#include <RTPFec.h>
 
 namespace Homer { namespace Multimedia {
 
@@ -53,7 +55,8 @@ public:
 
     virtual ~MediaSinkMem();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "");
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "", MediaBuffer *pSharedPacketData = NULL);
+    virtual bool SupportsSharedPacketData();
     virtual void UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp);
 
     virtual int GetFragmentBufferCounter();
@@ -63,7 +66,10 @@ public:
     virtual void StopProcessing();
 
 protected:
-    virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber);
+    virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber, bool pKeyFrame = true);
+    virtual void WriteFragmentShared(MediaBuffer *pData, int64_t pFragmentNumber, bool pKeyFrame = true);
+    /* native RTP packetizer: gathers the parts of a RTP packet directly in the sink FIFO */
+    virtual void WriteFragmentVectored(RtpPacketDescriptor *pPacket, int64_t pFragmentNumber, bool pKeyFrame = true);
 
     /* RTP stream handling */
     virtual bool OpenStreamer(AVStream *pStream, std::string pStreamName);
@@ -87,6 +93,10 @@ protected:
     bool                mWaitUntillFirstKeyFrame;
     /* queue handling */
     MediaFifo           *mSinkFifo;
+    /* retransmissions: sent RTP packets are remembered if a derived class creates the history */
+    RTPPacketHistory    *mRtpPacketHistory;
+    /* forward error correction: parity packets are added if a derived class creates the encoder */
+    RTPFecEncoder       *mRtpFecEncoder;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
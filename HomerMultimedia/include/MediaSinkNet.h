@@ -31,6 +31,7 @@
 #include <NAPI.h>
 #include <HBSocket.h>
 #include <HBThread.h>
+#include <HBExecutor.h>
 #include <MediaSinkMem.h>
 
 #include <string>
@@ -46,10 +47,13 @@ namespace Homer { namespace Multimedia {
 
 //#define MSIN_DEBUG_TIMING
 
+// maximum number of packets which are taken from the sink FIFO and sent in one go
+#define MEDIA_SINK_NET_SEND_BATCH_SIZE                  64
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class MediaSinkNet:
-    public MediaSinkMem, public Thread
+    public MediaSinkMem, public Thread, public Task
 {
 
 public:
@@ -60,33 +64,54 @@ public:
 
     virtual ~MediaSinkNet();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "");
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "", MediaBuffer *pSharedPacketData = NULL);
+    virtual bool SupportsSharedPacketData();
 
     /* network oriented ID */
     static std::string CreateId(std::string pHost, std::string pPort, enum TransportType pSocketTransportType = SOCKET_TRANSPORT_TYPE_INVALID, bool pRtpActivated = true);
 
     virtual void StopProcessing();
 
+    /* RTCP feedback which was received by a network listener: receiver reports, NACKs and key frame requests are delivered to the media sink which has sent the addressed stream */
+    static bool HandleFeedback(char *pData, int pDataSize);
+
 protected:
-    virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber);
+    virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber, bool pKeyFrame = true);
 
 private:
     /* sender thread */
     virtual void* Run(void* pArgs = NULL);
+    /* sender task: used instead of the sender thread if pipeline tasks are activated at the executor */
+    virtual void Execute();
     void StartSender();
     void StopSender();
 
     /* sending one single fragment of an (rtp) packet stream */
     virtual void SendPacket(char* pData, unsigned int pSize);
+    /* sending a burst of fragments which was read from the sink FIFO */
+    void SendPackets(MediaFifoBatchEntry *pPackets, int pPacketCount);
+    /* checks if an RTP packet is a further fragment of the same frame, used for segmentation offload */
+    static bool BelongToSameRtpFrame(void *pFirstPacket, void *pPacket, int pPacketSize);
+    /* retransmission of packets from the RTP packet history */
+    void RetransmitPackets(unsigned short int *pSequenceNumbers, int pCount);
+    /* PLI/FIR: flags the request at the addressed media sinks */
+    static bool HandleKeyFrameRequest(char *pData, int pDataSize);
+    /* receiver reports: the FEC overhead follows the packet loss of the receiver */
+    static bool HandleReceiverReport(char *pData, int pDataSize);
 
     void BasicInit(string pTargetHost, unsigned int pTargetPort);
 
     /* general transport */
     bool                mSenderNeeded;
+    bool                mSenderIsTask;
     int                 mMaxNetworkPacketSize;
     bool                mBrokenPipe;
     bool                mStreamedTransport;
     char                *mStreamFragmentCopyBuffer;
+    /* retransmissions */
+    Mutex               mRetransmissionMutex; // held during a retransmission, the destructor waits for it
+    char                *mRetransmissionBuffer;
+    int64_t             mRetransmittedPackets;
     /* Berkeley sockets based transport */
     Socket              *mDataSocket;
     /* NAPI based transport */
@@ -31,6 +31,8 @@
 #include <MediaFifo.h>
 #include <MediaSource.h>
 #include <RTP.h>
+#include <RTPJitterBuffer.h>
+#include <RTPFec.h>
 #include <VideoScaler.h>
 
 #include <HBThread.h>
@@ -71,6 +73,12 @@ namespace Homer { namespace Multimedia {
 
 #define MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT     ((System::GetTargetMachineType() != "x86") ? 1024 : 512)
 
+// memory budget of the fragment queue, fragments are usually limited by the MTU
+#define MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_MEMORY_BUDGET  (MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT * 2 * 1024)
+
+// minimum time between two key frame requests (PLI) because of packet loss, the key frame needs some time until it arrives
+#define MEDIA_SOURCE_MEM_KEY_FRAME_REQUEST_INTERVAL          (500 * 1000) // 500 ms
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct MediaInputQueueEntry
@@ -117,6 +125,12 @@ public:
     /* transmission quality */
     virtual int64_t GetEndToEndDelay(); // in us
     virtual float GetRelativeLoss();
+    RtpJitterBufferStatistic GetJitterBufferStatistic();
+    RtpFecStatistic GetFecStatistic();
+
+    /* jitter buffer for received RTP packets, activated by default */
+    static void DisableJitterBuffer();
+    static bool IsJitterBufferActivated();
 
     /* video grabbing control */
     virtual void GetVideoDisplayAspectRation(int &pHoriz, int &pVert);
@@ -148,6 +162,9 @@ public:
 
     // send input to the media source
     void WriteFragment(char *pBuffer, int pBufferSize, int64_t pFragmentNumber);
+    // avoids memory copy: reserves a fragment within the input queue, returns -1 if no fragment is available
+    int WriteFragmentExclusive(char **pBuffer, int pBufferSize);
+    void WriteFragmentExclusiveFinished(int pFragmentEntry, int pBufferSize, int64_t pFragmentNumber);
 
 protected:
     /* internal video resolution switch */
@@ -155,6 +172,12 @@ protected:
 
     static int GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBufferSize);
     virtual void ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber);
+    void ReadBufferedFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber); // reads fragments through the jitter buffer
+    void RequestRetransmissions();
+    void RequestKeyFrame(); // on stream start and after unrecoverable packet loss
+    void SendReceiverReport(); // tells the sender of a FEC protected stream about the packet loss
+    /* sends RTCP feedback towards the sender of the received stream, returns false if there is no back channel */
+    virtual bool SendFeedback(char *pData, int pDataSize);
 
     bool IsAcceptableStartFrame(AVFrame *pFrame);
     virtual bool InputIsPicture();
@@ -213,6 +236,15 @@ protected:
     Mutex               mDecoderSeekMutex;
     MediaFifo           *mDecoderFragmentFifo;
     Mutex               mDecoderFragmentFifoDestructionMutex;
+    RTPJitterBuffer     mDecoderJitterBuffer;
+    unsigned int        mDecoderFeedbackSourceIdentifier; // our SSRC in RTCP feedback
+    int64_t             mDecoderRequestedRetransmissions;
+    unsigned int        mDecoderKeyFrameRequestSourceIdentifier; // SSRC of the stream we have requested a key frame for
+    int64_t             mDecoderKeyFrameRequestLostPackets; // lost packets of the jitter buffer at the time of the last request
+    int64_t             mDecoderKeyFrameRequestTime;
+    int64_t             mDecoderRequestedKeyFrames;
+    RTPFecDecoder       mDecoderFecDecoder;
+    int64_t             mDecoderFecReportedRecoveredPackets;
     MediaFifo           *mDecoderFifo; // for frames
     int                 mDecoderExpectedMaxOutputPerInputFrame; // how many output frames can be calculated of one input frame?
     /* decoder thread seeking */
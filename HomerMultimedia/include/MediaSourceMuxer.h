@@ -55,6 +55,9 @@ namespace Homer { namespace Multimedia {
 // amount of entries within the input FIFO
 #define MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT                  32
 
+// minimum time between two key frames which are forced by requests of the receivers
+#define MEDIA_SOURCE_MUX_KEY_FRAME_REQUEST_INTERVAL              (250 * 1000) // 250 ms
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class MediaSourceMuxer:
@@ -222,6 +225,8 @@ private:
     void StopEncoder();
 
     void ResetEncoderBuffers();
+    /* collects the key frame requests of all registered media sinks */
+    bool HasKeyFrameRequest();
 
     static int FfmpegWriteOneOutputPacket(AVFormatContext *pFormatContext, AVPacket *pAVPacket);
     static int FfmpegForceOneOutputStream(AVFormatContext *pFormatContext);
@@ -248,6 +253,8 @@ private:
     Mutex               mEncoderFifoAvailableMutex;
     int                 mEncoderBufferedFrames; // in frames
     int64_t             mEncoderStartTime;
+    int64_t             mEncoderForcedKeyFrameTime;
+    int64_t             mEncoderForcedKeyFrames;
     /* device control */
     MediaSources        mMediaSources;
     Mutex               mMediaSourcesMutex;
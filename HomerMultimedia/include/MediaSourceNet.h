@@ -83,6 +83,9 @@ protected:
 
     void Init();
 
+    /* RTCP feedback is sent via the listener socket to the current peer */
+    virtual bool SendFeedback(char *pData, int pDataSize);
+
     NetworkListener     *mNetworkListener;
 };
 
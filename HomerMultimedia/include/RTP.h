@@ -29,6 +29,7 @@
 
 #include <Header_Ffmpeg.h>
 #include <PacketStatistic.h>
+#include <RTPPacketizer.h>
 
 #include <sys/types.h>
 #include <string>
@@ -62,9 +63,25 @@ enum RtcpType{
     RTCP_RECEIVER_REPORT = 201,
     RTCP_SOURCE_DESCRIPTION = 202,
     RTCP_BYE = 203,
-    RTCP_APP = 204
+    RTCP_APP = 204,
+    RTCP_TRANSPORT_FEEDBACK = 205, // RFC 4585
+    RTCP_PAYLOAD_FEEDBACK = 206 // RFC 4585
 };
 
+// generic NACK (RFC 4585): feedback message type and the maximum number of sequence numbers we request with one RTCP packet
+#define RTCP_FEEDBACK_GENERIC_NACK              1
+#define RTCP_NACK_MAX_PACKETS                   64
+// RTCP header (12 bytes) and, in the worst case of isolated losses, one FCI entry (4 bytes) per sequence number
+#define RTCP_NACK_MAX_SIZE                      (12 + 4 * RTCP_NACK_MAX_PACKETS)
+
+// key frame requests: picture loss indication (RFC 4585) and full intra request (RFC 5104)
+#define RTCP_FEEDBACK_PLI                       1
+#define RTCP_FEEDBACK_FIR                       4
+#define RTCP_PLI_SIZE                           12
+
+// receiver report with one report block, it tells the sender about the measured packet loss
+#define RTCP_RECEIVER_REPORT_SIZE               32
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // ########################## RTCP ###########################################
@@ -173,6 +190,13 @@ public:
     /* RTP packetizing/parsing */
     void SetExternallyNegotiatedPayloadID(unsigned int pNewID); //should be called before the first frame packet gets packetized
     bool RtpCreate(AVPacket *pAVPacket, char *&pResultingOutputData, unsigned int &pResultingOutputDataSize);
+    /* native packetizer: the packets reference the encoded frame of pAVPacket and stay valid until the next call,
+       pSenderReport is a RTCP packet which has to be sent before the packets, it is NULL if there is none */
+    bool RtpCreateVectored(AVPacket *pAVPacket, RtpPacketDescriptor *&pPackets, int &pPacketCount, char *&pSenderReport, unsigned int &pSenderReportSize);
+
+    /* native H.264/HEVC packetizer (see RTPPacketizer.h): replaces the ffmpeg RTP muxer for these codecs, activated by default */
+    static bool IsNativePacketizerSupported();
+    static void DisableNativePacketizerSupport();
 
     unsigned int GetLostPacketsFromRTP();
     static void LogRtpHeader(RtpHeader *pRtpHeader);
@@ -192,12 +216,39 @@ public:
     bool RtcpParseSenderDescription(char *&pData, int &pDataSize);
     bool RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPackets, unsigned int &pOctets);
 
+    /* RTCP generic NACK (RFC 4585): requests retransmissions of lost RTP packets, activated by default */
+    static bool IsNackSupported();
+    static void DisableNackSupport();
+    static bool IsRtcpTransportFeedback(char *pData, int pDataSize);
+    static bool RtcpCreateNack(unsigned int pSenderSsrc, unsigned int pMediaSsrc, unsigned short int *pSequenceNumbers, int pCount, char *pBuffer, int &pBufferSize);
+    /* pCount: maximum number of sequence numbers as input, found number as output */
+    static bool RtcpParseNack(char *pData, int pDataSize, unsigned int &pMediaSsrc, unsigned short int *pSequenceNumbers, int &pCount);
+
+    /* RTCP key frame requests (PLI/FIR): the sender encodes the next frame as key frame, activated by default */
+    static bool IsKeyFrameRequestSupported();
+    static void DisableKeyFrameRequestSupport();
+    static bool IsRtcpPayloadFeedback(char *pData, int pDataSize);
+    static bool RtcpCreatePli(unsigned int pSenderSsrc, unsigned int pMediaSsrc, char *pBuffer, int &pBufferSize);
+    /* accepts PLI and FIR */
+    static bool RtcpParseKeyFrameRequest(char *pData, int pDataSize, unsigned int &pMediaSsrc);
+
+    /* forward error correction: the sender adds XOR parity packets (see RTPFec.h), deactivated by default */
+    static bool IsFecActivated();
+    static void ActivateFec();
+    static bool RtcpCreateReceiverReport(unsigned int pSenderSsrc, unsigned int pMediaSsrc, float pRelativeLoss, char *pBuffer, int &pBufferSize);
+    static bool RtcpParseReceiverReport(char *pData, int pDataSize, unsigned int &pMediaSsrc, float &pRelativeLoss);
+
+    /* RTCP packets from the receivers of our streams: receiver reports, transport and payload feedback */
+    static bool IsRtcpFeedback(char *pData, int pDataSize);
+
 protected:
     uint64_t GetCurrentPtsFromRTP(); // returns the timestamp of the last received RTP packet
     void GetSynchronizationReferenceFromRTP(uint64_t &pReferenceNtpTime, uint64_t &pReferencePts);
     void SetSynchronizationReferenceForRTP(uint64_t pReferenceNtpTime, uint64_t pReferencePts);
     unsigned int GetSourceIdentifierFromRTP(); // returns the RTP source identifier
+    unsigned int GetLocalSourceIdentifierFromRTP(); // returns the RTP source identifier of the encoder
     bool HasSourceChangedFromRTP(); // return if RTP source identifier has changed and resets the flag
+    bool IsNativePacketizerUsed(); // RtpCreateVectored() has to be used instead of RtpCreate()
 
     /* for clock rate adaption, e.g., 8, 16, 90 kHz */
     float CalculateClockRateFactor();
@@ -212,7 +263,16 @@ private:
     /* internal RTP packetizer for h.261 */
     bool OpenRtpEncoderH261(std::string pTargetHost, unsigned int pTargetPort, AVStream *pInnerStream);
     bool RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPts);
-    void RtcpCreateH261SenderReport(char *&pData, unsigned int &pDataSize, int64_t pCurPts);
+
+    /* native RTP packetizer for h.264/hevc */
+    bool OpenRtpEncoderNative(std::string pTargetHost, unsigned int pTargetPort, AVStream *pInnerStream);
+
+    /* sender reports of the internal packetizers */
+    void RtcpCreateInternalSenderReport(char *&pData, unsigned int &pDataSize, int64_t pCurPts);
+
+    /* H.264 STAP-A, HEVC AP: converts the aggregated NAL units in place into NAL units with start codes, pData points to the size field of the
+       first NAL unit and is moved backwards by up to one byte per additional NAL unit, pHeadroom gives the available bytes in front of it */
+    static bool RtpConvertAggregationPacket(char *&pData, int pDataSize, int pDondFieldSize, int pHeadroom);
 
     /* RTP packet stream */
     static int StoreRtpPacket(void *pOpaque, uint8_t *pBuffer, int pBufferSize);
@@ -266,14 +326,18 @@ private:
     /* H261 RTP encoder */
     static unsigned int mH261PayloadSizeMax;
     bool                mH261UseInternalEncoder;
-    unsigned short int  mH261LocalSequenceNumber;
-    uint64_t            mH261SentPackets;
-    uint64_t            mH261SentOctets;
-    uint64_t            mH261SentOctetsLastSenderReport;
-    uint64_t            mH261SentNtpTimeLastSenderReport;
-    uint64_t            mH261SentNtpTimeBase;
-    int                 mH261SenderReports;
-    bool                mH261FirstPacket;
+    /* H264/HEVC RTP encoder */
+    RTPPacketizer       *mNativePacketizer;
+    uint32_t            mNativeSenderReport[(4 + RTCP_HEADER_SIZE) / 4]; // size field and RTCP packet
+    /* internal RTP encoders */
+    unsigned short int  mInternalSequenceNumber;
+    uint64_t            mInternalSentPackets;
+    uint64_t            mInternalSentOctets;
+    uint64_t            mInternalSentOctetsLastSenderReport;
+    uint64_t            mInternalSentNtpTimeLastSenderReport;
+    uint64_t            mInternalSentNtpTimeBase;
+    int                 mInternalSenderReports;
+    bool                mInternalFirstPacket;
     /* RTCP */
     Mutex               mSynchDataMutex;
     uint64_t            mRtcpLastRemoteNtpTime; // (NTP timestamp)
@@ -294,6 +358,7 @@ private:
 protected:
     /* derived stats based on RTCP */
     float               mRtcpRelativeLoss;
+    uint64_t            mRtcpExpectedPackets; // sent packets between the last two sender reports
     int64_t             mRtcpEndToEndDelay; // in us
     int64_t             mRtcpSenderReportsReceived;
     std::string         mRtcpSenderDescription;
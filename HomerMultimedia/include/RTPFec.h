@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: XOR parity based forward error correction (RFC 5109) for RTP streams
+ * Since:   2026-10-17
+ */
+
+#ifndef _MULTIMEDIA_RTP_FEC_
+#define _MULTIMEDIA_RTP_FEC_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of FEC packets
+//#define RTPFEC_DEBUG_PACKETS
+
+///////////////////////////////////////////////////////////////////////////////
+
+// dynamic payload type of FEC packets, they are sent within the protected RTP stream (same SSRC, own sequence numbers)
+#define RTP_FEC_PAYLOAD_TYPE                        127
+
+// RTP header (12 bytes), FEC header (10 bytes) and one FEC level header with a 16 bit mask (4 bytes)
+#define RTP_FEC_HEADER_SIZE                         26
+
+// maximum size of a protected RTP packet
+#define RTP_FEC_MAX_PACKET_SIZE                     (8 * 1024)
+
+// number of media packets which are protected by one FEC packet
+#define RTP_FEC_MIN_GROUP_SIZE                      2
+#define RTP_FEC_MAX_GROUP_SIZE                      16 // limited by the 16 bit mask
+#define RTP_FEC_DEFAULT_GROUP_SIZE                  8
+
+// receiver: number of remembered media packets and of FEC packets which wait for missing media packets
+#define RTP_FEC_DECODER_WINDOW                      64
+#define RTP_FEC_DECODER_MAX_FEC_PACKETS             8
+
+struct RtpFecSlot
+{
+    char                *Data;
+    int                 Size;
+    int                 Capacity;
+    unsigned short int  SequenceNumber;
+    bool                Used;
+};
+
+struct RtpFecStatistic
+{
+    int64_t     FecPackets;     // received FEC packets
+    int64_t     Recovered;      // media packets which were restored from FEC packets
+    int64_t     Unrecoverable;  // FEC packets which were discarded because more than one of their media packets was missing
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//HINT: the encoder is used by the thread which creates the RTP packets, only the group size may be set by another thread
+class RTPFecEncoder
+{
+public:
+    RTPFecEncoder();
+    virtual ~RTPFecEncoder();
+
+    /* the group size is adapted to the loss rate which is reported by the receiver */
+    static int CalculateGroupSize(float pRelativeLoss /* in % */);
+    void SetGroupSize(int pGroupSize); // applied to the next group
+    int GetGroupSize();
+
+    /* adds a RTP packet to the current group, returns true if the group is complete:
+       pFecPacket points to the FEC packet then, it is valid until the next call */
+    bool Protect(char *pData, int pDataSize, char *&pFecPacket, int &pFecPacketSize);
+    void Reset();
+
+    int64_t GetFecPackets();
+
+private:
+    void StartGroup(char *pData, int pGroupSize);
+
+    char                mFecPacket[RTP_FEC_HEADER_SIZE + RTP_FEC_MAX_PACKET_SIZE];
+    int                 mProtectionLength; // size of the longest protected payload
+    int                 mGroupPackets; // protected packets within current group
+    int                 mGroupSize;
+    int                 mRequestedGroupSize;
+    unsigned short int  mGroupSequenceNumberBase;
+    unsigned short int  mFecSequenceNumber;
+    unsigned int        mSsrc;
+    int64_t             mFecPackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//HINT: the decoder is used by exactly one thread: the one which feeds the jitter buffer
+class RTPFecDecoder
+{
+public:
+    RTPFecDecoder();
+    virtual ~RTPFecDecoder();
+
+    static bool IsFecPacket(char *pData, int pDataSize);
+
+    /* received media packets are remembered for the recovery of lost ones of the same group */
+    void StoreMediaPacket(char *pData, int pDataSize);
+    void StoreFecPacket(char *pData, int pDataSize);
+    /* copies the next recovered media packet to pBuffer */
+    bool GetRecoveredPacket(char *pBuffer, int &pBufferSize);
+    void Reset();
+
+    bool IsActive(); // did we receive FEC packets?
+    RtpFecStatistic GetStatistic();
+
+private:
+    bool StoreSlot(RtpFecSlot *pSlot, char *pData, int pDataSize); // pData = NULL only allocates the slot
+    void DropPackets(unsigned int pSsrc);
+    void Recover();
+    bool RecoverPacket(RtpFecSlot *pFecSlot, unsigned short int pSequenceNumber);
+    
+    RtpFecSlot          mMediaSlots[RTP_FEC_DECODER_WINDOW];
+    RtpFecSlot          mFecSlots[RTP_FEC_DECODER_MAX_FEC_PACKETS];
+    unsigned short int  mRecoveredPackets[RTP_FEC_DECODER_MAX_FEC_PACKETS];
+    int                 mRecoveredPacketsCount;
+    unsigned int        mSsrc;
+    unsigned short int  mHighestSequenceNumber;
+    bool                mActive;
+    /* statistic */
+    int64_t             mFecPacketsCount;
+    int64_t             mRecoveredPacketsTotal;
+    int64_t             mUnrecoverablePackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -0,0 +1,140 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: RTP jitter buffer which reorders received packets by their sequence numbers
+ * Since:   2026-10-17
+ */
+
+#ifndef _MULTIMEDIA_RTP_JITTER_BUFFER_
+#define _MULTIMEDIA_RTP_JITTER_BUFFER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the jitter buffer
+//#define RTPJB_DEBUG_PACKETS
+//#define RTPJB_DEBUG_DELAY
+
+///////////////////////////////////////////////////////////////////////////////
+
+// number of packet slots, defines the reordering window in sequence numbers
+#define RTP_JITTER_BUFFER_SIZE                      1024
+
+// adaptive playout delay: how long do we wait for a missing packet?
+#define RTP_JITTER_BUFFER_INITIAL_DELAY             40000 // us
+#define RTP_JITTER_BUFFER_MIN_DELAY                 10000 // us
+#define RTP_JITTER_BUFFER_MAX_DELAY                 250000 // us
+
+// how many newly detected missing packets are remembered until they are fetched for retransmission requests?
+#define RTP_JITTER_BUFFER_MAX_MISSING_PACKETS       64
+
+// results of Insert()
+enum RtpJitterBufferInsertResult
+{
+    RTP_JITTER_BUFFER_PASS = 0, // packet is the next expected one and nothing is buffered: the caller can use the packet directly
+    RTP_JITTER_BUFFER_STORED,   // packet was stored and will be released by Pop()
+    RTP_JITTER_BUFFER_DROPPED   // packet is late or a duplicate
+};
+
+struct RtpJitterBufferStatistic
+{
+    int64_t     Late;           // packets which arrived after their playout deadline
+    int64_t     Lost;           // packets which were skipped at their playout deadline
+    int64_t     Reordered;      // packets which arrived after a packet with a higher sequence number
+    int64_t     Duplicates;
+    int64_t     Requested;      // packets which were requested for retransmission, counted by the user of the jitter buffer
+    int         BufferedPackets;
+    int64_t     PlayoutDelay;   // in us
+};
+
+struct RtpJitterBufferSlot
+{
+    char        *Data;
+    int         Size;
+    int         Capacity;
+    int64_t     ExtendedSequenceNumber;
+    int64_t     ArrivalTime;    // in us
+    bool        Used;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//HINT: the jitter buffer is used by exactly one thread: the one which feeds the depacketizer
+//HINT: packets are released in sequence number order, a gap blocks the output until the missing packet arrives or its playout deadline has passed
+class RTPJitterBuffer
+{
+public:
+    RTPJitterBuffer();
+    virtual ~RTPJitterBuffer();
+
+    /* RTCP packets and other data can't be ordered and have to bypass the jitter buffer */
+    static bool IsRtpPacket(char *pData, int pDataSize);
+
+    /* pNow: monotonic time stamp in us, pExtendedSequenceNumber: the unwrapped sequence number of the packet */
+    enum RtpJitterBufferInsertResult Insert(char *pData, int pDataSize, int64_t pNow, int64_t &pExtendedSequenceNumber);
+    /* returns true and copies the next packet to pBuffer if it is available,
+       otherwise pWaitTime is set to the time in us until the next playout deadline or to 0 if nothing is buffered */
+    bool Pop(char *pBuffer, int &pBufferSize, int64_t &pExtendedSequenceNumber, int64_t &pWaitTime, int64_t pNow);
+    void Reset();
+
+    /* returns the sequence numbers of packets which were detected as missing since the last call */
+    int GetMissingPackets(unsigned short int *pSequenceNumbers, int pMaxCount);
+    unsigned int GetSourceIdentifier();
+
+    int GetBufferedPackets();
+    int64_t GetLostPackets();
+    int64_t GetPlayoutDelay(); // in us
+    RtpJitterBufferStatistic GetStatistic();
+
+private:
+    void Restart(int64_t pExtendedSequenceNumber, unsigned int pSsrc);
+    void DropPackets();
+    void ReleaseSlot(RtpJitterBufferSlot *pSlot);
+    int64_t FindNextPacket(); // extended sequence number of the first buffered packet behind the head
+    void IncreaseDelay(int64_t pDelay);
+    void DecreaseDelay();
+
+    RtpJitterBufferSlot mSlots[RTP_JITTER_BUFFER_SIZE];
+    bool                mStarted;
+    unsigned int        mSsrc;
+    int64_t             mNextSequenceNumber; // extended sequence number of the next packet which has to be released
+    int64_t             mHighestSequenceNumber;
+    int64_t             mGapTime; // arrival time of the first packet behind the current gap, -1 if unknown
+    int64_t             mPlayoutDelay;
+    int                 mBufferedPackets;
+    unsigned short int  mMissingPackets[RTP_JITTER_BUFFER_MAX_MISSING_PACKETS];
+    int                 mMissingPacketsCount;
+    /* statistic */
+    int64_t             mLatePackets;
+    int64_t             mLostPackets;
+    int64_t             mReorderedPackets;
+    int64_t             mDuplicatePackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
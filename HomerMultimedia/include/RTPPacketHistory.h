@@ -0,0 +1,83 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: history of recently sent RTP packets for retransmissions
+ * Since:   2026-10-17
+ */
+
+#ifndef _MULTIMEDIA_RTP_PACKET_HISTORY_
+#define _MULTIMEDIA_RTP_PACKET_HISTORY_
+
+#include <HBMutex.h>
+#include <RTPPacketizer.h>
+
+using namespace Homer::Base;
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// number of remembered packets, indexed by their sequence numbers
+#define RTP_PACKET_HISTORY_SIZE                     512
+
+struct RtpPacketHistorySlot
+{
+    char                *Data;
+    int                 Size;
+    int                 Capacity;
+    unsigned short int  SequenceNumber;
+    bool                Used;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//HINT: packets are stored by the sending thread and fetched by the thread which receives the retransmission requests
+class RTPPacketHistory
+{
+public:
+    RTPPacketHistory();
+    virtual ~RTPPacketHistory();
+
+    /* stores a copy of a sent RTP packet, RTCP and FEC packets are ignored */
+    void Store(char *pData, int pDataSize);
+    /* the same for a packet which is described by its parts, the first part has to contain the RTP header */
+    void Store(RtpPacketDescriptor *pPacket);
+    /* copies a stored packet to pBuffer, returns false if the packet isn't available anymore */
+    bool Get(unsigned short int pSequenceNumber, char *pBuffer, int &pBufferSize);
+    void Reset();
+
+    unsigned int GetSourceIdentifier(); // SSRC of the stored packets
+
+private:
+    /* returns the slot for the packet with enough capacity and the locked mutex or NULL if the packet isn't stored */
+    RtpPacketHistorySlot* LockSlot(char *pHeader, int pDataSize);
+
+    Mutex                   mMutex;
+    RtpPacketHistorySlot    mSlots[RTP_PACKET_HISTORY_SIZE];
+    unsigned int            mSsrc;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
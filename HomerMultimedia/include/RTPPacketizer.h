@@ -0,0 +1,122 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: native RTP packetizer for H.264 (RFC 6184) and HEVC (RFC 7798)
+ * Since:   2026-10-17
+ */
+
+#ifndef _MULTIMEDIA_RTP_PACKETIZER_
+#define _MULTIMEDIA_RTP_PACKETIZER_
+
+#include <Header_Ffmpeg.h>
+
+#include <vector>
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of created packets
+//#define RTPPACKETIZER_DEBUG_PACKETS
+
+///////////////////////////////////////////////////////////////////////////////
+
+// size of a RTP header without CSRCs
+#define RTP_PACKETIZER_RTP_HEADER_SIZE              12
+
+// maximum number of NAL units within one aggregation packet (H.264: STAP-A, HEVC: AP),
+// the receiver converts aggregation packets in place and needs one byte per additional NAL unit in front of the payload
+#define RTP_PACKETIZER_MAX_AGGREGATED_NAL_UNITS     8
+
+// RTP header, payload header (H.264: 1 byte, HEVC: 2 bytes) and the size fields of aggregated NAL units
+#define RTP_PACKETIZER_HEADER_BUFFER_SIZE           (RTP_PACKETIZER_RTP_HEADER_SIZE + 2 + 2 * RTP_PACKETIZER_MAX_AGGREGATED_NAL_UNITS)
+
+// aggregation packets: one reference per NAL unit and one per size field, the first size field belongs to the first vector
+#define RTP_PACKETIZER_MAX_VECTORS                  (2 * RTP_PACKETIZER_MAX_AGGREGATED_NAL_UNITS)
+
+// one part of a RTP packet: either within the header memory of the packet or within the encoded frame
+struct RtpPacketVector
+{
+    char            *Data;
+    unsigned int    Size;
+};
+
+// one RTP packet described by its parts, the parts have to be sent one after another
+struct RtpPacketDescriptor
+{
+    char            Header[RTP_PACKETIZER_HEADER_BUFFER_SIZE]; // starts with the RTP header which is filled by the caller, first member for 32 bit alignment
+    RtpPacketVector Vectors[RTP_PACKETIZER_MAX_VECTORS]; // the first vector points to Header
+    int             VectorCount;
+    unsigned int    Size; // of all vectors
+    bool            LastPacket; // last packet of the frame, the RTP marker bit has to be set
+};
+
+struct RtpNalUnit
+{
+    char            *Data;
+    unsigned int    Size;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//HINT: the packetizer doesn't copy the encoded frame, the created packets reference it instead
+class RTPPacketizer
+{
+public:
+    RTPPacketizer();
+    virtual ~RTPPacketizer();
+
+    static bool IsCodecSupported(enum AVCodecID pCodecId);
+
+    /* pMaxPacketSize: limit for entire RTP packets, a "avcC"/"hvcC" configuration in pExtraData announces
+       length prefixed NAL units, otherwise NAL units separated by start codes (Annex B) are expected */
+    bool Open(enum AVCodecID pCodecId, unsigned int pMaxPacketSize, const uint8_t *pExtraData, int pExtraDataSize);
+
+    /* splits an encoded frame into RTP packets, returns the number of packets: they reference the memory of pData
+       and stay valid until the next call, only the RTP headers are left to the caller */
+    int Packetize(char *pData, unsigned int pDataSize, RtpPacketDescriptor *&pPackets);
+
+private:
+    void FindNalUnits(char *pData, unsigned int pDataSize);
+    void FindNalUnitsLengthPrefixed(char *pData, unsigned int pDataSize);
+    static char* FindStartCode(char *pData, char *pDataEnd);
+    RtpPacketDescriptor* CreatePacket(unsigned int pPayloadHeaderSize);
+    void AddVector(RtpPacketDescriptor *pPacket, char *pData, unsigned int pSize);
+    void CreateSingleNalUnitPacket(RtpNalUnit *pNalUnit);
+    void CreateAggregationPacket(RtpNalUnit *pNalUnits, int pCount);
+    void CreateFragmentationUnits(RtpNalUnit *pNalUnit);
+
+    enum AVCodecID      mCodecId;
+    unsigned int        mMaxPayloadSize;
+    unsigned int        mNalHeaderSize; // H.264: 1 byte, HEVC: 2 bytes
+    int                 mNalLengthSize; // 0 for start codes
+    std::vector<RtpNalUnit> mNalUnits;
+    std::vector<RtpPacketDescriptor> mPackets;
+    int                 mPacketCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -60,7 +60,9 @@ public:
     void StartScaler(int pInputQueueSize, int pSourceResX, int pSourceResY, enum PixelFormat pSourcePixelFormat, int pTargetResX, int pTargetResY, enum PixelFormat pTargetPixelFormat);
     void StopScaler();
 
-    virtual void WriteFifo(char* pBuffer, int pBufferSize, int64_t pFrameTimestamp);
+    virtual void WriteFifo(char* pBuffer, int pBufferSize, int64_t pFrameTimestamp, bool pKeyFrame = true);
+    virtual int WriteFifoExclusive(char **pBuffer, int pBufferSize); // avoids memory copy, keeps the input FIFO locked until WriteFifoExclusiveFinished()
+    virtual void WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pFrameTimestamp, bool pKeyFrame = true);
     virtual void ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pFrameTimestamp); // memory copy, returns entire memory
     virtual void ClearFifo();
 
@@ -0,0 +1,300 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: micro benchmark for the RTP packetizers of H.264/HEVC streams
+ * Since:   2026-10-17
+ */
+
+#include <Header_Ffmpeg.h>
+#include <MediaSource.h>
+#include <RTP.h>
+#include <HBTime.h>
+#include <Logger.h>
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+using namespace Homer::Base;
+using namespace Homer::Multimedia;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCHMARK_DEFAULT_ITERATIONS                2000
+// RTP packets including the RTP header, like MediaSourceMuxer
+#define BENCHMARK_RTP_PACKET_SIZE                   1400
+// total size of the packets of one frame after they were written to the sink FIFO
+#define BENCHMARK_FIFO_SIZE                         (4 * 1024 * 1024)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the destination of the RTP packets: a media sink copies every packet into its FIFO
+static char sFifo[BENCHMARK_FIFO_SIZE];
+
+/* former path: the RTP muxer of ffmpeg delivers a stream of length prefixed RTP packets, which is walked and copied packet by packet (see MediaSinkMem::ProcessPacket) */
+static int64_t StoreFfmpegPackets(RTP *pRtp, AVPacket *pAVPacket)
+{
+    char *tStream = NULL;
+    unsigned int tStreamSize = 0;
+    int64_t tStored = 0;
+
+    if ((!pRtp->RtpCreate(pAVPacket, tStream, tStreamSize)) || (tStream == NULL))
+        return 0;
+
+    char *tRtpPacket = tStream + 4;
+    uint32_t tRemainingSize = tStreamSize;
+    while (tRemainingSize > RTP_HEADER_SIZE)
+    {
+        uint32_t tRtpPacketSize = ntohl(*(uint32_t*)(tRtpPacket - 4));
+        if ((tRtpPacketSize == 0) || (tStored + tRtpPacketSize > BENCHMARK_FIFO_SIZE))
+            break;
+        memcpy(sFifo + tStored, tRtpPacket, tRtpPacketSize);
+        tStored += tRtpPacketSize;
+        tRtpPacket += tRtpPacketSize + 4;
+        tRemainingSize -= tRtpPacketSize + 4;
+    }
+
+    return tStored;
+}
+
+/* native path: the RTP packets reference the encoded frame and are gathered in the FIFO (see MediaSinkMem::WriteFragmentVectored) */
+static int64_t StoreNativePackets(RTP *pRtp, AVPacket *pAVPacket)
+{
+    RtpPacketDescriptor *tPackets = NULL;
+    int tPacketCount = 0;
+    char *tSenderReport = NULL;
+    unsigned int tSenderReportSize = 0;
+    int64_t tStored = 0;
+
+    if (!pRtp->RtpCreateVectored(pAVPacket, tPackets, tPacketCount, tSenderReport, tSenderReportSize))
+        return 0;
+
+    if (tSenderReport != NULL)
+    {
+        memcpy(sFifo, tSenderReport, tSenderReportSize);
+        tStored += tSenderReportSize;
+    }
+    for (int i = 0; i < tPacketCount; i++)
+    {
+        if (tStored + tPackets[i].Size > BENCHMARK_FIFO_SIZE)
+            break;
+        for (int j = 0; j < tPackets[i].VectorCount; j++)
+        {
+            memcpy(sFifo + tStored, tPackets[i].Vectors[j].Data, tPackets[i].Vectors[j].Size);
+            tStored += tPackets[i].Vectors[j].Size;
+        }
+    }
+
+    return tStored;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* Annex B frame with random payload: SPS, PPS and one slice which has to be fragmented */
+static void CreateFrame(enum AVCodecID pCodecId, vector<char> &pFrame, unsigned int pSize)
+{
+    static const char sH264NalUnits[3] = { 0x67 /* SPS */, 0x68 /* PPS */, 0x65 /* IDR slice */ };
+    static const char sHevcNalUnits[3] = { 33 << 1 /* SPS */, 34 << 1 /* PPS */, 19 << 1 /* IDR slice */ };
+    const char *tNalUnits = (pCodecId == AV_CODEC_ID_H264) ? sH264NalUnits : sHevcNalUnits;
+    unsigned int tNalUnitStart[3] = { 0, 16, 32 };
+
+    pFrame.resize(pSize + FF_INPUT_BUFFER_PADDING_SIZE);
+    // random bytes without zeros can't form start codes
+    for (unsigned int i = 0; i < pSize; i++)
+        pFrame[i] = (char)(1 + rand() % 255);
+    for (int i = 0; i < 3; i++)
+    {
+        memcpy(&pFrame[tNalUnitStart[i]], "\0\0\0\1", 4);
+        pFrame[tNalUnitStart[i] + 4] = tNalUnits[i];
+        if (pCodecId != AV_CODEC_ID_H264)
+            pFrame[tNalUnitStart[i] + 5] = 1; // temporal id
+    }
+}
+
+static AVStream* CreateStream(AVFormatContext *pFormatContext, enum AVCodecID pCodecId)
+{
+    AVCodec *tCodec = avcodec_find_decoder(pCodecId);
+    if (tCodec == NULL)
+        return NULL;
+
+    AVStream *tStream = HM_avformat_new_stream(pFormatContext, tCodec);
+    if (tStream == NULL)
+        return NULL;
+
+    tStream->codec->codec = tCodec;
+    tStream->codec->codec_id = pCodecId;
+    tStream->codec->codec_type = AVMEDIA_TYPE_VIDEO;
+    tStream->codec->width = 1280;
+    tStream->codec->height = 720;
+    tStream->codec->pix_fmt = PIX_FMT_YUV420P;
+    tStream->codec->time_base.num = 1;
+    tStream->codec->time_base.den = 90000;
+    tStream->time_base = tStream->codec->time_base;
+    tStream->codec->rtp_payload_size = BENCHMARK_RTP_PACKET_SIZE;
+
+    return tStream;
+}
+
+// packetizers of one codec: both wrap the same stream
+struct PacketizerPass
+{
+    enum AVCodecID      CodecId;
+    AVFormatContext     *FormatContext;
+    AVStream            *Stream;
+    RTP                 *NativeRtp;
+    RTP                 *FfmpegRtp;
+};
+
+static bool OpenNativePacketizer(PacketizerPass &pPass, enum AVCodecID pCodecId)
+{
+    pPass.CodecId = pCodecId;
+    pPass.FormatContext = AV_NEW_FORMAT_CONTEXT();
+    pPass.Stream = CreateStream(pPass.FormatContext, pCodecId);
+    pPass.NativeRtp = new RTP();
+    pPass.FfmpegRtp = new RTP();
+
+    if (pPass.Stream == NULL)
+    {
+        printf("   codec %s isn't supported by ffmpeg\n", HM_avcodec_get_name(pCodecId));
+        return false;
+    }
+
+    if ((!pPass.NativeRtp->OpenRtpEncoder("127.0.0.1", 5000, pPass.Stream, "native")) || (!pPass.NativeRtp->IsNativePacketizerUsed()))
+    {
+        printf("   failed to open the native RTP packetizer for codec %s\n", HM_avcodec_get_name(pCodecId));
+        return false;
+    }
+
+    return true;
+}
+
+static bool OpenFfmpegPacketizer(PacketizerPass &pPass)
+{
+    if ((!pPass.FfmpegRtp->OpenRtpEncoder("127.0.0.1", 5000, pPass.Stream, "ffmpeg")) || (pPass.FfmpegRtp->IsNativePacketizerUsed()))
+    {
+        printf("   failed to open the ffmpeg RTP muxer for codec %s\n", HM_avcodec_get_name(pPass.CodecId));
+        return false;
+    }
+
+    return true;
+}
+
+static void ClosePacketizers(PacketizerPass &pPass)
+{
+    pPass.NativeRtp->CloseRtpEncoder();
+    pPass.FfmpegRtp->CloseRtpEncoder();
+    delete pPass.NativeRtp;
+    delete pPass.FfmpegRtp;
+    avformat_free_context(pPass.FormatContext);
+}
+
+static void MeasurePacketizers(PacketizerPass &pPass, int pIterations)
+{
+    unsigned int tFrameSizes[] = { 1200, 15000, 150000 };
+
+    for (unsigned int i = 0; i < sizeof(tFrameSizes) / sizeof(tFrameSizes[0]); i++)
+    {
+        vector<char> tFrame;
+        CreateFrame(pPass.CodecId, tFrame, tFrameSizes[i]);
+
+        AVPacket tAVPacket;
+        av_init_packet(&tAVPacket);
+        tAVPacket.data = (uint8_t*)&tFrame[0];
+        tAVPacket.size = (int)tFrameSizes[i];
+        tAVPacket.flags |= AV_PKT_FLAG_KEY;
+
+        int64_t tFfmpegStored = 0, tNativeStored = 0;
+        int64_t tStart = Time::GetMonotonicNanoTime();
+        for (int j = 0; j < pIterations; j++)
+        {
+            tAVPacket.pts = tAVPacket.dts = j * 3000;
+            tFfmpegStored += StoreFfmpegPackets(pPass.FfmpegRtp, &tAVPacket);
+        }
+        int64_t tFfmpegDuration = Time::GetMonotonicNanoTime() - tStart;
+
+        tStart = Time::GetMonotonicNanoTime();
+        for (int j = 0; j < pIterations; j++)
+        {
+            tAVPacket.pts = tAVPacket.dts = j * 3000;
+            tNativeStored += StoreNativePackets(pPass.NativeRtp, &tAVPacket);
+        }
+        int64_t tNativeDuration = Time::GetMonotonicNanoTime() - tStart;
+
+        printf("   %s frame of %6u bytes: ffmpeg muxer %8.2f us/frame (%" PRId64 " bytes), native %8.2f us/frame (%" PRId64 " bytes)\n", HM_avcodec_get_name(pPass.CodecId), tFrameSizes[i], (double)tFfmpegDuration / pIterations / 1000, tFfmpegStored / pIterations, (double)tNativeDuration / pIterations / 1000, tNativeStored / pIterations);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int pArgc, char* pArgv[])
+{
+    int tIterations = BENCHMARK_DEFAULT_ITERATIONS;
+    vector<enum AVCodecID> tCodecs;
+    PacketizerPass tPasses[2];
+    bool tOpened[2];
+    int tPassCount;
+
+    for (int i = 1; i < pArgc; i++)
+    {
+        string tArg = pArgv[i];
+        if ((tArg.find("-Iterations=") == 0) && (atoi(tArg.substr(12).c_str()) > 0))
+        {
+            tIterations = atoi(tArg.substr(12).c_str());
+        }else
+        {
+            printf("Usage:\n");
+            printf("   HomerMultimediaBenchmark [-Iterations=<count>]   compares the RTP packetizers for H.264/HEVC frames\n");
+            return 1;
+        }
+    }
+
+    MediaSource::FfmpegInit();
+
+    tCodecs.push_back(AV_CODEC_ID_H264);
+    if (MediaSource::IsHEVCDecodingSupported())
+        tCodecs.push_back(AV_CODEC_ID_HEVC);
+    tPassCount = (int)tCodecs.size();
+
+    printf("RTP packetizers (%d iterations):\n", tIterations);
+
+    // HINT: the native packetizer can't be activated again after DisableNativePacketizerSupport(), hence the native packetizers of all codecs are opened first
+    for (int i = 0; i < tPassCount; i++)
+        tOpened[i] = OpenNativePacketizer(tPasses[i], tCodecs[i]);
+    RTP::DisableNativePacketizerSupport();
+    for (int i = 0; i < tPassCount; i++)
+    {
+        if (tOpened[i])
+            tOpened[i] = OpenFfmpegPacketizer(tPasses[i]);
+    }
+
+    for (int i = 0; i < tPassCount; i++)
+    {
+        if (tOpened[i])
+            MeasurePacketizers(tPasses[i], tIterations);
+        ClosePacketizers(tPasses[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of reference counted media buffers
+ * Since:   2026-10-17
+ */
+
+#include <Header_Ffmpeg.h>
+#include <MediaBuffer.h>
+#include <Logger.h>
+
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+MediaBuffer::MediaBuffer(int pSize)
+{
+    mSize = pSize;
+    mReferences = 1;
+    mData = (char*)av_malloc(mSize + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (mData == NULL)
+    {
+        LOG(LOG_ERROR, "Unable to allocate %d bytes of memory for media buffer", mSize);
+        mSize = 0;
+    }
+}
+
+MediaBuffer::~MediaBuffer()
+{
+    av_free(mData);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MediaBuffer* MediaBuffer::Create(int pSize)
+{
+    return new MediaBuffer(pSize);
+}
+
+MediaBuffer* MediaBuffer::Create(const char *pData, int pSize)
+{
+    MediaBuffer *tResult = new MediaBuffer(pSize);
+
+    if ((pData != NULL) && (tResult->mSize > 0))
+        memcpy(tResult->mData, pData, (size_t)tResult->mSize);
+
+    return tResult;
+}
+
+void MediaBuffer::AddReference()
+{
+    __sync_add_and_fetch(&mReferences, 1);
+}
+
+void MediaBuffer::Release()
+{
+    int tReferences = __sync_sub_and_fetch(&mReferences, 1);
+
+    #ifdef MB_DEBUG
+        LOG(LOG_VERBOSE, "Released media buffer at %p, remaining references: %d", mData, tReferences);
+    #endif
+
+    if (tReferences == 0)
+        delete this;
+    else if (tReferences < 0)
+        LOG(LOG_ERROR, "Media buffer at %p was released too often", mData);
+}
+
+char* MediaBuffer::GetData()
+{
+    return mData;
+}
+
+int MediaBuffer::GetSize()
+{
+    return mSize;
+}
+
+int MediaBuffer::GetReferenceCount()
+{
+    return mReferences;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
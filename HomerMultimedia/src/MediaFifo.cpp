@@ -25,7 +25,9 @@
  */
 
 #include <Header_Ffmpeg.h>
+#include <MediaBuffer.h>
 #include <MediaFifo.h>
+#include <HBTime.h>
 #include <Logger.h>
 
 #include <string.h> // memcpy
@@ -37,7 +39,24 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-MediaFifo::MediaFifo(std::string pName)
+// waits on a condition for the remaining part of a timeout which started at pStartTime (monotonic clock), returns false if the timeout has already passed
+static bool WaitForRemainingTime(Condition &pCondition, Mutex &pMutex, int64_t pStartTime, int pTimeout)
+{
+    if (pTimeout <= 0)
+        return pCondition.Wait(&pMutex);
+
+    int64_t tRemainingTime = (int64_t)pTimeout - (Time::GetMonotonicTimeStamp() - pStartTime) / 1000;
+    if (tRemainingTime <= 0)
+        return false;
+    pCondition.Wait(&pMutex, (int)tRemainingTime);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MediaFifo::MediaFifo(std::string pName):
+    QueueStatistic(pName)
 {
     mName = pName;
     mFifoSize = 0;
@@ -46,12 +65,38 @@ MediaFifo::MediaFifo(std::string pName)
     mFifoReadPtr = 0;
     mFifoAvailableEntries = 0;
     mFifo = NULL;
+    mFifoMode = MEDIA_FIFO_LOCKED;
+    mSpscWriteCounter = 0;
+    mSpscReadCounter = 0;
+    mSpscConsumerWaiting = 0;
+    mSpscWakeUpHead = 0;
+    mSpscWakeUpTail = 0;
+    mSpscClearRequested = 0;
+    mSpscClearMark = 0;
+    mSpscProducerWaiting = 0;
+    mSpaceWaiters = 0;
+    mConsumerTask = NULL;
+    mGroup = NULL;
+    mOverflowPolicy = MEDIA_FIFO_DROP_OLDEST;
+    mOverflowBlockTimeout = MEDIA_FIFO_DEFAULT_BLOCK_TIMEOUT;
+    mArena = NULL;
+    mArenaSize = 0;
+    mArenaWritePos = 0;
+    mArenaHighWatermark = 0;
+    mArenaChunks = NULL;
+    mArenaChunkCount = 0;
+    mArenaChunkHead = 0;
+    mArenaChunkTail = 0;
+    // the critical sections only update the FIFO indices, hence spinning is cheaper than parking the thread
+    mFifoMutex.AssignName("MediaFifo " + pName);
+    mFifoMutex.SetAdaptiveSpinning();
     LOG(LOG_VERBOSE, "Created abstract FIFO for %s with %d entries of %d bytes", pName.c_str(), mFifoSize, mFifoEntrySize);
 }
 
-MediaFifo::MediaFifo(int pFifoSize, int pFifoEntrySize, string pName)
+MediaFifo::MediaFifo(int pFifoSize, int pFifoEntrySize, string pName, enum MediaFifoMode pFifoMode, int pFifoMemoryBudget):
+    QueueStatistic(pName)
 {
-    LOG(LOG_VERBOSE, "Creating FIFO for %s with %d entries of %d bytes", pName.c_str(), pFifoSize, pFifoEntrySize);
+    LOG(LOG_VERBOSE, "Creating %sFIFO for %s with %d entries of %d bytes", (pFifoMode == MEDIA_FIFO_SPSC) ? "lock-free " : "", pName.c_str(), pFifoSize, pFifoEntrySize);
 
     mName = pName;
     mFifoSize = pFifoSize;
@@ -59,31 +104,108 @@ MediaFifo::MediaFifo(int pFifoSize, int pFifoEntrySize, string pName)
     mFifoWritePtr = 0;
     mFifoReadPtr = 0;
     mFifoAvailableEntries = 0;
+    mFifoMode = pFifoMode;
+    mSpscWriteCounter = 0;
+    mSpscReadCounter = 0;
+    mSpscConsumerWaiting = 0;
+    mSpscWakeUpHead = 0;
+    mSpscWakeUpTail = 0;
+    mSpscClearRequested = 0;
+    mSpscClearMark = 0;
+    mSpscProducerWaiting = 0;
+    mSpaceWaiters = 0;
+    mConsumerTask = NULL;
+    mGroup = NULL;
+    mOverflowPolicy = MEDIA_FIFO_DROP_OLDEST;
+    mOverflowBlockTimeout = MEDIA_FIFO_DEFAULT_BLOCK_TIMEOUT;
+    mArena = NULL;
+    mArenaSize = 0;
+    mArenaWritePos = 0;
+    mArenaHighWatermark = 0;
+    mArenaChunks = NULL;
+    mArenaChunkCount = 0;
+    mArenaChunkHead = 0;
+    mArenaChunkTail = 0;
+    mFifoMutex.AssignName("MediaFifo " + pName);
+    mFifoMutex.SetAdaptiveSpinning();
+    if (pFifoMemoryBudget > 0)
+    {
+        if (pFifoMemoryBudget < mFifoEntrySize)
+        {
+            LOG(LOG_WARN, "Memory budget of %d bytes for FIFO %s is too small for one entry, using %d bytes instead", pFifoMemoryBudget, pName.c_str(), mFifoEntrySize);
+            pFifoMemoryBudget = mFifoEntrySize;
+        }
+        mArenaSize = (pFifoMemoryBudget + MEDIA_FIFO_ARENA_ALIGNMENT - 1) & ~(MEDIA_FIFO_ARENA_ALIGNMENT - 1);
+        mArena = (char*)av_malloc(mArenaSize);
+        if (mArena == NULL)
+            LOG(LOG_ERROR, "Unable to allocate %d bytes of memory for FIFO %s", mArenaSize, pName.c_str());
+        // released chunks are recycled in allocation order, hence an exclusively read entry may block some more chunks than entries exist
+        mArenaChunkCount = 2 * mFifoSize + 1;
+        mArenaChunks = new MediaFifoArenaChunk[mArenaChunkCount];
+        for (int i = 0; i < mArenaChunkCount; i++)
+        {
+            mArenaChunks[i].Offset = 0;
+            mArenaChunks[i].Busy = false;
+        }
+    }
     mFifo = new MediaFifoEntry[mFifoSize];
     for (int i = 0; i < mFifoSize; i++)
     {
         mFifo[i].Size = 0;
-        mFifo[i].Data = (char*)av_malloc(mFifoEntrySize);
-        if (mFifo[i].Data == NULL)
-            LOG(LOG_ERROR, "Unable to allocate %d bytes of memory for FIFO %s", mFifoEntrySize, pName.c_str());
+        mFifo[i].KeyFrame = true;
+        mFifo[i].WriteTime = 0;
+        mFifo[i].ArenaChunk = -1;
+        mFifo[i].SharedBuffer = NULL;
+        mFifo[i].Reserved = false;
+        if (mArenaSize > 0)
+        {// data pointer is assigned when the entry is written
+            mFifo[i].Storage = mArena;
+        }else
+        {
+            mFifo[i].Storage = (char*)av_malloc(mFifoEntrySize);
+            if (mFifo[i].Storage == NULL)
+                LOG(LOG_ERROR, "Unable to allocate %d bytes of memory for FIFO %s", mFifoEntrySize, pName.c_str());
+        }
+        mFifo[i].Data = mFifo[i].Storage;
     }
-    LOG(LOG_VERBOSE, "Created FIFO for %s with %d entries of %d bytes", pName.c_str(), mFifoSize, mFifoEntrySize);
+    if (mArenaSize > 0)
+        LOG(LOG_VERBOSE, "Created FIFO for %s with %d entries of up to %d bytes within an arena of %d bytes", pName.c_str(), mFifoSize, mFifoEntrySize, mArenaSize);
+    else
+        LOG(LOG_VERBOSE, "Created FIFO for %s with %d entries of %d bytes", pName.c_str(), mFifoSize, mFifoEntrySize);
+
+    SetQueueStatisticActivation(true);
 }
 
 MediaFifo::~MediaFifo()
 {
-    LOG(LOG_VERBOSE, "Destroying FIFO %s with size of %d", mName.c_str(), mFifoSize);
+    LOG(LOG_VERBOSE, "Destroying FIFO %s with size of %d, memory high watermark: %d of %d bytes", mName.c_str(), mFifoSize, GetMemoryHighWatermark(), GetMemoryBudget());
+
+    // the statistic readers mustn't access the FIFO during its destruction
+    SetQueueStatisticActivation(false);
+
+    if (mGroup != NULL)
+        mGroup->RemoveFifo(this);
 
     if (mFifo != NULL)
     {
         for (int i = 0; i < mFifoSize; i++)
         {
             mFifo[i].Size = 0;
-            av_free(mFifo[i].Data);
+            if (mFifo[i].SharedBuffer != NULL)
+                mFifo[i].SharedBuffer->Release();
+            if (mArena == NULL)
+                av_free(mFifo[i].Storage);
         }
         delete[] mFifo;
         mFifo = NULL;
     }
+    if (mArena != NULL)
+    {
+        av_free(mArena);
+        mArena = NULL;
+    }
+    delete[] mArenaChunks;
+    mArenaChunks = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -96,9 +218,56 @@ void MediaFifo::ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimest
         LOG(LOG_VERBOSE, "%s-FIFO: ReadFifo() START", mName.c_str());
     #endif
 
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        SpscWaitForInput();
+
+        // wake up signal? it is read after all entries which were written before it
+        if (SpscGetEntriesBeforeWakeUp() == 0)
+        {
+            SpscTakeWakeUp();
+            pBufferTimestamp = 0;
+            pBufferSize = 0;
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+            return;
+        }
+
+        tCurrentFifoReadPtr = mSpscReadCounter % mFifoSize;
+        AnnounceEntryRead(tCurrentFifoReadPtr);
+
+        if (pBufferSize >= mFifo[tCurrentFifoReadPtr].Size)
+        {// input buffer is okay
+            pBufferTimestamp = mFifo[tCurrentFifoReadPtr].Number;
+            pBufferSize = mFifo[tCurrentFifoReadPtr].Size;
+            memcpy((void*)pBuffer, mFifo[tCurrentFifoReadPtr].Data, (size_t)pBufferSize);
+        }else
+        {// input buffer is too small
+            LOG(LOG_ERROR, "Given read buffer is too small (%d bytes) for the current chunk of %d bytes from FIFO %s, dropping data", pBufferSize, mFifo[tCurrentFifoReadPtr].Size, mName.c_str());
+            pBufferSize = 0;
+        }
+
+        ReleaseEntry(tCurrentFifoReadPtr);
+
+        // release the entry for the producer: the copy has to be finished before the cursor moves
+        __sync_synchronize();
+        mSpscReadCounter = (mSpscReadCounter + 1) % (2 * mFifoSize);
+        SpscWakeUpProducer();
+
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: erased front element of size %d, size afterwards: %d", mName.c_str(), (int)pBufferSize, SpscGetUsage());
+        #endif
+
+        if (pBufferSize == 0)
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+
+        return;
+    }
+
     // make sure there is some pending data in the input Fifo
+    // HINT: a reserved entry is waited for via the input condition, this releases the FIFO mutex for other readers and writers
     mFifoMutex.lock();
-    while(mFifoAvailableEntries < 1)
+    int64_t tWaitStart = (!LockedHasReadableEntry()) ? GetStatisticTimestamp() : 0;
+    while(!LockedHasReadableEntry())
     {
         #ifdef MF_DEBUG
             LOG(LOG_VERBOSE, "%s-FIFO: waiting for new input", mName.c_str());
@@ -116,6 +285,8 @@ void MediaFifo::ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimest
         if (mFifoAvailableEntries < 0)
             LOG(LOG_ERROR, "%s-FIFO: negative amount of entries: %d", mName.c_str(), mFifoAvailableEntries);
     }
+    if (tWaitStart > 0)
+        AnnounceReaderBlocked(Time::GetTimeStamp() - tWaitStart);
 
     tCurrentFifoReadPtr = mFifoReadPtr;
 
@@ -134,6 +305,7 @@ void MediaFifo::ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimest
     // release FIFO mutex and use fine grained mutex of corresponding FIFO entry instead for protecting memcpy
     mFifo[tCurrentFifoReadPtr].EntryMutex.lock();
     mFifoMutex.unlock();
+    AnnounceEntryRead(tCurrentFifoReadPtr);
 
     if (pBufferSize >= mFifo[tCurrentFifoReadPtr].Size)
     {// input buffer is okay
@@ -147,9 +319,12 @@ void MediaFifo::ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimest
         LOG(LOG_ERROR, "Given read buffer is too small (%d bytes) for the current chunk of %d bytes from FIFO %s, dropping data", pBufferSize, mFifo[tCurrentFifoReadPtr].Size, mName.c_str());
         pBufferSize = 0;
     }
+    ReleaseEntry(tCurrentFifoReadPtr);
     // unlock fine grained mutex again
     mFifo[tCurrentFifoReadPtr].EntryMutex.unlock();
 
+    LockedWakeUpProducers();
+
     #ifdef MF_DEBUG
         LOG(LOG_VERBOSE, "%s-FIFO: erased front element of size %d, size afterwards: %d", mName.c_str(), (int)pBufferSize, (int)mFifoAvailableEntries);
     #endif
@@ -164,19 +339,37 @@ void MediaFifo::ClearFifo()
         LOG(LOG_VERBOSE, "%s-FIFO: going to clear entire buffer", mName.c_str());
     #endif
 
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // HINT: ClearFifo() may be called from any thread, hence we only store a request which is applied by the consumer before its next read
+        mSpscClearMark = mSpscWriteCounter;
+        __sync_synchronize();
+        mSpscClearRequested = 1;
+        return;
+    }
+
     // make sure there is some pending data in the input Fifo
     mFifoMutex.lock();
 
-    mFifoWritePtr = 0;
-    mFifoReadPtr = 0;
-    mFifoAvailableEntries = 0;
-    for (int i = 0; i < mFifoSize; i++)
+    // release the arena memory of all waiting entries, entries which are currently read exclusively are released by ReadFifoExclusiveFinished()
+    // HINT: an entry which is still reserved by its writer and all younger entries are kept, the writer still uses its position
+    int tDroppedEntries = 0;
+    while ((tDroppedEntries < mFifoAvailableEntries) && (!mFifo[(mFifoReadPtr + tDroppedEntries) % mFifoSize].Reserved))
     {
-        mFifo[i].Size = 0;
+        int tEntry = (mFifoReadPtr + tDroppedEntries) % mFifoSize;
+        ReleaseEntry(tEntry);
+        mFifo[tEntry].Size = 0;
+        tDroppedEntries++;
     }
+    AnnounceQueueDrop(tDroppedEntries);
+
+    mFifoReadPtr = (mFifoReadPtr + tDroppedEntries) % mFifoSize;
+    mFifoAvailableEntries -= tDroppedEntries;
 
     // unlock
     mFifoMutex.unlock();
+
+    LockedWakeUpProducers();
 }
 
 int MediaFifo::GetEntrySize()
@@ -187,6 +380,10 @@ int MediaFifo::GetEntrySize()
 int MediaFifo::GetUsage()
 {
     int tResult = 0;
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+        return SpscGetUsage();
+
     mFifoMutex.lock();
 
     tResult = mFifoAvailableEntries;
@@ -208,6 +405,173 @@ int MediaFifo::GetSize()
     return tResult;
 }
 
+bool MediaFifo::HasPendingData()
+{
+    bool tResult;
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+        return ((SpscGetPendingWakeUps() > 0) || (SpscGetUsage() > 0));
+
+    mFifoMutex.lock();
+    tResult = LockedHasReadableEntry();
+    mFifoMutex.unlock();
+
+    return tResult;
+}
+
+bool MediaFifo::WaitForInput(int pTimeout)
+{
+    bool tResult;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        SpscApplyClearRequest();
+
+        // fast path: no locking if there is some pending data
+        if (HasPendingData())
+            return true;
+
+        mFifoMutex.lock();
+        mSpscConsumerWaiting = 1;
+        // the waiting flag has to be visible to the producer before we check the cursors a last time
+        __sync_synchronize();
+        while (!HasPendingData())
+        {
+            if (!WaitForRemainingTime(mFifoDataInputCondition, mFifoMutex, tStartTime, pTimeout))
+                break;
+            SpscApplyClearRequest();
+        }
+        mSpscConsumerWaiting = 0;
+        mFifoMutex.unlock();
+
+        return HasPendingData();
+    }
+
+    mFifoMutex.lock();
+    while (!LockedHasReadableEntry())
+    {
+        if (!WaitForRemainingTime(mFifoDataInputCondition, mFifoMutex, tStartTime, pTimeout))
+            break;
+    }
+    tResult = LockedHasReadableEntry();
+    mFifoMutex.unlock();
+
+    return tResult;
+}
+
+bool MediaFifo::WaitForSpace(int pMaxUsage, int pTimeout)
+{
+    bool tResult;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // fast path: no locking if there is enough free space
+        if (SpscGetUsage() <= pMaxUsage)
+            return true;
+
+        mFifoMutex.lock();
+        mSpscProducerWaiting = 1;
+        // the waiting flag has to be visible to the consumer before we check the read cursor a last time
+        __sync_synchronize();
+        while (SpscGetUsage() > pMaxUsage)
+        {
+            if (!WaitForRemainingTime(mFifoSpaceCondition, mFifoMutex, tStartTime, pTimeout))
+                break;
+        }
+        mSpscProducerWaiting = 0;
+        tResult = (SpscGetUsage() <= pMaxUsage);
+        mFifoMutex.unlock();
+
+        return tResult;
+    }
+
+    mFifoMutex.lock();
+    mSpaceWaiters++;
+    while (mFifoAvailableEntries > pMaxUsage)
+    {
+        if (!WaitForRemainingTime(mFifoSpaceCondition, mFifoMutex, tStartTime, pTimeout))
+            break;
+    }
+    mSpaceWaiters--;
+    tResult = (mFifoAvailableEntries <= pMaxUsage);
+    mFifoMutex.unlock();
+
+    return tResult;
+}
+
+void MediaFifo::NotifyGroup()
+{
+    if (mGroup != NULL)
+        mGroup->Notify();
+}
+
+enum MediaFifoMode MediaFifo::GetMode()
+{
+    return mFifoMode;
+}
+
+void MediaFifo::SetOverflowPolicy(enum MediaFifoOverflowPolicy pPolicy, int pBlockTimeout)
+{
+    LOG(LOG_VERBOSE, "%s-FIFO: setting overflow policy to %d with a block timeout of %d ms", mName.c_str(), (int)pPolicy, pBlockTimeout);
+
+    mFifoMutex.lock();
+    mOverflowPolicy = pPolicy;
+    mOverflowBlockTimeout = (pBlockTimeout > 0) ? pBlockTimeout : 0;
+    // wake up blocked writers, they re-evaluate the new policy
+    mFifoSpaceCondition.Signal();
+    mFifoMutex.unlock();
+}
+
+enum MediaFifoOverflowPolicy MediaFifo::GetOverflowPolicy()
+{
+    return mOverflowPolicy;
+}
+
+void MediaFifo::SetConsumerTask(Task *pTask)
+{
+    mConsumerTask = pTask;
+}
+
+void MediaFifo::ScheduleConsumerTask()
+{
+    Task *tConsumerTask = mConsumerTask;
+
+    if (tConsumerTask != NULL)
+        SVC_EXECUTOR.Schedule(tConsumerTask);
+}
+
+QueueStatisticDescriptor MediaFifo::GetQueueStatistic()
+{
+    QueueStatisticDescriptor tResult = QueueStatistic::GetQueueStatistic();
+
+    // HINT: avoid the virtual functions of derived FIFOs, they may refer to other FIFOs
+    tResult.Size = mFifoSize;
+    tResult.Usage = (mFifoMode == MEDIA_FIFO_SPSC) ? SpscGetUsage() : mFifoAvailableEntries;
+    tResult.MemoryBudget = GetMemoryBudget();
+    tResult.MemoryHighWatermark = GetMemoryHighWatermark();
+
+    return tResult;
+}
+
+int MediaFifo::GetMemoryBudget()
+{
+    if (mArena != NULL)
+        return mArenaSize;
+    else
+        return mFifoSize * mFifoEntrySize;
+}
+
+int MediaFifo::GetMemoryHighWatermark()
+{
+    // fixed size entries are preallocated
+    if (mArena != NULL)
+        return mArenaHighWatermark;
+    else
+        return mFifoSize * mFifoEntrySize;
+}
+
 int MediaFifo::ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBufferTimestamp)
 {
     int tCurrentFifoReadPtr;
@@ -216,10 +580,45 @@ int MediaFifo::ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBuf
         LOG(LOG_VERBOSE, "%s-FIFO: ReadFifoExclusive() START", mName.c_str());
     #endif
 
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        SpscWaitForInput();
+
+        // wake up signal? it isn't backed by a FIFO entry and is read after all entries which were written before it
+        if (SpscGetEntriesBeforeWakeUp() == 0)
+        {
+            SpscTakeWakeUp();
+            pBufferTimestamp = 0;
+            pBufferSize = 0;
+            *pBuffer = NULL;
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+            return -1;
+        }
+
+        tCurrentFifoReadPtr = mSpscReadCounter % mFifoSize;
+        AnnounceEntryRead(tCurrentFifoReadPtr);
+
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: reading exclusively entry %d with %d bytes", mName.c_str(), tCurrentFifoReadPtr, mFifo[tCurrentFifoReadPtr].Size);
+        #endif
+
+        pBufferTimestamp = mFifo[tCurrentFifoReadPtr].Number;
+        pBufferSize = mFifo[tCurrentFifoReadPtr].Size;
+        *pBuffer = mFifo[tCurrentFifoReadPtr].Data;
+
+        // HINT: the read cursor is moved in ReadFifoExclusiveFinished(), this protects the entry against being overwritten by the producer
+
+        if (pBufferSize == 0)
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+
+        return tCurrentFifoReadPtr;
+    }
+
     // make sure there is some pending data in the input Fifo
     mFifoMutex.lock();
     int tRounds = 0;
-    while (mFifoAvailableEntries < 1)
+    int64_t tWaitStart = (!LockedHasReadableEntry()) ? GetStatisticTimestamp() : 0;
+    while (!LockedHasReadableEntry())
     {
         if (tRounds > 0)
             LOG(LOG_VERBOSE, "%s-FIFO: woke up but no new data found, already passed rounds: %d", mName.c_str(), tRounds);
@@ -231,6 +630,8 @@ int MediaFifo::ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBuf
 
         tRounds++;
     }
+    if (tWaitStart > 0)
+        AnnounceReaderBlocked(Time::GetTimeStamp() - tWaitStart);
 
     tCurrentFifoReadPtr = mFifoReadPtr;
 
@@ -249,6 +650,7 @@ int MediaFifo::ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBuf
     // release FIFO mutex and use fine grained mutex of corresponding FIFO entry instead for protecting memcpy
     mFifo[tCurrentFifoReadPtr].EntryMutex.lock();
     mFifoMutex.unlock();
+    AnnounceEntryRead(tCurrentFifoReadPtr);
 
     // get number
     pBufferTimestamp = mFifo[tCurrentFifoReadPtr].Number;
@@ -275,69 +677,323 @@ void MediaFifo::ReadFifoExclusiveFinished(int pEntryPointer)
         LOG(LOG_VERBOSE, "%s-FIFO: finishing exclusive entry access to %d", mName.c_str(), pEntryPointer);
     #endif
 
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // wake up signals aren't backed by an entry
+        if (pEntryPointer < 0)
+            return;
+
+        ReleaseEntry(pEntryPointer);
+
+        // release the entry for the producer: all accesses to the entry have to be finished before the cursor moves
+        __sync_synchronize();
+        mSpscReadCounter = (mSpscReadCounter + 1) % (2 * mFifoSize);
+        SpscWakeUpProducer();
+        return;
+    }
+
+    ReleaseEntry(pEntryPointer);
     mFifo[pEntryPointer].EntryMutex.unlock();
+
+    LockedWakeUpProducers();
 }
 
-void MediaFifo::WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp)
+int MediaFifo::ReadFifoBatch(char *pBuffer, int pBufferSize, MediaFifoBatchEntry *pEntries, int pMaxEntries, bool pWaitForInput)
 {
-    int tCurrentFifoWritePtr;
+    int tEntryCount;
+    int tBufferOffset = 0;
 
     #ifdef MF_DEBUG
-        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifo() START", mName.c_str());
+        LOG(LOG_VERBOSE, "%s-FIFO: ReadFifoBatch() START", mName.c_str());
     #endif
 
-    if (pBufferSize > mFifoEntrySize)
+    // limit the batch to the amount of entries which fit into the given buffer in any case
+    if ((mFifoEntrySize > 0) && (pMaxEntries > pBufferSize / mFifoEntrySize))
+        pMaxEntries = pBufferSize / mFifoEntrySize;
+    if (pMaxEntries < 1)
+        pMaxEntries = 1;
+
+    tEntryCount = ReadFifoExclusiveBatch(pEntries, pMaxEntries, pWaitForInput);
+
+    for (int i = 0; i < tEntryCount; i++)
     {
-        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, current write request of %d bytes will be ignored, current FIFO size: %d", mName.c_str(), mFifoEntrySize, pBufferSize, mFifoSize);
-        return;
+        if (pEntries[i].Size == 0)
+            continue;
+
+        if (pBufferSize - tBufferOffset >= pEntries[i].Size)
+        {// input buffer is okay
+            memcpy((void*)(pBuffer + tBufferOffset), pEntries[i].Data, (size_t)pEntries[i].Size);
+            pEntries[i].Data = pBuffer + tBufferOffset;
+            tBufferOffset += pEntries[i].Size;
+        }else
+        {// input buffer is too small
+            LOG(LOG_ERROR, "Given read buffer is too small (%d bytes left) for the current chunk of %d bytes from FIFO %s, dropping data", pBufferSize - tBufferOffset, pEntries[i].Size, mName.c_str());
+            pEntries[i].Data = NULL;
+            pEntries[i].Size = 0;
+        }
     }
 
-    if (pBufferSize == 0)
-        LOG(LOG_VERBOSE, "%s-FIFO: writing empty chunk", mName.c_str());
+    // the entry pointers stay valid, only the data pointers were redirected to the copies
+    ReadFifoExclusiveBatchFinished(pEntries, tEntryCount);
 
+    return tEntryCount;
+}
+
+int MediaFifo::ReadFifoExclusiveBatch(MediaFifoBatchEntry *pEntries, int pMaxEntries, bool pWaitForInput)
+{
+    int tCurrentFifoReadPtr;
+    int tEntryCount = 0;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: ReadFifoExclusiveBatch() START", mName.c_str());
+    #endif
+
+    if (pMaxEntries < 1)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: invalid batch size %d", mName.c_str(), pMaxEntries);
+        return 0;
+    }
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        if (pWaitForInput)
+            SpscWaitForInput();
+        else
+        {
+            SpscApplyClearRequest();
+            if ((SpscGetPendingWakeUps() < 1) && (SpscGetUsage() < 1))
+                return 0;
+        }
+
+        // wake up signal? it isn't backed by a FIFO entry and is returned alone
+        int tEntriesBeforeWakeUp = SpscGetEntriesBeforeWakeUp();
+        if (tEntriesBeforeWakeUp == 0)
+        {
+            SpscTakeWakeUp();
+            pEntries[0].Data = NULL;
+            pEntries[0].Size = 0;
+            pEntries[0].Number = 0;
+            pEntries[0].EntryPointer = -1;
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+            return 1;
+        }
+
+        // all entries up to the current write cursor are published, their content has to be read after the cursor
+        int tUsage = SpscGetUsage();
+        __sync_synchronize();
+
+        // a pending wake up signal ends the batch at its position
+        if ((tEntriesBeforeWakeUp > 0) && (tUsage > tEntriesBeforeWakeUp))
+            tUsage = tEntriesBeforeWakeUp;
+
+        while ((tEntryCount < pMaxEntries) && (tEntryCount < tUsage))
+        {
+            tCurrentFifoReadPtr = (mSpscReadCounter + tEntryCount) % mFifoSize;
+            AnnounceEntryRead(tCurrentFifoReadPtr);
+
+            pEntries[tEntryCount].Data = mFifo[tCurrentFifoReadPtr].Data;
+            pEntries[tEntryCount].Size = mFifo[tCurrentFifoReadPtr].Size;
+            pEntries[tEntryCount].Number = mFifo[tCurrentFifoReadPtr].Number;
+            pEntries[tEntryCount].EntryPointer = tCurrentFifoReadPtr;
+            tEntryCount++;
+
+            // an empty chunk ends the batch
+            if (mFifo[tCurrentFifoReadPtr].Size == 0)
+            {
+                LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+                break;
+            }
+        }
+
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: reading exclusively %d entries, %d entries were available", mName.c_str(), tEntryCount, tUsage);
+        #endif
+
+        // HINT: the read cursor is moved in ReadFifoExclusiveBatchFinished(), this protects the entries against being overwritten by the producer
+
+        return tEntryCount;
+    }
+
+    // make sure there is some pending data in the input Fifo
     mFifoMutex.lock();
-    if (pBufferSize == 0)
-        LOG(LOG_VERBOSE, "%s-FIFO: got lock for empty chunk", mName.c_str());
+    if ((!pWaitForInput) && (!LockedHasReadableEntry()))
+    {
+        mFifoMutex.unlock();
+        return 0;
+    }
+    int64_t tWaitStart = (!LockedHasReadableEntry()) ? GetStatisticTimestamp() : 0;
+    while (!LockedHasReadableEntry())
+    {
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: waiting for new input", mName.c_str());
+        #endif
+
+        while(!mFifoDataInputCondition.Wait(&mFifoMutex))
+        {
+            LOG(LOG_ERROR, "%s-FIFO: error when waiting for new input", mName.c_str());
+        }
+    }
+    if (tWaitStart > 0)
+        AnnounceReaderBlocked(Time::GetTimeStamp() - tWaitStart);
 
-    if (mFifoAvailableEntries >= mFifoSize)
+    // a reserved entry ends the batch
+    while ((tEntryCount < pMaxEntries) && (LockedHasReadableEntry()))
     {
-        LOG(LOG_WARN, "%s-FIFO: buffer full (size is %d, read: %d, write %d) - dropping oldest (%d) data chunk", mName.c_str(), mFifoSize, mFifoReadPtr, mFifoWritePtr, mFifoReadPtr);
+        tCurrentFifoReadPtr = mFifoReadPtr;
 
         // update FIFO read pointer
         mFifoReadPtr++;
         if (mFifoReadPtr >= mFifoSize)
             mFifoReadPtr = mFifoReadPtr - mFifoSize;
-    }else
-    {
+
         // update FIFO counter
-        mFifoAvailableEntries++;
+        mFifoAvailableEntries--;
+
+        // use fine grained mutex of corresponding FIFO entry
+        mFifo[tCurrentFifoReadPtr].EntryMutex.lock();
+        pEntries[tEntryCount].EntryPointer = tCurrentFifoReadPtr;
+        tEntryCount++;
+
+        // an empty chunk ends the batch
+        if (mFifo[tCurrentFifoReadPtr].Size == 0)
+            break;
+    }
+    mFifoMutex.unlock();
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: reading exclusively %d entries, size afterwards: %d", mName.c_str(), tEntryCount, (int)mFifoAvailableEntries);
+    #endif
+
+    for (int i = 0; i < tEntryCount; i++)
+    {
+        tCurrentFifoReadPtr = pEntries[i].EntryPointer;
+        AnnounceEntryRead(tCurrentFifoReadPtr);
+
+        pEntries[i].Data = mFifo[tCurrentFifoReadPtr].Data;
+        pEntries[i].Size = mFifo[tCurrentFifoReadPtr].Size;
+        pEntries[i].Number = mFifo[tCurrentFifoReadPtr].Number;
+
+        if (pEntries[i].Size == 0)
+            LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
     }
 
-    tCurrentFifoWritePtr = mFifoWritePtr;
+    // NO unlock of fine grained mutexes -> has to be triggered by caller via ReadFifoExclusiveBatchFinished()
+
+    return tEntryCount;
+}
+
+void MediaFifo::ReadFifoExclusiveBatchFinished(MediaFifoBatchEntry *pEntries, int pEntryCount)
+{
+    int tHeldEntries = 0;
 
     #ifdef MF_DEBUG
-        LOG(LOG_VERBOSE, "%s-FIFO: writing entry %d", mName.c_str(), tCurrentFifoWritePtr);
+        LOG(LOG_VERBOSE, "%s-FIFO: finishing exclusive access to %d entries", mName.c_str(), pEntryCount);
     #endif
 
-    // update FIFO write pointer
-    mFifoWritePtr++;
-    if (mFifoWritePtr >= mFifoSize)
-        mFifoWritePtr = mFifoWritePtr - mFifoSize;
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        for (int i = 0; i < pEntryCount; i++)
+        {
+            // wake up signals aren't backed by an entry
+            if (pEntries[i].EntryPointer < 0)
+                continue;
 
-    // release FIFO mutex and use fine grained mutex of corresponding FIFO entry instead for protecting memcpy
-    mFifo[tCurrentFifoWritePtr].EntryMutex.lock();
+            ReleaseEntry(pEntries[i].EntryPointer);
+            tHeldEntries++;
+        }
 
-    // add the new entry
-    mFifo[tCurrentFifoWritePtr].Size = pBufferSize;
-    if ((pBuffer != NULL) && (pBufferSize > 0))
-        memcpy((void*)mFifo[tCurrentFifoWritePtr].Data, (const void*)pBuffer, (size_t)pBufferSize);
-    mFifo[tCurrentFifoWritePtr].Number = pBufferTimestamp;
+        if (tHeldEntries == 0)
+            return;
 
-    // unlock fine grained mutex again
-    mFifo[tCurrentFifoWritePtr].EntryMutex.unlock();
+        // release all entries at once for the producer: all accesses to the entries have to be finished before the cursor moves
+        __sync_synchronize();
+        mSpscReadCounter = (mSpscReadCounter + tHeldEntries) % (2 * mFifoSize);
+        SpscWakeUpProducer();
+        return;
+    }
+
+    for (int i = 0; i < pEntryCount; i++)
+    {
+        ReleaseEntry(pEntries[i].EntryPointer);
+        mFifo[pEntries[i].EntryPointer].EntryMutex.unlock();
+    }
+
+    if (pEntryCount > 0)
+        LockedWakeUpProducers();
+}
+
+void MediaFifo::WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp, bool pKeyFrame)
+{
+    int tCurrentFifoWritePtr;
 
     #ifdef MF_DEBUG
-        LOG(LOG_VERBOSE, "%s-FIFO: buffer size now: %d", mName.c_str(), mFifoAvailableEntries);
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifo() START", mName.c_str());
+    #endif
+
+    if (pBufferSize > mFifoEntrySize)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, current write request of %d bytes will be ignored, current FIFO size: %d", mName.c_str(), mFifoEntrySize, pBufferSize, mFifoSize);
+        return;
+    }
+
+    if (pBufferSize == 0)
+        LOG(LOG_VERBOSE, "%s-FIFO: writing empty chunk", mName.c_str());
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        if (pBufferSize == 0)
+        {// wake up signal: it is usually sent by a control thread, hence it mustn't use the producer cursor
+            SpscSignalWakeUp();
+            return;
+        }
+
+        tCurrentFifoWritePtr = SpscAcquireEntry(pBufferSize, pKeyFrame);
+        if (tCurrentFifoWritePtr < 0)
+            return;
+
+        mFifo[tCurrentFifoWritePtr].Size = pBufferSize;
+        if (pBuffer != NULL)
+            memcpy((void*)mFifo[tCurrentFifoWritePtr].Data, (const void*)pBuffer, (size_t)pBufferSize);
+        mFifo[tCurrentFifoWritePtr].Number = pBufferTimestamp;
+        mFifo[tCurrentFifoWritePtr].KeyFrame = pKeyFrame;
+        mFifo[tCurrentFifoWritePtr].WriteTime = GetStatisticTimestamp();
+
+        SpscPublishEntry();
+        AnnounceQueueWrite(SpscGetUsage());
+        return;
+    }
+
+    mFifoMutex.lock();
+    if (pBufferSize == 0)
+        LOG(LOG_VERBOSE, "%s-FIFO: got lock for empty chunk", mName.c_str());
+
+    int tArenaChunk;
+    tCurrentFifoWritePtr = LockedAcquireEntry(pBufferSize, pBufferSize, pKeyFrame, tArenaChunk);
+    if (tCurrentFifoWritePtr < 0)
+    {
+        mFifoMutex.unlock();
+        return;
+    }
+
+    // release FIFO mutex and use fine grained mutex of corresponding FIFO entry instead for protecting memcpy
+    mFifo[tCurrentFifoWritePtr].EntryMutex.lock();
+
+    // add the new entry
+    if (tArenaChunk >= 0)
+        ArenaAssign(tCurrentFifoWritePtr, tArenaChunk);
+    mFifo[tCurrentFifoWritePtr].Size = pBufferSize;
+    if ((pBuffer != NULL) && (pBufferSize > 0))
+        memcpy((void*)mFifo[tCurrentFifoWritePtr].Data, (const void*)pBuffer, (size_t)pBufferSize);
+    mFifo[tCurrentFifoWritePtr].Number = pBufferTimestamp;
+    mFifo[tCurrentFifoWritePtr].KeyFrame = pKeyFrame;
+    mFifo[tCurrentFifoWritePtr].WriteTime = GetStatisticTimestamp();
+
+    // unlock fine grained mutex again
+    mFifo[tCurrentFifoWritePtr].EntryMutex.unlock();
+    AnnounceQueueWrite(mFifoAvailableEntries);
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: buffer size now: %d", mName.c_str(), mFifoAvailableEntries);
     #endif
 
     if (pBufferSize == 0)
@@ -347,6 +1003,895 @@ void MediaFifo::WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimesta
     mFifoMutex.unlock();
     if (pBufferSize == 0)
         LOG(LOG_VERBOSE, "%s-FIFO: released lock after writing empty chunk", mName.c_str());
+
+    NotifyGroup();
+}
+
+void MediaFifo::WriteFifoShared(MediaBuffer *pBuffer, int64_t pBufferTimestamp, bool pKeyFrame)
+{
+    int tCurrentFifoWritePtr;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifoShared() START", mName.c_str());
+    #endif
+
+    if (mFifo == NULL)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: shared entries aren't supported by this FIFO", mName.c_str());
+        return;
+    }
+
+    // empty chunks are signals and have to follow the rules of WriteFifo()
+    if ((pBuffer == NULL) || (pBuffer->GetSize() == 0))
+    {
+        WriteFifo(NULL, 0, pBufferTimestamp);
+        return;
+    }
+
+    // readers expect entries which fit into buffers of mFifoEntrySize bytes
+    if (pBuffer->GetSize() > mFifoEntrySize)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, current shared write request of %d bytes will be ignored, current FIFO size: %d", mName.c_str(), mFifoEntrySize, pBuffer->GetSize(), mFifoSize);
+        return;
+    }
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // HINT: no memory is allocated for shared entries
+        tCurrentFifoWritePtr = SpscAcquireEntry(0, pKeyFrame);
+        if (tCurrentFifoWritePtr < 0)
+            return;
+
+        AssignSharedBuffer(tCurrentFifoWritePtr, pBuffer);
+        mFifo[tCurrentFifoWritePtr].Number = pBufferTimestamp;
+        mFifo[tCurrentFifoWritePtr].KeyFrame = pKeyFrame;
+        mFifo[tCurrentFifoWritePtr].WriteTime = GetStatisticTimestamp();
+
+        SpscPublishEntry();
+        AnnounceQueueWrite(SpscGetUsage());
+        return;
+    }
+
+    mFifoMutex.lock();
+
+    int tArenaChunk;
+    tCurrentFifoWritePtr = LockedAcquireEntry(pBuffer->GetSize(), 0, pKeyFrame, tArenaChunk);
+    if (tCurrentFifoWritePtr < 0)
+    {
+        mFifoMutex.unlock();
+        return;
+    }
+
+    mFifo[tCurrentFifoWritePtr].EntryMutex.lock();
+    AssignSharedBuffer(tCurrentFifoWritePtr, pBuffer);
+    mFifo[tCurrentFifoWritePtr].Number = pBufferTimestamp;
+    mFifo[tCurrentFifoWritePtr].KeyFrame = pKeyFrame;
+    mFifo[tCurrentFifoWritePtr].WriteTime = GetStatisticTimestamp();
+    mFifo[tCurrentFifoWritePtr].EntryMutex.unlock();
+    AnnounceQueueWrite(mFifoAvailableEntries);
+
+    mFifoDataInputCondition.Signal();
+    mFifoMutex.unlock();
+
+    NotifyGroup();
+}
+
+int MediaFifo::WriteFifoExclusive(char **pBuffer, int pBufferSize)
+{
+    int tCurrentFifoWritePtr;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifoExclusive() START", mName.c_str());
+    #endif
+
+    if ((pBufferSize > mFifoEntrySize) || (pBufferSize < 1))
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, current reservation request of %d bytes will be ignored, current FIFO size: %d", mName.c_str(), mFifoEntrySize, pBufferSize, mFifoSize);
+        return -1;
+    }
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // HINT: the key flag is given in WriteFifoExclusiveFinished(), until then the entry is treated as key entry
+        tCurrentFifoWritePtr = SpscAcquireEntry(pBufferSize, true);
+        if (tCurrentFifoWritePtr < 0)
+            return -1;
+
+        // HINT: the entry gets visible for the consumer in WriteFifoExclusiveFinished()
+        *pBuffer = mFifo[tCurrentFifoWritePtr].Data;
+
+        return tCurrentFifoWritePtr;
+    }
+
+    mFifoMutex.lock();
+
+    int tArenaChunk;
+    // HINT: the key flag is given in WriteFifoExclusiveFinished(), until then the entry is protected as key entry
+    tCurrentFifoWritePtr = LockedAcquireEntry(pBufferSize, pBufferSize, true, tArenaChunk);
+    if (tCurrentFifoWritePtr < 0)
+    {
+        mFifoMutex.unlock();
+        return -1;
+    }
+
+    // release FIFO mutex and use fine grained mutex of corresponding FIFO entry instead for protecting the data access of the caller
+    mFifo[tCurrentFifoWritePtr].EntryMutex.lock();
+    if (tArenaChunk >= 0)
+        ArenaAssign(tCurrentFifoWritePtr, tArenaChunk);
+    mFifo[tCurrentFifoWritePtr].Size = 0;
+    mFifo[tCurrentFifoWritePtr].KeyFrame = true;
+    mFifo[tCurrentFifoWritePtr].WriteTime = 0;
+    mFifo[tCurrentFifoWritePtr].Reserved = true;
+    mFifoMutex.unlock();
+
+    *pBuffer = mFifo[tCurrentFifoWritePtr].Data;
+
+    // NO unlock of fine grained mutex again -> has to be triggered by caller via separated function: WriteFifoExclusiveFinished()
+
+    return tCurrentFifoWritePtr;
+}
+
+void MediaFifo::WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp, bool pKeyFrame)
+{
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: finishing exclusive write access to %d with %d bytes", mName.c_str(), pEntryPointer, pBufferSize);
+    #endif
+
+    if (pEntryPointer < 0)
+        return;
+
+    if ((pBufferSize < 0) || (pBufferSize > mFifoEntrySize))
+    {
+        LOG(LOG_ERROR, "%s-FIFO: invalid size of %d bytes for reserved entry %d, storing an empty chunk instead", mName.c_str(), pBufferSize, pEntryPointer);
+        pBufferSize = 0;
+    }
+
+    mFifo[pEntryPointer].Size = pBufferSize;
+    mFifo[pEntryPointer].Number = pBufferTimestamp;
+    mFifo[pEntryPointer].KeyFrame = pKeyFrame;
+    mFifo[pEntryPointer].WriteTime = GetStatisticTimestamp();
+
+    if (mFifoMode == MEDIA_FIFO_SPSC)
+    {
+        // HINT: an empty chunk stays in-band, the entry was reserved by the producer and keeps its position
+        ArenaShrink(mFifo[pEntryPointer].ArenaChunk, pBufferSize);
+        SpscPublishEntry();
+        AnnounceQueueWrite(SpscGetUsage());
+        return;
+    }
+
+    // HINT: the entry mutex has to be released before we lock the FIFO mutex, the reader locks in the opposite order;
+    //       a reserved entry is neither moved nor dropped by the overflow handling, hence it is still located at pEntryPointer
+    mFifo[pEntryPointer].EntryMutex.unlock();
+
+    mFifoMutex.lock();
+    ArenaShrink(mFifo[pEntryPointer].ArenaChunk, pBufferSize);
+    mFifo[pEntryPointer].Reserved = false;
+    AnnounceQueueWrite(mFifoAvailableEntries);
+    mFifoDataInputCondition.Signal();
+    mFifoMutex.unlock();
+
+    NotifyGroup();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int MediaFifo::LockedAcquireEntry(int pBufferSize, int pMemorySize, bool pKeyFrame, int &pArenaChunk)
+{
+    int tResult;
+    int64_t tBlockStartTime = 0;
+
+    pArenaChunk = -1;
+    while (true)
+    {
+        if (mFifoAvailableEntries < mFifoSize)
+        {
+            if ((mArena == NULL) || (pMemorySize < 1))
+                break;
+            if ((pArenaChunk = ArenaAllocate(pMemorySize)) >= 0)
+                break;
+        }
+
+        if (!LockedHandleOverflow(pBufferSize, pKeyFrame, tBlockStartTime))
+            return -1;
+    }
+
+    // update FIFO counter
+    mFifoAvailableEntries++;
+
+    tResult = mFifoWritePtr;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: writing entry %d", mName.c_str(), tResult);
+    #endif
+
+    // update FIFO write pointer
+    mFifoWritePtr++;
+    if (mFifoWritePtr >= mFifoSize)
+        mFifoWritePtr = mFifoWritePtr - mFifoSize;
+
+    return tResult;
+}
+
+bool MediaFifo::LockedHandleOverflow(int pBufferSize, bool pKeyFrame, int64_t &pBlockStartTime)
+{
+    enum MediaFifoOverflowPolicy tPolicy = mOverflowPolicy;
+    int tQueuePosition = 0;
+
+    // signaling chunks mustn't block, otherwise a stopped reader would block the writer forever
+    if ((tPolicy == MEDIA_FIFO_BLOCK) && (pBufferSize == 0))
+        tPolicy = MEDIA_FIFO_DROP_OLDEST;
+
+    switch(tPolicy)
+    {
+        case MEDIA_FIFO_DROP_NEWEST:
+            LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full (%d of %d entries, memory budget: %d bytes) - dropping newest data chunk of %d bytes", mName.c_str(), mFifoAvailableEntries, mFifoSize, GetMemoryBudget(), pBufferSize);
+            AnnounceQueueDrop();
+            return false;
+        case MEDIA_FIFO_BLOCK:
+            {
+                #ifdef MF_DEBUG
+                    LOG(LOG_VERBOSE, "%s-FIFO: buffer full, waiting for free space", mName.c_str());
+                #endif
+                ScheduleConsumerTask();
+                // the timeout limits the entire blocking, the caller checks for free space after each wake up
+                if (pBlockStartTime == 0)
+                    pBlockStartTime = Time::GetMonotonicTimeStamp();
+                int64_t tWaitStart = GetStatisticTimestamp();
+                // HINT: readers signal after they have released an entry
+                bool tWaited = WaitForRemainingTime(mFifoSpaceCondition, mFifoMutex, pBlockStartTime, mOverflowBlockTimeout);
+                if (tWaitStart > 0)
+                    AnnounceWriterBlocked(Time::GetTimeStamp() - tWaitStart);
+                if (!tWaited)
+                {
+                    LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer still full after %d ms (%d of %d entries, memory budget: %d bytes) - dropping newest data chunk of %d bytes", mName.c_str(), mOverflowBlockTimeout, mFifoAvailableEntries, mFifoSize, GetMemoryBudget(), pBufferSize);
+                    AnnounceQueueDrop();
+                    return false;
+                }
+            }
+            return true;
+        case MEDIA_FIFO_DROP_NON_KEY:
+            tQueuePosition = LockedFindNonKeyEntry();
+            if (tQueuePosition < 0)
+            {
+                if (!pKeyFrame)
+                {
+                    LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full of key entries (%d of %d entries) - dropping newest non-key data chunk of %d bytes", mName.c_str(), mFifoAvailableEntries, mFifoSize, pBufferSize);
+                    AnnounceQueueDrop();
+                    return false;
+                }
+                // only key entries are waiting, drop the oldest one
+                tQueuePosition = 0;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // entries which are still filled by their writers mustn't be moved
+    if (LockedHasReservedEntry(tQueuePosition + 1))
+    {
+        LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full and oldest entries are still reserved by writers - dropping newest data chunk of %d bytes", mName.c_str(), pBufferSize);
+        AnnounceQueueDrop();
+        return false;
+    }
+
+    // the memory budget may be exhausted by entries which are currently read exclusively
+    if (mFifoAvailableEntries < 1)
+    {
+        LOG(LOG_WARN, "%s-FIFO: memory budget of %d bytes exhausted - dropping newest data chunk of %d bytes", mName.c_str(), mArenaSize, pBufferSize);
+        AnnounceQueueDrop();
+        return false;
+    }
+
+    LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full (size is %d, read: %d, write %d) - dropping %s (%d) data chunk", mName.c_str(), mFifoSize, mFifoReadPtr, mFifoWritePtr, (tPolicy == MEDIA_FIFO_DROP_NON_KEY) && (tQueuePosition > 0) ? "oldest non-key" : "oldest", (mFifoReadPtr + tQueuePosition) % mFifoSize);
+
+    LockedDropEntry(tQueuePosition);
+
+    return true;
+}
+
+bool MediaFifo::LockedHasReadableEntry()
+{
+    return ((mFifoAvailableEntries > 0) && (!mFifo[mFifoReadPtr].Reserved));
+}
+
+bool MediaFifo::LockedHasReservedEntry(int pQueuePositions)
+{
+    for (int i = 0; (i < pQueuePositions) && (i < mFifoAvailableEntries); i++)
+    {
+        if (mFifo[(mFifoReadPtr + i) % mFifoSize].Reserved)
+            return true;
+    }
+
+    return false;
+}
+
+int MediaFifo::LockedFindNonKeyEntry()
+{
+    for (int i = 0; i < mFifoAvailableEntries; i++)
+    {
+        if (!mFifo[(mFifoReadPtr + i) % mFifoSize].KeyFrame)
+            return i;
+    }
+
+    return -1;
+}
+
+void MediaFifo::LockedDropEntry(int pQueuePosition)
+{
+    int tEntry = (mFifoReadPtr + pQueuePosition) % mFifoSize;
+
+    // HINT: reserved entries are never dropped or moved, see LockedHandleOverflow(), the entry mutexes protect against concurrent exclusive accesses
+    for (int i = 0; i <= pQueuePosition; i++)
+        mFifo[(mFifoReadPtr + i) % mFifoSize].EntryMutex.lock();
+
+    ReleaseEntry(tEntry);
+    mFifo[tEntry].Size = 0;
+
+    // move the older entries one position forward, afterwards the dropped entry is located at the read position
+    for (int i = pQueuePosition; i > 0; i--)
+        SwapEntries((mFifoReadPtr + i) % mFifoSize, (mFifoReadPtr + i - 1) % mFifoSize);
+
+    for (int i = 0; i <= pQueuePosition; i++)
+        mFifo[(mFifoReadPtr + i) % mFifoSize].EntryMutex.unlock();
+
+    // update FIFO read pointer
+    mFifoReadPtr++;
+    if (mFifoReadPtr >= mFifoSize)
+        mFifoReadPtr = mFifoReadPtr - mFifoSize;
+
+    // update FIFO counter
+    mFifoAvailableEntries--;
+
+    AnnounceQueueDrop();
+}
+
+void MediaFifo::SwapEntries(int pEntry1, int pEntry2)
+{
+    MediaFifoEntry *tEntry1 = &mFifo[pEntry1];
+    MediaFifoEntry *tEntry2 = &mFifo[pEntry2];
+
+    // HINT: the entry mutex stays at its position
+    char *tData = tEntry1->Data;
+    int tSize = tEntry1->Size;
+    int64_t tNumber = tEntry1->Number;
+    bool tKeyFrame = tEntry1->KeyFrame;
+    int64_t tWriteTime = tEntry1->WriteTime;
+    char *tStorage = tEntry1->Storage;
+    int tArenaChunk = tEntry1->ArenaChunk;
+    MediaBuffer *tSharedBuffer = tEntry1->SharedBuffer;
+
+    tEntry1->Data = tEntry2->Data;
+    tEntry1->Size = tEntry2->Size;
+    tEntry1->Number = tEntry2->Number;
+    tEntry1->KeyFrame = tEntry2->KeyFrame;
+    tEntry1->WriteTime = tEntry2->WriteTime;
+    tEntry1->Storage = tEntry2->Storage;
+    tEntry1->ArenaChunk = tEntry2->ArenaChunk;
+    tEntry1->SharedBuffer = tEntry2->SharedBuffer;
+
+    tEntry2->Data = tData;
+    tEntry2->Size = tSize;
+    tEntry2->Number = tNumber;
+    tEntry2->KeyFrame = tKeyFrame;
+    tEntry2->WriteTime = tWriteTime;
+    tEntry2->Storage = tStorage;
+    tEntry2->ArenaChunk = tArenaChunk;
+    tEntry2->SharedBuffer = tSharedBuffer;
+}
+
+void MediaFifo::LockedWakeUpProducers()
+{
+    // HINT: writers only wait with MEDIA_FIFO_BLOCK or within WaitForSpace(), they check for free space while holding the FIFO mutex, hence the signal can't get lost
+    if ((mOverflowPolicy != MEDIA_FIFO_BLOCK) && (mSpaceWaiters == 0))
+        return;
+
+    mFifoMutex.lock();
+    mFifoSpaceCondition.Signal();
+    mFifoMutex.unlock();
+}
+
+int MediaFifo::SpscAcquireEntry(int pMemorySize, bool pKeyFrame)
+{
+    int tResult = mSpscWriteCounter % mFifoSize;
+    int tReadCounter;
+    int64_t tBlockStartTime = 0;
+
+    while (true)
+    {
+        // remember the read cursor before we check for free space, the consumer moves it after it has freed an entry
+        tReadCounter = mSpscReadCounter;
+        if (SpscTryAcquireSpace(tResult, pMemorySize))
+            break;
+
+        if (!SpscHandleOverflow(pMemorySize, pKeyFrame, tReadCounter, tBlockStartTime))
+            return -1;
+    }
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: writing entry %d", mName.c_str(), tResult);
+    #endif
+
+    return tResult;
+}
+
+bool MediaFifo::SpscTryAcquireSpace(int pEntry, int pMemorySize)
+{
+    if (SpscGetUsage() >= mFifoSize)
+        return false;
+
+    // the consumer has to be finished with the entry before we overwrite it
+    __sync_synchronize();
+
+    if ((mArena != NULL) && (pMemorySize > 0))
+    {
+        int tArenaChunk = ArenaAllocate(pMemorySize);
+        if (tArenaChunk < 0)
+            return false;
+        ArenaAssign(pEntry, tArenaChunk);
+    }
+
+    return true;
+}
+
+bool MediaFifo::SpscHandleOverflow(int pMemorySize, bool pKeyFrame, int pReadCounter, int64_t &pBlockStartTime)
+{
+    switch(mOverflowPolicy)
+    {
+        case MEDIA_FIFO_DROP_NON_KEY:
+            // key entries wait for free space
+            if (pKeyFrame)
+                break;
+            LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full (%d of %d entries, memory budget: %d bytes) - dropping newest non-key data chunk of %d bytes", mName.c_str(), SpscGetUsage(), mFifoSize, GetMemoryBudget(), pMemorySize);
+            AnnounceQueueDrop();
+            return false;
+        case MEDIA_FIFO_BLOCK:
+            break;
+        default:
+            // HINT: the oldest entry is owned by the consumer, hence we drop the newest one
+            LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer full (%d of %d entries, memory budget: %d bytes) - dropping newest data chunk of %d bytes", mName.c_str(), SpscGetUsage(), mFifoSize, GetMemoryBudget(), pMemorySize);
+            AnnounceQueueDrop();
+            return false;
+    }
+
+    // the consumer task would be scheduled by the producer after this write, hence we do this now
+    ScheduleConsumerTask();
+
+    if (!SpscWaitForSpace(pReadCounter, pBlockStartTime))
+    {
+        LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "%s-FIFO: buffer still full after %d ms (%d of %d entries, memory budget: %d bytes) - dropping newest data chunk of %d bytes", mName.c_str(), mOverflowBlockTimeout, SpscGetUsage(), mFifoSize, GetMemoryBudget(), pMemorySize);
+        AnnounceQueueDrop();
+        return false;
+    }
+
+    return true;
+}
+
+bool MediaFifo::SpscWaitForSpace(int pReadCounter, int64_t &pBlockStartTime)
+{
+    bool tResult = true;
+
+    // the timeout limits the entire blocking, the caller checks for free space after each wake up
+    if (pBlockStartTime == 0)
+        pBlockStartTime = Time::GetMonotonicTimeStamp();
+
+    mFifoMutex.lock();
+    mSpscProducerWaiting = 1;
+    // the waiting flag has to be visible to the consumer before we check the read cursor a last time
+    __sync_synchronize();
+    if (mSpscReadCounter == pReadCounter)
+    {
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: buffer full, waiting for free space", mName.c_str());
+        #endif
+        int64_t tWaitStart = GetStatisticTimestamp();
+        tResult = WaitForRemainingTime(mFifoSpaceCondition, mFifoMutex, pBlockStartTime, mOverflowBlockTimeout);
+        if (tWaitStart > 0)
+            AnnounceWriterBlocked(Time::GetTimeStamp() - tWaitStart);
+    }
+    mSpscProducerWaiting = 0;
+    mFifoMutex.unlock();
+
+    return tResult;
+}
+
+void MediaFifo::SpscPublishEntry()
+{
+    // publish the entry: its content has to be visible before the cursor moves
+    __sync_synchronize();
+    mSpscWriteCounter = (mSpscWriteCounter + 1) % (2 * mFifoSize);
+
+    SpscWakeUpConsumer();
+}
+
+int MediaFifo::SpscGetUsage()
+{
+    return (mSpscWriteCounter - mSpscReadCounter + 2 * mFifoSize) % (2 * mFifoSize);
+}
+
+bool MediaFifo::SpscApplyClearRequest()
+{
+    if (!__sync_lock_test_and_set(&mSpscClearRequested, 0))
+        return false;
+
+    __sync_synchronize();
+
+    // the mark has to be in range [read, write], otherwise it is outdated and the consumer has already passed it
+    int tMarkDistance = (mSpscClearMark - mSpscReadCounter + 2 * mFifoSize) % (2 * mFifoSize);
+    if (tMarkDistance <= SpscGetUsage())
+    {
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: dropping %d entries due to clear request", mName.c_str(), tMarkDistance);
+        #endif
+        for (int i = 0; i < tMarkDistance; i++)
+            ReleaseEntry((mSpscReadCounter + i) % mFifoSize);
+        AnnounceQueueDrop(tMarkDistance);
+        __sync_synchronize();
+        mSpscReadCounter = mSpscClearMark;
+        SpscWakeUpProducer();
+    }
+
+    return true;
+}
+
+void MediaFifo::SpscWaitForInput()
+{
+    SpscApplyClearRequest();
+
+    // fast path: no locking if there is some pending data
+    if ((SpscGetPendingWakeUps() > 0) || (SpscGetUsage() > 0))
+        return;
+
+    // slow path: park the consumer
+    int64_t tWaitStart = GetStatisticTimestamp();
+    mFifoMutex.lock();
+    mSpscConsumerWaiting = 1;
+    // the waiting flag has to be visible to the producer before we check the cursors a last time
+    __sync_synchronize();
+    while ((SpscGetPendingWakeUps() < 1) && (SpscGetUsage() < 1))
+    {
+        #ifdef MF_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: waiting for new input", mName.c_str());
+        #endif
+
+        if (!mFifoDataInputCondition.Wait(&mFifoMutex))
+        {
+            LOG(LOG_ERROR, "%s-FIFO: error when waiting for new input", mName.c_str());
+        }
+        SpscApplyClearRequest();
+    }
+    mSpscConsumerWaiting = 0;
+    mFifoMutex.unlock();
+
+    if (tWaitStart > 0)
+        AnnounceReaderBlocked(Time::GetTimeStamp() - tWaitStart);
+
+    __sync_synchronize();
+}
+
+int MediaFifo::ArenaGetTailOffset()
+{
+    // skip all chunks which were already released by the consumer
+    while ((mArenaChunkTail != mArenaChunkHead) && (!mArenaChunks[mArenaChunkTail].Busy))
+        mArenaChunkTail = (mArenaChunkTail + 1) % mArenaChunkCount;
+
+    // the consumer has to be finished with the released memory before we overwrite it
+    __sync_synchronize();
+
+    if (mArenaChunkTail == mArenaChunkHead)
+        return -1;
+    else
+        return mArenaChunks[mArenaChunkTail].Offset;
+}
+
+int MediaFifo::ArenaAllocate(int pSize)
+{
+    int tSize = (pSize + MEDIA_FIFO_ARENA_ALIGNMENT - 1) & ~(MEDIA_FIFO_ARENA_ALIGNMENT - 1);
+    int tTailOffset = ArenaGetTailOffset();
+    int tOffset = -1;
+
+    if ((mArenaChunkHead + 1) % mArenaChunkCount == mArenaChunkTail)
+        return -1;
+
+    if (tTailOffset < 0)
+    {// arena is empty
+        mArenaWritePos = 0;
+        if (tSize <= mArenaSize)
+            tOffset = 0;
+    }else if (tTailOffset < mArenaWritePos)
+    {// used memory is in range [tail, write], free memory at the end and at the start
+        if (mArenaWritePos + tSize <= mArenaSize)
+            tOffset = mArenaWritePos;
+        else if (tSize <= tTailOffset)
+            tOffset = 0;
+    }else
+    {// used memory wraps around, free memory is in range [write, tail]
+        if (mArenaWritePos + tSize <= tTailOffset)
+            tOffset = mArenaWritePos;
+    }
+
+    if (tOffset < 0)
+        return -1;
+
+    mArenaWritePos = tOffset + tSize;
+
+    // update high watermark
+    int tUsage;
+    if (tTailOffset < 0)
+        tUsage = tSize;
+    else if (tTailOffset < mArenaWritePos)
+        tUsage = mArenaWritePos - tTailOffset;
+    else
+        tUsage = mArenaSize - tTailOffset + mArenaWritePos;
+    if (mArenaHighWatermark < tUsage)
+        mArenaHighWatermark = tUsage;
+
+    int tResult = mArenaChunkHead;
+    mArenaChunks[tResult].Offset = tOffset;
+    mArenaChunks[tResult].Busy = true;
+    mArenaChunkHead = (mArenaChunkHead + 1) % mArenaChunkCount;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: allocated %d bytes at arena offset %d, arena usage: %d bytes", mName.c_str(), tSize, tOffset, tUsage);
+    #endif
+
+    return tResult;
+}
+
+void MediaFifo::AssignSharedBuffer(int pEntry, MediaBuffer *pBuffer)
+{
+    pBuffer->AddReference();
+    mFifo[pEntry].SharedBuffer = pBuffer;
+    mFifo[pEntry].Data = pBuffer->GetData();
+    mFifo[pEntry].Size = pBuffer->GetSize();
+}
+
+void MediaFifo::ReleaseEntry(int pEntry)
+{
+    MediaBuffer *tSharedBuffer = mFifo[pEntry].SharedBuffer;
+
+    if (tSharedBuffer != NULL)
+    {
+        mFifo[pEntry].SharedBuffer = NULL;
+        mFifo[pEntry].Data = mFifo[pEntry].Storage;
+        tSharedBuffer->Release();
+    }
+
+    ArenaRelease(pEntry);
+}
+
+void MediaFifo::ArenaShrink(int pChunk, int pSize)
+{
+    int tSize = (pSize + MEDIA_FIFO_ARENA_ALIGNMENT - 1) & ~(MEDIA_FIFO_ARENA_ALIGNMENT - 1);
+
+    // only the most recent allocation can be shrunk
+    if ((pChunk < 0) || ((pChunk + 1) % mArenaChunkCount != mArenaChunkHead))
+        return;
+
+    if (mArenaChunks[pChunk].Offset + tSize < mArenaWritePos)
+        mArenaWritePos = mArenaChunks[pChunk].Offset + tSize;
+}
+
+void MediaFifo::ArenaAssign(int pEntry, int pChunk)
+{
+    mFifo[pEntry].ArenaChunk = pChunk;
+    mFifo[pEntry].Data = mArena + mArenaChunks[pChunk].Offset;
+}
+
+void MediaFifo::ArenaRelease(int pEntry)
+{
+    int tChunk = mFifo[pEntry].ArenaChunk;
+
+    if (tChunk < 0)
+        return;
+
+    mFifo[pEntry].ArenaChunk = -1;
+
+    // all accesses to the memory have to be finished before the producer recycles it
+    __sync_synchronize();
+    mArenaChunks[tChunk].Busy = false;
+}
+
+void MediaFifo::SpscWakeUpConsumer()
+{
+    // the new cursor has to be visible to the consumer before we check the waiting flag
+    __sync_synchronize();
+
+    // only signal a parked consumer, the FIFO mutex guarantees it is already waiting within the condition
+    if (mSpscConsumerWaiting)
+    {
+        mFifoMutex.lock();
+        mFifoDataInputCondition.Signal();
+        mFifoMutex.unlock();
+    }
+
+    NotifyGroup();
+}
+
+void MediaFifo::SpscSignalWakeUp()
+{
+    // HINT: signals are rare, hence the signaling threads are serialized by the FIFO mutex and the producer isn't involved
+    mFifoMutex.lock();
+    if (SpscGetPendingWakeUps() < MEDIA_FIFO_MAX_PENDING_WAKE_UPS)
+    {
+        mSpscWakeUpMarks[mSpscWakeUpTail % MEDIA_FIFO_MAX_PENDING_WAKE_UPS] = mSpscWriteCounter;
+        // the mark has to be visible to the consumer before the signal
+        __sync_synchronize();
+        mSpscWakeUpTail = (mSpscWakeUpTail + 1) % (2 * MEDIA_FIFO_MAX_PENDING_WAKE_UPS);
+    }else
+        LOG(LOG_VERBOSE, "%s-FIFO: %d wake up signals are already pending, ignoring further signal", mName.c_str(), MEDIA_FIFO_MAX_PENDING_WAKE_UPS);
+    mFifoMutex.unlock();
+
+    SpscWakeUpConsumer();
+}
+
+int MediaFifo::SpscGetPendingWakeUps()
+{
+    return (mSpscWakeUpTail - mSpscWakeUpHead + 2 * MEDIA_FIFO_MAX_PENDING_WAKE_UPS) % (2 * MEDIA_FIFO_MAX_PENDING_WAKE_UPS);
+}
+
+int MediaFifo::SpscGetEntriesBeforeWakeUp()
+{
+    if (SpscGetPendingWakeUps() < 1)
+        return -1;
+
+    // the mark has to be read after the signal
+    __sync_synchronize();
+
+    // the mark has to be in range [read, write], otherwise the consumer has already passed it due to a clear request
+    int tMarkDistance = (mSpscWakeUpMarks[mSpscWakeUpHead % MEDIA_FIFO_MAX_PENDING_WAKE_UPS] - mSpscReadCounter + 2 * mFifoSize) % (2 * mFifoSize);
+    if (tMarkDistance > SpscGetUsage())
+        return 0;
+
+    return tMarkDistance;
+}
+
+void MediaFifo::SpscTakeWakeUp()
+{
+    // the mark has to be read before its slot can be reused by a signaling thread
+    __sync_synchronize();
+    mSpscWakeUpHead = (mSpscWakeUpHead + 1) % (2 * MEDIA_FIFO_MAX_PENDING_WAKE_UPS);
+}
+
+int64_t MediaFifo::GetStatisticTimestamp()
+{
+    if (IsQueueStatisticActive())
+        return Time::GetTimeStamp();
+    else
+        return 0;
+}
+
+void MediaFifo::AnnounceEntryRead(int pEntry)
+{
+    // signaling chunks and entries which were written before the activation of the statistic are ignored
+    if ((mFifo[pEntry].WriteTime > 0) && (mFifo[pEntry].Size > 0))
+        AnnounceQueueRead(Time::GetTimeStamp() - mFifo[pEntry].WriteTime);
+}
+
+void MediaFifo::SpscWakeUpProducer()
+{
+    // the new read cursor has to be visible to the producer before we check the waiting flag
+    __sync_synchronize();
+
+    // only signal a blocked producer, the FIFO mutex guarantees it is already waiting within the condition
+    if (mSpscProducerWaiting)
+    {
+        mFifoMutex.lock();
+        mFifoSpaceCondition.Signal();
+        mFifoMutex.unlock();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MediaFifoGroup::MediaFifoGroup(string pName)
+{
+    mName = pName;
+    mNextFifo = 0;
+    mConsumerWaiting = 0;
+    mGroupMutex.AssignName("MediaFifoGroup");
+}
+
+MediaFifoGroup::~MediaFifoGroup()
+{
+    mGroupMutex.lock();
+    for (int i = 0; i < (int)mFifos.size(); i++)
+        mFifos[i]->mGroup = NULL;
+    mFifos.clear();
+    mGroupMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MediaFifoGroup::AddFifo(MediaFifo *pFifo)
+{
+    if (pFifo == NULL)
+        return;
+
+    if ((pFifo->mGroup != NULL) && (pFifo->mGroup != this))
+    {
+        LOG(LOG_ERROR, "%s-FIFO already belongs to another group, adding it to group %s failed", pFifo->mName.c_str(), mName.c_str());
+        return;
+    }
+
+    mGroupMutex.lock();
+    for (int i = 0; i < (int)mFifos.size(); i++)
+    {
+        if (mFifos[i] == pFifo)
+        {
+            mGroupMutex.unlock();
+            return;
+        }
+    }
+    mFifos.push_back(pFifo);
+    pFifo->mGroup = this;
+    mGroupMutex.unlock();
+}
+
+void MediaFifoGroup::RemoveFifo(MediaFifo *pFifo)
+{
+    mGroupMutex.lock();
+    for (vector<MediaFifo*>::iterator tIt = mFifos.begin(); tIt != mFifos.end(); tIt++)
+    {
+        if (*tIt == pFifo)
+        {
+            pFifo->mGroup = NULL;
+            mFifos.erase(tIt);
+            break;
+        }
+    }
+    mGroupMutex.unlock();
+}
+
+MediaFifo* MediaFifoGroup::WaitForAny(int pTimeout)
+{
+    MediaFifo *tResult = NULL;
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+
+    mGroupMutex.lock();
+    mConsumerWaiting = 1;
+    // the waiting flag has to be visible to the producers before we check the FIFOs
+    __sync_synchronize();
+    while (true)
+    {
+        // HINT: lock order is group mutex before FIFO mutex, the FIFOs notify the group after they have released their mutex
+        int tFifoCount = (int)mFifos.size();
+        for (int i = 0; i < tFifoCount; i++)
+        {
+            int tFifo = (mNextFifo + i) % tFifoCount;
+            if (mFifos[tFifo]->HasPendingData())
+            {
+                tResult = mFifos[tFifo];
+                // round robin: the next call starts with the following FIFO
+                mNextFifo = (tFifo + 1) % tFifoCount;
+                break;
+            }
+        }
+        if (tResult != NULL)
+            break;
+
+        if (!WaitForRemainingTime(mGroupCondition, mGroupMutex, tStartTime, pTimeout))
+            break;
+    }
+    mConsumerWaiting = 0;
+    mGroupMutex.unlock();
+
+    return tResult;
+}
+
+void MediaFifoGroup::Notify()
+{
+    // the new data has to be visible to the consumer before we check the waiting flag
+    __sync_synchronize();
+
+    // only signal a waiting consumer, the group mutex guarantees it is already waiting within the condition
+    if (mConsumerWaiting)
+    {
+        mGroupMutex.lock();
+        mGroupCondition.Signal();
+        mGroupMutex.unlock();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
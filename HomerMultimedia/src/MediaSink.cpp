@@ -47,6 +47,7 @@ MediaSink::MediaSink(enum MediaSinkType pType):
     mSinkIsActive = false;
     mMaxFpsTimestampLastFragment = 0;
     mMaxFpsFrameNumberLastFragment = 0;
+    mKeyFrameRequested = 0;
     switch(pType)
     {
         case MEDIA_SINK_VIDEO:
@@ -71,6 +72,11 @@ void MediaSink::UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pR
     // nothing to do
 }
 
+bool MediaSink::SupportsSharedPacketData()
+{
+    return false;
+}
+
 void MediaSink::SetActivation(bool pState)
 {
     mSinkIsActive = pState;
@@ -92,6 +98,17 @@ int MediaSink::GetMaxFps()
     return mMaxFps;
 }
 
+void MediaSink::RequestKeyFrame()
+{
+    //HINT: the request is set by a network listener and reset by the encoder thread
+    __sync_lock_test_and_set(&mKeyFrameRequested, 1);
+}
+
+bool MediaSink::HasKeyFrameRequest()
+{
+    return (__sync_lock_test_and_set(&mKeyFrameRequested, 0) != 0);
+}
+
 bool MediaSink::BelowMaxFps(int pFrameNumber)
 {
     int64_t tCurrentTime = Time::GetTimeStamp();
@@ -36,6 +36,7 @@
 #include <Logger.h>
 
 #include <string>
+#include <string.h>
 
 namespace Homer { namespace Multimedia {
 
@@ -45,6 +46,10 @@ using namespace Homer::Monitor;
 ///////////////////////////////////////////////////////////////////////////////
 
 #define MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE    MEDIA_SOURCE_AV_CHUNK_BUFFER_SIZE
+// encoded frames are usually much smaller than the worst case, hence the FIFO shares a byte arena for all entries
+#define MEDIA_SINK_MEM_PLAIN_FIFO_MEMORY_BUDGET      (2 * MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE)
+// time in ms the encoder waits for free space before it drops a key frame fragment
+#define MEDIA_SINK_MEM_KEY_FRAME_BLOCK_TIMEOUT       20
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -59,11 +64,16 @@ MediaSinkMem::MediaSinkMem(string pMediaId, enum MediaSinkType pType, bool pRtpA
     mTargetPort = 0;
     mIncomingAVStreamCodecContext = NULL;
     mRtpActivated = pRtpActivated;
+    mRtpPacketHistory = NULL;
+    mRtpFecEncoder = NULL;
     mWaitUntillFirstKeyFrame = (pType == MEDIA_SINK_VIDEO) ? true : false;
     if (mRtpActivated)
-        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
+        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem", MEDIA_FIFO_SPSC, MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_MEMORY_BUDGET);
     else
-        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
+        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem", MEDIA_FIFO_SPSC, MEDIA_SINK_MEM_PLAIN_FIFO_MEMORY_BUDGET);
+    // a lost key frame corrupts the video until the next one arrives, hence we drop delta frames first
+    if (pType == MEDIA_SINK_VIDEO)
+        mSinkFifo->SetOverflowPolicy(MEDIA_FIFO_DROP_NON_KEY, MEDIA_SINK_MEM_KEY_FRAME_BLOCK_TIMEOUT);
     AssignStreamName("MEM-OUT: " + mMediaId);
     switch(pType)
     {
@@ -82,11 +92,13 @@ MediaSinkMem::~MediaSinkMem()
 {
     CloseStreamer();
     delete mSinkFifo;
+    delete mRtpPacketHistory;
+    delete mRtpFecEncoder;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName)
+void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName, MediaBuffer *pSharedPacketData)
 {
     bool tResetNeeded = false;
     bool tIsKeyFrame = pAVPacket->flags & AV_PKT_FLAG_KEY;
@@ -111,6 +123,8 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
             #ifdef MSIM_DEBUG_PACKETS
                 LOG(LOG_VERBOSE, "Still waiting for first key frame");
             #endif
+            // ask the encoder for a key frame instead of waiting for the next scheduled one
+            RequestKeyFrame();
             return;
         }else
         {
@@ -134,7 +148,7 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         #endif
 
         if ((tPacketTimestamp != (int64_t)AV_NOPTS_VALUE) && (tPacketTimestamp < mLastPacketPts))
-            LOG(LOG_ERROR, "Current %s packet pts (%lld) from A/V encoder is lower than last one (%"PRId64")", GetDataTypeStr().c_str(), tPacketTimestamp, mLastPacketPts);
+            LOG_RATE_LIMITED(LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Current %s packet pts (%lld) from A/V encoder is lower than last one (%"PRId64")", GetDataTypeStr().c_str(), tPacketTimestamp, mLastPacketPts);
 
         // do we have monotonously increasing PTS values
         if (mIncomingAVStreamLastPts > tPacketTimestamp)
@@ -237,12 +251,40 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         #endif
 
 
-        int64_t tTime = Time::GetTimeStamp();
+        //####################################################################
+        // H.264/HEVC: the RTP packets reference the encoded frame and are gathered directly in the sink FIFO
+        //####################################################################
+        if (IsNativePacketizerUsed())
+        {
+            #ifdef MSIM_DEBUG_TIMING
+                int64_t tTime = Time::GetMonotonicTimeStamp();
+            #endif
+            RtpPacketDescriptor *tRtpPackets = NULL;
+            int tRtpPacketCount = 0;
+            char *tRtcpSenderReport = NULL;
+            unsigned int tRtcpSenderReportSize = 0;
+            if (RtpCreateVectored(pAVPacket, tRtpPackets, tRtpPacketCount, tRtcpSenderReport, tRtcpSenderReportSize))
+            {
+                if (tRtcpSenderReport != NULL)
+                    WriteFragment(tRtcpSenderReport, tRtcpSenderReportSize, ++mPacketNumber, tIsKeyFrame);
+                for (int i = 0; i < tRtpPacketCount; i++)
+                    WriteFragmentVectored(&tRtpPackets[i], ++mPacketNumber, tIsKeyFrame);
+            }
+            #ifdef MSIM_DEBUG_TIMING
+                int64_t tTime2 = Time::GetMonotonicTimeStamp();
+                LOG(LOG_VERBOSE, "               generating and storing %d RTP packets took %"PRId64" us", tRtpPacketCount, tTime2 - tTime);
+            #endif
+            return;
+        }
+
+        #ifdef MSIM_DEBUG_TIMING
+            int64_t tTime = Time::GetMonotonicTimeStamp();
+        #endif
         char *tOutputStreamData = NULL;
         unsigned int tOutputStreamDataSize = 0;
         bool tRtpCreationSucceed = RtpCreate(pAVPacket, tOutputStreamData, tOutputStreamDataSize);
         #ifdef MSIM_DEBUG_TIMING
-            int64_t tTime2 = Time::GetTimeStamp();
+            int64_t tTime2 = Time::GetMonotonicTimeStamp();
             LOG(LOG_VERBOSE, "               generating RTP envelope took %"PRId64" us", tTime2 - tTime);
         #endif
         #ifdef MSIM_DEBUG_PACKETS
@@ -263,7 +305,9 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         //####################################################################
         if ((tRtpCreationSucceed) && (tOutputStreamData != 0) && (tOutputStreamDataSize > 0))
         {
-            tTime = Time::GetTimeStamp();
+            #ifdef MSIM_DEBUG_TIMING
+                tTime = Time::GetMonotonicTimeStamp();
+            #endif
             char *tRtpPacket = tOutputStreamData + 4;
             uint32_t tRtpPacketSize = 0;
             uint32_t tRemainingRtpDataSize = tOutputStreamDataSize;
@@ -279,7 +323,16 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
                     break;
 
                 // send final packet
-                WriteFragment(tRtpPacket, tRtpPacketSize, ++mPacketNumber);
+                WriteFragment(tRtpPacket, tRtpPacketSize, ++mPacketNumber, tIsKeyFrame);
+
+                // send the parity packet directly after the last packet of its group
+                if (mRtpFecEncoder != NULL)
+                {
+                    char *tFecPacket;
+                    int tFecPacketSize;
+                    if (mRtpFecEncoder->Protect(tRtpPacket, (int)tRtpPacketSize, tFecPacket, tFecPacketSize))
+                        WriteFragment(tFecPacket, (unsigned int)tFecPacketSize, ++mPacketNumber, tIsKeyFrame);
+                }
 
                 // go to the next RTP packet
                 tRtpPacket = tRtpPacket + (tRtpPacketSize + 4);
@@ -291,17 +344,26 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
                 #endif
             }while (tRemainingRtpDataSize > RTP_HEADER_SIZE);
             #ifdef MSIM_DEBUG_TIMING
-                tTime2 = Time::GetTimeStamp();
+                tTime2 = Time::GetMonotonicTimeStamp();
                 LOG(LOG_VERBOSE, "                             sending RTP packets to network took %"PRId64" us", tTime2 - tTime);
             #endif
         }
     }else
     {
-        // send final packet
-        WriteFragment((char*)pAVPacket->data, (unsigned int)pAVPacket->size, ++mPacketNumber);
+        // send final packet, use the shared packet data if available: the RTP packetizer creates individual data per media sink but plain packets are identical for all media sinks
+        if ((pSharedPacketData != NULL) && (SupportsSharedPacketData()))
+            WriteFragmentShared(pSharedPacketData, ++mPacketNumber, tIsKeyFrame);
+        else
+            WriteFragment((char*)pAVPacket->data, (unsigned int)pAVPacket->size, ++mPacketNumber, tIsKeyFrame);
     }
 }
 
+bool MediaSinkMem::SupportsSharedPacketData()
+{
+    // the RTP packetizer creates individual data per media sink
+    return !mRtpActivated;
+}
+
 void MediaSinkMem::UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp)
 {
     if ((mRtpActivated) && (mMediaSinkOpened))
@@ -352,7 +414,7 @@ void MediaSinkMem::StopProcessing()
     LOG(LOG_VERBOSE, "Media sink \"%s\" successfully stopped", GetStreamName().c_str());
 }
 
-void MediaSinkMem::WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber)
+void MediaSinkMem::WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber, bool pKeyFrame)
 {
     #ifdef MSIM_DEBUG_PACKETS
         LOG(LOG_VERBOSE, "Storing packet number %6ld at %p with size %4u(%3u header) in memory \"%s\"", pFragmentNumber, pData, pSize, RTP_HEADER_SIZE, mMediaId.c_str());
@@ -370,11 +432,63 @@ void MediaSinkMem::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
     AnnouncePacket(pSize);
     if ((int)pSize <= mSinkFifo->GetEntrySize())
     {
-        mSinkFifo->WriteFifo(pData, (int)pSize, pFragmentNumber);
+        if (mRtpPacketHistory != NULL)
+            mRtpPacketHistory->Store(pData, (int)pSize);
+        mSinkFifo->WriteFifo(pData, (int)pSize, pFragmentNumber, pKeyFrame);
     }else
         LOG(LOG_ERROR, "Packet for %s media sink of %u bytes is too big for FIFO with entries of %d bytes", GetDataTypeStr().c_str(), pSize, mSinkFifo->GetEntrySize());
 }
 
+void MediaSinkMem::WriteFragmentShared(MediaBuffer *pData, int64_t pFragmentNumber, bool pKeyFrame)
+{
+    #ifdef MSIM_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Storing shared packet number %6ld at %p with size %4d and %d references in memory \"%s\"", pFragmentNumber, pData->GetData(), pData->GetSize(), pData->GetReferenceCount(), mMediaId.c_str());
+    #endif
+    AnnouncePacket(pData->GetSize());
+    mSinkFifo->WriteFifoShared(pData, pFragmentNumber, pKeyFrame);
+}
+
+void MediaSinkMem::WriteFragmentVectored(RtpPacketDescriptor *pPacket, int64_t pFragmentNumber, bool pKeyFrame)
+{
+    char *tFecPacket = NULL;
+    int tFecPacketSize = 0;
+
+    #ifdef MSIM_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Storing packet number %6ld with size %4u from %d parts in memory \"%s\"", pFragmentNumber, pPacket->Size, pPacket->VectorCount, mMediaId.c_str());
+    #endif
+    AnnouncePacket(pPacket->Size);
+    if ((int)pPacket->Size > mSinkFifo->GetEntrySize())
+    {
+        LOG(LOG_ERROR, "Packet for %s media sink of %u bytes is too big for FIFO with entries of %d bytes", GetDataTypeStr().c_str(), pPacket->Size, mSinkFifo->GetEntrySize());
+        return;
+    }
+
+    // the packet has its sequence number: remember it for retransmissions even if the FIFO drops it
+    if (mRtpPacketHistory != NULL)
+        mRtpPacketHistory->Store(pPacket);
+
+    // reserve a FIFO entry and gather the packet parts in it, this is the only copy of the encoded frame
+    char *tEntry = NULL;
+    int tEntryPointer = mSinkFifo->WriteFifoExclusive(&tEntry, (int)pPacket->Size);
+    if (tEntryPointer < 0)
+        return;
+    char *tEntryPos = tEntry;
+    for (int i = 0; i < pPacket->VectorCount; i++)
+    {
+        memcpy(tEntryPos, pPacket->Vectors[i].Data, pPacket->Vectors[i].Size);
+        tEntryPos += pPacket->Vectors[i].Size;
+    }
+
+    // the entry belongs to us until it is finished: add the packet to the current FEC group
+    bool tFecPacketReady = ((mRtpFecEncoder != NULL) && (mRtpFecEncoder->Protect(tEntry, (int)pPacket->Size, tFecPacket, tFecPacketSize)));
+
+    mSinkFifo->WriteFifoExclusiveFinished(tEntryPointer, (int)pPacket->Size, pFragmentNumber, pKeyFrame);
+
+    // send the parity packet directly after the last packet of its group
+    if (tFecPacketReady)
+        WriteFragment(tFecPacket, (unsigned int)tFecPacketSize, ++mPacketNumber, pKeyFrame);
+}
+
 bool MediaSinkMem::OpenStreamer(AVStream *pStream, string pStreamName)
 {
     if (mMediaSinkOpened)
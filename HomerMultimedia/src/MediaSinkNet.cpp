@@ -38,6 +38,8 @@
 #include <Berkeley/SocketName.h>
 #include <RequirementTargetPort.h>
 
+#include <list>
+#include <vector>
 #include <string>
 
 #include <Requirements.h>
@@ -52,17 +54,30 @@ using namespace Homer::Base;
 
 #define MSIN_SIMULATED_PACKET_LOSS                              0 // in percent
 
+// minimum number of equally sized RTP packets which are handed over to the network stack as one segmented transmission
+#define MEDIA_SINK_NET_MIN_SEGMENTS                             2
+
+///////////////////////////////////////////////////////////////////////////////
+
+// media sinks which answer retransmission and key frame requests
+static Mutex sFeedbackReceiversMutex;
+static list<MediaSinkNet*> sFeedbackReceivers;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void MediaSinkNet::BasicInit(string pTargetHost, unsigned int pTargetPort)
 {
     mStreamFragmentCopyBuffer = NULL;
+    mRetransmissionBuffer = NULL;
     mNAPIDataSocket = NULL;
     mDataSocket = NULL;
     mBrokenPipe = false;
     mMaxNetworkPacketSize = -1;
+    mRetransmittedPackets = 0;
     mTargetHost = pTargetHost;
     mTargetPort = pTargetPort;
+    mSenderNeeded = false;
+    mSenderIsTask = Executor::PipelineTasksActivated();
 }
 
 MediaSinkNet::MediaSinkNet(string pTarget, Requirements *pTransportRequirements, enum MediaSinkType pType, bool pRtpActivated):
@@ -95,6 +110,10 @@ MediaSinkNet::MediaSinkNet(string pTarget, Requirements *pTransportRequirements,
     if (mStreamedTransport)
         mStreamFragmentCopyBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
 
+    // FEC without feedback: the group size isn't adapted
+    if ((mRtpActivated) && (RTP::IsFecActivated()) && (!mStreamedTransport))
+        mRtpFecEncoder = new RTPFecEncoder();
+
     // call NAPI
     if (mTargetHost != "")
     {
@@ -166,6 +185,27 @@ MediaSinkNet::MediaSinkNet(string pTargetHost, unsigned int pTargetPort, Socket*
                 break;
         }
         mDataSocket->SetQoS(tQoSSettings);
+
+        // resolve the target address once instead of per packet
+        //HINT: the socket isn't connected because it shares its local port with the receiving socket of the conference session (see Meeting),
+        //      a connected UDP socket would catch the incoming media from the same peer
+        if (!mDataSocket->SetDestination(pTargetHost, pTargetPort))
+            LOG(LOG_ERROR, "Failed to set destination %s:%u for the %s socket", pTargetHost.c_str(), pTargetPort, GetTransportTypeStr().c_str());
+
+        // RTCP feedback of the receiver arrives at the network listener of the shared socket, which delivers it via HandleFeedback()
+        if ((mRtpActivated) && ((RTP::IsNackSupported()) || (RTP::IsKeyFrameRequestSupported()) || (RTP::IsFecActivated())) && ((tTransportType == SOCKET_UDP) || (tTransportType == SOCKET_UDP_LITE)))
+        {
+            if (RTP::IsNackSupported())
+            {
+                mRtpPacketHistory = new RTPPacketHistory();
+                mRetransmissionBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+            }
+            if (RTP::IsFecActivated())
+                mRtpFecEncoder = new RTPFecEncoder();
+            sFeedbackReceiversMutex.lock();
+            sFeedbackReceivers.push_back(this);
+            sFeedbackReceiversMutex.unlock();
+        }
     }
 
     mMediaId = CreateId(pTargetHost, toString(pTargetPort), tTransportType, pRtpActivated);
@@ -176,6 +216,14 @@ MediaSinkNet::MediaSinkNet(string pTargetHost, unsigned int pTargetPort, Socket*
 
 MediaSinkNet::~MediaSinkNet()
 {
+    sFeedbackReceiversMutex.lock();
+    sFeedbackReceivers.remove(this);
+    sFeedbackReceiversMutex.unlock();
+
+    // wait for the end of a running retransmission
+    mRetransmissionMutex.lock();
+    mRetransmissionMutex.unlock();
+
     StopSender();
 
     if(mNAPIUsed)
@@ -187,12 +235,13 @@ MediaSinkNet::~MediaSinkNet()
         //HINT: socket object has to be deleted outside
     }
     free(mStreamFragmentCopyBuffer);
+    free(mRetransmissionBuffer);
     LOG(LOG_VERBOSE, "Destroyed");
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName)
+void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName, MediaBuffer *pSharedPacketData)
 {
     int tNewMaxNetworkPacketSize = -1;
 
@@ -214,7 +263,17 @@ void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
     }
 
     // call ProcessPacket from mem based media sink
-    MediaSinkMem::ProcessPacket(pAVPacket, pStream, pStreamName);
+    MediaSinkMem::ProcessPacket(pAVPacket, pStream, pStreamName, pSharedPacketData);
+
+    // the sender task drains all fragments of the packet at once
+    if ((mSenderIsTask) && (mSenderNeeded))
+        SVC_EXECUTOR.Schedule(this);
+}
+
+bool MediaSinkNet::SupportsSharedPacketData()
+{
+    // without RTP, packets are split according to the max. network packet size within WriteFragment()
+    return (!mRtpActivated) && (mMaxNetworkPacketSize <= 0);
 }
 
 string MediaSinkNet::CreateId(string pHost, string pPort, enum TransportType pSocketTransportType, bool pRtpActivated)
@@ -228,14 +287,15 @@ string MediaSinkNet::CreateId(string pHost, string pPort, enum TransportType pSo
 void MediaSinkNet::StopProcessing()
 {
     mSenderNeeded = false;
+    WakeUp();
     MediaSinkMem::StopProcessing();
 }
 
-void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber)
+void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber, bool pKeyFrame)
 {
     if (mRtpActivated)
     {// RTP active
-        MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber);
+        MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber, pKeyFrame);
     }else
     {// RTP inactive
         if (mMaxNetworkPacketSize > 0)
@@ -255,7 +315,9 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
             char *tFragmentData = pData;
             while (tFragmentCount)
             {
-                int64_t tTime = Time::GetTimeStamp();
+                #ifdef MSIN_DEBUG_TIMING
+                    int64_t tTime = Time::GetMonotonicTimeStamp();
+                #endif
                 tFragmentSize = (unsigned int)(((int)pSize > mMaxNetworkPacketSize)? mMaxNetworkPacketSize : pSize);
 
                 // for TCP add an additional fragment header in front of the codec data to be able to differentiate the fragments in a received TCP packet at receiver side
@@ -274,17 +336,17 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
                     }
                 }
 
-                int64_t tTime3 = Time::GetTimeStamp();
                 #ifdef MSIN_DEBUG_TIMING
-                    int64_t tTime4 = Time::GetTimeStamp();
+                    int64_t tTime3 = Time::GetMonotonicTimeStamp();
+                    int64_t tTime4 = Time::GetMonotonicTimeStamp();
                     LOG(LOG_VERBOSE, "       SendFragment::AnnouncePacket for a fragment of %u bytes took %"PRId64" us", tFragmentSize, tTime4 - tTime3);
                 #endif
-                MediaSinkMem::WriteFragment(tFragmentData, tFragmentSize, pFragmentNumber /* do not increase the fragment number here because we don't disntinguish between sub-fragments here*/);
+                MediaSinkMem::WriteFragment(tFragmentData, tFragmentSize, pFragmentNumber /* do not increase the fragment number here because we don't disntinguish between sub-fragments here*/, pKeyFrame);
 
                 tFragmentData = tFragmentData + tFragmentSize;
                 tFragmentCount--;
                 #ifdef MSIN_DEBUG_TIMING
-                    int64_t tTime2 = Time::GetTimeStamp();
+                    int64_t tTime2 = Time::GetMonotonicTimeStamp();
                     LOG(LOG_VERBOSE, "       SendFragment::Loop for a fragment of %u bytes took %"PRId64" us", tFragmentSize, tTime2 - tTime);
                 #endif
                 if ((tFragmentData > (pData + pSize)) && (tFragmentCount))
@@ -295,7 +357,7 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
             }
         }else
         {// fragment has to be sent 1:1
-            MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber);
+            MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber, pKeyFrame);
         }
     }
 }
@@ -304,20 +366,25 @@ void MediaSinkNet::StartSender()
 {
     LOG(LOG_VERBOSE, "Starting sender for target %s:%u", mTargetHost.c_str(), mTargetPort);
 
+    if (mSenderIsTask)
+    {
+        AssignTaskName(GetDataTypeStr() + "-Relay: " + mMediaId);
+        mSenderNeeded = true;
+        // a full FIFO schedules the sender task before a writer waits for free space
+        if (mSinkFifo != NULL)
+            mSinkFifo->SetConsumerTask(this);
+        LOG(LOG_VERBOSE, "Sender task for target %s:%u started", mTargetHost.c_str(), mTargetPort);
+        return;
+    }
+
     if (!IsRunning())
     {
         // start sender main loop
-        StartThread();
-
-        int tLoops = 0;
-
-        // wait until thread is running
-        while ((!IsRunning() /* wait until thread is started */) || (!mSenderNeeded /* wait until thread has finished the init. process */))
+        if (StartThread())
         {
-            if (tLoops % 10 == 0)
-                LOG(LOG_VERBOSE, "Waiting for the start of the packet relay thread, loop count: %d", ++tLoops);
-
-            Thread::Suspend(25 * 1000);
+            // wait until thread has finished the init. process
+            if (!WaitForReady())
+                LOG(LOG_ERROR, "Packet relay thread terminated during its init. process");
         }
     }
 
@@ -330,7 +397,15 @@ void MediaSinkNet::StopSender()
 
     LOG(LOG_VERBOSE, "Stopping sender");
 
-    if (mSinkFifo != NULL)
+    if (mSenderIsTask)
+    {
+        mSenderNeeded = false;
+        if (mSinkFifo != NULL)
+            mSinkFifo->SetConsumerTask(NULL);
+
+        // drop a queued execution and wait for the end of a running one, the executor signals its end
+        UnscheduleTask();
+    }else if (mSinkFifo != NULL)
     {
         // tell sender thread it isn't needed anymore
         mSenderNeeded = false;
@@ -344,9 +419,13 @@ void MediaSinkNet::StopSender()
 
             // write fake data to awake sender thread as long as it still runs
             mSinkFifo->WriteFifo(NULL, 0, 0);
-
-            Suspend(25 * 1000);
-        }while(IsRunning());
+        }while(!WaitForTermination(25));
+    }else
+    {
+        // tell sender thread it isn't needed anymore and awake it from its idle state
+        mSenderNeeded = false;
+        WakeUp();
+        WaitForTermination();
     }
 
     LOG(LOG_VERBOSE, "Encoder stopped");
@@ -354,10 +433,8 @@ void MediaSinkNet::StopSender()
 
 void* MediaSinkNet::Run(void* pArgs)
 {
-    int tFifoEntry = 0;
-    char *tBuffer;
-    int tBufferSize;
-    int64_t tFragmentNumber;
+    MediaFifoBatchEntry tPackets[MEDIA_SINK_NET_SEND_BATCH_SIZE];
+    int tPacketCount;
 
     LOG(LOG_VERBOSE, "%s Stream relay for target %s:%u started", GetDataTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
     if (mNAPIUsed)
@@ -391,31 +468,28 @@ void* MediaSinkNet::Run(void* pArgs)
     }
 
     mSenderNeeded = true;
+    AnnounceReady();
 
     while(mSenderNeeded)
     {
         if (mSinkFifo != NULL)
         {
-            int tBufferedPackets = mSinkFifo->GetUsage();
-
-            tFifoEntry = mSinkFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tFragmentNumber);
+            // drain all waiting packets at once, e.g., the fragments of a key frame
+            tPacketCount = mSinkFifo->ReadFifoExclusiveBatch(tPackets, MEDIA_SINK_NET_SEND_BATCH_SIZE);
 
-            if ((tBufferSize > 0) && (mSenderNeeded))
-            {
-                #ifdef MSIN_DEBUG_PACKETS
-                    if (tBufferedPackets > 2)
-                        LOG(LOG_WARN, "%d/%d %s packets are already buffered for relaying to %s", tBufferedPackets, mSinkFifo->GetSize(), mCodec.c_str(), GetId().c_str());
-                    else
-                        LOG(LOG_VERBOSE, "Sending packet %d with %d bytes, %d remaining packets in queue", (int)tFragmentNumber, tBufferSize, tBufferedPackets);
-                #endif
+            #ifdef MSIN_DEBUG_PACKETS
+                if (tPacketCount > 2)
+                    LOG(LOG_WARN, "%d/%d %s packets were buffered for relaying to %s", tPacketCount, mSinkFifo->GetSize(), mCodec.c_str(), GetId().c_str());
+            #endif
 
-                SendPacket(tBuffer, tBufferSize);
-            }
+            if (mSenderNeeded)
+                SendPackets(tPackets, tPacketCount);
 
-            // release FIFO entry lock
-            mSinkFifo->ReadFifoExclusiveFinished(tFifoEntry);
+            // release FIFO entry locks
+            mSinkFifo->ReadFifoExclusiveBatchFinished(tPackets, tPacketCount);
 
-            if (tBufferSize == 0)
+            // a batch ends with an empty chunk
+            if ((tPacketCount > 0) && (tPackets[tPacketCount - 1].Size == 0))
             {
                 LOG(LOG_VERBOSE, "Zero byte %s packet in relay thread detected", GetDataTypeStr().c_str());
             }
@@ -430,8 +504,8 @@ void* MediaSinkNet::Run(void* pArgs)
             }
         }else
         {
-            LOG(LOG_VERBOSE, "Suspending the sender thread for 10 ms");
-            Suspend(10 * 1000); // check every 1/100 seconds the state of the FIFO
+            LOG(LOG_VERBOSE, "Suspending the sender thread until it gets awaked");
+            SuspendUntilWakeUp();
         }
     }
 
@@ -440,6 +514,254 @@ void* MediaSinkNet::Run(void* pArgs)
     return NULL;
 }
 
+void MediaSinkNet::Execute()
+{
+    MediaFifoBatchEntry tPackets[MEDIA_SINK_NET_SEND_BATCH_SIZE];
+    int tPacketCount;
+
+    if (mSinkFifo == NULL)
+        return;
+
+    // one batch per execution, this keeps the workers fair among all stages
+    tPacketCount = mSinkFifo->ReadFifoExclusiveBatch(tPackets, MEDIA_SINK_NET_SEND_BATCH_SIZE, false);
+    if (tPacketCount < 1)
+        return;
+
+    if (mSenderNeeded)
+        SendPackets(tPackets, tPacketCount);
+
+    // release FIFO entry locks
+    mSinkFifo->ReadFifoExclusiveBatchFinished(tPackets, tPacketCount);
+
+    // further packets are waiting? execute the task once more
+    if ((tPacketCount == MEDIA_SINK_NET_SEND_BATCH_SIZE) && (mSenderNeeded))
+        SVC_EXECUTOR.Schedule(this);
+
+    // is FIFO near overload situation?
+    if (mSinkFifo->GetUsage() >= mSinkFifo->GetSize() - 4)
+    {
+        LOG(LOG_WARN, "Relay FIFO is near overload situation, deleting all stored frames");
+
+        // delete all stored frames: it is a better for the encoding to have a gap instead of frames which have high picture differences
+        mSinkFifo->ClearFifo();
+    }
+}
+
+void MediaSinkNet::SendPackets(MediaFifoBatchEntry *pPackets, int pPacketCount)
+{
+    #if (MSIN_SIMULATED_PACKET_LOSS == 0) && !defined(MSIN_DEBUG_PACKETS)
+        // a socket with a fixed destination sends the entire burst with one system call
+        if ((!mNAPIUsed) && (mDataSocket != NULL) && (mDataSocket->HasDestination()))
+        {
+            SocketDatagram tDatagrams[MEDIA_SINK_NET_SEND_BATCH_SIZE];
+            int tDatagramCount = 0;
+
+            if (mBrokenPipe)
+            {
+                LOG(LOG_VERBOSE, "Skipped fragment transmission because of broken pipe");
+                return;
+            }
+
+            for (int i = 0; (i < pPacketCount) && (tDatagramCount < MEDIA_SINK_NET_SEND_BATCH_SIZE); i++)
+            {
+                if (pPackets[i].Size > 0)
+                {
+                    tDatagrams[tDatagramCount].Data = pPackets[i].Data;
+                    tDatagrams[tDatagramCount].Size = (ssize_t)pPackets[i].Size;
+                    tDatagramCount++;
+                }
+            }
+
+            // equally sized RTP packets of one frame, e.g., the fragments of a key frame, are segmented by the network stack
+            int tSentDatagrams = 0;
+            if ((mRtpActivated) && (Socket::IsSegmentationOffloadActivated()) && (mDataSocket->GetTransportType() == SOCKET_UDP))
+            {
+                int tRunStart = 0;
+                while (tRunStart < tDatagramCount)
+                {
+                    int tRunEnd = tRunStart + 1;
+                    while ((tRunEnd < tDatagramCount) && (tDatagrams[tRunEnd - 1].Size == tDatagrams[tRunStart].Size) && (tDatagrams[tRunEnd].Size <= tDatagrams[tRunStart].Size) && (BelongToSameRtpFrame(tDatagrams[tRunStart].Data, tDatagrams[tRunEnd].Data, (int)tDatagrams[tRunEnd].Size)))
+                        tRunEnd++;
+
+                    if (tRunEnd - tRunStart >= MEDIA_SINK_NET_MIN_SEGMENTS)
+                    {
+                        // keep the packet order: send the preceding packets first
+                        if ((tRunStart > tSentDatagrams) && (!mDataSocket->SendBatch(&tDatagrams[tSentDatagrams], tRunStart - tSentDatagrams)))
+                            break;
+                        tSentDatagrams = tRunStart;
+                        if (!mDataSocket->SendSegmented(&tDatagrams[tRunStart], tRunEnd - tRunStart))
+                            break;
+                        tSentDatagrams = tRunEnd;
+                    }
+                    tRunStart = tRunEnd;
+                }
+                if (tRunStart < tDatagramCount)
+                {
+                    LOG(LOG_ERROR, "Error when sending %d packets through %s socket to %s:%u, will skip further transmissions", tDatagramCount - tSentDatagrams, GetTransportTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
+                    mBrokenPipe = true;
+                    return;
+                }
+            }
+
+            if ((tDatagramCount > tSentDatagrams) && (!mDataSocket->SendBatch(&tDatagrams[tSentDatagrams], tDatagramCount - tSentDatagrams)))
+            {
+                LOG(LOG_ERROR, "Error when sending %d packets through %s socket to %s:%u, will skip further transmissions", tDatagramCount - tSentDatagrams, GetTransportTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
+                mBrokenPipe = true;
+            }
+            return;
+        }
+    #endif
+
+    for (int i = 0; i < pPacketCount; i++)
+    {
+        if (pPackets[i].Size > 0)
+        {
+            #ifdef MSIN_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Sending packet %d with %d bytes, %d remaining packets in batch", (int)pPackets[i].Number, pPackets[i].Size, pPacketCount - i - 1);
+            #endif
+
+            SendPacket(pPackets[i].Data, (unsigned int)pPackets[i].Size);
+        }
+    }
+}
+
+bool MediaSinkNet::HandleFeedback(char *pData, int pDataSize)
+{
+    unsigned short int tSequenceNumbers[RTCP_NACK_MAX_PACKETS];
+    int tCount = RTCP_NACK_MAX_PACKETS;
+    unsigned int tMediaSsrc;
+    vector<MediaSinkNet*> tReceivers;
+
+    if (RTP::IsRtcpPayloadFeedback(pData, pDataSize))
+        return HandleKeyFrameRequest(pData, pDataSize);
+
+    if (!RTP::IsRtcpTransportFeedback(pData, pDataSize))
+        return HandleReceiverReport(pData, pDataSize);
+
+    if ((!RTP::IsNackSupported()) || (!RTP::RtcpParseNack(pData, pDataSize, tMediaSsrc, tSequenceNumbers, tCount)))
+        return false;
+
+    // look up the addressed media sinks, their retransmission mutex keeps them alive after the list is unlocked
+    sFeedbackReceiversMutex.lock();
+    for (list<MediaSinkNet*>::iterator tIt = sFeedbackReceivers.begin(); tIt != sFeedbackReceivers.end(); tIt++)
+    {
+        if (((*tIt)->mRtpPacketHistory != NULL) && ((*tIt)->mRtpPacketHistory->GetSourceIdentifier() == tMediaSsrc))
+        {
+            (*tIt)->mRetransmissionMutex.lock();
+            tReceivers.push_back(*tIt);
+        }
+    }
+    sFeedbackReceiversMutex.unlock();
+
+    // the retransmissions don't block the feedback of other media sinks
+    for (vector<MediaSinkNet*>::iterator tIt = tReceivers.begin(); tIt != tReceivers.end(); tIt++)
+    {
+        (*tIt)->RetransmitPackets(tSequenceNumbers, tCount);
+        (*tIt)->mRetransmissionMutex.unlock();
+    }
+
+    if (tReceivers.empty())
+        LOGEX_RATE_LIMITED(MediaSinkNet, LOG_VERBOSE, LOG_PER_PACKET_RATE_LIMIT, "Got NACK for %d packets of unknown SSRC %u", tCount, tMediaSsrc);
+
+    return !tReceivers.empty();
+}
+
+bool MediaSinkNet::HandleKeyFrameRequest(char *pData, int pDataSize)
+{
+    unsigned int tMediaSsrc;
+    bool tResult = false;
+
+    if ((!RTP::IsKeyFrameRequestSupported()) || (!RTP::RtcpParseKeyFrameRequest(pData, pDataSize, tMediaSsrc)))
+        return false;
+
+    //HINT: the request is only flagged here, the encoder of the media source collects the requests of all its sinks and creates one key frame for them
+    sFeedbackReceiversMutex.lock();
+    for (list<MediaSinkNet*>::iterator tIt = sFeedbackReceivers.begin(); tIt != sFeedbackReceivers.end(); tIt++)
+    {
+        if ((*tIt)->GetLocalSourceIdentifierFromRTP() == tMediaSsrc)
+        {
+            #ifdef MSIN_DEBUG_PACKETS
+                LOGEX(MediaSinkNet, LOG_VERBOSE, "Got key frame request for %s", (*tIt)->GetId().c_str());
+            #endif
+            (*tIt)->RequestKeyFrame();
+            tResult = true;
+        }
+    }
+    sFeedbackReceiversMutex.unlock();
+
+    if (!tResult)
+        LOGEX_RATE_LIMITED(MediaSinkNet, LOG_VERBOSE, LOG_PER_PACKET_RATE_LIMIT, "Got key frame request for unknown SSRC %u", tMediaSsrc);
+
+    return tResult;
+}
+
+bool MediaSinkNet::HandleReceiverReport(char *pData, int pDataSize)
+{
+    unsigned int tMediaSsrc;
+    float tRelativeLoss;
+    bool tResult = false;
+
+    if (!RTP::RtcpParseReceiverReport(pData, pDataSize, tMediaSsrc, tRelativeLoss))
+        return false;
+
+    sFeedbackReceiversMutex.lock();
+    for (list<MediaSinkNet*>::iterator tIt = sFeedbackReceivers.begin(); tIt != sFeedbackReceivers.end(); tIt++)
+    {
+        if (((*tIt)->mRtpFecEncoder != NULL) && ((*tIt)->GetLocalSourceIdentifierFromRTP() == tMediaSsrc))
+        {
+            #ifdef MSIN_DEBUG_PACKETS
+                LOGEX(MediaSinkNet, LOG_VERBOSE, "Got receiver report with %.2f %% loss for %s", tRelativeLoss, (*tIt)->GetId().c_str());
+            #endif
+            (*tIt)->mRtpFecEncoder->SetGroupSize(RTPFecEncoder::CalculateGroupSize(tRelativeLoss));
+            tResult = true;
+        }
+    }
+    sFeedbackReceiversMutex.unlock();
+
+    return tResult;
+}
+
+// retransmission mutex has to be held by the caller
+void MediaSinkNet::RetransmitPackets(unsigned short int *pSequenceNumbers, int pCount)
+{
+    int tPacketSize;
+    int tRetransmittedPackets = 0;
+
+    if ((mBrokenPipe) || (mDataSocket == NULL) || (!mSenderNeeded) || (mRetransmissionBuffer == NULL))
+        return;
+
+    //HINT: the socket has a fixed destination, sending from the listener thread doesn't interfere with the sender thread
+    for (int i = 0; i < pCount; i++)
+    {
+        tPacketSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
+        if (mRtpPacketHistory->Get(pSequenceNumbers[i], mRetransmissionBuffer, tPacketSize))
+        {
+            if (!mDataSocket->Send(mRetransmissionBuffer, (ssize_t)tPacketSize))
+                break;
+            tRetransmittedPackets++;
+        }
+    }
+    mRetransmittedPackets += tRetransmittedPackets;
+
+    #ifdef MSIN_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Retransmitted %d of %d requested packets to %s:%u, %"PRId64" retransmissions in total", tRetransmittedPackets, pCount, mTargetHost.c_str(), mTargetPort, mRetransmittedPackets);
+    #endif
+    if (tRetransmittedPackets < pCount)
+        LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "Only %d of %d requested packets were available for a retransmission to %s:%u", tRetransmittedPackets, pCount, mTargetHost.c_str(), mTargetPort);
+}
+
+bool MediaSinkNet::BelongToSameRtpFrame(void *pFirstPacket, void *pPacket, int pPacketSize)
+{
+    // compare in network byte order: payload type, timestamp and SSRC, the marker bit of the last fragment is ignored
+    uint32_t *tFirstHeader = (uint32_t*)pFirstPacket;
+    uint32_t *tHeader = (uint32_t*)pPacket;
+
+    if (pPacketSize < (int)RTP_HEADER_SIZE)
+        return false;
+
+    return ((((uint8_t*)tFirstHeader)[1] & 0x7F) == (((uint8_t*)tHeader)[1] & 0x7F)) && (tFirstHeader[1] == tHeader[1]) && (tFirstHeader[2] == tHeader[2]);
+}
+
 void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
 {
     if ((mTargetHost == "") || (mTargetPort == 0))
@@ -486,7 +808,9 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
         }
     #endif
 
-    int64_t tTime = Time::GetTimeStamp();
+    #ifdef MSIN_DEBUG_TIMING
+        int64_t tTime = Time::GetMonotonicTimeStamp();
+    #endif
     if(mNAPIUsed)
     {
         if (mNAPIDataSocket != NULL)
@@ -502,7 +826,7 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
     {
         if (mDataSocket != NULL)
         {
-            if (!mDataSocket->Send(mTargetHost, mTargetPort, pData, (ssize_t)pSize))
+            if (!mDataSocket->Send(pData, (ssize_t)pSize))
             {
                 LOG(LOG_ERROR, "Error when sending data through %s socket to %s:%u, will skip further transmissions", GetTransportTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
                 mBrokenPipe = true;
@@ -510,7 +834,7 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
         }
     }
     #ifdef MSIN_DEBUG_TIMING
-        int64_t tTime2 = Time::GetTimeStamp();
+        int64_t tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "       sending a packet of %u bytes took %"PRId64" us", pSize, tTime2 - tTime);
     #endif
 }
@@ -1079,7 +1079,7 @@ bool MediaSource::WaitForRTGrabbing()
         int64_t tDesiredPlayOutTime = mRTGrabbingFrameTimestamps.front() + tTimeDiffForHistory;
 
         // get the time since last successful grabbing
-        int64_t tWaitingTine = tDesiredPlayOutTime - Time::GetTimeStamp(); // in us
+        int64_t tWaitingTine = tDesiredPlayOutTime - Time::GetMonotonicTimeStamp(); // in us
 
         if (tWaitingTine > 0)
         {// skip capturing when we are too fast
@@ -1098,7 +1098,7 @@ bool MediaSource::WaitForRTGrabbing()
     }
 
     // store current timestamp
-    mRTGrabbingFrameTimestamps.push_back(Time::GetTimeStamp());
+    mRTGrabbingFrameTimestamps.push_back(Time::GetMonotonicTimeStamp());
 
     return true;
 }
@@ -1845,6 +1845,8 @@ void MediaSource::RelayChunkToMediaFilters(char* pPacketData, unsigned int pPack
 void MediaSource::RelayAVPacketToMediaSinks(AVPacket *pAVPacket)
 {
     MediaSinks::iterator tIt;
+    MediaBuffer *tSharedPacketData = NULL;
+    int tSharingMediaSinks = 0;
 
     // lock
     mMediaSinksMutex.lock();
@@ -1855,10 +1857,27 @@ void MediaSource::RelayAVPacketToMediaSinks(AVPacket *pAVPacket)
 
     if (mMediaSinks.size() > 0)
     {
+        // fan-out: copy the packet data only once if at least two media sinks store it unchanged, the media sinks store references instead of own copies
+        // HINT: RTP based media sinks packetize directly from the AVPacket, a shared copy would be an additional one for them
+        if ((mMediaSinks.size() > 1) && (pAVPacket->size > 0))
+        {
+            for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
+            {
+                if ((*tIt)->SupportsSharedPacketData())
+                    tSharingMediaSinks++;
+            }
+            if (tSharingMediaSinks > 1)
+                tSharedPacketData = MediaBuffer::Create((const char*)pAVPacket->data, pAVPacket->size);
+        }
+
         for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
         {
-            (*tIt)->ProcessPacket(pAVPacket, (mFormatContext != NULL ? mFormatContext->streams[0] : NULL), GetCurrentDeviceName());
+            (*tIt)->ProcessPacket(pAVPacket, (mFormatContext != NULL ? mFormatContext->streams[0] : NULL), GetCurrentDeviceName(), ((tSharedPacketData != NULL) && ((*tIt)->SupportsSharedPacketData())) ? tSharedPacketData : NULL);
         }
+
+        // release our own reference, the last media sink releases the memory
+        if (tSharedPacketData != NULL)
+            tSharedPacketData->Release();
     }
 
     // unlock
@@ -3074,12 +3093,12 @@ MetaData MediaSource::GetMetaData()
 
 void MediaSource::InitFpsEmulator()
 {
-    mSourceStartTimeForRTGrabbing = av_gettime();
+    mSourceStartTimeForRTGrabbing = Time::GetMonotonicTimeStamp();
 }
 
 int64_t MediaSource::GetPtsFromFpsEmulator()
 {
-    int64_t tRelativeRealTimeUSecs = av_gettime() - mSourceStartTimeForRTGrabbing; // relative playback time in usecs
+    int64_t tRelativeRealTimeUSecs = Time::GetMonotonicTimeStamp() - mSourceStartTimeForRTGrabbing; // relative playback time in usecs
     float tRelativeFrameNumber = GetInputFrameRate() * tRelativeRealTimeUSecs / AV_TIME_BASE;
     return (int64_t)tRelativeFrameNumber;
 }
@@ -29,6 +29,7 @@
 
 #include <MediaSourceAlsa.h>
 #include <ProcessStatisticService.h>
+#include <HBThread.h>
 #include <Logger.h>
 
 #include <string.h>
@@ -161,6 +162,7 @@ bool MediaSourceAlsa::OpenAudioGrabDevice(int pSampleRate, int pChannels)
     LOG(LOG_VERBOSE, "Trying to open the audio source");
 
     SVC_PROCESS_STATISTIC.AssignThreadName("Audio-Grabber(ALSA)");
+    Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
 
     if (mMediaSourceOpened)
         return false;
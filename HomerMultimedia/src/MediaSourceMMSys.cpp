@@ -28,6 +28,7 @@
 
 #include <MediaSourceMMSys.h>
 #include <ProcessStatisticService.h>
+#include <HBThread.h>
 #include <Logger.h>
 
 #include <cstdio>
@@ -183,6 +184,7 @@ bool MediaSourceMMSys::OpenAudioGrabDevice(int pSampleRate, int pChannels)
     LOG(LOG_VERBOSE, "Trying to open the audio source");
 
     SVC_PROCESS_STATISTIC.AssignThreadName("Audio-Grabber(MMSYS)");
+    Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
 
     if (mMediaSourceOpened)
         return false;
@@ -34,6 +34,7 @@
 
 #include <Logger.h>
 #include <HBSystem.h>
+#include <HBTime.h>
 
 #include <string>
 #include <stdint.h>
@@ -70,6 +71,10 @@ using namespace Homer::Base;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static bool sJitterBufferActivated = true;
+
+///////////////////////////////////////////////////////////////////////////////
+
 MediaSourceMem::MediaSourceMem(string pName):
     MediaSource(pName), RTP()
 {
@@ -83,6 +88,13 @@ MediaSourceMem::MediaSourceMem(string pName):
     mDecoderFifo = NULL;
     mRtpActivated = false;
     mDecoderFragmentFifo = NULL;
+    mDecoderFeedbackSourceIdentifier = av_get_random_seed();
+    mDecoderRequestedRetransmissions = 0;
+    mDecoderKeyFrameRequestSourceIdentifier = 0;
+    mDecoderKeyFrameRequestLostPackets = 0;
+    mDecoderKeyFrameRequestTime = 0;
+    mDecoderRequestedKeyFrames = 0;
+    mDecoderFecReportedRecoveredPackets = 0;
     mResXLastGrabbedFrame = 0;
     mResYLastGrabbedFrame = 0;
     mDecoderSinglePictureResX = 0;
@@ -105,8 +117,8 @@ MediaSourceMem::MediaSourceMem(string pName):
     mRtpSourceCodecIdHint = AV_CODEC_ID_NONE;
     mSourceCodecId = AV_CODEC_ID_NONE;
 
-    mDecoderFragmentFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, "MediaSourceMem-Fragments");
-    LOG(LOG_VERBOSE, "Listen for video/audio frames with queue of %d bytes", MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT * MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+    mDecoderFragmentFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, "MediaSourceMem-Fragments", MEDIA_FIFO_SPSC, MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_MEMORY_BUDGET);
+    LOG(LOG_VERBOSE, "Listen for video/audio frames with queue of %d bytes", MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_MEMORY_BUDGET);
 }
 
 MediaSourceMem::~MediaSourceMem()
@@ -163,8 +175,8 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
             tFragmenHasAVData = false;
             tFragmentData = &tMediaSourceMemInstance->mFragmentBuffer[0];
             tFragmentBufferSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE; // maximum size of one single fragment of a frame packet
-            // receive a fragment
-            tMediaSourceMemInstance->ReadFragment(tFragmentData, tFragmentBufferSize, tFragmentNumber);
+            // receive a fragment, in sequence number order
+            tMediaSourceMemInstance->ReadBufferedFragment(tFragmentData, tFragmentBufferSize, tFragmentNumber);
 
             // create new AV packet
             AVPacket tAVPacket;
@@ -228,7 +240,9 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
                 {// fragment has no valid A/V data
                     if (tFragmentRtcpType > 0)
                     {// we have received a sender report or a sender description
-                        // nothing to do here
+                        // the sender of a FEC protected stream adapts the FEC overhead to our packet loss
+                        if ((tFragmentRtcpType == RTCP_SENDER_REPORT) && (tMediaSourceMemInstance->mDecoderFecDecoder.IsActive()))
+                            tMediaSourceMemInstance->SendReceiverReport();
                     }else
                     {// we have received an unsupported RTCP packet/RTP payload or something went completely wrong
                         if (tMediaSourceMemInstance->HasInputStreamChanged())
@@ -237,7 +251,7 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
                             return AVERROR(ENODEV);
                         }else
                         {// something went wrong
-                            LOGEX(MediaSourceMem, LOG_WARN, "Current RTP packet was reported as invalid by RTP parser, ignoring this data");
+                            LOGEX_RATE_LIMITED(MediaSourceMem, LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "Current RTP packet was reported as invalid by RTP parser, ignoring this data");
                         }
                     }
                 }
@@ -308,6 +322,31 @@ float MediaSourceMem::GetRelativeLoss()
     return mRtcpRelativeLoss;
 }
 
+RtpJitterBufferStatistic MediaSourceMem::GetJitterBufferStatistic()
+{
+    RtpJitterBufferStatistic tResult = mDecoderJitterBuffer.GetStatistic();
+
+    tResult.Requested = mDecoderRequestedRetransmissions;
+
+    return tResult;
+}
+
+RtpFecStatistic MediaSourceMem::GetFecStatistic()
+{
+    return mDecoderFecDecoder.GetStatistic();
+}
+
+void MediaSourceMem::DisableJitterBuffer()
+{
+    LOGEX(MediaSourceMem, LOG_VERBOSE, "Disabling jitter buffer for received RTP packets");
+    sJitterBufferActivated = false;
+}
+
+bool MediaSourceMem::IsJitterBufferActivated()
+{
+    return sJitterBufferActivated;
+}
+
 void MediaSourceMem::WriteFragment(char *pBuffer, int pBufferSize, int64_t pFragmentNumber)
 {
     if (mDecoderFragmentFifo == NULL)
@@ -328,7 +367,8 @@ void MediaSourceMem::WriteFragment(char *pBuffer, int pBufferSize, int64_t pFrag
         #endif
     }
 
-    if (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4)
+    // HINT: in SPSC mode only the reader may drop the stored fragments, it does this in ReadFragment(), until then a full FIFO drops the newest fragments
+    if ((mDecoderFragmentFifo->GetMode() != MEDIA_FIFO_SPSC) && (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4))
     {
         LOG(LOG_WARN, "Decoder fragment FIFO is near overload situation in WriteFragmet(), deleting all stored fragments");
 
@@ -339,6 +379,46 @@ void MediaSourceMem::WriteFragment(char *pBuffer, int pBufferSize, int64_t pFrag
     mDecoderFragmentFifo->WriteFifo(pBuffer, pBufferSize, pFragmentNumber);
 }
 
+int MediaSourceMem::WriteFragmentExclusive(char **pBuffer, int pBufferSize)
+{
+    if (mDecoderFragmentFifo == NULL)
+    {
+        return -1;
+    }
+
+    // HINT: in SPSC mode only the reader may drop the stored fragments, it does this in ReadFragment(), until then a full FIFO drops the newest fragments
+    if ((mDecoderFragmentFifo->GetMode() != MEDIA_FIFO_SPSC) && (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4))
+    {
+        LOG(LOG_WARN, "Decoder fragment FIFO is near overload situation in WriteFragmentExclusive(), deleting all stored fragments");
+
+        // delete all stored frames: it is a better for the decoding!
+        mDecoderFragmentFifo->ClearFifo();
+    }
+
+    return mDecoderFragmentFifo->WriteFifoExclusive(pBuffer, pBufferSize);
+}
+
+void MediaSourceMem::WriteFragmentExclusiveFinished(int pFragmentEntry, int pBufferSize, int64_t pFragmentNumber)
+{
+    if ((mDecoderFragmentFifo == NULL) || (pFragmentEntry < 0))
+    {
+        return;
+    }
+
+    if (pBufferSize > 0)
+    {
+        // log statistics
+        // mFragmentHeaderSize to add additional TCPFragmentHeader to the statistic if TCP is used, this is triggered by MediaSourceNet
+        AnnouncePacket((int)pBufferSize + mPacketStatAdditionalFragmentSize);
+
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Write reserved fragment %d with size %5d for %s decoder", pFragmentEntry, pBufferSize, GetMediaTypeStr().c_str());
+        #endif
+    }
+
+    mDecoderFragmentFifo->WriteFifoExclusiveFinished(pFragmentEntry, pBufferSize, pFragmentNumber);
+}
+
 void MediaSourceMem::ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber)
 {
     if (mDecoderFragmentFifo == NULL)
@@ -365,6 +445,171 @@ void MediaSourceMem::ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFra
     }
 }
 
+//HINT: only the decoder thread reads fragments, hence it is the only user of the jitter buffer
+//HINT: fragments which passed the jitter buffer are numbered by their extended RTP sequence number
+void MediaSourceMem::ReadBufferedFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber)
+{
+    int tBufferSize = pBufferSize;
+    int64_t tWaitTime;
+    int64_t tExtendedSequenceNumber;
+
+    // without RTP, there are neither sequence numbers nor FEC packets: the fragments are used as they are
+    if (!mRtpActivated)
+    {
+        ReadFragment(pBuffer, pBufferSize, pFragmentNumber);
+        return;
+    }
+
+    if ((!sJitterBufferActivated) || (mDecoderFragmentFifo == NULL))
+    {
+        // without reordering, a recovered packet would be too late: FEC packets are ignored
+        do{
+            pBufferSize = tBufferSize;
+            ReadFragment(pBuffer, pBufferSize, pFragmentNumber);
+        }while ((pBufferSize > 0) && (!mGrabbingStopped) && (RTPFecDecoder::IsFecPacket(pBuffer, pBufferSize)));
+        return;
+    }
+
+    while (true)
+    {
+        // a new stream or packets which were skipped at their playout deadline? the decoder needs a key frame to recover
+        if ((mMediaType == MEDIA_VIDEO) && (RTP::IsKeyFrameRequestSupported()))
+            RequestKeyFrame();
+
+        // is the next packet available?
+        pBufferSize = tBufferSize;
+        if (mDecoderJitterBuffer.Pop(pBuffer, pBufferSize, pFragmentNumber, tWaitTime, Time::GetMonotonicTimeStamp()))
+            return;
+
+        // packets which were restored by FEC are inserted like received ones
+        pBufferSize = tBufferSize;
+        if (mDecoderFecDecoder.GetRecoveredPacket(pBuffer, pBufferSize))
+        {
+            SetRecoveredPacketCount(mDecoderFecDecoder.GetStatistic().Recovered);
+        }else
+        {
+            // wait for new input until the playout deadline of a missing packet has passed
+            if ((tWaitTime > 0) && (!mDecoderFragmentFifo->WaitForInput((int)((tWaitTime + 999) / 1000))))
+                continue;
+
+            pBufferSize = tBufferSize;
+            ReadFragment(pBuffer, pBufferSize, pFragmentNumber);
+
+            // signaling fragments and RTCP packets bypass the jitter buffer
+            if ((pBufferSize <= 0) || (mGrabbingStopped) || (!RTPJitterBuffer::IsRtpPacket(pBuffer, pBufferSize)))
+                return;
+
+            // FEC packets are consumed by the FEC decoder, media packets are remembered for the recovery of later losses
+            if (RTPFecDecoder::IsFecPacket(pBuffer, pBufferSize))
+            {
+                mDecoderFecDecoder.StoreFecPacket(pBuffer, pBufferSize);
+                continue;
+            }
+            mDecoderFecDecoder.StoreMediaPacket(pBuffer, pBufferSize);
+        }
+
+        enum RtpJitterBufferInsertResult tInsertResult = mDecoderJitterBuffer.Insert(pBuffer, pBufferSize, Time::GetMonotonicTimeStamp(), tExtendedSequenceNumber);
+
+        // a packet behind a gap? ask the sender for the missing packets, they may arrive before the playout deadline
+        if ((tInsertResult == RTP_JITTER_BUFFER_STORED) && (RTP::IsNackSupported()))
+            RequestRetransmissions();
+
+        if (tInsertResult == RTP_JITTER_BUFFER_PASS)
+        {
+            // a recovered packet has no number from the fragment FIFO
+            pFragmentNumber = tExtendedSequenceNumber;
+            return;
+        }
+    }
+}
+
+void MediaSourceMem::RequestRetransmissions()
+{
+    unsigned short int tSequenceNumbers[RTCP_NACK_MAX_PACKETS];
+    uint32_t tNack[RTCP_NACK_MAX_SIZE / 4]; // 32 bit aligned
+    int tNackSize = RTCP_NACK_MAX_SIZE;
+
+    int tCount = mDecoderJitterBuffer.GetMissingPackets(tSequenceNumbers, RTCP_NACK_MAX_PACKETS);
+    if (tCount < 1)
+        return;
+
+    if (!RtcpCreateNack(mDecoderFeedbackSourceIdentifier, mDecoderJitterBuffer.GetSourceIdentifier(), tSequenceNumbers, tCount, (char*)tNack, tNackSize))
+        return;
+
+    if (SendFeedback((char*)tNack, tNackSize))
+    {
+        mDecoderRequestedRetransmissions += tCount;
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Requested retransmission of %d packets starting at sequence number %u, %"PRId64" requests in total", tCount, (unsigned int)tSequenceNumbers[0], mDecoderRequestedRetransmissions);
+        #endif
+    }
+}
+
+void MediaSourceMem::SendReceiverReport()
+{
+    uint32_t tReport[RTCP_RECEIVER_REPORT_SIZE / 4]; // 32 bit aligned
+    int tReportSize = RTCP_RECEIVER_REPORT_SIZE;
+    int64_t tRecoveredPackets = mDecoderFecDecoder.GetStatistic().Recovered;
+    float tRelativeLoss = mRtcpRelativeLoss;
+
+    //HINT: recovered packets are counted as received ones by the RTP parser, but the FEC overhead depends on the loss before the recovery
+    if (mRtcpExpectedPackets > 0)
+        tRelativeLoss += 100 * (float)(tRecoveredPackets - mDecoderFecReportedRecoveredPackets) / mRtcpExpectedPackets;
+    mDecoderFecReportedRecoveredPackets = tRecoveredPackets;
+
+    if (!RtcpCreateReceiverReport(mDecoderFeedbackSourceIdentifier, mDecoderJitterBuffer.GetSourceIdentifier(), tRelativeLoss, (char*)tReport, tReportSize))
+        return;
+
+    if (SendFeedback((char*)tReport, tReportSize))
+    {
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Reported %.2f %% loss (%.2f %% after FEC recovery) for SSRC %u", tRelativeLoss, mRtcpRelativeLoss, mDecoderJitterBuffer.GetSourceIdentifier());
+        #endif
+    }
+}
+
+void MediaSourceMem::RequestKeyFrame()
+{
+    uint32_t tPli[RTCP_PLI_SIZE / 4]; // 32 bit aligned
+    int tPliSize = RTCP_PLI_SIZE;
+    unsigned int tSsrc = mDecoderJitterBuffer.GetSourceIdentifier();
+    int64_t tLostPackets = mDecoderJitterBuffer.GetLostPackets();
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+
+    //HINT: before the first packet is received, the SSRC of the jitter buffer is 0 like the initial one of the last request
+    if (tSsrc == mDecoderKeyFrameRequestSourceIdentifier)
+    {// known stream
+        if (tLostPackets <= mDecoderKeyFrameRequestLostPackets)
+            return;
+
+        // a key frame of an earlier request may be still on its way
+        if (tNow - mDecoderKeyFrameRequestTime < MEDIA_SOURCE_MEM_KEY_FRAME_REQUEST_INTERVAL)
+            return;
+    }
+
+    // the state is updated even if there is no back channel, otherwise we would try it again for every packet
+    mDecoderKeyFrameRequestSourceIdentifier = tSsrc;
+    mDecoderKeyFrameRequestLostPackets = tLostPackets;
+    mDecoderKeyFrameRequestTime = tNow;
+
+    if (!RtcpCreatePli(mDecoderFeedbackSourceIdentifier, tSsrc, (char*)tPli, tPliSize))
+        return;
+
+    if (SendFeedback((char*)tPli, tPliSize))
+    {
+        mDecoderRequestedKeyFrames++;
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Requested key frame for SSRC %u after %"PRId64" lost packets, %"PRId64" requests in total", tSsrc, tLostPackets, mDecoderRequestedKeyFrames);
+        #endif
+    }
+}
+
+bool MediaSourceMem::SendFeedback(char *pData, int pDataSize)
+{
+    // memory based sources don't have a back channel
+    return false;
+}
+
 std::string MediaSourceMem::GetBroadcasterName()
 {
     string tResult = "";
@@ -1015,6 +1260,13 @@ bool MediaSourceMem::CloseGrabDevice()
     // reset the FIFO to have a clean FIFO next time we open the media source again
     if (mDecoderFragmentFifo != NULL)
         mDecoderFragmentFifo->ClearFifo();
+    mDecoderJitterBuffer.Reset();
+    mDecoderFecDecoder.Reset();
+    mDecoderFecReportedRecoveredPackets = 0;
+    mDecoderRequestedRetransmissions = 0;
+    mDecoderKeyFrameRequestSourceIdentifier = 0;
+    mDecoderKeyFrameRequestLostPackets = 0;
+    mDecoderKeyFrameRequestTime = 0;
 
     ResetPacketStatistic();
 
@@ -1059,7 +1311,7 @@ int MediaSourceMem::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropChu
 
     bool tShouldGrabNext = false;
     int tGrabLoops = 0;
-    int64_t tGrabStartTime = Time::GetTimeStamp();
+    int64_t tGrabStartTime = Time::GetMonotonicTimeStamp();
 
     do{
         tShouldGrabNext = false;
@@ -1258,7 +1510,7 @@ int MediaSourceMem::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropChu
                 }
             }
         }
-        if ((tShouldGrabNext) && (Time::GetTimeStamp() >= tGrabStartTime + MEDIA_SOURCE_MEM_GRABBING_TIMEOUT * AV_TIME_BASE))
+        if ((tShouldGrabNext) && (Time::GetMonotonicTimeStamp() >= tGrabStartTime + MEDIA_SOURCE_MEM_GRABBING_TIMEOUT * AV_TIME_BASE))
         {
             LOG(LOG_VERBOSE, "Timeout of %.2f seconds occurred for %s grabbing, haven't found a suitable frame, using the current one anyhow", (float)MEDIA_SOURCE_MEM_GRABBING_TIMEOUT, GetMediaTypeStr().c_str());
             tShouldGrabNext = false;
@@ -1294,16 +1546,13 @@ void MediaSourceMem::StartDecoder()
     if (!IsRunning())
     {
         // start decoder main loop
-        StartThread();
-
-        int tLoops = 0;
-
-        // wait until thread is running
-        while ((!IsRunning() /* wait until thread is started */) || (!mDecoderThreadNeeded /* wait until thread has finished the init. process */))
+        if (StartThread())
         {
-            if (tLoops % 10 == 0)
-                LOG(LOG_VERBOSE, "Waiting for start of %s decoding thread, loop count: %d", GetMediaTypeStr().c_str(), ++tLoops);
-            Thread::Suspend(25 * 1000);
+            LOG(LOG_VERBOSE, "Waiting for start of %s decoding thread", GetMediaTypeStr().c_str());
+
+            // wait until thread has finished the init. process
+            if (!WaitForReady())
+                LOG(LOG_ERROR, "%s decoding thread terminated during its init. process", GetMediaTypeStr().c_str());
         }
     }
 }
@@ -1332,9 +1581,7 @@ void MediaSourceMem::StopDecoder()
 
             // force a wake up of decoder thread
             mDecoderNeedWorkCondition.Signal();
-
-            Suspend(25 * 1000);
-        }while(IsRunning());
+        }while(!WaitForTermination(25));
     }
     mDecoderFragmentFifoDestructionMutex.unlock();
 
@@ -1709,8 +1956,12 @@ void* MediaSourceMem::Run(void* pArgs)
             // allocate chunk buffer
             tChunkBuffer = (uint8_t*)av_malloc(tChunkBufferSize);
 
-            LOG(LOG_VERBOSE, "Creating %s media FIFO with %d entries of %d bytes", GetMediaTypeStr().c_str(), CalculateFrameBufferSize(), tChunkBufferSize);
-            mDecoderFifo = new MediaFifo(CalculateFrameBufferSize(), tChunkBufferSize, GetMediaTypeStr() + "-MediaSource" + GetSourceTypeStr());
+            // HINT: decoded audio frames are much smaller than AVCODEC_MAX_AUDIO_FRAME_SIZE, hence we use a byte arena which is able to store one worst case frame
+            LOG(LOG_VERBOSE, "Creating %s media FIFO with %d entries of up to %d bytes", GetMediaTypeStr().c_str(), CalculateFrameBufferSize(), tChunkBufferSize);
+            mDecoderFifo = new MediaFifo(CalculateFrameBufferSize(), tChunkBufferSize, GetMediaTypeStr() + "-MediaSource" + GetSourceTypeStr(), MEDIA_FIFO_LOCKED, CalculateFrameBufferSize() * MEDIA_SOURCE_SAMPLES_MULTI_BUFFER_SIZE + tChunkBufferSize);
+            // file playback has to be lossless, the decoder may wait for the grabber instead
+            if (GetSourceType() == SOURCE_FILE)
+                mDecoderFifo->SetOverflowPolicy(MEDIA_FIFO_BLOCK);
 
             break;
         default:
@@ -1732,6 +1983,7 @@ void* MediaSourceMem::Run(void* pArgs)
 
     // signal that decoder thread has finished init.
     mDecoderThreadNeeded = true;
+    AnnounceReady();
 
     CalculateExpectedOutputPerInputFrame();
 
@@ -2016,7 +2268,7 @@ void* MediaSourceMem::Run(void* pArgs)
                                             mDecoderWaitForNextKeyFrameTimeout = 0;
                                         }else
                                         {
-                                            if (av_gettime() > mDecoderWaitForNextKeyFrameTimeout)
+                                            if (Time::GetMonotonicTimeStamp() > mDecoderWaitForNextKeyFrameTimeout)
                                             {
                                                 LOG(LOG_WARN, "We haven't found a key frame in the input stream within a specified time, giving up, continuing anyways");
                                                 mDecoderWaitForNextKeyFrame = false;
@@ -2449,7 +2701,7 @@ void MediaSourceMem::ResetDecoderBuffers()
     LOG(LOG_VERBOSE, "Waiting for first %s key frame after reset of decoder buffers", GetMediaTypeStr().c_str());
     mDecoderWaitForNextKeyFramePackets = true;
     mDecoderWaitForNextKeyFrame = true;
-    mDecoderWaitForNextKeyFrameTimeout = av_gettime() + MSM_WAITING_FOR_FIRST_KEY_FRAME_TIMEOUT * 1000 * 1000;
+    mDecoderWaitForNextKeyFrameTimeout = Time::GetMonotonicTimeStamp() + MSM_WAITING_FOR_FIRST_KEY_FRAME_TIMEOUT * 1000 * 1000;
 
     mDecoderResetBuffersMutex.unlock();
 }
@@ -2613,7 +2865,7 @@ void MediaSourceMem::CalibrateRTGrabbing()
         LOG(LOG_ERROR, "Found invalid relative PTS value of: %.2lf for frame index: %.2f", tRelativeTime, tRelativeFrameIndex);
         tRelativeTime = 0;
     }
-    mSourceStartTimeForRTGrabbing = av_gettime() - tRelativeTime  + mSourceTimeShiftForRTGrabbing + mDecoderFramePreBufferTime * AV_TIME_BASE;
+    mSourceStartTimeForRTGrabbing = Time::GetMonotonicTimeStamp() - tRelativeTime  + mSourceTimeShiftForRTGrabbing + mDecoderFramePreBufferTime * AV_TIME_BASE;
     #ifdef MSMEM_DEBUG_CALIBRATION
         LOG(LOG_WARN, "Calibrating %s RT playback: new PTS start: %.2f, rel. frame index: %.2f, rel. time: %.2f ms", GetMediaTypeStr().c_str(), mSourceStartTimeForRTGrabbing, tRelativeFrameIndex, (float)(tRelativeTime / 1000));
     #endif
@@ -2678,7 +2930,7 @@ bool MediaSourceMem::WaitForRTGrabbing()
     int64_t tDesiredPlayOutTime = 1000 * ((int64_t)tCurrentPtsFromGrabber); // in us
 
     // calculate the current (normalized) play-out time of the current A/V stream
-    int64_t tCurrentPlayOutTime = av_gettime() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
+    int64_t tCurrentPlayOutTime = Time::GetMonotonicTimeStamp() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
 
     // check if we have already reached the pre-buffer threshold time
     if (tCurrentPlayOutTime < 0)
@@ -2701,7 +2953,7 @@ bool MediaSourceMem::WaitForRTGrabbing()
         }
 
         // update play-out time
-        tCurrentPlayOutTime = av_gettime() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
+        tCurrentPlayOutTime = Time::GetMonotonicTimeStamp() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
     }
 
     // calculate the time offset between the desired and current play-out time, which can be used for a wait cycle (Thread::Suspend)
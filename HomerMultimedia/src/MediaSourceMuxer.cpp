@@ -95,6 +95,8 @@ MediaSourceMuxer::MediaSourceMuxer(MediaSource *pMediaSource):
     mRelayingSkipAudioSilenceSkippedChunks = 0;
     mEncoderThreadNeeded = true;
     mEncoderFifo = NULL;
+    mEncoderForcedKeyFrameTime = 0;
+    mEncoderForcedKeyFrames = 0;
 }
 
 MediaSourceMuxer::~MediaSourceMuxer()
@@ -1323,12 +1325,10 @@ void MediaSourceMuxer::StartEncoder()
     LOG(LOG_VERBOSE, "Starting %s transcoder", GetMediaTypeStr().c_str());
 
     // start transcoder main loop
-    StartThread();
-
-    while(!IsRunning())
+    if (StartThread())
     {
         LOG(LOG_VERBOSE, "Waiting for the start of %s transcoding thread", GetMediaTypeStr().c_str());
-        Thread::Suspend(25 * 1000);
+        WaitForStart();
     }
 
     LOG(LOG_VERBOSE, "..%s transcoder started", GetMediaTypeStr().c_str());
@@ -1344,6 +1344,7 @@ void MediaSourceMuxer::StopEncoder()
     {
         // tell transcoder thread it isn't needed anymore
         mEncoderThreadNeeded = false;
+        WakeUp();
 
         // wait for termination of transcoder thread
         if(tSignalingRound > 0)
@@ -1356,7 +1357,8 @@ void MediaSourceMuxer::StopEncoder()
             mEncoderFifo->WriteFifo(NULL, 0, 0);
         mEncoderFifoState.unlock();
 
-        Thread::Suspend(25 * 1000);
+        if (WaitForTermination(25))
+            break;
     }
 
     LOG(LOG_VERBOSE, "%s encoder stopped", GetMediaTypeStr().c_str());
@@ -1393,6 +1395,36 @@ void MediaSourceMuxer::ResetEncoderBuffers()
     mEncoderSeekMutex.unlock();
 }
 
+//HINT: requests of several receivers arriving within the same frame period or within the minimum interval are served by one key frame
+bool MediaSourceMuxer::HasKeyFrameRequest()
+{
+    MediaSinks::iterator tIt;
+    bool tResult = false;
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+
+    // the requests stay pending until the minimum interval has passed
+    if ((mEncoderForcedKeyFrameTime != 0) && (tNow - mEncoderForcedKeyFrameTime < MEDIA_SOURCE_MUX_KEY_FRAME_REQUEST_INTERVAL))
+        return false;
+
+    // lock
+    mMediaSinksMutex.lock();
+
+    for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
+    {
+        // reset the requests of all sinks, one key frame serves all of them
+        if ((*tIt)->HasKeyFrameRequest())
+            tResult = true;
+    }
+
+    // unlock
+    mMediaSinksMutex.unlock();
+
+    if (tResult)
+        mEncoderForcedKeyFrameTime = tNow;
+
+    return tResult;
+}
+
 void* MediaSourceMuxer::Run(void* pArgs)
 {
     char                *tBuffer;
@@ -1415,6 +1447,9 @@ void* MediaSourceMuxer::Run(void* pArgs)
 
     LOG(LOG_WARN, ">>>>>>>>>>>>>>>> %s-Encoding thread for %s media source started", GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str());
 
+    // the encoder has to keep pace with the grabber, otherwise its input FIFO overflows
+    SetSchedulingClass(THREAD_SCHEDULING_HIGH);
+
     switch(mMediaType)
     {
         case MEDIA_VIDEO:
@@ -1458,7 +1493,7 @@ void* MediaSourceMuxer::Run(void* pArgs)
 
             mEncoderFifoAvailableMutex.lock();
 
-            mEncoderFifo = new MediaFifo(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_SAMPLES_MULTI_BUFFER_SIZE * 2, "AUDIO-Encoder");
+            mEncoderFifo = new MediaFifo(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_SAMPLES_MULTI_BUFFER_SIZE * 2, "AUDIO-Encoder", MEDIA_FIFO_SPSC);
             if (mEncoderFifo == NULL)
                 LOG(LOG_ERROR, "Out of memory for encoder FIFO");
 
@@ -1491,6 +1526,8 @@ void* MediaSourceMuxer::Run(void* pArgs)
 
     mFrameNumber = 0;
     mEncoderStartTime = 0;
+    mEncoderForcedKeyFrameTime = 0;
+    mEncoderForcedKeyFrames = 0;
 
     // trigger an avcodec_flush_buffers()
     TimeShift(0);
@@ -1581,6 +1618,15 @@ void* MediaSourceMuxer::Run(void* pArgs)
                                 tYUVFrame->height = mCurrentStreamingResY;
                                 tYUVFrame->format = mCodecContext->pix_fmt;
                                 tYUVFrame->pict_type = AV_PICTURE_TYPE_NONE;
+                                // a receiver has lost the stream state or has joined the stream? -> encode an I-frame instead of waiting for the end of the GOP
+                                if (HasKeyFrameRequest())
+                                {
+                                    tYUVFrame->pict_type = AV_PICTURE_TYPE_I;
+                                    mEncoderForcedKeyFrames++;
+                                    #ifdef MSM_DEBUG_PACKETS
+                                        LOG(LOG_VERBOSE, "Forcing key frame for frame %d, %"PRId64" forced key frames in total", mFrameNumber, mEncoderForcedKeyFrames);
+                                    #endif
+                                }
                                 tYUVFrame->coded_picture_number = mFrameNumber;
                                 tYUVFrame->coded_picture_number = mFrameNumber;
 
@@ -1844,8 +1890,8 @@ void* MediaSourceMuxer::Run(void* pArgs)
             }
         }else
         {
-            LOG(LOG_VERBOSE, "Suspending the transcoder thread for 10 ms");
-            Suspend(10 * 1000); // check every 1/100 seconds the state of the FIFO
+            LOG(LOG_VERBOSE, "Suspending the transcoder thread until it gets awaked");
+            SuspendUntilWakeUp();
         }
     }
 
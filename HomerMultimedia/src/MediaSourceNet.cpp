@@ -28,6 +28,7 @@
 
 #include <MediaSourceNet.h>
 #include <MediaSource.h>
+#include <HBSocketReactor.h>
 #include <ProcessStatisticService.h>
 #include <RequirementTransmitBitErrors.h>
 #include <RTP.h>
@@ -46,12 +47,18 @@ using namespace Homer::Base;
 // maximum number of acceptable continuous receive errors
 #define MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS                           3
 
+// maximum number of datagrams which are received by one system call
+#define MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE                           16
+
+// buffer size per received datagram if receive offload is used: the network stack coalesces datagrams up to 64 KB
+#define MEDIA_SOURCE_NET_RECEIVE_OFFLOAD_BUFFER_SIZE                  64 * 1024
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 class NetworkListener :
-    public Thread
+    public Thread, public SocketReactorHandler
 {
 public:
     NetworkListener(MediaSourceNet *pMediaSourceNet, Socket *pDataSocket, bool pRtpActivated = true);
@@ -68,15 +75,22 @@ public:
     enum NetworkType GetNetworkType();
     std::string GetListenerName();
     std::string GetCurrentDevicePeerName();
+    bool SendFeedback(char *pData, int pDataSize);
 
 private:
     friend class MediaSourceNet;
 
     void Init(Socket *pDataSocket, unsigned int pLocalPort, bool pRtpActivated = true);
+    void PrepareListener();
+    void FinishListener();
+    void PrepareReceiveBatch();
     bool ReceivePacket(std::string &pSourceHost, unsigned int &pSourcePort, char* pData, int &pSize);
+    void ProcessPacket(std::string &pSourceHost, unsigned int pSourcePort, char *pData, int pDataSize, int pFragmentEntry);
 
     /* network listener */
     virtual void* Run(void* pArgs = NULL);
+    /* network listener as part of the socket reactor: used instead of the listener thread if the reactor is activated */
+    virtual bool HandleSocketInput(Socket *pSocket);
 
     MediaSourceNet      *mMediaSourceNet;
     bool                mRtpActivated;
@@ -84,6 +98,9 @@ private:
     /* general transport */
     int                 mReceiveErrors;
     int                 mPacketNumber;
+    int64_t             mReceivedPackets;
+    char                *mPacketBuffer;
+    bool                mReactorUsed;
     bool                mListenerNeeded;
     bool                mListenerStopped;
     bool                mListenerSocketCreatedOutside;
@@ -91,8 +108,20 @@ private:
     /* Berkeley sockets based transport */
     std::string         mPeerHost;
     unsigned int        mPeerPort;
+    Mutex               mPeerMutex;
     Socket              *mDataSocket;
     unsigned int        mListenerPort;
+    /* batched reception of datagrams */
+    SocketDatagram      mReceiveBatch[MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE];
+    char                *mReceiveBatchBuffer;
+    int                 mReceiveBatchBufferSize; // per datagram
+    int                 mReceiveBatchCount;
+    int                 mReceiveBatchPosition;
+    int                 mReceiveBatchSegmentOffset; // position within a coalesced datagram
+    SocketAddressDescriptor mReceiveBatchLastSource;
+    unsigned int        mReceiveBatchLastSourceSize;
+    std::string         mReceiveBatchLastSourceHost;
+    unsigned int        mReceiveBatchLastSourcePort;
     /* NAPI based transport */
     IConnection         *mNAPIDataSocket;
     ICEPBinding         *mNAPIBinding;
@@ -108,9 +137,19 @@ void NetworkListener::Init(Socket *pDataSocket, unsigned int pLocalPort, bool pR
     mPeerHost = "";
     mPeerPort = 0;
     mReceiveErrors = 0;
+    mReceivedPackets = 0;
+    mPacketBuffer = NULL;
+    mReactorUsed = false;
     mListenerNeeded = false;
     mListenerPort = pLocalPort;
     mRtpActivated = pRtpActivated;
+    mReceiveBatchBuffer = NULL;
+    mReceiveBatchBufferSize = 0;
+    mReceiveBatchCount = 0;
+    mReceiveBatchPosition = 0;
+    mReceiveBatchSegmentOffset = 0;
+    mReceiveBatchLastSourceSize = 0;
+    mReceiveBatchLastSourcePort = 0;
 
     mDataSocket = pDataSocket;
 
@@ -252,19 +291,32 @@ void NetworkListener::StartListener()
         mMediaSourceNet->mDecoderFragmentFifo->ClearFifo();
     }
 
-    if (!IsRunning())
+    // datagram sockets are served by the I/O threads of the socket reactor
+    if ((SocketReactor::ReactorActivated()) && (!mReactorUsed) && (!IsRunning()) && (!mNAPIUsed) && (mDataSocket != NULL) && ((mDataSocket->GetTransportType() == SOCKET_UDP) || (mDataSocket->GetTransportType() == SOCKET_UDP_LITE)))
     {
-        // start decoder main loop
-        StartThread();
-
-        int tLoops = 0;
+        PrepareListener();
+        mListenerNeeded = true;
+        if (SVC_SOCKET_REACTOR.Register(mDataSocket, this))
+        {
+            LOG(LOG_VERBOSE, "%s network listener for local port %u is served by the socket reactor", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
+            mReactorUsed = true;
+            return;
+        }
+        LOG(LOG_WARN, "Socket reactor isn't available, falling back to a listener thread");
+        mListenerNeeded = false;
+        FinishListener();
+    }
 
-        // wait until thread is running
-        while ((!IsRunning() /* wait until thread is started */) || (!mListenerNeeded /* wait until thread has finished the init. process */))
+    if ((!IsRunning()) && (!mReactorUsed))
+    {
+        // start decoder main loop
+        if (StartThread())
         {
-            if (tLoops % 10 == 0)
-                LOG(LOG_VERBOSE, "Waiting for start of %s network listener thread, loop count: %d", mMediaSourceNet->GetMediaTypeStr().c_str(), ++tLoops);
-            Thread::Suspend(25 * 1000);
+            LOG(LOG_VERBOSE, "Waiting for start of %s network listener thread", mMediaSourceNet->GetMediaTypeStr().c_str());
+
+            // wait until thread has finished the init. process
+            if (!WaitForReady())
+                LOG(LOG_ERROR, "%s network listener thread terminated during its init. process", mMediaSourceNet->GetMediaTypeStr().c_str());
         }
     }
 }
@@ -278,7 +330,13 @@ void NetworkListener::StopListener()
     // tell network listener thread: it isn't needed anymore
     mListenerNeeded = false;
 
-    if(IsRunning())
+    if (mReactorUsed)
+    {
+        // waits for the end of a running dispatch
+        SVC_SOCKET_REACTOR.Unregister(mDataSocket);
+        FinishListener();
+        mReactorUsed = false;
+    }else if(IsRunning())
     {
         if (mNAPIUsed)
         {
@@ -294,13 +352,11 @@ void NetworkListener::StopListener()
         }
 
         // wait for termination of decoder thread
-        while(IsRunning())
+        while(!WaitForTermination(25))
         {
             if(tSignalingRound > 0)
                 LOG(LOG_WARN, "Signaling attempt %d to stop %s network listener", tSignalingRound, mMediaSourceNet->GetMediaTypeStr().c_str());
             tSignalingRound++;
-
-            Suspend(25 * 1000);
         }
     }else{
         LOG(LOG_VERBOSE, "  ..%s network listener isn't running", mMediaSourceNet->GetMediaTypeStr().c_str());
@@ -362,7 +418,52 @@ bool NetworkListener::ReceivePacket(std::string &pSourceHost, unsigned int &pSou
             LOG(LOG_ERROR, "Invalid NAPI association");
     }else
     {
-        if (mDataSocket != NULL)
+        if ((mDataSocket != NULL) && (mReceiveBatchBuffer != NULL))
+        {
+            // fetch all queued datagrams with one system call and deliver them one by one afterwards
+            if (mReceiveBatchPosition >= mReceiveBatchCount)
+            {
+                PrepareReceiveBatch();
+                mReceiveBatchCount = mDataSocket->ReceiveBatch(mReceiveBatch, MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE);
+                if (mReceiveBatchCount < 1)
+                {
+                    mReceiveBatchCount = 0;
+                    pSourceHost = "";
+                    pSourcePort = 0;
+                    pSize = -1;
+                    return false;
+                }
+            }
+
+            SocketDatagram *tDatagram = &mReceiveBatch[mReceiveBatchPosition];
+
+            // split datagrams which were coalesced by the network stack into the original packets
+            char *tSegment = (char*)tDatagram->Data + mReceiveBatchSegmentOffset;
+            int tSegmentSize = (int)tDatagram->Size - mReceiveBatchSegmentOffset;
+            if ((tDatagram->SegmentSize > 0) && (tSegmentSize > (int)tDatagram->SegmentSize))
+                tSegmentSize = (int)tDatagram->SegmentSize;
+            mReceiveBatchSegmentOffset += tSegmentSize;
+            if (mReceiveBatchSegmentOffset >= (int)tDatagram->Size)
+            {
+                mReceiveBatchPosition++;
+                mReceiveBatchSegmentOffset = 0;
+            }
+
+            // the source rarely changes, hence its string representation is only created for a new source
+            if ((tDatagram->SourceSize != mReceiveBatchLastSourceSize) || (memcmp(&tDatagram->Source, &mReceiveBatchLastSource, tDatagram->SourceSize) != 0))
+            {
+                mReceiveBatchLastSourceHost = Socket::GetAddrFromDescriptor(&tDatagram->Source, &mReceiveBatchLastSourcePort);
+                memcpy(&mReceiveBatchLastSource, &tDatagram->Source, tDatagram->SourceSize);
+                mReceiveBatchLastSourceSize = tDatagram->SourceSize;
+            }
+            pSourceHost = mReceiveBatchLastSourceHost;
+            pSourcePort = mReceiveBatchLastSourcePort;
+
+            if (pSize > tSegmentSize)
+                pSize = tSegmentSize;
+            memcpy(pData, tSegment, pSize);
+            tResult = true;
+        }else if (mDataSocket != NULL)
         {
             ssize_t tBufferSize = (ssize_t)pSize;
             tResult =  mDataSocket->Receive(pSourceHost, pSourcePort, (void*)pData, tBufferSize);
@@ -410,18 +511,243 @@ string NetworkListener::GetCurrentDevicePeerName()
     }
 }
 
+bool NetworkListener::SendFeedback(char *pData, int pDataSize)
+{
+    string tPeerHost;
+    unsigned int tPeerPort;
+
+    // TCP based transport is reliable, NAPI doesn't provide a back channel
+    if ((mNAPIUsed) || (mStreamedTransport) || (mDataSocket == NULL))
+        return false;
+
+    mPeerMutex.lock();
+    tPeerHost = mPeerHost;
+    tPeerPort = mPeerPort;
+    mPeerMutex.unlock();
+
+    if ((tPeerHost == "") || (tPeerPort == 0))
+        return false;
+
+    return mDataSocket->Send(tPeerHost, tPeerPort, pData, (ssize_t)pDataSize);
+}
+
+void NetworkListener::PrepareListener()
+{
+    mListenerStopped = false;
+    mReceivedPackets = 0;
+
+    mPacketBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+
+    // datagram sockets receive in batches
+    if ((!mNAPIUsed) && (mDataSocket != NULL) && ((mDataSocket->GetTransportType() == SOCKET_UDP) || (mDataSocket->GetTransportType() == SOCKET_UDP_LITE)))
+    {
+        mReceiveBatchBufferSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
+        // coalesced datagrams need larger buffers
+        if ((Socket::IsSegmentationOffloadActivated()) && (mDataSocket->EnableReceiveOffload()))
+            mReceiveBatchBufferSize = MEDIA_SOURCE_NET_RECEIVE_OFFLOAD_BUFFER_SIZE;
+        mReceiveBatchBuffer = (char*)malloc(MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE * mReceiveBatchBufferSize);
+        mReceiveBatchCount = 0;
+        mReceiveBatchPosition = 0;
+        mReceiveBatchSegmentOffset = 0;
+    }
+
+    if (mNAPIUsed)
+    {
+        // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
+        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + mNAPIDataSocket->getName()->toString() + "(" + (mStreamedTransport ? "TCP" : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? "UDP-Lite" : "UDP")) + (mRtpActivated ? "/RTP" : "") + ")";
+
+        enum TransportType tTransportType = (mStreamedTransport ? SOCKET_TCP : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? SOCKET_UDP_LITE : SOCKET_UDP));
+        // update category for packet statistics
+        enum NetworkType tNetworkType = (IS_IPV6_ADDRESS(mNAPIDataSocket->getName()->toString())) ? SOCKET_IPv6 : SOCKET_IPv4;
+        mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
+    }else
+    {
+        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
+        // update category for packet statistics
+        mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
+    }
+    mMediaSourceNet->AssignStreamName(mMediaSourceNet->mCurrentDeviceName);
+}
+
+void NetworkListener::FinishListener()
+{
+    free(mPacketBuffer);
+    mPacketBuffer = NULL;
+    free(mReceiveBatchBuffer);
+    mReceiveBatchBuffer = NULL;
+    mListenerStopped = true;
+}
+
+void NetworkListener::PrepareReceiveBatch()
+{
+    for (int i = 0; i < MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE; i++)
+    {
+        mReceiveBatch[i].Data = mReceiveBatchBuffer + i * mReceiveBatchBufferSize;
+        mReceiveBatch[i].Size = mReceiveBatchBufferSize;
+    }
+    mReceiveBatchPosition = 0;
+    mReceiveBatchSegmentOffset = 0;
+}
+
+void NetworkListener::ProcessPacket(string &pSourceHost, unsigned int pSourcePort, char *pData, int pDataSize, int pFragmentEntry)
+{
+    if ((pDataSize > 0) && (pSourceHost != "") && (pSourcePort != 0))
+    {
+        // some news about the peer?
+        if ((mPeerHost != pSourceHost) || (mPeerPort != pSourcePort))
+        {
+            if (mNAPIUsed)
+            {
+                // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
+                mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + mNAPIDataSocket->getName()->toString() + "(" + (mStreamedTransport ? "TCP" : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? "UDP-Lite" : "UDP")) + (mRtpActivated ? "/RTP" : "") + ")";
+
+                enum TransportType tTransportType = (mStreamedTransport ? SOCKET_TCP : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? SOCKET_UDP_LITE : SOCKET_UDP));
+                // update category for packet statistics
+                enum NetworkType tNetworkType = (IS_IPV6_ADDRESS(mNAPIDataSocket->getName()->toString())) ? SOCKET_IPv6 : SOCKET_IPv4;
+                mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
+            }else
+            {
+                mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
+
+                // update category for packet statistics
+                mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
+            }
+            LOG(LOG_VERBOSE, "Setting device name to %s", mMediaSourceNet->mCurrentDeviceName.c_str());
+            mPeerMutex.lock();
+            mPeerHost = pSourceHost;
+            mPeerPort = pSourcePort;
+            mPeerMutex.unlock();
+        }
+
+        // receiver reports, NACKs and key frame requests for our own media sinks arrive at the shared socket, they are answered immediately
+        //HINT: the fragment is delivered to the decoder nevertheless because a reserved FIFO entry can't be withdrawn, the RTP parser ignores it
+        if ((mRtpActivated) && (!mStreamedTransport) && (RTP::IsRtcpFeedback(pData, pDataSize)))
+            MediaSinkNet::HandleFeedback(pData, pDataSize);
+
+        #ifdef MSN_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Received packet number %5d at %p with size: %5d from %s:%u", (int)++mPacketNumber, pData, (int)pDataSize, pSourceHost.c_str(), pSourcePort);
+        #endif
+
+        // for TCP-like transport we have to use a special fragment header!
+        if (mStreamedTransport)
+        {// TCP - like transport
+            TCPFragmentHeader *tHeader;
+            char *tData = pData;
+            char *tDataEnd = pData + pDataSize;
+
+            while(pDataSize > 0)
+            {
+                if (tData > tDataEnd)
+                {
+                    LOG(LOG_ERROR, "Have found an invalid data position at %p while the data ends at %p", tData, tDataEnd);
+                    break;
+                }
+                #ifdef MSN_DEBUG_PACKETS
+                    LOG(LOG_VERBOSE, "Extracting a fragment from TCP stream");
+                #endif
+
+                tHeader = (TCPFragmentHeader*)tData;
+
+                if (tData + tHeader->FragmentSize > tDataEnd)
+                {
+                    LOG(LOG_ERROR, "Have found an invalid fragment size of %u bytes which is beyond the reported packet reception size", tHeader->FragmentSize);
+                    break;
+                }
+                //TODO: detect packet boundaries: maybe we get the last part of a former packet and the first part of the next packet -> this results in an error message at the moment, however, we could compensate this by a fragment buffer
+                //       -> picture errors occur if the video quality is high enough and causes a high data rate
+                tData += TCP_FRAGMENT_HEADER_SIZE;
+                pDataSize -= TCP_FRAGMENT_HEADER_SIZE;
+                mMediaSourceNet->WriteFragment(tData, (int)tHeader->FragmentSize, mReceivedPackets);
+                tData += tHeader->FragmentSize;
+                pDataSize -= tHeader->FragmentSize;
+            }
+        }else
+        {// UDP transport
+            if (pFragmentEntry >= 0)
+                mMediaSourceNet->WriteFragmentExclusiveFinished(pFragmentEntry, (int)pDataSize, mReceivedPackets);
+            else
+                mMediaSourceNet->WriteFragment(pData, (int)pDataSize, mReceivedPackets);
+        }
+    }else
+    {
+        if (pDataSize == 0)
+        {
+            LOG(LOG_VERBOSE, "Zero byte %s packet received", mMediaSourceNet->GetMediaTypeStr().c_str());
+
+            // add also a zero byte packet to enable early thread termination
+            if (pFragmentEntry >= 0)
+                mMediaSourceNet->WriteFragmentExclusiveFinished(pFragmentEntry, 0, 0);
+            else
+                mMediaSourceNet->WriteFragment(pData, 0, 0);
+        }else
+        {
+            LOG(LOG_VERBOSE, "Got faulty %s packet with size: %d from %s:%u", mMediaSourceNet->GetMediaTypeStr().c_str(), pDataSize, pSourceHost.c_str(), pSourcePort);
+
+            // a reserved fragment can't be withdrawn, it is delivered as empty fragment
+            mMediaSourceNet->WriteFragmentExclusiveFinished(pFragmentEntry, 0, 0);
+        }
+    }
+}
+
+bool NetworkListener::HandleSocketInput(Socket *pSocket)
+{
+    string              tSourceHost = "";
+    unsigned int        tSourcePort = 0;
+    int                 tDataSize;
+
+    // deliver all waiting datagrams, the I/O thread of the reactor mustn't be blocked
+    while ((mListenerNeeded) && (!mMediaSourceNet->mGrabbingStopped))
+    {
+        if (mReceiveBatchPosition >= mReceiveBatchCount)
+        {
+            PrepareReceiveBatch();
+            mReceiveBatchCount = mDataSocket->ReceiveBatch(mReceiveBatch, MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE, false);
+            if (mReceiveBatchCount == 0)
+                return true;
+            if (mReceiveBatchCount < 0)
+            {
+                mReceiveBatchCount = 0;
+                if (mReceiveErrors == MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS)
+                {
+                    LOG(LOG_ERROR, "Maximum number of continuous receive errors(%d) is exceeded, will stop network listener", MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS);
+                    mListenerNeeded = false;
+                    break;
+                }
+                mReceiveErrors++;
+                return true;
+            }
+            mReceiveErrors = 0;
+        }
+
+        // receive directly into the fragment FIFO of the decoder
+        tDataSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
+        char *tReceiveBuffer = mPacketBuffer;
+        int tFragmentEntry = mMediaSourceNet->WriteFragmentExclusive(&tReceiveBuffer, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+        if (tFragmentEntry < 0)
+            tReceiveBuffer = mPacketBuffer;
+
+        // the datagram is taken from the batch, this doesn't wait
+        ReceivePacket(tSourceHost, tSourcePort, tReceiveBuffer, tDataSize);
+        mReceivedPackets++;
+
+        ProcessPacket(tSourceHost, tSourcePort, tReceiveBuffer, tDataSize, tFragmentEntry);
+    }
+
+    // the reactor drops the socket afterwards, like the listener thread terminates
+    LOG(LOG_VERBOSE, "%s Socket-Listener for port %u finished", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
+    FinishListener();
+    mReactorUsed = false;
+
+    return false;
+}
+
 void* NetworkListener::Run(void* pArgs)
 {
-    char                *tPacketBuffer = NULL;
     string              tSourceHost = "";
     unsigned int        tSourcePort = 0;
     int                 tDataSize;
-    int64_t             tReceivedPackets = 0;
 
     LOG(LOG_WARN, "%s Socket-Listener for port %u started", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
-    mListenerStopped = false;
-
-    tPacketBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
 
     if (mNAPIUsed)
     {
@@ -453,25 +779,11 @@ void* NetworkListener::Run(void* pArgs)
         }
     }
 
-    if (mNAPIUsed)
-    {
-        // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
-        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + mNAPIDataSocket->getName()->toString() + "(" + (mStreamedTransport ? "TCP" : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? "UDP-Lite" : "UDP")) + (mRtpActivated ? "/RTP" : "") + ")";
-
-        enum TransportType tTransportType = (mStreamedTransport ? SOCKET_TCP : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? SOCKET_UDP_LITE : SOCKET_UDP));
-        // update category for packet statistics
-        enum NetworkType tNetworkType = (IS_IPV6_ADDRESS(mNAPIDataSocket->getName()->toString())) ? SOCKET_IPv6 : SOCKET_IPv4;
-        mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
-    }else
-    {
-        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
-        // update category for packet statistics
-        mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
-    }
-    mMediaSourceNet->AssignStreamName(mMediaSourceNet->mCurrentDeviceName);
+    PrepareListener();
 
     // set marker to "active"
     mListenerNeeded = true;
+    AnnounceReady();
 
     while ((mListenerNeeded) && (!mMediaSourceNet->mGrabbingStopped))
     {
@@ -480,118 +792,50 @@ void* NetworkListener::Run(void* pArgs)
         // ###################################################################
         tDataSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
         tSourceHost = "";
-        if (!ReceivePacket(tSourceHost, tSourcePort, tPacketBuffer, tDataSize))
+
+        // UDP transport: receive directly into the fragment FIFO of the decoder, TCP-like transport needs a local buffer for splitting the stream
+        char *tReceiveBuffer = mPacketBuffer;
+        int tFragmentEntry = -1;
+        if (!mStreamedTransport)
+        {
+            tFragmentEntry = mMediaSourceNet->WriteFragmentExclusive(&tReceiveBuffer, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+            if (tFragmentEntry < 0)
+                tReceiveBuffer = mPacketBuffer;
+        }
+
+        if (!ReceivePacket(tSourceHost, tSourcePort, tReceiveBuffer, tDataSize))
         {// error occurred
             if (mReceiveErrors == MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS)
             {
                 LOG(LOG_ERROR, "Maximum number of continuous receive errors(%d) is exceeded, will stop network listener", MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS);
                 mListenerNeeded = false;
+                mMediaSourceNet->WriteFragmentExclusiveFinished(tFragmentEntry, 0, 0);
                 break;
             }else
                 mReceiveErrors++;
         }else
         {// everything is okay
             mReceiveErrors = 0;
-            tReceivedPackets++;
+            mReceivedPackets++;
         }
 
         // stop loop if listener isn't needed anymore
         if (!mListenerNeeded)
         {
             LOG(LOG_WARN, "Leaving %s network listener immediately", mMediaSourceNet->GetMediaTypeStr().c_str());
+            mMediaSourceNet->WriteFragmentExclusiveFinished(tFragmentEntry, 0, 0);
             break;
         }
 //      LOG(LOG_ERROR, "Data Size: %d", (int)tDataSize);
 //      LOG(LOG_ERROR, "Port: %u", tSourcePort);
 //      LOG(LOG_ERROR, "Host: %s", tSourceHost.c_str());
 
-        if ((tDataSize > 0) && (tSourceHost != "") && (tSourcePort != 0))
-        {
-            // some news about the peer?
-            if ((mPeerHost != tSourceHost) || (mPeerPort != tSourcePort))
-            {
-                if (mNAPIUsed)
-                {
-                    // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
-                    mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + mNAPIDataSocket->getName()->toString() + "(" + (mStreamedTransport ? "TCP" : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? "UDP-Lite" : "UDP")) + (mRtpActivated ? "/RTP" : "") + ")";
-
-                    enum TransportType tTransportType = (mStreamedTransport ? SOCKET_TCP : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? SOCKET_UDP_LITE : SOCKET_UDP));
-                    // update category for packet statistics
-                    enum NetworkType tNetworkType = (IS_IPV6_ADDRESS(mNAPIDataSocket->getName()->toString())) ? SOCKET_IPv6 : SOCKET_IPv4;
-                    mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
-                }else
-                {
-                    mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
-
-                    // update category for packet statistics
-                    mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
-                }
-                LOG(LOG_VERBOSE, "Setting device name to %s", mMediaSourceNet->mCurrentDeviceName.c_str());
-                mPeerHost = tSourceHost;
-                mPeerPort = tSourcePort;
-            }
-
-            #ifdef MSN_DEBUG_PACKETS
-                LOG(LOG_VERBOSE, "Received packet number %5d at %p with size: %5d from %s:%u", (int)++mPacketNumber, tPacketBuffer, (int)tDataSize, tSourceHost.c_str(), tSourcePort);
-            #endif
-
-            // for TCP-like transport we have to use a special fragment header!
-            if (mStreamedTransport)
-            {// TCP - like transport
-                TCPFragmentHeader *tHeader;
-                char *tData = tPacketBuffer;
-                char *tDataEnd = tPacketBuffer + tDataSize;
-
-                while(tDataSize > 0)
-                {
-                    if (tData > tDataEnd)
-                    {
-                        LOG(LOG_ERROR, "Have found an invalid data position at %p while the data ends at %p", tData, tDataEnd);
-                        break;
-                    }
-                    #ifdef MSN_DEBUG_PACKETS
-                        LOG(LOG_VERBOSE, "Extracting a fragment from TCP stream");
-                    #endif
-
-                    tHeader = (TCPFragmentHeader*)tData;
-
-                    if (tData + tHeader->FragmentSize > tDataEnd)
-                    {
-                        LOG(LOG_ERROR, "Have found an invalid fragment size of %u bytes which is beyond the reported packet reception size", tHeader->FragmentSize);
-                        break;
-                    }
-                    //TODO: detect packet boundaries: maybe we get the last part of a former packet and the first part of the next packet -> this results in an error message at the moment, however, we could compensate this by a fragment buffer
-                    //       -> picture errors occur if the video quality is high enough and causes a high data rate
-                    tData += TCP_FRAGMENT_HEADER_SIZE;
-                    tDataSize -= TCP_FRAGMENT_HEADER_SIZE;
-                    mMediaSourceNet->WriteFragment(tData, (int)tHeader->FragmentSize, tReceivedPackets);
-                    tData += tHeader->FragmentSize;
-                    tDataSize -= tHeader->FragmentSize;
-                }
-            }else
-            {// UDP transport
-                mMediaSourceNet->WriteFragment(tPacketBuffer, (int)tDataSize, tReceivedPackets);
-            }
-        }else
-        {
-            if (tDataSize == 0)
-            {
-                LOG(LOG_VERBOSE, "Zero byte %s packet received", mMediaSourceNet->GetMediaTypeStr().c_str());
-
-                // add also a zero byte packet to enable early thread termination
-                mMediaSourceNet->WriteFragment(tPacketBuffer, 0, 0);
-            }else
-            {
-                LOG(LOG_VERBOSE, "Got faulty %s packet with size: %d from %s:%u", mMediaSourceNet->GetMediaTypeStr().c_str(), tDataSize, tSourceHost.c_str(), tSourcePort);
-                tDataSize = -1;
-            }
-        }
+        ProcessPacket(tSourceHost, tSourcePort, tReceiveBuffer, tDataSize, tFragmentEntry);
     }
 
     LOG(LOG_VERBOSE, "%s Socket-Listener for port %u finished", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
 
-    free(tPacketBuffer);
-    mListenerStopped = true;
+    FinishListener();
 
     return NULL;
 }
@@ -669,6 +913,14 @@ string MediaSourceNet::GetCurrentDevicePeerName()
         return "";
 }
 
+bool MediaSourceNet::SendFeedback(char *pData, int pDataSize)
+{
+    if (mNetworkListener != NULL)
+        return mNetworkListener->SendFeedback(pData, pDataSize);
+    else
+        return false;
+}
+
 unsigned int MediaSourceNet::GetListenerPort()
 {
     if (mNetworkListener != NULL)
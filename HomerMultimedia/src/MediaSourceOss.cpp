@@ -31,6 +31,7 @@
 #include <MediaSourceOss.h>
 #include <MediaSource.h>
 #include <ProcessStatisticService.h>
+#include <HBThread.h>
 #include <Logger.h>
 
 #include <cstdio>
@@ -136,6 +137,7 @@ bool MediaSourceOss::OpenAudioGrabDevice(int pSampleRate, int pChannels)
     }
 
     SVC_PROCESS_STATISTIC.AssignThreadName("Audio-Grabber(OSS)");
+    Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
 
     if (mMediaSourceOpened)
         return false;
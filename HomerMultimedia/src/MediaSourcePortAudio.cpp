@@ -251,6 +251,7 @@ void MediaSourcePortAudio::AssignThreadName()
     if (mHaveToAssignThreadName)
     {
         SVC_PROCESS_STATISTIC.AssignThreadName("PortAudio-Capture");
+        Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
         mHaveToAssignThreadName = false;
     }
 }
@@ -277,6 +278,7 @@ bool MediaSourcePortAudio::OpenAudioGrabDevice(int pSampleRate, int pChannels)
     LOG(LOG_VERBOSE, "Trying to open the audio source");
 
     SVC_PROCESS_STATISTIC.AssignThreadName("Audio-Grabber(PortAudio)");
+    Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
 
     if (mMediaSourceOpened)
         return false;
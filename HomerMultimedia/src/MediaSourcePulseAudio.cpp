@@ -367,6 +367,7 @@ bool MediaSourcePulseAudio::OpenAudioGrabDevice(int pSampleRate, int pChannels)
     LOG(LOG_VERBOSE, "Trying to open the audio source");
 
     SVC_PROCESS_STATISTIC.AssignThreadName("Audio-Grabber(PulseAudio)");
+    Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
 
     if (mMediaSourceOpened)
         return false;
@@ -60,11 +60,13 @@
 #include <HBSocket.h>
 #include <MediaSourceNet.h>
 #include <Logger.h>
+#include <HBTime.h>
 
 namespace Homer { namespace Multimedia {
 
 using namespace std;
 using namespace Homer::Monitor;
+using namespace Homer::Base;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -78,7 +80,8 @@ using namespace Homer::Monitor;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#define IS_RTCP_TYPE(x)                 ((x >= 72) && (x <= 76))
+// RTCP packet types 200-206 without the marker bit
+#define IS_RTCP_TYPE(x)                 ((x >= 72) && (x <= 78))
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -100,6 +103,11 @@ using namespace Homer::Monitor;
  */
 unsigned int RTP::mH261PayloadSizeMax = 1280;
 
+static bool sNackSupported = true;
+static bool sKeyFrameRequestSupported = true;
+static bool sFecActivated = false;
+static bool sNativePacketizerSupported = true;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // ########################## AMR-NB (RFC 3267) ###########################################
@@ -456,7 +464,8 @@ union VP8ExtendedHeader{
 
 uint64_t RTP::GetNtpTime()
 {
-    return (av_gettime() / 1000) * 1000 + NTP_OFFSET_US;
+    // derived from the monotonic clock with us precision
+    return Time::GetNtpTimeStamp();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -464,13 +473,14 @@ uint64_t RTP::GetNtpTime()
 RTP::RTP()
 {
     LOG(LOG_VERBOSE, "Created");
-    mH261LocalSequenceNumber = 0;
+    mInternalSequenceNumber = 0;
     mStreamName = "";
     mIntermediateFragment = 0;
     mPacketStatistic = NULL;
     mRtpFormatContext = NULL;
     mRtpEncoderOpened = false;
     mH261UseInternalEncoder = false;
+    mNativePacketizer = NULL;
     mRtpPacketStream = NULL;
     mRtpPacketBuffer = NULL;
     mTargetHost = "";
@@ -527,6 +537,7 @@ void RTP::Init()
     mRemoteTimestampConsecutiveOverflows = 0;
     mRemoteTimestamp = 0;
     mRtcpRelativeLoss = 0;
+    mRtcpExpectedPackets = 0;
     mRtcpEndToEndDelay = 0;
     mLastTimestampFromRTPHeader = 0;
     mLastSequenceNumberFromRTPHeader = 0;
@@ -584,13 +595,60 @@ bool RTP::OpenRtpEncoderH261(string pTargetHost, unsigned int pTargetPort, AVStr
     LOG(LOG_INFO, "    ..rtp payload size: %d bytes", pInnerStream->codec->rtp_payload_size);
     mRtpEncoderOpened = true;
     mH261UseInternalEncoder = true;
-    mH261FirstPacket = true;
-    mH261SentPackets = 0;
-    mH261SentOctets = 0;
-    mH261SenderReports = 0;
-    mH261SentNtpTimeBase = GetNtpTime();
-    mH261SentOctetsLastSenderReport = 0;
-    mH261SentNtpTimeLastSenderReport = 0;
+    mInternalFirstPacket = true;
+    mInternalSentPackets = 0;
+    mInternalSentOctets = 0;
+    mInternalSenderReports = 0;
+    mInternalSentNtpTimeBase = GetNtpTime();
+    mInternalSentOctetsLastSenderReport = 0;
+    mInternalSentNtpTimeLastSenderReport = 0;
+    return true;
+}
+
+bool RTP::IsNativePacketizerSupported()
+{
+    return sNativePacketizerSupported;
+}
+
+void RTP::DisableNativePacketizerSupport()
+{
+    LOGEX(RTP, LOG_VERBOSE, "Disabling native RTP packetizer");
+    sNativePacketizerSupported = false;
+}
+
+bool RTP::OpenRtpEncoderNative(string pTargetHost, unsigned int pTargetPort, AVStream *pInnerStream)
+{
+    RTPPacketizer *tPacketizer = new RTPPacketizer();
+    if (!tPacketizer->Open(mStreamCodecID, (unsigned int)pInnerStream->codec->rtp_payload_size, pInnerStream->codec->extradata, pInnerStream->codec->extradata_size))
+    {
+        delete tPacketizer;
+        return false;
+    }
+
+    LOG(LOG_VERBOSE, "Using lib internal rtp packetizer for %s codec", HM_avcodec_get_name(mStreamCodecID));
+    LOG(LOG_INFO, "Opened...");
+    LOG(LOG_INFO, "    ..rtp target: %s:%u", pTargetHost.c_str(), pTargetPort);
+    LOG(LOG_INFO, "    ..rtp header size: %d", RTP_HEADER_SIZE);
+    LOG(LOG_INFO, "    ..rtp SRC: %u", mLocalSourceIdentifier);
+    LOG(LOG_INFO, "    ..rtp payload ID: %u", mPayloadId);
+    LOG(LOG_INFO, "  Wrapping following codec...");
+    LOG(LOG_INFO, "    ..codec name: %s", pInnerStream->codec->codec->name);
+    LOG(LOG_INFO, "    ..codec long name: %s", pInnerStream->codec->codec->long_name);
+    LOG(LOG_INFO, "    ..resolution: %d * %d pixels", pInnerStream->codec->width, pInnerStream->codec->height);
+    LOG(LOG_INFO, "    ..stream time_base: %d/%d", pInnerStream->time_base.num, pInnerStream->time_base.den);
+    LOG(LOG_INFO, "    ..i-frame distance: %d pictures", pInnerStream->codec->gop_size);
+    LOG(LOG_INFO, "    ..bit rate: %d bit/s", pInnerStream->codec->bit_rate);
+    LOG(LOG_INFO, "    ..extra data size: %d bytes", pInnerStream->codec->extradata_size);
+    LOG(LOG_INFO, "    ..rtp payload size: %d bytes", pInnerStream->codec->rtp_payload_size);
+    mNativePacketizer = tPacketizer;
+    mRtpEncoderOpened = true;
+    mInternalFirstPacket = true;
+    mInternalSentPackets = 0;
+    mInternalSentOctets = 0;
+    mInternalSenderReports = 0;
+    mInternalSentNtpTimeBase = GetNtpTime();
+    mInternalSentOctetsLastSenderReport = 0;
+    mInternalSentNtpTimeLastSenderReport = 0;
     return true;
 }
 
@@ -634,6 +692,14 @@ bool RTP::OpenRtpEncoder(string pTargetHost, unsigned int pTargetPort, AVStream
     // set SRC ID
     mLocalSourceIdentifier = av_get_random_seed();
 
+    // H.264/HEVC: use the native packetizer instead of the ffmpeg RTP muxer, it avoids copying the encoded frames
+    if ((sNativePacketizerSupported) && (RTPPacketizer::IsCodecSupported(mStreamCodecID)))
+    {
+        if (OpenRtpEncoderNative(pTargetHost, pTargetPort, pInnerStream))
+            return true;
+        LOG(LOG_WARN, "Native RTP packetizer isn't usable for codec %s, using the one of ffmpeg instead", HM_avcodec_get_name(mStreamCodecID));
+    }
+
     // allocate new format context
     mRtpFormatContext = AV_NEW_FORMAT_CONTEXT();
 
@@ -816,7 +882,7 @@ bool RTP::CloseRtpEncoder()
 
     if (mRtpEncoderOpened)
     {
-        if (!mH261UseInternalEncoder /* h261 */)
+        if ((!mH261UseInternalEncoder /* h261 */) && (mNativePacketizer == NULL /* h264, hevc */))
         {
             // write the trailer, if any
             av_write_trailer(mRtpFormatContext);
@@ -831,6 +897,12 @@ bool RTP::CloseRtpEncoder()
             av_free(mRtpFormatContext);
         }
 
+        if (mNativePacketizer != NULL)
+        {
+            delete mNativePacketizer;
+            mNativePacketizer = NULL;
+        }
+
         if (mRtpPacketStream != NULL)
         {
             delete mRtpPacketBuffer;
@@ -1062,6 +1134,12 @@ bool RTP::RtpCreate(AVPacket *pAVPacket, char *&pResultingOutputData, unsigned i
     if (pAVPacket->size <= 0)
         return false;
 
+    if (mNativePacketizer != NULL)
+    {
+        LOG(LOG_ERROR, "Native RTP packetizer is active, RtpCreateVectored() has to be used instead");
+        return false;
+    }
+
     //####################################################################
     // for H261 use the internal RTP implementation
     //####################################################################
@@ -1363,7 +1441,7 @@ bool RTP::RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPt
         #ifdef RTP_DEBUG_PACKET_ENCODER_PTS
             LOG(LOG_VERBOSE, "Sending packet with PTS: %"PRId64", outgoing RTP-PTS: %.2f", pPacketPts, (float)pPacketPts * CalculateClockRateFactor());
         #endif
-        RtcpCreateH261SenderReport(tCurrentRtpStreamData, tRtpStreamDataSize, pPacketPts);
+        RtcpCreateInternalSenderReport(tCurrentRtpStreamData, tRtpStreamDataSize, pPacketPts);
 
         // #############################################################
         // create RTP packet with H.261 payload inside
@@ -1407,7 +1485,7 @@ bool RTP::RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPt
         tRtpHeader->CsrcCount = 0; // no usage of CSRCs
         tRtpHeader->Marked = (tPacketIndex == tPacketCount - 1)? 1 : 0; // 1 = last fragment, 0 = intermediate fragment
         tRtpHeader->PayloadType = 31; // 31 = h261
-        tRtpHeader->SequenceNumber = ++mH261LocalSequenceNumber; // monotonous growing
+        tRtpHeader->SequenceNumber = ++mInternalSequenceNumber; // monotonous growing
         tRtpHeader->Timestamp = pPacketPts * CalculateClockRateFactor() /* 90 kHz clock rate */;
         tRtpHeader->Ssrc = mLocalSourceIdentifier; // use the initially computed unique ID
 
@@ -1452,8 +1530,8 @@ bool RTP::RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPt
         tCurrentRtpStreamData += tChunkSize;
 
         //increase packet counter
-        mH261SentPackets++;
-        mH261SentOctets+= RTP_H261_PAYLOAD_HEADER_SIZE + tChunkSize;
+        mInternalSentPackets++;
+        mInternalSentOctets+= RTP_H261_PAYLOAD_HEADER_SIZE + tChunkSize;
     }
     pData = mRtpPacketStream;
     pDataSize = tRtpStreamDataSize;
@@ -1461,6 +1539,81 @@ bool RTP::RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPt
     return true;
 }
 
+// HINT: in contrast to RtpCreate() the encoded frame isn't copied, the packets reference it
+bool RTP::RtpCreateVectored(AVPacket *pAVPacket, RtpPacketDescriptor *&pPackets, int &pPacketCount, char *&pSenderReport, unsigned int &pSenderReportSize)
+{
+    pPackets = NULL;
+    pPacketCount = 0;
+    pSenderReport = NULL;
+    pSenderReportSize = 0;
+
+    if ((!mRtpEncoderOpened) || (mNativePacketizer == NULL))
+        return false;
+
+    if ((pAVPacket->data == NULL) || (pAVPacket->size <= 0))
+        return false;
+
+    int64_t tPacketPts = pAVPacket->pts;
+
+    #ifdef RTP_DEBUG_PACKET_ENCODER
+        LOG(LOG_VERBOSE, "Encapsulate frame with format %s of size: %d", HM_avcodec_get_name(mStreamCodecID), pAVPacket->size);
+    #endif
+
+    // #############################################################
+    // create RTCP sender report
+    // #############################################################
+    char *tSenderReport = (char*)mNativeSenderReport;
+    unsigned int tSenderReportSize = 0;
+    RtcpCreateInternalSenderReport(tSenderReport, tSenderReportSize, tPacketPts);
+    if (tSenderReportSize > 4)
+    {// skip the size field
+        pSenderReport = (char*)mNativeSenderReport + 4;
+        pSenderReportSize = tSenderReportSize - 4;
+    }
+
+    // #############################################################
+    // split the frame into RTP packets
+    // #############################################################
+    pPacketCount = mNativePacketizer->Packetize((char*)pAVPacket->data, (unsigned int)pAVPacket->size, pPackets);
+    if (pPacketCount == 0)
+    {
+        LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "Frame of %d bytes doesn't contain any NAL unit", pAVPacket->size);
+        return false;
+    }
+
+    // #############################################################
+    // HEADER: create RTP headers
+    // #############################################################
+    for (int i = 0; i < pPacketCount; i++)
+    {
+        RtpHeader* tRtpHeader = (RtpHeader*)pPackets[i].Header;
+
+        tRtpHeader->Version = 2; // current RTP-rfc 3550 defines version 2
+        tRtpHeader->Padding = 0; // no padding octets
+        tRtpHeader->Extension = 0; // no extension header used
+        tRtpHeader->CsrcCount = 0; // no usage of CSRCs
+        tRtpHeader->Marked = (pPackets[i].LastPacket) ? 1 : 0; // 1 = last packet of the frame
+        tRtpHeader->PayloadType = mPayloadId;
+        tRtpHeader->SequenceNumber = ++mInternalSequenceNumber; // monotonous growing
+        tRtpHeader->Timestamp = tPacketPts * CalculateClockRateFactor() /* 90 kHz clock rate */;
+        tRtpHeader->Ssrc = mLocalSourceIdentifier; // use the initially computed unique ID
+
+        // convert from host to network byte order
+        for (int j = 0; j < 3; j++)
+            tRtpHeader->Data[j] = htonl(tRtpHeader->Data[j]);
+
+        #ifdef RTP_DEBUG_PACKET_ENCODER
+            LogRtpHeader(tRtpHeader);
+        #endif
+
+        //increase packet counter
+        mInternalSentPackets++;
+        mInternalSentOctets += pPackets[i].Size - RTP_HEADER_SIZE;
+    }
+
+    return true;
+}
+
 unsigned int RTP::GetLostPacketsFromRTP()
 {
     return mLostPackets;
@@ -1537,11 +1690,21 @@ unsigned int RTP::GetSourceIdentifierFromRTP()
     return mRemoteSourceIdentifier;
 }
 
+unsigned int RTP::GetLocalSourceIdentifierFromRTP()
+{
+    return mLocalSourceIdentifier;
+}
+
 bool RTP::HasSourceChangedFromRTP()
 {
     return mRtpRemoteSourceChanged;
 }
 
+bool RTP::IsNativePacketizerUsed()
+{
+    return (mNativePacketizer != NULL);
+}
+
 float RTP::CalculateClockRateFactor()
 {
     float tResult = 1;
@@ -1714,7 +1877,7 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
     // RTCP feedback packet within data stream: RFC4585
     // transmitted every 5 seconds
     // #############################################################
-    if ((tRtpHeader->PayloadType >= 72) && (tRtpHeader->PayloadType <= 76))
+    if (IS_RTCP_TYPE(tRtpHeader->PayloadType))
     {// RTCP intermediate packet for streaming feedback received
         if (!pLoggingOnly)
             mRTCPPacketCounter++;
@@ -1754,7 +1917,7 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                         break;
                 case RTCP_RECEIVER_REPORT:
                         {
-                            LOG(LOG_WARN, "Got a RECEIVER REPORT packet, this packet type isn't supported yet");
+                            // receiver reports are already processed by the network listener, they address our own media sinks
                             pDataSize = 0;
                         }
                         break;
@@ -1780,8 +1943,20 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                             pDataSize = 0;
                         }
                         break;
+                case RTCP_TRANSPORT_FEEDBACK:
+                        {
+                            // NACKs are already processed by the network listener, they address our own media sinks
+                            pDataSize = 0;
+                        }
+                        break;
+                case RTCP_PAYLOAD_FEEDBACK:
+                        {
+                            // key frame requests are already processed by the network listener, they address our own media sinks
+                            pDataSize = 0;
+                        }
+                        break;
                 default:
-                        LOG(LOG_ERROR, "Unsupported RTCP packet type: %d (nested packet nr. %d)", (int)tCurrentRtcpType, tFoundNestedPackets);
+                        LOG_RATE_LIMITED(LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Unsupported RTCP packet type: %d (nested packet nr. %d)", (int)tCurrentRtcpType, tFoundNestedPackets);
                         pDataSize = 0;
                         break;
             }
@@ -2515,6 +2690,11 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                                             // STAP-A    Single-time aggregation packet
                                             case 24:
                                                     pData += 1;
+                                                    if (!pLoggingOnly)
+                                                    {
+                                                        if (!RtpConvertAggregationPacket(pData, tRemainingDataSize - 1, 0, pData - tRtpPacketStart))
+                                                            return false;
+                                                    }
                                                     break;
                                             // STAP-B    Single-time aggregation packet
                                             case 25:
@@ -2566,7 +2746,8 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                                 // in case it is no FU or it is one AND it is the start fragment:
                                 //      create start sequence of [0, 0, 1]
                                 // HINT: inspired by "h264_handle_packet" from rtp_h264.c from ffmpeg package
-                                if (((tH264HeaderType != 28) && (tH264HeaderType != 29)) || (tH264HeaderFragmentStart))
+                                // HINT: the NAL units of a STAP-A got their start sequences during the conversion above
+                                if (((tH264HeaderType != 24) && (tH264HeaderType != 28) && (tH264HeaderType != 29)) || (tH264HeaderFragmentStart))
                                 {
                                     #ifdef RTP_DEBUG_PACKET_DECODER
                                     #endif
@@ -2666,7 +2847,14 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                                             tRemainingDataSize -= RTP_HEVC_DONL_FIELD_SIZE;
                                         }
 
-                                        // fall-through
+                                        // convert the aggregated NAL units, each further NAL unit is preceded by a DOND field if DON fields are used
+                                        if (!pLoggingOnly)
+                                        {
+                                            if (!RtpConvertAggregationPacket(pData, tRemainingDataSize, mHEVCIsUsingDonFields ? 1 : 0, pData - tRtpPacketStart))
+                                                return false;
+                                        }
+
+                                        break;
                                     // video parameter set (VPS)
                                     case 32:
                                     // sequence parameter set (SPS)
@@ -2911,6 +3099,72 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
     return true;
 }
 
+//HINT: each NAL unit loses its 2 byte size field (and DOND field) and gets a 3 byte start sequence instead, hence the NAL units are moved
+//      towards the packet start and the result ends where the aggregation packet ends; the output never overtakes the input
+bool RTP::RtpConvertAggregationPacket(char *&pData, int pDataSize, int pDondFieldSize, int pHeadroom)
+{
+    int tNalUnits = 0;
+    int tNalUnitsSize = 0;
+    int tPos = 0;
+
+    // validate the size fields
+    while (tPos < pDataSize)
+    {
+        if (tNalUnits > 0)
+            tPos += pDondFieldSize;
+        if (tPos + 2 > pDataSize)
+        {
+            LOGEX_RATE_LIMITED(RTP, LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Aggregation packet of %d bytes ends within the size field of NAL unit %d", pDataSize, tNalUnits + 1);
+            return false;
+        }
+        int tNalUnitSize = (((int)(unsigned char)pData[tPos]) << 8) | (int)(unsigned char)pData[tPos + 1];
+        tPos += 2;
+        if ((tNalUnitSize == 0) || (tPos + tNalUnitSize > pDataSize))
+        {
+            LOGEX_RATE_LIMITED(RTP, LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Invalid size of %d bytes for NAL unit %d in aggregation packet of %d bytes", tNalUnitSize, tNalUnits + 1, pDataSize);
+            return false;
+        }
+        tPos += tNalUnitSize;
+        tNalUnits++;
+        tNalUnitsSize += tNalUnitSize;
+    }
+
+    if (tNalUnits == 0)
+    {
+        LOGEX_RATE_LIMITED(RTP, LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Empty aggregation packet");
+        return false;
+    }
+
+    char *tOutput = pData + pDataSize - (3 * tNalUnits + tNalUnitsSize);
+    if (pData - tOutput > pHeadroom)
+    {
+        LOGEX_RATE_LIMITED(RTP, LOG_ERROR, LOG_PER_PACKET_RATE_LIMIT, "Aggregation packet with %d NAL units needs %d bytes in front of the payload, only %d available", tNalUnits, (int)(pData - tOutput), pHeadroom);
+        return false;
+    }
+
+    char *tInput = pData;
+    pData = tOutput;
+    for (int i = 0; i < tNalUnits; i++)
+    {
+        if (i > 0)
+            tInput += pDondFieldSize;
+        int tNalUnitSize = (((int)(unsigned char)tInput[0]) << 8) | (int)(unsigned char)tInput[1];
+        tInput += 2;
+
+        // create the start sequence "0x00 0x00 0x01"
+        tOutput[0] = 0;
+        tOutput[1] = 0;
+        tOutput[2] = 1;
+        tOutput += 3;
+
+        memmove(tOutput, tInput, tNalUnitSize);
+        tOutput += tNalUnitSize;
+        tInput += tNalUnitSize;
+    }
+
+    return true;
+}
+
 /*************************************************
  *  Video codec name to RTP id mapping:
  *  ===================================
@@ -3051,9 +3305,12 @@ string RTP::GetCodecFromPreferedPayloadID(int pId)
                 break;
 
         //others
-        case 72 ... 76:
+        case 72 ... 78:
                 tResult = "rtcp";
                 break;
+        case 127:
+                tResult = "fec";
+                break;
 
         //others
         case 96 ... 99:
@@ -3090,6 +3347,12 @@ string GetRtcpPayloadTypeStr(int pType)
         case 204:
                 tResult = "application defined";
                 break;
+        case RTCP_TRANSPORT_FEEDBACK:
+                tResult = "transport feedback";
+                break;
+        case RTCP_PAYLOAD_FEEDBACK:
+                tResult = "payload feedback";
+                break;
         default:
                 tResult = "type " + toString(pType);
                 break;
@@ -3132,7 +3395,7 @@ void RTP::LogRtcpHeader(RtcpHeader *pRtcpHeader, uint64_t pTimestampOffset)
         int64_t tRemoteTimestamLow = ((int64_t)pRtcpHeader->Feedback.TimestampLow * 1000 * 1000) >> 32;
         int64_t tRemoteUsTimestamp = tRemoteTimestamHigh + tRemoteTimestamLow;
         int64_t tRemoteTimestamp = tRemoteUsTimestamp - NTP_OFFSET_US;
-        int64_t tLocalTimestamp = av_gettime();
+        int64_t tLocalTimestamp = (int64_t)(Time::GetNtpTimeStamp() - NTP_OFFSET_US);
 
         LOGEX(RTP, LOG_VERBOSE, "Local     time: %"PRId64"", tLocalTimestamp);
         LOGEX(RTP, LOG_VERBOSE, "Remote    time: %"PRId64"", tRemoteTimestamp);
@@ -3222,7 +3485,7 @@ bool RTP::RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPac
         uint64_t tRemoteNtpTimestampLow = ((uint64_t)tRtcpHeader->Feedback.TimestampLow * 1000 * 1000) >> 32;
         uint64_t tRemoteNtpUsTimestamp = tRemoteNtpTimestampHigh + tRemoteNtpTimestampLow;
         uint64_t tRemoteNtpTimestamp = tRemoteNtpUsTimestamp - NTP_OFFSET_US;
-        uint64_t tLocalNtpTimestamp = av_gettime();
+        uint64_t tLocalNtpTimestamp = Time::GetNtpTimeStamp() - NTP_OFFSET_US;
 
         // #############################################################
         // START TIMESTAMP: update the remote start timestamp
@@ -3246,6 +3509,7 @@ bool RTP::RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPac
             uint64_t tRemotelyReportedSentPackets = pPackets - mRtcpLastRemotePackets + 1;
             double tRelativeLoss = 100 - 100 * (double)tLocallyReceivedPackets / tRemotelyReportedSentPackets;
             mRtcpRelativeLoss = (float)tRelativeLoss;
+            mRtcpExpectedPackets = tRemotelyReportedSentPackets;
 
             #ifdef RTCP_DEBUG_PACKETS_DECODER
                 LOG(LOG_VERBOSE, "Received NTP time: US %lu, high %u, low %u, DE %lu/%lu (diff: %lu)", tRemoteNtpUsTimestamp, tRtcpHeader->Feedback.TimestampHigh, tRtcpHeader->Feedback.TimestampLow, tRemoteNtpTimestamp, av_gettime(), tLocalNtpTimestamp- tRemoteNtpTimestamp);
@@ -3274,6 +3538,264 @@ bool RTP::RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPac
     return tResult;
 }
 
+bool RTP::IsNackSupported()
+{
+    return sNackSupported;
+}
+
+void RTP::DisableNackSupport()
+{
+    LOGEX(RTP, LOG_VERBOSE, "Disabling NACK based retransmissions");
+    sNackSupported = false;
+}
+
+bool RTP::IsRtcpTransportFeedback(char *pData, int pDataSize)
+{
+    if ((pData == NULL) || (pDataSize < 12))
+        return false;
+
+    return (((pData[0] & 0xC0) == 0x80) && ((unsigned char)pData[1] == RTCP_TRANSPORT_FEEDBACK));
+}
+
+//HINT: a generic NACK consists of the RTCP feedback header and a list of FCI entries, each of them describes a lost packet (PID)
+//      and a bit mask of lost packets among the following 16 ones (BLP)
+bool RTP::RtcpCreateNack(unsigned int pSenderSsrc, unsigned int pMediaSsrc, unsigned short int *pSequenceNumbers, int pCount, char *pBuffer, int &pBufferSize)
+{
+    uint32_t *tWords = (uint32_t*)pBuffer;
+    int tEntries = 0;
+
+    if ((pCount < 1) || (pBufferSize < 16))
+        return false;
+
+    for (int i = 0; i < pCount; i++)
+    {
+        // covered by the bit mask of the previous entry?
+        if (tEntries > 0)
+        {
+            unsigned short int tDistance = pSequenceNumbers[i] - (unsigned short int)(tWords[2 + tEntries] >> 16);
+            if ((tDistance >= 1) && (tDistance <= 16))
+            {
+                tWords[2 + tEntries] |= 1u << (tDistance - 1);
+                continue;
+            }
+        }
+        if (12 + 4 * (tEntries + 1) > pBufferSize)
+            break;
+        tEntries++;
+        tWords[2 + tEntries] = ((uint32_t)pSequenceNumbers[i]) << 16;
+    }
+
+    tWords[0] = ((uint32_t)(0x80 | RTCP_FEEDBACK_GENERIC_NACK) << 24) | ((uint32_t)RTCP_TRANSPORT_FEEDBACK << 16) | (uint32_t)(2 + tEntries);
+    tWords[1] = pSenderSsrc;
+    tWords[2] = pMediaSsrc;
+
+    // convert from host to network byte order
+    for (int i = 0; i < 3 + tEntries; i++)
+        tWords[i] = htonl(tWords[i]);
+
+    pBufferSize = 12 + 4 * tEntries;
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOGEX(RTP, LOG_VERBOSE, "Created NACK for %d packets of SSRC %u with %d entries", pCount, pMediaSsrc, tEntries);
+    #endif
+
+    return true;
+}
+
+bool RTP::RtcpParseNack(char *pData, int pDataSize, unsigned int &pMediaSsrc, unsigned short int *pSequenceNumbers, int &pCount)
+{
+    //HINT: assumes network byte order!
+
+    uint32_t *tWords = (uint32_t*)pData;
+    int tMaxCount = pCount;
+
+    pCount = 0;
+
+    if (!IsRtcpTransportFeedback(pData, pDataSize))
+        return false;
+
+    uint32_t tHeader = ntohl(tWords[0]);
+    if (((tHeader >> 24) & 0x1F) != RTCP_FEEDBACK_GENERIC_NACK)
+        return false;
+
+    int tSize = ((tHeader & 0xFFFF) + 1) * 4 /* 32 bit words */;
+    if (tSize > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "NACK of %d bytes exceeds the received %d bytes", tSize, pDataSize);
+        return false;
+    }
+
+    pMediaSsrc = ntohl(tWords[2]);
+
+    for (int i = 3; i < tSize / 4; i++)
+    {
+        uint32_t tEntry = ntohl(tWords[i]);
+        unsigned short int tSequenceNumber = (unsigned short int)(tEntry >> 16);
+
+        if (pCount < tMaxCount)
+            pSequenceNumbers[pCount++] = tSequenceNumber;
+        for (int j = 0; j < 16; j++)
+        {
+            if ((tEntry & (1u << j)) && (pCount < tMaxCount))
+                pSequenceNumbers[pCount++] = tSequenceNumber + j + 1;
+        }
+    }
+
+    return (pCount > 0);
+}
+
+bool RTP::IsKeyFrameRequestSupported()
+{
+    return sKeyFrameRequestSupported;
+}
+
+void RTP::DisableKeyFrameRequestSupport()
+{
+    LOGEX(RTP, LOG_VERBOSE, "Disabling RTCP based key frame requests");
+    sKeyFrameRequestSupported = false;
+}
+
+bool RTP::IsRtcpPayloadFeedback(char *pData, int pDataSize)
+{
+    if ((pData == NULL) || (pDataSize < 12))
+        return false;
+
+    return (((pData[0] & 0xC0) == 0x80) && ((unsigned char)pData[1] == RTCP_PAYLOAD_FEEDBACK));
+}
+
+//HINT: a PLI consists of the RTCP feedback header only, it doesn't have any FCI
+bool RTP::RtcpCreatePli(unsigned int pSenderSsrc, unsigned int pMediaSsrc, char *pBuffer, int &pBufferSize)
+{
+    uint32_t *tWords = (uint32_t*)pBuffer;
+
+    if (pBufferSize < RTCP_PLI_SIZE)
+        return false;
+
+    tWords[0] = htonl(((uint32_t)(0x80 | RTCP_FEEDBACK_PLI) << 24) | ((uint32_t)RTCP_PAYLOAD_FEEDBACK << 16) | (uint32_t)2);
+    tWords[1] = htonl(pSenderSsrc);
+    tWords[2] = htonl(pMediaSsrc);
+
+    pBufferSize = RTCP_PLI_SIZE;
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOGEX(RTP, LOG_VERBOSE, "Created PLI for SSRC %u", pMediaSsrc);
+    #endif
+
+    return true;
+}
+
+//HINT: a FIR addresses the media sources by its FCI entries (SSRC, 8 bit command sequence number, 24 bit reserved),
+//      the media source SSRC of the header is unused
+bool RTP::RtcpParseKeyFrameRequest(char *pData, int pDataSize, unsigned int &pMediaSsrc)
+{
+    //HINT: assumes network byte order!
+
+    uint32_t *tWords = (uint32_t*)pData;
+
+    if (!IsRtcpPayloadFeedback(pData, pDataSize))
+        return false;
+
+    uint32_t tHeader = ntohl(tWords[0]);
+    int tSize = ((tHeader & 0xFFFF) + 1) * 4 /* 32 bit words */;
+    if (tSize > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "Payload feedback of %d bytes exceeds the received %d bytes", tSize, pDataSize);
+        return false;
+    }
+
+    switch((tHeader >> 24) & 0x1F)
+    {
+        case RTCP_FEEDBACK_PLI:
+            pMediaSsrc = ntohl(tWords[2]);
+            return true;
+        case RTCP_FEEDBACK_FIR:
+            if (tSize < 20)
+                return false;
+            pMediaSsrc = ntohl(tWords[3]);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RTP::IsFecActivated()
+{
+    return sFecActivated;
+}
+
+void RTP::ActivateFec()
+{
+    LOGEX(RTP, LOG_VERBOSE, "Activating forward error correction");
+    sFecActivated = true;
+}
+
+//HINT: only the fraction lost of the report block is used, the remaining fields are set to 0
+bool RTP::RtcpCreateReceiverReport(unsigned int pSenderSsrc, unsigned int pMediaSsrc, float pRelativeLoss, char *pBuffer, int &pBufferSize)
+{
+    uint32_t *tWords = (uint32_t*)pBuffer;
+
+    if (pBufferSize < RTCP_RECEIVER_REPORT_SIZE)
+        return false;
+
+    if (pRelativeLoss < 0)
+        pRelativeLoss = 0;
+    if (pRelativeLoss > 100)
+        pRelativeLoss = 100;
+    uint32_t tFractionLost = (uint32_t)(pRelativeLoss * 256 / 100);
+    if (tFractionLost > 255)
+        tFractionLost = 255;
+
+    memset(pBuffer, 0, RTCP_RECEIVER_REPORT_SIZE);
+    tWords[0] = ((uint32_t)(0x80 | 1 /* report blocks */) << 24) | ((uint32_t)RTCP_RECEIVER_REPORT << 16) | (uint32_t)(RTCP_RECEIVER_REPORT_SIZE / 4 - 1);
+    tWords[1] = pSenderSsrc;
+    tWords[2] = pMediaSsrc;
+    tWords[3] = tFractionLost << 24;
+
+    // convert from host to network byte order
+    for (int i = 0; i < 4; i++)
+        tWords[i] = htonl(tWords[i]);
+
+    pBufferSize = RTCP_RECEIVER_REPORT_SIZE;
+
+    return true;
+}
+
+bool RTP::RtcpParseReceiverReport(char *pData, int pDataSize, unsigned int &pMediaSsrc, float &pRelativeLoss)
+{
+    //HINT: assumes network byte order!
+
+    uint32_t *tWords = (uint32_t*)pData;
+
+    if ((pData == NULL) || (pDataSize < RTCP_RECEIVER_REPORT_SIZE) || ((pData[0] & 0xC0) != 0x80) || ((unsigned char)pData[1] != RTCP_RECEIVER_REPORT))
+        return false;
+
+    uint32_t tHeader = ntohl(tWords[0]);
+    if (((tHeader >> 24) & 0x1F) < 1)
+        return false;
+
+    int tSize = ((tHeader & 0xFFFF) + 1) * 4 /* 32 bit words */;
+    if (tSize > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "Receiver report of %d bytes exceeds the received %d bytes", tSize, pDataSize);
+        return false;
+    }
+
+    pMediaSsrc = ntohl(tWords[2]);
+    pRelativeLoss = (float)(ntohl(tWords[3]) >> 24) * 100 / 256;
+
+    return true;
+}
+
+bool RTP::IsRtcpFeedback(char *pData, int pDataSize)
+{
+    if ((pData == NULL) || (pDataSize < 8) || ((pData[0] & 0xC0) != 0x80))
+        return false;
+
+    unsigned char tType = (unsigned char)pData[1];
+
+    return ((tType == RTCP_RECEIVER_REPORT) || (tType == RTCP_TRANSPORT_FEEDBACK) || (tType == RTCP_PAYLOAD_FEEDBACK));
+}
+
 void RTP::SetSynchronizationReferenceForRTP(uint64_t pReferenceNtpTime, uint64_t pReferencePts)
 {
     if (!mRtpEncoderOpened)
@@ -3342,16 +3864,16 @@ void RTP::RtcpPatchLiveSenderReport(char *pHeader, uint32_t pTimestamp)
 #define RTCP_TX_RATIO_NUM           5
 #define RTCP_TX_RATIO_DEN           1000
 #define RTCP_SR_SIZE                28
-void RTP::RtcpCreateH261SenderReport(char *&pData /* current stream pointer */, unsigned int &pDataSize /* resulting stream size */, int64_t pCurPts)
+void RTP::RtcpCreateInternalSenderReport(char *&pData /* current stream pointer */, unsigned int &pDataSize /* resulting stream size */, int64_t pCurPts)
 {
     uint64_t tNtpTime = GetNtpTime();
-    int tRtcpBytes = ((mH261SentOctets - mH261SentOctetsLastSenderReport) * RTCP_TX_RATIO_NUM) / RTCP_TX_RATIO_DEN;
-    if ((mH261FirstPacket) || ((tRtcpBytes >= (int)RTCP_HEADER_SIZE /* 0.5 % rules */) && (tNtpTime - mH261SentNtpTimeLastSenderReport > 5000000 /* minimum period between two SRs is 5 seconds */)))
+    int tRtcpBytes = ((mInternalSentOctets - mInternalSentOctetsLastSenderReport) * RTCP_TX_RATIO_NUM) / RTCP_TX_RATIO_DEN;
+    if ((mInternalFirstPacket) || ((tRtcpBytes >= (int)RTCP_HEADER_SIZE /* 0.5 % rules */) && (tNtpTime - mInternalSentNtpTimeLastSenderReport > 5000000 /* minimum period between two SRs is 5 seconds */)))
     {// we should create a sender report
         #ifdef RTCP_DEBUG_PACKETS_ENCODER
-            LOG(LOG_VERBOSE, "Creating %d bytes H.261 sender report, %d reports already sent..", RTCP_HEADER_SIZE, mH261SenderReports);
+            LOG(LOG_VERBOSE, "Creating %d bytes sender report, %d reports already sent..", RTCP_HEADER_SIZE, mInternalSenderReports);
         #endif
-        mH261SenderReports++;
+        mInternalSenderReports++;
 
         // ################################################
         // write sender report packet size to RTP stream
@@ -3378,8 +3900,8 @@ void RTP::RtcpCreateH261SenderReport(char *&pData /* current stream pointer */,
         tRtcpHeader->Feedback.TimestampHigh = tNtpTime / 1000000;
         tRtcpHeader->Feedback.TimestampLow = ((tNtpTime % 1000000) << 32) / 1000000;
         tRtcpHeader->Feedback.RtpTimestamp = pCurPts * CalculateClockRateFactor() /* 90 kHz clock rate */;
-        tRtcpHeader->Feedback.Packets = mH261SentPackets;
-        tRtcpHeader->Feedback.Octets = mH261SentOctets;
+        tRtcpHeader->Feedback.Packets = mInternalSentPackets;
+        tRtcpHeader->Feedback.Octets = mInternalSentOctets;
 
         // convert from host to network byte order
         for (int i = 0; i < 7; i++)
@@ -3392,9 +3914,9 @@ void RTP::RtcpCreateH261SenderReport(char *&pData /* current stream pointer */,
         pData += RTCP_SR_SIZE;
         pDataSize += RTCP_SR_SIZE;
 
-        mH261SentOctetsLastSenderReport = mH261SentOctets;
-        mH261SentNtpTimeLastSenderReport = tNtpTime;
-        mH261FirstPacket = false;
+        mInternalSentOctetsLastSenderReport = mInternalSentOctets;
+        mInternalSentNtpTimeLastSenderReport = tNtpTime;
+        mInternalFirstPacket = false;
     }
 }
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,539 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of XOR parity based forward error correction for RTP streams
+ * Since:   2026-10-17
+ */
+
+//HINT: one FEC packet protects a group of consecutive RTP packets by the XOR parity of their headers, lengths and payloads (RFC 5109 with
+//HINT: a single protection level), hence any single lost packet of a group can be restored without a round trip to the sender
+
+#include <RTPFec.h>
+#include <RTPJitterBuffer.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// size of a RTP header without CSRCs
+#define RTP_FEC_RTP_HEADER_SIZE                             12
+
+// offsets of the FEC header and the FEC level header within a FEC packet
+#define RTP_FEC_OFFSET_RECOVERY_BITS                        12 // E, L, P, X, CC, M and PT
+#define RTP_FEC_OFFSET_SEQUENCE_NUMBER_BASE                 14
+#define RTP_FEC_OFFSET_TIMESTAMP_RECOVERY                   16
+#define RTP_FEC_OFFSET_LENGTH_RECOVERY                      20
+#define RTP_FEC_OFFSET_PROTECTION_LENGTH                    22
+#define RTP_FEC_OFFSET_MASK                                 24
+
+// expected losses per group: the group size is chosen such that a group is hit by a loss with a probability of about 25 %
+#define RTP_FEC_GROUP_LOSS_FACTOR                           25.0
+
+#define READ_UINT16(x)                                      ((((unsigned int)(unsigned char)(x)[0]) << 8) | (unsigned int)(unsigned char)(x)[1])
+#define WRITE_UINT16(x, y)                                  { (x)[0] = (char)(((y) >> 8) & 0xFF); (x)[1] = (char)((y) & 0xFF); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPFecEncoder::RTPFecEncoder()
+{
+    mRequestedGroupSize = RTP_FEC_DEFAULT_GROUP_SIZE;
+    mFecSequenceNumber = (unsigned short int)rand();
+    mFecPackets = 0;
+    Reset();
+}
+
+RTPFecEncoder::~RTPFecEncoder()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPFecEncoder::CalculateGroupSize(float pRelativeLoss)
+{
+    if (pRelativeLoss <= 0)
+        return RTP_FEC_MAX_GROUP_SIZE;
+
+    int tResult = (int)(RTP_FEC_GROUP_LOSS_FACTOR / pRelativeLoss) - 1;
+    if (tResult < RTP_FEC_MIN_GROUP_SIZE)
+        tResult = RTP_FEC_MIN_GROUP_SIZE;
+    if (tResult > RTP_FEC_MAX_GROUP_SIZE)
+        tResult = RTP_FEC_MAX_GROUP_SIZE;
+
+    return tResult;
+}
+
+void RTPFecEncoder::SetGroupSize(int pGroupSize)
+{
+    if (pGroupSize < RTP_FEC_MIN_GROUP_SIZE)
+        pGroupSize = RTP_FEC_MIN_GROUP_SIZE;
+    if (pGroupSize > RTP_FEC_MAX_GROUP_SIZE)
+        pGroupSize = RTP_FEC_MAX_GROUP_SIZE;
+
+    if (mRequestedGroupSize != pGroupSize)
+        LOG(LOG_VERBOSE, "Setting FEC group size from %d to %d packets", mRequestedGroupSize, pGroupSize);
+
+    mRequestedGroupSize = pGroupSize;
+}
+
+int RTPFecEncoder::GetGroupSize()
+{
+    return mRequestedGroupSize;
+}
+
+void RTPFecEncoder::StartGroup(char *pData, int pGroupSize)
+{
+    memset(mFecPacket, 0, RTP_FEC_HEADER_SIZE);
+    mFecPacket[0] = (char)0x80; // version 2
+    mFecPacket[1] = RTP_FEC_PAYLOAD_TYPE;
+    memcpy(mFecPacket + 8, pData + 8, 4); // SSRC of the protected stream
+    memcpy(mFecPacket + RTP_FEC_OFFSET_SEQUENCE_NUMBER_BASE, pData + 2, 2);
+
+    mGroupSequenceNumberBase = READ_UINT16(pData + 2);
+    mSsrc = (((unsigned int)(unsigned char)pData[8]) << 24) | (((unsigned int)(unsigned char)pData[9]) << 16) | (((unsigned int)(unsigned char)pData[10]) << 8) | (unsigned int)(unsigned char)pData[11];
+    mGroupSize = pGroupSize;
+    mProtectionLength = 0;
+}
+
+bool RTPFecEncoder::Protect(char *pData, int pDataSize, char *&pFecPacket, int &pFecPacketSize)
+{
+    // RTCP packets aren't protected
+    if (!RTPJitterBuffer::IsRtpPacket(pData, pDataSize))
+        return false;
+
+    int tPayloadSize = pDataSize - RTP_FEC_RTP_HEADER_SIZE;
+    if (tPayloadSize > RTP_FEC_MAX_PACKET_SIZE)
+    {
+        LOG(LOG_WARN, "RTP packet of %d bytes is too big for FEC protection, skipping current group", pDataSize);
+        mGroupPackets = 0;
+        return false;
+    }
+
+    unsigned short int tSequenceNumber = READ_UINT16(pData + 2);
+    unsigned int tSsrc = (((unsigned int)(unsigned char)pData[8]) << 24) | (((unsigned int)(unsigned char)pData[9]) << 16) | (((unsigned int)(unsigned char)pData[10]) << 8) | (unsigned int)(unsigned char)pData[11];
+
+    // a group consists of consecutive packets of one source
+    if ((mGroupPackets > 0) && ((tSsrc != mSsrc) || (tSequenceNumber != (unsigned short int)(mGroupSequenceNumberBase + mGroupPackets))))
+    {
+        #ifdef RTPFEC_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Restarting FEC group at packet %u of SSRC %u, %d packets of the current group remain unprotected", (unsigned int)tSequenceNumber, tSsrc, mGroupPackets);
+        #endif
+        mGroupPackets = 0;
+    }
+    if (mGroupPackets == 0)
+        StartGroup(pData, mRequestedGroupSize);
+
+    // P, X, CC, M and PT
+    mFecPacket[RTP_FEC_OFFSET_RECOVERY_BITS] ^= pData[0] & 0x3F;
+    mFecPacket[RTP_FEC_OFFSET_RECOVERY_BITS + 1] ^= pData[1];
+    // timestamp
+    for (int i = 0; i < 4; i++)
+        mFecPacket[RTP_FEC_OFFSET_TIMESTAMP_RECOVERY + i] ^= pData[4 + i];
+    // length
+    mFecPacket[RTP_FEC_OFFSET_LENGTH_RECOVERY] ^= (char)((tPayloadSize >> 8) & 0xFF);
+    mFecPacket[RTP_FEC_OFFSET_LENGTH_RECOVERY + 1] ^= (char)(tPayloadSize & 0xFF);
+
+    // shorter payloads are padded with zeros
+    if (tPayloadSize > mProtectionLength)
+    {
+        memset(mFecPacket + RTP_FEC_HEADER_SIZE + mProtectionLength, 0, tPayloadSize - mProtectionLength);
+        mProtectionLength = tPayloadSize;
+    }
+    char *tParity = mFecPacket + RTP_FEC_HEADER_SIZE;
+    char *tPayload = pData + RTP_FEC_RTP_HEADER_SIZE;
+    for (int i = 0; i < tPayloadSize; i++)
+        tParity[i] ^= tPayload[i];
+
+    // the most significant bit of the mask represents the sequence number base
+    mFecPacket[RTP_FEC_OFFSET_MASK + mGroupPackets / 8] |= (char)(0x80 >> (mGroupPackets % 8));
+
+    // the FEC packet carries the timestamp of the last protected packet
+    memcpy(mFecPacket + 4, pData + 4, 4);
+
+    mGroupPackets++;
+
+    // the end of a frame (marker bit) completes a group which is at least half full, this limits the delay of the FEC packet
+    if ((mGroupPackets < mGroupSize) && ((!(pData[1] & 0x80)) || (mGroupPackets < RTP_FEC_MIN_GROUP_SIZE) || (mGroupPackets < mGroupSize / 2)))
+        return false;
+
+    WRITE_UINT16(mFecPacket + 2, mFecSequenceNumber);
+    WRITE_UINT16(mFecPacket + RTP_FEC_OFFSET_PROTECTION_LENGTH, mProtectionLength);
+    mFecSequenceNumber++;
+
+    pFecPacket = mFecPacket;
+    pFecPacketSize = RTP_FEC_HEADER_SIZE + mProtectionLength;
+    mFecPackets++;
+
+    #ifdef RTPFEC_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Created FEC packet of %d bytes for %d packets starting at sequence number %u", pFecPacketSize, mGroupPackets, (unsigned int)mGroupSequenceNumberBase);
+    #endif
+
+    mGroupPackets = 0;
+
+    return true;
+}
+
+void RTPFecEncoder::Reset()
+{
+    mGroupPackets = 0;
+    mGroupSize = mRequestedGroupSize;
+    mGroupSequenceNumberBase = 0;
+    mProtectionLength = 0;
+    mSsrc = 0;
+}
+
+int64_t RTPFecEncoder::GetFecPackets()
+{
+    return mFecPackets;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPFecDecoder::RTPFecDecoder()
+{
+    for (int i = 0; i < RTP_FEC_DECODER_WINDOW; i++)
+    {
+        mMediaSlots[i].Data = NULL;
+        mMediaSlots[i].Size = 0;
+        mMediaSlots[i].Capacity = 0;
+        mMediaSlots[i].SequenceNumber = 0;
+        mMediaSlots[i].Used = false;
+    }
+    for (int i = 0; i < RTP_FEC_DECODER_MAX_FEC_PACKETS; i++)
+    {
+        mFecSlots[i].Data = NULL;
+        mFecSlots[i].Size = 0;
+        mFecSlots[i].Capacity = 0;
+        mFecSlots[i].SequenceNumber = 0;
+        mFecSlots[i].Used = false;
+    }
+    Reset();
+}
+
+RTPFecDecoder::~RTPFecDecoder()
+{
+    for (int i = 0; i < RTP_FEC_DECODER_WINDOW; i++)
+        free(mMediaSlots[i].Data);
+    for (int i = 0; i < RTP_FEC_DECODER_MAX_FEC_PACKETS; i++)
+        free(mFecSlots[i].Data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPFecDecoder::IsFecPacket(char *pData, int pDataSize)
+{
+    if ((pData == NULL) || (pDataSize < RTP_FEC_HEADER_SIZE))
+        return false;
+
+    return (((pData[0] & 0xC0) == 0x80) && ((pData[1] & 0x7F) == RTP_FEC_PAYLOAD_TYPE));
+}
+
+bool RTPFecDecoder::StoreSlot(RtpFecSlot *pSlot, char *pData, int pDataSize)
+{
+    if (pSlot->Capacity < pDataSize)
+    {
+        char *tData = (char*)realloc(pSlot->Data, pDataSize);
+        if (tData == NULL)
+        {
+            LOG(LOG_ERROR, "Failed to allocate %d bytes for FEC decoding", pDataSize);
+            pSlot->Used = false;
+            return false;
+        }
+        pSlot->Data = tData;
+        pSlot->Capacity = pDataSize;
+    }
+    if (pData != NULL)
+        memcpy(pSlot->Data, pData, pDataSize);
+    pSlot->Size = pDataSize;
+    pSlot->Used = true;
+
+    return true;
+}
+
+void RTPFecDecoder::DropPackets(unsigned int pSsrc)
+{
+    for (int i = 0; i < RTP_FEC_DECODER_WINDOW; i++)
+        mMediaSlots[i].Used = false;
+    for (int i = 0; i < RTP_FEC_DECODER_MAX_FEC_PACKETS; i++)
+        mFecSlots[i].Used = false;
+    mRecoveredPacketsCount = 0;
+    mSsrc = pSsrc;
+}
+
+void RTPFecDecoder::StoreMediaPacket(char *pData, int pDataSize)
+{
+    // streams without FEC don't need the copies
+    if ((!mActive) || (pDataSize < RTP_FEC_RTP_HEADER_SIZE))
+        return;
+
+    unsigned short int tSequenceNumber = READ_UINT16(pData + 2);
+    unsigned int tSsrc = (((unsigned int)(unsigned char)pData[8]) << 24) | (((unsigned int)(unsigned char)pData[9]) << 16) | (((unsigned int)(unsigned char)pData[10]) << 8) | (unsigned int)(unsigned char)pData[11];
+
+    if (tSsrc != mSsrc)
+    {
+        DropPackets(tSsrc);
+        mHighestSequenceNumber = tSequenceNumber;
+    }
+    if ((short int)(tSequenceNumber - mHighestSequenceNumber) > 0)
+        mHighestSequenceNumber = tSequenceNumber;
+
+    RtpFecSlot *tSlot = &mMediaSlots[tSequenceNumber % RTP_FEC_DECODER_WINDOW];
+
+    // already recovered or a duplicate
+    if ((tSlot->Used) && (tSlot->SequenceNumber == tSequenceNumber))
+        return;
+
+    if (!StoreSlot(tSlot, pData, pDataSize))
+        return;
+    tSlot->SequenceNumber = tSequenceNumber;
+
+    // a FEC packet may wait for this packet
+    Recover();
+}
+
+void RTPFecDecoder::StoreFecPacket(char *pData, int pDataSize)
+{
+    unsigned short int tSequenceNumberBase = READ_UINT16(pData + RTP_FEC_OFFSET_SEQUENCE_NUMBER_BASE);
+    unsigned int tSsrc = (((unsigned int)(unsigned char)pData[8]) << 24) | (((unsigned int)(unsigned char)pData[9]) << 16) | (((unsigned int)(unsigned char)pData[10]) << 8) | (unsigned int)(unsigned char)pData[11];
+    RtpFecSlot *tSlot = NULL;
+
+    if (!mActive)
+    {
+        LOG(LOG_VERBOSE, "Received first FEC packet for SSRC %u, activating FEC recovery", tSsrc);
+        mActive = true;
+    }
+    mFecPacketsCount++;
+
+    if (tSsrc != mSsrc)
+    {
+        DropPackets(tSsrc);
+        mHighestSequenceNumber = tSequenceNumberBase;
+    }
+
+    // find a free slot, otherwise replace the oldest FEC packet
+    for (int i = 0; i < RTP_FEC_DECODER_MAX_FEC_PACKETS; i++)
+    {
+        if (!mFecSlots[i].Used)
+        {
+            tSlot = &mFecSlots[i];
+            break;
+        }
+        if ((tSlot == NULL) || ((short int)(mFecSlots[i].SequenceNumber - tSlot->SequenceNumber) < 0))
+            tSlot = &mFecSlots[i];
+    }
+    if (tSlot->Used)
+        mUnrecoverablePackets++;
+
+    if (!StoreSlot(tSlot, pData, pDataSize))
+        return;
+    tSlot->SequenceNumber = tSequenceNumberBase;
+
+    Recover();
+}
+
+void RTPFecDecoder::Recover()
+{
+    bool tProgress = true;
+
+    // a recovered packet may complete another group
+    while (tProgress)
+    {
+        tProgress = false;
+        for (int i = 0; i < RTP_FEC_DECODER_MAX_FEC_PACKETS; i++)
+        {
+            RtpFecSlot *tFecSlot = &mFecSlots[i];
+            if (!tFecSlot->Used)
+                continue;
+
+            unsigned short int tSequenceNumberBase = tFecSlot->SequenceNumber;
+            unsigned int tMask = READ_UINT16(tFecSlot->Data + RTP_FEC_OFFSET_MASK);
+            unsigned short int tMissingSequenceNumber = 0;
+            int tMissingPackets = 0;
+
+            for (int j = 0; j < RTP_FEC_MAX_GROUP_SIZE; j++)
+            {
+                if (tMask & (0x8000 >> j))
+                {
+                    unsigned short int tSequenceNumber = tSequenceNumberBase + j;
+                    RtpFecSlot *tMediaSlot = &mMediaSlots[tSequenceNumber % RTP_FEC_DECODER_WINDOW];
+                    if ((!tMediaSlot->Used) || (tMediaSlot->SequenceNumber != tSequenceNumber))
+                    {
+                        tMissingPackets++;
+                        tMissingSequenceNumber = tSequenceNumber;
+                    }
+                }
+            }
+
+            switch(tMissingPackets)
+            {
+                case 0:
+                    // nothing lost
+                    tFecSlot->Used = false;
+                    break;
+                case 1:
+                    if (RecoverPacket(tFecSlot, tMissingSequenceNumber))
+                        tProgress = true;
+                    tFecSlot->Used = false;
+                    break;
+                default:
+                    // the group leaves the window of remembered packets: more than one packet was lost
+                    if ((short int)(mHighestSequenceNumber - tSequenceNumberBase) >= RTP_FEC_DECODER_WINDOW - RTP_FEC_MAX_GROUP_SIZE)
+                    {
+                        #ifdef RTPFEC_DEBUG_PACKETS
+                            LOG(LOG_VERBOSE, "Dropping FEC packet for %d missing packets starting at sequence number %u", tMissingPackets, (unsigned int)tSequenceNumberBase);
+                        #endif
+                        tFecSlot->Used = false;
+                        mUnrecoverablePackets++;
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+bool RTPFecDecoder::RecoverPacket(RtpFecSlot *pFecSlot, unsigned short int pSequenceNumber)
+{
+    char *tFec = pFecSlot->Data;
+    int tProtectionLength = READ_UINT16(tFec + RTP_FEC_OFFSET_PROTECTION_LENGTH);
+    unsigned int tMask = READ_UINT16(tFec + RTP_FEC_OFFSET_MASK);
+    unsigned short int tSequenceNumberBase = pFecSlot->SequenceNumber;
+
+    if ((RTP_FEC_HEADER_SIZE + tProtectionLength > pFecSlot->Size) || (mRecoveredPacketsCount >= RTP_FEC_DECODER_MAX_FEC_PACKETS))
+        return false;
+
+    RtpFecSlot *tSlot = &mMediaSlots[pSequenceNumber % RTP_FEC_DECODER_WINDOW];
+    if (!StoreSlot(tSlot, NULL, RTP_FEC_RTP_HEADER_SIZE + tProtectionLength))
+        return false;
+
+    // start with the FEC packet
+    char *tPacket = tSlot->Data;
+    char tRecoveryBits[2] = { tFec[RTP_FEC_OFFSET_RECOVERY_BITS], tFec[RTP_FEC_OFFSET_RECOVERY_BITS + 1] };
+    unsigned int tLength = READ_UINT16(tFec + RTP_FEC_OFFSET_LENGTH_RECOVERY);
+    memcpy(tPacket + 4, tFec + RTP_FEC_OFFSET_TIMESTAMP_RECOVERY, 4);
+    memcpy(tPacket + RTP_FEC_RTP_HEADER_SIZE, tFec + RTP_FEC_HEADER_SIZE, tProtectionLength);
+
+    // XOR all received packets of the group
+    for (int j = 0; j < RTP_FEC_MAX_GROUP_SIZE; j++)
+    {
+        unsigned short int tSequenceNumber = tSequenceNumberBase + j;
+        if ((!(tMask & (0x8000 >> j))) || (tSequenceNumber == pSequenceNumber))
+            continue;
+
+        RtpFecSlot *tMediaSlot = &mMediaSlots[tSequenceNumber % RTP_FEC_DECODER_WINDOW];
+        char *tData = tMediaSlot->Data;
+        int tPayloadSize = tMediaSlot->Size - RTP_FEC_RTP_HEADER_SIZE;
+        if (tPayloadSize > tProtectionLength)
+        {
+            LOG(LOG_WARN, "Packet %u exceeds the protection length %d of its FEC packet", (unsigned int)tSequenceNumber, tProtectionLength);
+            tSlot->Used = false;
+            return false;
+        }
+
+        tRecoveryBits[0] ^= tData[0] & 0x3F;
+        tRecoveryBits[1] ^= tData[1];
+        for (int i = 0; i < 4; i++)
+            tPacket[4 + i] ^= tData[4 + i];
+        tLength ^= (unsigned int)tPayloadSize;
+        char *tPayload = tData + RTP_FEC_RTP_HEADER_SIZE;
+        char *tRecoveredPayload = tPacket + RTP_FEC_RTP_HEADER_SIZE;
+        for (int i = 0; i < tPayloadSize; i++)
+            tRecoveredPayload[i] ^= tPayload[i];
+    }
+
+    if ((int)tLength > tProtectionLength)
+    {
+        LOG(LOG_WARN, "Recovered length %u of packet %u exceeds the protection length %d", tLength, (unsigned int)pSequenceNumber, tProtectionLength);
+        tSlot->Used = false;
+        return false;
+    }
+
+    tPacket[0] = (char)(0x80 | (tRecoveryBits[0] & 0x3F));
+    tPacket[1] = tRecoveryBits[1];
+    WRITE_UINT16(tPacket + 2, pSequenceNumber);
+    memcpy(tPacket + 8, tFec + 8, 4); // SSRC
+    tSlot->Size = RTP_FEC_RTP_HEADER_SIZE + tLength;
+    tSlot->SequenceNumber = pSequenceNumber;
+
+    mRecoveredPackets[mRecoveredPacketsCount++] = pSequenceNumber;
+    mRecoveredPacketsTotal++;
+
+    #ifdef RTPFEC_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Recovered packet %u with %u bytes payload, %"PRId64" recovered packets in total", (unsigned int)pSequenceNumber, tLength, mRecoveredPacketsTotal);
+    #endif
+
+    return true;
+}
+
+bool RTPFecDecoder::GetRecoveredPacket(char *pBuffer, int &pBufferSize)
+{
+    while (mRecoveredPacketsCount > 0)
+    {
+        unsigned short int tSequenceNumber = mRecoveredPackets[0];
+        mRecoveredPacketsCount--;
+        memmove(&mRecoveredPackets[0], &mRecoveredPackets[1], mRecoveredPacketsCount * sizeof(unsigned short int));
+
+        RtpFecSlot *tSlot = &mMediaSlots[tSequenceNumber % RTP_FEC_DECODER_WINDOW];
+        if ((tSlot->Used) && (tSlot->SequenceNumber == tSequenceNumber) && (tSlot->Size <= pBufferSize))
+        {
+            memcpy(pBuffer, tSlot->Data, tSlot->Size);
+            pBufferSize = tSlot->Size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RTPFecDecoder::Reset()
+{
+    DropPackets(0);
+    mHighestSequenceNumber = 0;
+    mActive = false;
+    mFecPacketsCount = 0;
+    mRecoveredPacketsTotal = 0;
+    mUnrecoverablePackets = 0;
+}
+
+bool RTPFecDecoder::IsActive()
+{
+    return mActive;
+}
+
+RtpFecStatistic RTPFecDecoder::GetStatistic()
+{
+    RtpFecStatistic tResult;
+
+    tResult.FecPackets = mFecPacketsCount;
+    tResult.Recovered = mRecoveredPacketsTotal;
+    tResult.Unrecoverable = mUnrecoverablePackets;
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -0,0 +1,366 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a RTP jitter buffer
+ * Since:   2026-10-17
+ */
+
+//HINT: the playout delay adapts to the observed network jitter: it grows if a missing packet arrives late or
+//HINT: after a long waiting time and it slowly shrinks with every completely released frame (RTP marker bit)
+
+#include <RTPJitterBuffer.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// minimum size of a RTP header without CSRCs
+#define RTP_JITTER_BUFFER_MIN_HEADER_SIZE                   12
+
+// the playout delay shrinks by 1/x with every released frame
+#define RTP_JITTER_BUFFER_DELAY_DECAY                       64
+
+// if the buffered packets span more than this number of sequence numbers, a gap is skipped without waiting for its deadline
+#define RTP_JITTER_BUFFER_OVERLOAD_THRESHOLD                (RTP_JITTER_BUFFER_SIZE / 2)
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPJitterBuffer::RTPJitterBuffer()
+{
+    for (int i = 0; i < RTP_JITTER_BUFFER_SIZE; i++)
+    {
+        mSlots[i].Data = NULL;
+        mSlots[i].Size = 0;
+        mSlots[i].Capacity = 0;
+        mSlots[i].ExtendedSequenceNumber = 0;
+        mSlots[i].ArrivalTime = 0;
+        mSlots[i].Used = false;
+    }
+    mBufferedPackets = 0;
+    Reset();
+}
+
+RTPJitterBuffer::~RTPJitterBuffer()
+{
+    for (int i = 0; i < RTP_JITTER_BUFFER_SIZE; i++)
+        free(mSlots[i].Data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPJitterBuffer::IsRtpPacket(char *pData, int pDataSize)
+{
+    if ((pData == NULL) || (pDataSize < RTP_JITTER_BUFFER_MIN_HEADER_SIZE))
+        return false;
+
+    // RTP version 2?
+    if ((pData[0] & 0xC0) != 0x80)
+        return false;
+
+    // RTCP packet types 192-223 (RFC 5761)
+    unsigned char tPayloadType = (unsigned char)pData[1];
+    if ((tPayloadType >= 192) && (tPayloadType <= 223))
+        return false;
+
+    return true;
+}
+
+enum RtpJitterBufferInsertResult RTPJitterBuffer::Insert(char *pData, int pDataSize, int64_t pNow, int64_t &pExtendedSequenceNumber)
+{
+    unsigned short int tSequenceNumber = (((unsigned char)pData[2]) << 8) | (unsigned char)pData[3];
+    unsigned int tSsrc = (((unsigned int)(unsigned char)pData[8]) << 24) | (((unsigned int)(unsigned char)pData[9]) << 16) | (((unsigned int)(unsigned char)pData[10]) << 8) | (unsigned int)(unsigned char)pData[11];
+
+    if (!mStarted)
+    {
+        // start with one sequence number cycle to be able to handle packets from before the first one
+        Restart(65536 + tSequenceNumber, tSsrc);
+    }else if (tSsrc != mSsrc)
+    {
+        LOG(LOG_INFO, "Detected new RTP source (SSRC: %u), dropping %d buffered packets of the former source (SSRC: %u)", tSsrc, mBufferedPackets, mSsrc);
+        DropPackets();
+        Restart(65536 + tSequenceNumber, tSsrc);
+    }
+
+    // unwrap the 16 bit sequence number
+    int64_t tExtendedSequenceNumber = mHighestSequenceNumber + (short int)(tSequenceNumber - (unsigned short int)(mHighestSequenceNumber & 0xFFFF));
+    pExtendedSequenceNumber = tExtendedSequenceNumber;
+
+    if ((tExtendedSequenceNumber - mNextSequenceNumber >= RTP_JITTER_BUFFER_SIZE) || (mNextSequenceNumber - tExtendedSequenceNumber > RTP_JITTER_BUFFER_SIZE))
+    {// sequence number jumped beyond the reordering window: the sender was restarted
+        LOG(LOG_WARN, "Sequence number jumped from %"PRId64" to %"PRId64", dropping %d buffered packets", mNextSequenceNumber, tExtendedSequenceNumber, mBufferedPackets);
+        DropPackets();
+        Restart(tExtendedSequenceNumber, tSsrc);
+    }
+
+    if (tExtendedSequenceNumber < mNextSequenceNumber)
+    {// packet was already released or skipped
+        mLatePackets++;
+        IncreaseDelay(mPlayoutDelay + mPlayoutDelay / 2);
+        #ifdef RTPJB_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Dropping late packet %"PRId64", expected %"PRId64", new playout delay: %"PRId64" us", tExtendedSequenceNumber, mNextSequenceNumber, mPlayoutDelay);
+        #endif
+        return RTP_JITTER_BUFFER_DROPPED;
+    }
+
+    // fast path: in-order packet and nothing buffered
+    if ((tExtendedSequenceNumber == mNextSequenceNumber) && (mBufferedPackets == 0))
+    {
+        mNextSequenceNumber++;
+        if (tExtendedSequenceNumber > mHighestSequenceNumber)
+            mHighestSequenceNumber = tExtendedSequenceNumber;
+        if (pData[1] & 0x80)
+            DecreaseDelay();
+        return RTP_JITTER_BUFFER_PASS;
+    }
+
+    RtpJitterBufferSlot *tSlot = &mSlots[tExtendedSequenceNumber % RTP_JITTER_BUFFER_SIZE];
+    if (tSlot->Used)
+    {
+        mDuplicatePackets++;
+        #ifdef RTPJB_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Dropping duplicate of packet %"PRId64"", tExtendedSequenceNumber);
+        #endif
+        return RTP_JITTER_BUFFER_DROPPED;
+    }
+
+    if (tExtendedSequenceNumber > mHighestSequenceNumber)
+    {
+        // remember the skipped sequence numbers for retransmission requests
+        for (int64_t i = mHighestSequenceNumber + 1; (i < tExtendedSequenceNumber) && (mMissingPacketsCount < RTP_JITTER_BUFFER_MAX_MISSING_PACKETS); i++)
+            mMissingPackets[mMissingPacketsCount++] = (unsigned short int)(i & 0xFFFF);
+        mHighestSequenceNumber = tExtendedSequenceNumber;
+    }else if (tExtendedSequenceNumber < mHighestSequenceNumber)
+        mReorderedPackets++;
+
+    // the missing packet at the head of the buffer has arrived: the playout delay has to cover this waiting time
+    if ((tExtendedSequenceNumber == mNextSequenceNumber) && (mGapTime != -1))
+    {
+        int64_t tWaitTime = pNow - mGapTime;
+        IncreaseDelay(tWaitTime + tWaitTime / 2);
+        #ifdef RTPJB_DEBUG_DELAY
+            LOG(LOG_VERBOSE, "Missing packet %"PRId64" arrived after %"PRId64" us, playout delay: %"PRId64" us", tExtendedSequenceNumber, tWaitTime, mPlayoutDelay);
+        #endif
+    }
+
+    if (tSlot->Capacity < pDataSize)
+    {
+        char *tData = (char*)realloc(tSlot->Data, pDataSize);
+        if (tData == NULL)
+        {
+            LOG(LOG_ERROR, "Failed to allocate %d bytes for packet %"PRId64"", pDataSize, tExtendedSequenceNumber);
+            return RTP_JITTER_BUFFER_DROPPED;
+        }
+        tSlot->Data = tData;
+        tSlot->Capacity = pDataSize;
+    }
+    memcpy(tSlot->Data, pData, pDataSize);
+    tSlot->Size = pDataSize;
+    tSlot->ExtendedSequenceNumber = tExtendedSequenceNumber;
+    tSlot->ArrivalTime = pNow;
+    tSlot->Used = true;
+    mBufferedPackets++;
+
+    #ifdef RTPJB_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Buffered packet %"PRId64", expected %"PRId64", %d packets buffered", tExtendedSequenceNumber, mNextSequenceNumber, mBufferedPackets);
+    #endif
+
+    return RTP_JITTER_BUFFER_STORED;
+}
+
+bool RTPJitterBuffer::Pop(char *pBuffer, int &pBufferSize, int64_t &pExtendedSequenceNumber, int64_t &pWaitTime, int64_t pNow)
+{
+    pWaitTime = 0;
+
+    while (mBufferedPackets > 0)
+    {
+        RtpJitterBufferSlot *tSlot = &mSlots[mNextSequenceNumber % RTP_JITTER_BUFFER_SIZE];
+
+        if (tSlot->Used)
+        {// the next packet is available
+            bool tResult = false;
+            if (pBufferSize >= tSlot->Size)
+            {
+                memcpy(pBuffer, tSlot->Data, tSlot->Size);
+                pBufferSize = tSlot->Size;
+                pExtendedSequenceNumber = tSlot->ExtendedSequenceNumber;
+                if (tSlot->Data[1] & 0x80)
+                    DecreaseDelay();
+                tResult = true;
+            }else
+                LOG(LOG_ERROR, "Given buffer is too small (%d bytes) for packet %"PRId64" of %d bytes, dropping data", pBufferSize, tSlot->ExtendedSequenceNumber, tSlot->Size);
+
+            ReleaseSlot(tSlot);
+            mNextSequenceNumber++;
+            mGapTime = -1;
+            if (tResult)
+                return true;
+            continue;
+        }
+
+        // there is a gap at the head of the buffer: wait for the missing packet until its playout deadline has passed
+        if (mGapTime == -1)
+            mGapTime = mSlots[FindNextPacket() % RTP_JITTER_BUFFER_SIZE].ArrivalTime;
+        int64_t tDeadline = mGapTime + mPlayoutDelay;
+        if ((pNow < tDeadline) && (mHighestSequenceNumber - mNextSequenceNumber < RTP_JITTER_BUFFER_OVERLOAD_THRESHOLD))
+        {
+            pWaitTime = tDeadline - pNow;
+            return false;
+        }
+
+        // skip the missing packets
+        int64_t tNextPacket = FindNextPacket();
+        mLostPackets += tNextPacket - mNextSequenceNumber;
+        LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "Playout deadline passed, skipping %"PRId64" missing packet(s) starting at sequence number %"PRId64" (playout delay: %"PRId64" us, buffered packets: %d)", tNextPacket - mNextSequenceNumber, mNextSequenceNumber, mPlayoutDelay, mBufferedPackets);
+        mNextSequenceNumber = tNextPacket;
+        mGapTime = -1;
+    }
+
+    return false;
+}
+
+void RTPJitterBuffer::Reset()
+{
+    DropPackets();
+    mStarted = false;
+    mSsrc = 0;
+    mNextSequenceNumber = 0;
+    mHighestSequenceNumber = 0;
+    mGapTime = -1;
+    mMissingPacketsCount = 0;
+    mPlayoutDelay = RTP_JITTER_BUFFER_INITIAL_DELAY;
+    mLatePackets = 0;
+    mLostPackets = 0;
+    mReorderedPackets = 0;
+    mDuplicatePackets = 0;
+}
+
+int RTPJitterBuffer::GetMissingPackets(unsigned short int *pSequenceNumbers, int pMaxCount)
+{
+    int tResult = (mMissingPacketsCount < pMaxCount) ? mMissingPacketsCount : pMaxCount;
+
+    memcpy(pSequenceNumbers, mMissingPackets, tResult * sizeof(unsigned short int));
+    mMissingPacketsCount = 0;
+
+    return tResult;
+}
+
+unsigned int RTPJitterBuffer::GetSourceIdentifier()
+{
+    return mSsrc;
+}
+
+int RTPJitterBuffer::GetBufferedPackets()
+{
+    return mBufferedPackets;
+}
+
+int64_t RTPJitterBuffer::GetLostPackets()
+{
+    return mLostPackets;
+}
+
+int64_t RTPJitterBuffer::GetPlayoutDelay()
+{
+    return mPlayoutDelay;
+}
+
+RtpJitterBufferStatistic RTPJitterBuffer::GetStatistic()
+{
+    RtpJitterBufferStatistic tResult;
+
+    tResult.Late = mLatePackets;
+    tResult.Lost = mLostPackets;
+    tResult.Reordered = mReorderedPackets;
+    tResult.Duplicates = mDuplicatePackets;
+    tResult.Requested = 0;
+    tResult.BufferedPackets = mBufferedPackets;
+    tResult.PlayoutDelay = mPlayoutDelay;
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPJitterBuffer::Restart(int64_t pExtendedSequenceNumber, unsigned int pSsrc)
+{
+    mStarted = true;
+    mSsrc = pSsrc;
+    mNextSequenceNumber = pExtendedSequenceNumber;
+    mHighestSequenceNumber = pExtendedSequenceNumber;
+    mGapTime = -1;
+    mMissingPacketsCount = 0;
+}
+
+void RTPJitterBuffer::DropPackets()
+{
+    if (mBufferedPackets == 0)
+        return;
+
+    for (int i = 0; i < RTP_JITTER_BUFFER_SIZE; i++)
+    {
+        if (mSlots[i].Used)
+            ReleaseSlot(&mSlots[i]);
+    }
+}
+
+void RTPJitterBuffer::ReleaseSlot(RtpJitterBufferSlot *pSlot)
+{
+    // the memory is kept for the next packet
+    pSlot->Used = false;
+    pSlot->Size = 0;
+    mBufferedPackets--;
+}
+
+int64_t RTPJitterBuffer::FindNextPacket()
+{
+    // only called if packets are buffered, all of them are within the window behind the head
+    int64_t tResult = mNextSequenceNumber + 1;
+    while (!mSlots[tResult % RTP_JITTER_BUFFER_SIZE].Used)
+        tResult++;
+
+    return tResult;
+}
+
+void RTPJitterBuffer::IncreaseDelay(int64_t pDelay)
+{
+    if (pDelay > RTP_JITTER_BUFFER_MAX_DELAY)
+        pDelay = RTP_JITTER_BUFFER_MAX_DELAY;
+    if (pDelay > mPlayoutDelay)
+        mPlayoutDelay = pDelay;
+}
+
+void RTPJitterBuffer::DecreaseDelay()
+{
+    mPlayoutDelay -= mPlayoutDelay / RTP_JITTER_BUFFER_DELAY_DECAY;
+    if (mPlayoutDelay < RTP_JITTER_BUFFER_MIN_DELAY)
+        mPlayoutDelay = RTP_JITTER_BUFFER_MIN_DELAY;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
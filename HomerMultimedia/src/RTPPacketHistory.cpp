@@ -0,0 +1,165 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a history of recently sent RTP packets
+ * Since:   2026-10-17
+ */
+
+#include <RTPPacketHistory.h>
+#include <RTPJitterBuffer.h>
+#include <RTPFec.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPPacketHistory::RTPPacketHistory()
+{
+    for (int i = 0; i < RTP_PACKET_HISTORY_SIZE; i++)
+    {
+        mSlots[i].Data = NULL;
+        mSlots[i].Size = 0;
+        mSlots[i].Capacity = 0;
+        mSlots[i].SequenceNumber = 0;
+        mSlots[i].Used = false;
+    }
+    mSsrc = 0;
+}
+
+RTPPacketHistory::~RTPPacketHistory()
+{
+    for (int i = 0; i < RTP_PACKET_HISTORY_SIZE; i++)
+        free(mSlots[i].Data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RtpPacketHistorySlot* RTPPacketHistory::LockSlot(char *pHeader, int pDataSize)
+{
+    // FEC packets have their own sequence numbers and aren't retransmitted
+    if ((!RTPJitterBuffer::IsRtpPacket(pHeader, pDataSize)) || (RTPFecDecoder::IsFecPacket(pHeader, pDataSize)))
+        return NULL;
+
+    unsigned short int tSequenceNumber = (((unsigned char)pHeader[2]) << 8) | (unsigned char)pHeader[3];
+    unsigned int tSsrc = (((unsigned int)(unsigned char)pHeader[8]) << 24) | (((unsigned int)(unsigned char)pHeader[9]) << 16) | (((unsigned int)(unsigned char)pHeader[10]) << 8) | (unsigned int)(unsigned char)pHeader[11];
+    RtpPacketHistorySlot *tSlot = &mSlots[tSequenceNumber % RTP_PACKET_HISTORY_SIZE];
+
+    mMutex.lock();
+
+    // a restarted RTP packetizer uses a new SSRC, the old packets are useless
+    if (tSsrc != mSsrc)
+    {
+        for (int i = 0; i < RTP_PACKET_HISTORY_SIZE; i++)
+            mSlots[i].Used = false;
+        mSsrc = tSsrc;
+    }
+
+    if (tSlot->Capacity < pDataSize)
+    {
+        char *tData = (char*)realloc(tSlot->Data, pDataSize);
+        if (tData == NULL)
+        {
+            mMutex.unlock();
+            LOG(LOG_ERROR, "Failed to allocate %d bytes for packet %u", pDataSize, (unsigned int)tSequenceNumber);
+            return NULL;
+        }
+        tSlot->Data = tData;
+        tSlot->Capacity = pDataSize;
+    }
+    tSlot->Size = pDataSize;
+    tSlot->SequenceNumber = tSequenceNumber;
+    tSlot->Used = true;
+
+    return tSlot;
+}
+
+void RTPPacketHistory::Store(char *pData, int pDataSize)
+{
+    RtpPacketHistorySlot *tSlot = LockSlot(pData, pDataSize);
+    if (tSlot == NULL)
+        return;
+
+    memcpy(tSlot->Data, pData, pDataSize);
+
+    mMutex.unlock();
+}
+
+void RTPPacketHistory::Store(RtpPacketDescriptor *pPacket)
+{
+    if ((pPacket->VectorCount < 1) || (pPacket->Vectors[0].Size < RTP_PACKETIZER_RTP_HEADER_SIZE))
+        return;
+
+    RtpPacketHistorySlot *tSlot = LockSlot(pPacket->Vectors[0].Data, (int)pPacket->Size);
+    if (tSlot == NULL)
+        return;
+
+    // gather the parts directly in the slot
+    char *tSlotPos = tSlot->Data;
+    for (int i = 0; i < pPacket->VectorCount; i++)
+    {
+        memcpy(tSlotPos, pPacket->Vectors[i].Data, pPacket->Vectors[i].Size);
+        tSlotPos += pPacket->Vectors[i].Size;
+    }
+
+    mMutex.unlock();
+}
+
+bool RTPPacketHistory::Get(unsigned short int pSequenceNumber, char *pBuffer, int &pBufferSize)
+{
+    bool tResult = false;
+    RtpPacketHistorySlot *tSlot = &mSlots[pSequenceNumber % RTP_PACKET_HISTORY_SIZE];
+
+    mMutex.lock();
+    if ((tSlot->Used) && (tSlot->SequenceNumber == pSequenceNumber) && (tSlot->Size <= pBufferSize))
+    {
+        memcpy(pBuffer, tSlot->Data, tSlot->Size);
+        pBufferSize = tSlot->Size;
+        tResult = true;
+    }
+    mMutex.unlock();
+
+    return tResult;
+}
+
+void RTPPacketHistory::Reset()
+{
+    mMutex.lock();
+    for (int i = 0; i < RTP_PACKET_HISTORY_SIZE; i++)
+        mSlots[i].Used = false;
+    mSsrc = 0;
+    mMutex.unlock();
+}
+
+unsigned int RTPPacketHistory::GetSourceIdentifier()
+{
+    return mSsrc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
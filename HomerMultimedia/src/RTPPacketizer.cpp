@@ -0,0 +1,386 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of the native RTP packetizer for H.264 and HEVC
+ * Since:   2026-10-17
+ */
+
+//HINT: NAL units which fit into one packet are sent as single NAL unit packets or are aggregated (H.264: STAP-A, HEVC: AP),
+//HINT: bigger ones are split into fragmentation units (H.264: FU-A, HEVC: FU); the encoded frame is never copied
+
+#include <RTPPacketizer.h>
+#include <Logger.h>
+
+#include <string.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// minimum payload size per packet, smaller packet size limits are rejected
+#define RTP_PACKETIZER_MIN_PAYLOAD_SIZE                     64
+
+// size of the length field in front of each aggregated NAL unit
+#define RTP_PACKETIZER_AGGREGATION_SIZE_FIELD               2
+
+// H.264 payload types (RFC 6184)
+#define H264_NAL_TYPE_STAP_A                                24
+#define H264_NAL_TYPE_FU_A                                  28
+#define H264_FU_HEADER_SIZE                                 2 // FU indicator, FU header
+
+// HEVC payload types (RFC 7798)
+#define HEVC_NAL_TYPE_AP                                    48
+#define HEVC_NAL_TYPE_FU                                    49
+#define HEVC_FU_HEADER_SIZE                                 3 // payload header, FU header
+
+#define WRITE_UINT16(x, y)                                  { (x)[0] = (char)(((y) >> 8) & 0xFF); (x)[1] = (char)((y) & 0xFF); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPPacketizer::RTPPacketizer()
+{
+    mCodecId = AV_CODEC_ID_NONE;
+    mMaxPayloadSize = 0;
+    mNalHeaderSize = 1;
+    mNalLengthSize = 0;
+    mPacketCount = 0;
+}
+
+RTPPacketizer::~RTPPacketizer()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPPacketizer::IsCodecSupported(enum AVCodecID pCodecId)
+{
+    return ((pCodecId == AV_CODEC_ID_H264) || (pCodecId == AV_CODEC_ID_HEVC));
+}
+
+bool RTPPacketizer::Open(enum AVCodecID pCodecId, unsigned int pMaxPacketSize, const uint8_t *pExtraData, int pExtraDataSize)
+{
+    if (!IsCodecSupported(pCodecId))
+    {
+        LOG(LOG_ERROR, "Codec %d isn't supported by the native RTP packetizer", (int)pCodecId);
+        return false;
+    }
+
+    if (pMaxPacketSize < RTP_PACKETIZER_RTP_HEADER_SIZE + RTP_PACKETIZER_MIN_PAYLOAD_SIZE)
+    {
+        LOG(LOG_ERROR, "Maximum RTP packet size of %u bytes is too small for the native RTP packetizer", pMaxPacketSize);
+        return false;
+    }
+
+    mCodecId = pCodecId;
+    mMaxPayloadSize = pMaxPacketSize - RTP_PACKETIZER_RTP_HEADER_SIZE;
+    mNalHeaderSize = (pCodecId == AV_CODEC_ID_H264) ? 1 : 2;
+
+    // the configuration records "avcC" and "hvcC" start with version 1, Annex B extra data starts with a start code
+    mNalLengthSize = 0;
+    if ((pExtraData != NULL) && (pExtraDataSize > 0) && (pExtraData[0] == 1))
+    {
+        if ((pCodecId == AV_CODEC_ID_H264) && (pExtraDataSize >= 7))
+            mNalLengthSize = (pExtraData[4] & 0x03) + 1;
+        if ((pCodecId == AV_CODEC_ID_HEVC) && (pExtraDataSize >= 23))
+            mNalLengthSize = (pExtraData[21] & 0x03) + 1;
+    }
+
+    LOG(LOG_VERBOSE, "Opened native RTP packetizer for %s with max. payload size of %u bytes and %s", (pCodecId == AV_CODEC_ID_H264) ? "H.264" : "HEVC", mMaxPayloadSize, (mNalLengthSize > 0) ? "length prefixed NAL units" : "start codes");
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPPacketizer::Packetize(char *pData, unsigned int pDataSize, RtpPacketDescriptor *&pPackets)
+{
+    pPackets = NULL;
+    mPacketCount = 0;
+
+    if ((mMaxPayloadSize == 0) || (pData == NULL) || (pDataSize == 0))
+        return 0;
+
+    mNalUnits.clear();
+    if (mNalLengthSize > 0)
+        FindNalUnitsLengthPrefixed(pData, pDataSize);
+    else
+        FindNalUnits(pData, pDataSize);
+
+    int tNalUnitCount = (int)mNalUnits.size();
+    if (tNalUnitCount == 0)
+        return 0;
+
+    // upper bound for the packet count: every NAL unit ends one packet and each full packet carries at least mMaxPayloadSize - 3 bytes
+    // HINT: the packets reference their own header memory, hence the packet list mustn't grow while packets are created
+    unsigned int tMaxPackets = tNalUnitCount + pDataSize / (mMaxPayloadSize - HEVC_FU_HEADER_SIZE) + 1;
+    if (mPackets.size() < tMaxPackets)
+        mPackets.resize(tMaxPackets);
+
+    int i = 0;
+    while (i < tNalUnitCount)
+    {
+        if (mNalUnits[i].Size > mMaxPayloadSize)
+        {
+            CreateFragmentationUnits(&mNalUnits[i]);
+            i++;
+            continue;
+        }
+
+        // aggregate the following NAL units as long as they fit into the same packet
+        unsigned int tAggregationSize = mNalHeaderSize + RTP_PACKETIZER_AGGREGATION_SIZE_FIELD + mNalUnits[i].Size;
+        int tCount = 1;
+        while ((i + tCount < tNalUnitCount) && (tCount < RTP_PACKETIZER_MAX_AGGREGATED_NAL_UNITS) && (tAggregationSize + RTP_PACKETIZER_AGGREGATION_SIZE_FIELD + mNalUnits[i + tCount].Size <= mMaxPayloadSize))
+        {
+            tAggregationSize += RTP_PACKETIZER_AGGREGATION_SIZE_FIELD + mNalUnits[i + tCount].Size;
+            tCount++;
+        }
+
+        if (tCount > 1)
+            CreateAggregationPacket(&mNalUnits[i], tCount);
+        else
+            CreateSingleNalUnitPacket(&mNalUnits[i]);
+        i += tCount;
+    }
+
+    mPackets[mPacketCount - 1].LastPacket = true;
+
+    #ifdef RTPPACKETIZER_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Packetized frame of %u bytes with %d NAL units into %d RTP packets", pDataSize, tNalUnitCount, mPacketCount);
+    #endif
+
+    pPackets = &mPackets[0];
+
+    return mPacketCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+char* RTPPacketizer::FindStartCode(char *pData, char *pDataEnd)
+{
+    // search for the "0x01" of "0x00 0x00 0x01", it is rare within coded slice data and memchr() is much faster than a byte-wise scan
+    char *tData = pData + 2;
+    while (tData < pDataEnd)
+    {
+        tData = (char*)memchr(tData, 1, pDataEnd - tData);
+        if (tData == NULL)
+            break;
+        if ((tData[-1] == 0) && (tData[-2] == 0))
+            return tData - 2;
+        // the next start code can't end before tData + 3
+        tData += 3;
+    }
+
+    return pDataEnd;
+}
+
+void RTPPacketizer::FindNalUnits(char *pData, unsigned int pDataSize)
+{
+    char *tDataEnd = pData + pDataSize;
+    char *tNalUnitStart = FindStartCode(pData, tDataEnd);
+
+    // no start code at all: the frame is one NAL unit
+    if (tNalUnitStart == tDataEnd)
+    {
+        RtpNalUnit tNalUnit;
+        tNalUnit.Data = pData;
+        tNalUnit.Size = pDataSize;
+        if (tNalUnit.Size >= mNalHeaderSize)
+            mNalUnits.push_back(tNalUnit);
+        return;
+    }
+
+    while (tNalUnitStart < tDataEnd)
+    {
+        tNalUnitStart += 3;
+        char *tNalUnitEnd = FindStartCode(tNalUnitStart, tDataEnd);
+
+        // the next NAL unit may start with a 4 byte start code
+        char *tNalUnitLast = tNalUnitEnd;
+        if ((tNalUnitEnd < tDataEnd) && (tNalUnitLast > tNalUnitStart) && (tNalUnitLast[-1] == 0))
+            tNalUnitLast--;
+
+        RtpNalUnit tNalUnit;
+        tNalUnit.Data = tNalUnitStart;
+        tNalUnit.Size = (unsigned int)(tNalUnitLast - tNalUnitStart);
+        if (tNalUnit.Size >= mNalHeaderSize)
+            mNalUnits.push_back(tNalUnit);
+
+        tNalUnitStart = tNalUnitEnd;
+    }
+}
+
+void RTPPacketizer::FindNalUnitsLengthPrefixed(char *pData, unsigned int pDataSize)
+{
+    char *tData = pData;
+    char *tDataEnd = pData + pDataSize;
+
+    while (tDataEnd - tData > mNalLengthSize)
+    {
+        unsigned int tNalUnitSize = 0;
+        for (int i = 0; i < mNalLengthSize; i++)
+            tNalUnitSize = (tNalUnitSize << 8) | (unsigned int)(unsigned char)tData[i];
+        tData += mNalLengthSize;
+
+        if (tNalUnitSize > (unsigned int)(tDataEnd - tData))
+        {
+            LOG_RATE_LIMITED(LOG_WARN, LOG_PER_PACKET_RATE_LIMIT, "NAL unit of %u bytes exceeds the remaining %d bytes of the frame, skipping the rest", tNalUnitSize, (int)(tDataEnd - tData));
+            return;
+        }
+
+        RtpNalUnit tNalUnit;
+        tNalUnit.Data = tData;
+        tNalUnit.Size = tNalUnitSize;
+        if (tNalUnit.Size >= mNalHeaderSize)
+            mNalUnits.push_back(tNalUnit);
+
+        tData += tNalUnitSize;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RtpPacketDescriptor* RTPPacketizer::CreatePacket(unsigned int pPayloadHeaderSize)
+{
+    RtpPacketDescriptor *tPacket = &mPackets[mPacketCount++];
+
+    tPacket->VectorCount = 0;
+    tPacket->Size = 0;
+    tPacket->LastPacket = false;
+
+    // the RTP header and the payload header are sent from the header memory
+    AddVector(tPacket, tPacket->Header, RTP_PACKETIZER_RTP_HEADER_SIZE + pPayloadHeaderSize);
+
+    return tPacket;
+}
+
+void RTPPacketizer::AddVector(RtpPacketDescriptor *pPacket, char *pData, unsigned int pSize)
+{
+    pPacket->Vectors[pPacket->VectorCount].Data = pData;
+    pPacket->Vectors[pPacket->VectorCount].Size = pSize;
+    pPacket->VectorCount++;
+    pPacket->Size += pSize;
+}
+
+void RTPPacketizer::CreateSingleNalUnitPacket(RtpNalUnit *pNalUnit)
+{
+    // the NAL unit header serves as payload header
+    RtpPacketDescriptor *tPacket = CreatePacket(0);
+    AddVector(tPacket, pNalUnit->Data, pNalUnit->Size);
+}
+
+void RTPPacketizer::CreateAggregationPacket(RtpNalUnit *pNalUnits, int pCount)
+{
+    // payload header and the size field of the first NAL unit
+    RtpPacketDescriptor *tPacket = CreatePacket(mNalHeaderSize + RTP_PACKETIZER_AGGREGATION_SIZE_FIELD);
+    char *tPayloadHeader = tPacket->Header + RTP_PACKETIZER_RTP_HEADER_SIZE;
+
+    if (mCodecId == AV_CODEC_ID_H264)
+    {// STAP-A: F bit is set if any NAL unit has it, NRI is the maximum of all NAL units
+        unsigned char tForbiddenBit = 0;
+        unsigned char tNri = 0;
+        for (int i = 0; i < pCount; i++)
+        {
+            unsigned char tNalUnitHeader = (unsigned char)pNalUnits[i].Data[0];
+            tForbiddenBit |= tNalUnitHeader & 0x80;
+            if ((tNalUnitHeader & 0x60) > tNri)
+                tNri = tNalUnitHeader & 0x60;
+        }
+        tPayloadHeader[0] = (char)(tForbiddenBit | tNri | H264_NAL_TYPE_STAP_A);
+    }else
+    {// AP: F bit is set if any NAL unit has it, layer ID and temporal ID are the lowest ones of all NAL units
+        unsigned char tForbiddenBit = 0;
+        unsigned char tLayerId = 0x3F;
+        unsigned char tTemporalId = 0x07;
+        for (int i = 0; i < pCount; i++)
+        {
+            unsigned char tNalUnitHeader0 = (unsigned char)pNalUnits[i].Data[0];
+            unsigned char tNalUnitHeader1 = (unsigned char)pNalUnits[i].Data[1];
+            unsigned char tNalUnitLayerId = ((tNalUnitHeader0 & 0x01) << 5) | (tNalUnitHeader1 >> 3);
+            tForbiddenBit |= tNalUnitHeader0 & 0x80;
+            if (tNalUnitLayerId < tLayerId)
+                tLayerId = tNalUnitLayerId;
+            if ((tNalUnitHeader1 & 0x07) < tTemporalId)
+                tTemporalId = tNalUnitHeader1 & 0x07;
+        }
+        tPayloadHeader[0] = (char)(tForbiddenBit | (HEVC_NAL_TYPE_AP << 1) | (tLayerId >> 5));
+        tPayloadHeader[1] = (char)(((tLayerId & 0x1F) << 3) | tTemporalId);
+    }
+
+    char *tSizeField = tPayloadHeader + mNalHeaderSize;
+    for (int i = 0; i < pCount; i++)
+    {
+        // the size fields of the following NAL units are stored behind the one of the first NAL unit
+        if (i > 0)
+            AddVector(tPacket, tSizeField, RTP_PACKETIZER_AGGREGATION_SIZE_FIELD);
+        WRITE_UINT16(tSizeField, pNalUnits[i].Size);
+        tSizeField += RTP_PACKETIZER_AGGREGATION_SIZE_FIELD;
+
+        AddVector(tPacket, pNalUnits[i].Data, pNalUnits[i].Size);
+    }
+}
+
+void RTPPacketizer::CreateFragmentationUnits(RtpNalUnit *pNalUnit)
+{
+    unsigned char tNalUnitHeader0 = (unsigned char)pNalUnit->Data[0];
+    unsigned char tNalUnitHeader1 = (mNalHeaderSize > 1) ? (unsigned char)pNalUnit->Data[1] : 0;
+    unsigned int tFuHeaderSize = (mCodecId == AV_CODEC_ID_H264) ? H264_FU_HEADER_SIZE : HEVC_FU_HEADER_SIZE;
+    unsigned int tMaxFragmentSize = mMaxPayloadSize - tFuHeaderSize;
+
+    // the NAL unit header is rebuilt by the receiver from the FU headers
+    char *tFragment = pNalUnit->Data + mNalHeaderSize;
+    unsigned int tRemainingSize = pNalUnit->Size - mNalHeaderSize;
+    bool tFirstFragment = true;
+
+    while (tRemainingSize > 0)
+    {
+        unsigned int tFragmentSize = (tRemainingSize > tMaxFragmentSize) ? tMaxFragmentSize : tRemainingSize;
+        bool tLastFragment = (tFragmentSize == tRemainingSize);
+
+        RtpPacketDescriptor *tPacket = CreatePacket(tFuHeaderSize);
+        char *tPayloadHeader = tPacket->Header + RTP_PACKETIZER_RTP_HEADER_SIZE;
+
+        // S and E bits
+        unsigned char tFuHeader = (tFirstFragment ? 0x80 : 0) | (tLastFragment ? 0x40 : 0);
+        if (mCodecId == AV_CODEC_ID_H264)
+        {// FU indicator with F and NRI of the NAL unit, FU header with the NAL unit type
+            tPayloadHeader[0] = (char)((tNalUnitHeader0 & 0xE0) | H264_NAL_TYPE_FU_A);
+            tPayloadHeader[1] = (char)(tFuHeader | (tNalUnitHeader0 & 0x1F));
+        }else
+        {// payload header with F, layer ID and temporal ID of the NAL unit, FU header with the NAL unit type
+            tPayloadHeader[0] = (char)((tNalUnitHeader0 & 0x81) | (HEVC_NAL_TYPE_FU << 1));
+            tPayloadHeader[1] = (char)tNalUnitHeader1;
+            tPayloadHeader[2] = (char)(tFuHeader | ((tNalUnitHeader0 >> 1) & 0x3F));
+        }
+
+        AddVector(tPacket, tFragment, tFragmentSize);
+
+        tFragment += tFragmentSize;
+        tRemainingSize -= tFragmentSize;
+        tFirstFragment = false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
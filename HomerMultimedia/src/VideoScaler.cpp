@@ -73,15 +73,14 @@ void VideoScaler::StartScaler(int pInputQueueSize, int pSourceResX, int pSourceR
 
     int tInputBufferSize = avpicture_get_size(mSourcePixelFormat, mSourceResX, mSourceResY) + FF_INPUT_BUFFER_PADDING_SIZE;
     //HINT: we have to allocate input FIFO here to make sure we can force a return from a read request inside StopScaler(), StartScaler() and StopScaler() should be called from the same thread/context!
-    mInputFifo = new MediaFifo(mQueueSize, tInputBufferSize, "VIDEO-ScalerInput/" + mName);
+    mInputFifo = new MediaFifo(mQueueSize, tInputBufferSize, "VIDEO-ScalerInput/" + mName, MEDIA_FIFO_SPSC);
 
     // start scaler main loop
-    StartThread();
-
-    while(!mScalerNeeded)
+    if (StartThread())
     {
         LOG(LOG_VERBOSE, "Waiting for the start of %s VIDEO scaling thread", mName.c_str());
-        Thread::Suspend(100 * 1000);
+        if (!WaitForReady())
+            LOG(LOG_ERROR, "%s VIDEO scaling thread terminated during its init. process", mName.c_str());
     }
 
 }
@@ -96,6 +95,7 @@ void VideoScaler::StopScaler()
     {
         // tell scaler thread it isn't needed anymore
         mScalerNeeded = false;
+        WakeUp();
 
         // wait for termination of scaler thread
         do
@@ -106,9 +106,7 @@ void VideoScaler::StopScaler()
 
             // write fake data to awake scaler thread as long as it still runs
             mInputFifo->WriteFifo(NULL, 0, 0);
-
-            Suspend(100 * 1000);
-        }while(IsRunning());
+        }while(!WaitForTermination(100));
     }
 
     LOG(LOG_VERBOSE, "Video scaler seems to be stopped, deleting input FIFO");
@@ -121,16 +119,44 @@ void VideoScaler::StopScaler()
     LOG(LOG_VERBOSE, "Scaler stopped");
 }
 
-void VideoScaler::WriteFifo(char* pBuffer, int pBufferSize, int64_t pFrameTimestamp)
+void VideoScaler::WriteFifo(char* pBuffer, int pBufferSize, int64_t pFrameTimestamp, bool pKeyFrame)
+{
+    mInputFifoMutex.lock();
+    if (mInputFifo != NULL)
+    {
+        if (pBufferSize <= mInputFifo->GetEntrySize())
+            mInputFifo->WriteFifo(pBuffer, pBufferSize, pFrameTimestamp, pKeyFrame);
+        else
+            LOG(LOG_ERROR, "Input buffer of %d bytes is too big for input FIFO of video scaler %s with %d bytes per entry", pBufferSize, mName.c_str(), mInputFifo->GetEntrySize());
+    }
+    mInputFifoMutex.unlock();
+}
+
+int VideoScaler::WriteFifoExclusive(char **pBuffer, int pBufferSize)
 {
+    int tResult = -1;
+
+    // HINT: the input FIFO mutex stays locked until WriteFifoExclusiveFinished() is called, this avoids a deletion of the input FIFO by StopScaler()
     mInputFifoMutex.lock();
     if (mInputFifo != NULL)
     {
         if (pBufferSize <= mInputFifo->GetEntrySize())
-            mInputFifo->WriteFifo(pBuffer, pBufferSize, pFrameTimestamp);
+            tResult = mInputFifo->WriteFifoExclusive(pBuffer, pBufferSize);
         else
             LOG(LOG_ERROR, "Input buffer of %d bytes is too big for input FIFO of video scaler %s with %d bytes per entry", pBufferSize, mName.c_str(), mInputFifo->GetEntrySize());
     }
+    if (tResult < 0)
+        mInputFifoMutex.unlock();
+
+    return tResult;
+}
+
+void VideoScaler::WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pFrameTimestamp, bool pKeyFrame)
+{
+    if (pEntryPointer < 0)
+        return;
+
+    mInputFifo->WriteFifoExclusiveFinished(pEntryPointer, pBufferSize, pFrameTimestamp, pKeyFrame);
     mInputFifoMutex.unlock();
 }
 
@@ -253,8 +279,7 @@ void* VideoScaler::Run(void* pArgs)
         LOG(LOG_ERROR, "Out of video memory in avcodec_alloc_frame()");
     }
 
-    // Assign appropriate parts of buffer to image planes in frame
-    avpicture_fill((AVPicture *)tOutputFrame, (uint8_t *)tOutputBuffer, mTargetPixelFormat, mTargetResX, mTargetResY);
+    // HINT: the image planes of the output frame are assigned per frame, the frame is scaled directly into the output FIFO
 
     // Allocate video frame for format
     LOG(LOG_VERBOSE, "..allocating memory for %s input frame", mName.c_str());
@@ -273,10 +298,11 @@ void* VideoScaler::Run(void* pArgs)
     }
 
     LOG(LOG_VERBOSE, "..creating %s video scaler output FIFO", mName.c_str());
-    mOutputFifo = new MediaFifo(mQueueSize, tOutputBufferSize, "VIDEO-ScalerOutput/" + mName);
+    mOutputFifo = new MediaFifo(mQueueSize, tOutputBufferSize, "VIDEO-ScalerOutput/" + mName, MEDIA_FIFO_SPSC);
 
     mChunkNumber = 0;
     mScalerNeeded = true;
+    AnnounceReady();
 
     LOG(LOG_WARN, "================ Entering main VIDEO scaling loop");
     while(mScalerNeeded)
@@ -340,6 +366,18 @@ void* VideoScaler::Run(void* pArgs)
                     // ### SCALE FRAME (CONVERT)
                     // ###################################################################
                     int64_t tTime = Time::GetTimeStamp();
+
+                    // size of scaled output frame
+                    tCurrentChunkSize = avpicture_get_size(mTargetPixelFormat, mTargetResX, mTargetResY);
+
+                    // reserve an output FIFO entry and scale directly into it, use the local buffer if the output FIFO is full
+                    char *tOutputFifoBuffer = NULL;
+                    int tOutputFifoEntry = -1;
+                    if ((tCurrentChunkSize > 0) && (tCurrentChunkSize <= mOutputFifo->GetEntrySize()))
+                        tOutputFifoEntry = mOutputFifo->WriteFifoExclusive(&tOutputFifoBuffer, tCurrentChunkSize);
+                    uint8_t *tScaledFrame = (tOutputFifoEntry >= 0) ? (uint8_t*)tOutputFifoBuffer : tOutputBuffer;
+                    avpicture_fill((AVPicture *)tOutputFrame, tScaledFrame, mTargetPixelFormat, mTargetResX, mTargetResY);
+
                     // convert
 
                     #ifdef VS_DEBUG_PACKETS
@@ -356,9 +394,6 @@ void* VideoScaler::Run(void* pArgs)
                         LOG(LOG_VERBOSE, "SCALER-scaling video frame took %"PRId64" us", tTime2 - tTime);
                     #endif
 
-                    // size of scaled output frame
-                    tCurrentChunkSize = avpicture_get_size(mTargetPixelFormat, mTargetResX, mTargetResY);
-
                     #ifdef VS_DEBUG_PACKETS
                         LOG(LOG_VERBOSE, "SCALER-new output video frame..");
                         LOG(LOG_VERBOSE, "      ..key frame: %d", tOutputFrame->key_frame);
@@ -392,9 +427,11 @@ void* VideoScaler::Run(void* pArgs)
                         if (tCurrentChunkSize <= mOutputFifo->GetEntrySize())
                         {
                             if(mMediaSource != NULL)
-                                mMediaSource->RelayChunkToMediaFilters((char*)tOutputBuffer, tCurrentChunkSize, tInputFrameTimestamp);
+                                mMediaSource->RelayChunkToMediaFilters((char*)tScaledFrame, tCurrentChunkSize, tInputFrameTimestamp);
 
-                            mOutputFifo->WriteFifo((char*)tOutputBuffer, tCurrentChunkSize, tInputFrameTimestamp);
+                            // HINT: a failed reservation was already reported as dropped chunk by the output FIFO
+                            if (tOutputFifoEntry >= 0)
+                                mOutputFifo->WriteFifoExclusiveFinished(tOutputFifoEntry, tCurrentChunkSize, tInputFrameTimestamp);
                             #ifdef VS_DEBUG_PACKETS
                                 LOG(LOG_VERBOSE, "SCALER-successful scaler loop");
                             #endif
@@ -435,8 +472,8 @@ void* VideoScaler::Run(void* pArgs)
         }else
         {
             mScalingThreadMutex.unlock();
-            LOG(LOG_VERBOSE, "Suspending the scaler thread for 10 ms");
-            Suspend(10 * 1000); // check every 1/100 seconds the state of the FIFO
+            LOG(LOG_VERBOSE, "Suspending the scaler thread until it gets awaked");
+            SuspendUntilWakeUp();
         }
     }
 
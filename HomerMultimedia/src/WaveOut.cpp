@@ -300,6 +300,7 @@ void WaveOut::AssignThreadName()
     if (mHaveToAssignThreadName)
     {
         SVC_PROCESS_STATISTIC.AssignThreadName("WaveOut-File");
+        Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
         mHaveToAssignThreadName = false;
     }
 }
@@ -455,14 +456,14 @@ void* WaveOut::Run(void* pArgs)
                     LOG(LOG_VERBOSE, "Sending audio chunk %d of %d bytes from file to playback device", tSampleNumber, tSamplesSize);
                 #endif
 
-                // wait
+                // wait until the playback has consumed enough chunks
                 // HINT: we use 2 additional zero buffers after EOF was detected!
-                while ((GetQueueUsage() > MEDIA_SOURCE_SAMPLES_PLAYBACK_FIFO_SIZE - 4) && (MEDIA_SOURCE_SAMPLES_PLAYBACK_FIFO_SIZE > 4))
+                if ((GetQueueUsage() > MEDIA_SOURCE_SAMPLES_PLAYBACK_FIFO_SIZE - 4) && (MEDIA_SOURCE_SAMPLES_PLAYBACK_FIFO_SIZE > 4))
                 {
                     #ifdef WO_DEBUG_FILE
-                        LOG(LOG_VERBOSE, "Playback FIFO is filled, waiting some time");
+                        LOG(LOG_VERBOSE, "Playback FIFO is filled, waiting for free space");
                     #endif
-                    Thread::Suspend(10 * 1000); //TODO: use a condition here
+                    mPlaybackFifo->WaitForSpace(MEDIA_SOURCE_SAMPLES_PLAYBACK_FIFO_SIZE - 4);
                 }
 
                 WriteChunk(mFilePlaybackBuffer, tSamplesSize);
@@ -488,8 +489,7 @@ void* WaveOut::Run(void* pArgs)
                 {// passive waiting until next trigger is received
                     // wait until last chunk is played
                     LOG(LOG_VERBOSE, "EOF reached, waiting for playback end");
-                    while(mPlaybackFifo->GetUsage() > 0)
-                        Suspend(50 * 1000);
+                    mPlaybackFifo->WaitForSpace(0);
 
                     // stop playback
                     Stop();
@@ -440,6 +440,7 @@ void WaveOutPortAudio::AssignThreadName()
             SVC_PROCESS_STATISTIC.AssignThreadName("WaveOutPortAudio-File");
         else
             SVC_PROCESS_STATISTIC.AssignThreadName("WaveOutPortAudio-Mem");
+        Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
         mHaveToAssignThreadName = false;
     }
 }
@@ -223,6 +223,7 @@ void WaveOutSdl::AssignThreadName()
     if (mHaveToAssignThreadName)
     {
         SVC_PROCESS_STATISTIC.AssignThreadName("WaveOutSdl-File");
+        Thread::SetSchedulingClass(THREAD_SCHEDULING_REALTIME);
         mHaveToAssignThreadName = false;
     }
 }